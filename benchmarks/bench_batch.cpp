@@ -0,0 +1,89 @@
+#include <cmath>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "core/math/batch.hpp"
+
+#include "benchmark.hpp"
+
+static constexpr std::size_t TransformCount = 100000;
+
+struct BatchColumns {
+	std::vector<float> x = std::vector<float>(TransformCount, 1.0f);
+	std::vector<float> y = std::vector<float>(TransformCount, 2.0f);
+	std::vector<float> rotation = std::vector<float>(TransformCount, 0.5f);
+	std::vector<float> scaleX = std::vector<float>(TransformCount, 1.0f);
+	std::vector<float> scaleY = std::vector<float>(TransformCount, 1.0f);
+
+	auto GetArrays() -> Symbiote::Core::TransformArrays {
+		return {x.data(), y.data(), rotation.data(), scaleX.data(), scaleY.data()};
+	}
+};
+
+// the same kernel for every instruction set the processor supports
+static auto RunSimdLevels(BenchmarkContext &context, const std::function<void()> &body) -> void {
+	auto supported = Symbiote::Core::GetSupportedSimdLevel();
+	for (auto [level, name] : {std::make_pair(Symbiote::Core::SimdLevel::Scalar, "scalar"), std::make_pair(Symbiote::Core::SimdLevel::SSE2, "sse2"), std::make_pair(Symbiote::Core::SimdLevel::AVX2, "avx2")}) {
+		if (static_cast<int>(level) <= static_cast<int>(supported)) {
+			Symbiote::Core::SetSimdLevel(level);
+			context.Run(name, TransformCount, body);
+		}
+	}
+	Symbiote::Core::SetSimdLevel(supported);
+}
+
+BENCHMARK(Batch, ComposeTransforms) {
+	BatchColumns parents, locals, worlds;
+	RunSimdLevels(context, [&]() {
+		Symbiote::Core::ComposeTransforms(parents.GetArrays(), locals.GetArrays(), worlds.GetArrays(), TransformCount);
+		DoNotOptimize(worlds.x.data());
+	});
+}
+
+// one matrix at a time through glm, as the transform component does
+BENCHMARK(Batch, ComposeMatrices) {
+	std::vector<glm::mat3> parents(TransformCount, glm::mat3(1.0f)), locals(TransformCount, glm::mat3(1.0f)), worlds(TransformCount);
+	context.Run("glm", TransformCount, [&]() {
+		for (std::size_t i = 0; i < TransformCount; i++) {
+			worlds[i] = parents[i] * locals[i];
+		}
+		DoNotOptimize(worlds.data());
+	});
+}
+
+BENCHMARK(Batch, TransformPoints) {
+	BatchColumns points;
+	std::vector<float> x(TransformCount), y(TransformCount);
+	glm::mat3 matrix(1.0f);
+	RunSimdLevels(context, [&]() {
+		Symbiote::Core::TransformPoints(matrix, points.x.data(), points.y.data(), x.data(), y.data(), TransformCount);
+		DoNotOptimize(x.data());
+	});
+}
+
+BENCHMARK(Batch, IntegrateVelocities) {
+	BatchColumns positions, velocities;
+	RunSimdLevels(context, [&]() {
+		Symbiote::Core::IntegrateVelocities(positions.x.data(), positions.y.data(), velocities.x.data(), velocities.y.data(), 1.0f / 60.0f, TransformCount);
+		DoNotOptimize(positions.x.data());
+	});
+}
+
+// the same integration in fixed point, as lockstep builds run it
+template <typename Fixed>
+static auto BenchmarkIntegrateFixed(BenchmarkContext &context) -> void {
+	std::vector<Fixed> x(TransformCount, Fixed(1)), y(TransformCount, Fixed(2)), velocityX(TransformCount, Fixed(1)), velocityY(TransformCount, Fixed(2));
+	RunSimdLevels(context, [&]() {
+		Symbiote::Core::IntegrateVelocities(x.data(), y.data(), velocityX.data(), velocityY.data(), Fixed(1.0f / 60.0f), TransformCount);
+		DoNotOptimize(x.data());
+	});
+}
+
+BENCHMARK(Batch, IntegrateQ16) {
+	BenchmarkIntegrateFixed<Symbiote::Core::Q16>(context);
+}
+
+BENCHMARK(Batch, IntegrateQ32) {
+	BenchmarkIntegrateFixed<Symbiote::Core::Q32>(context);
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include <string>
+#include <vector>
+
+#include "core/ecs/entitymanager.hpp"
+
+#include "benchmark.hpp"
+#include "test_components/components.hpp"
+
+static constexpr std::size_t EntityCount = 50000;
+
+BENCHMARK(EntityManager, CreateDestroyChurn) {
+	auto manager = CreateEntityManager();
+	std::vector<Symbiote::Core::Entity> entities;
+	entities.reserve(EntityCount);
+	context.Run(EntityCount * 2, [&]() {
+		for (std::size_t i = 0; i < EntityCount; i++) {
+			entities.emplace_back(manager->CreateEntity());
+		}
+		for (auto &entity : entities) {
+			entity.Destroy();
+		}
+		entities.clear();
+	});
+}
+
+BENCHMARK(EntityManager, AddRemoveComponent) {
+	auto manager = CreateEntityManager();
+	std::vector<Symbiote::Core::Entity> entities;
+	for (std::size_t i = 0; i < EntityCount; i++) {
+		entities.emplace_back(manager->CreateEntity());
+	}
+	context.Run(EntityCount * 2, [&]() {
+		for (auto &entity : entities) {
+			entity.AddComponent<TransformComponent>();
+		}
+		for (auto &entity : entities) {
+			entity.RemoveComponent<TransformComponent>();
+		}
+	});
+}
+
+template<typename... C>
+static auto BenchmarkQuery(BenchmarkContext &context) -> void {
+	for (auto ratio : {10, 50, 100}) {
+		auto manager = CreateEntityManager();
+		for (std::size_t i = 0; i < EntityCount; i++) {
+			if (i % (100 / ratio) == 0) {
+				manager->CreateEntityWith<TransformComponent, PhysicsComponent, DummyComponent>();
+			} else {
+				manager->CreateEntityWith<DummyComponent>();
+			}
+		}
+		context.Run(std::to_string(ratio) + "%", EntityCount, [&]() {
+			auto matches = std::size_t{0};
+			manager->With<C...>([&matches](auto, C *...) { matches += 1; });
+			DoNotOptimize(matches);
+		});
+	}
+}
+
+BENCHMARK(EntityManager, Query1) {
+	BenchmarkQuery<TransformComponent>(context);
+}
+
+BENCHMARK(EntityManager, Query2) {
+	BenchmarkQuery<TransformComponent, PhysicsComponent>(context);
+}
+
+BENCHMARK(EntityManager, Query3) {
+	BenchmarkQuery<TransformComponent, PhysicsComponent, DummyComponent>(context);
+}
+
+// desync detection: the first hash goes over every page, the next ones only over the pages written to since
+BENCHMARK(EntityManager, Hash) {
+	auto manager = CreateEntityManager();
+	std::vector<Symbiote::Core::Entity> entities;
+	for (std::size_t i = 0; i < EntityCount * 20; i++) {
+		entities.emplace_back(manager->CreateEntity());
+		entities.back().AddComponent<PositionComponent>(static_cast<float>(i), 0.0f);
+		entities.back().AddComponent<VelocityComponent>(1.0f, 0.0f, 0.0f);
+	}
+	context.Run("cold", entities.size(), [&]() { DoNotOptimize(manager->Hash()); }, [&]() {
+		for (auto &entity : entities) {
+			entity.GetComponent<PositionComponent>()->x += 1.0f;
+			entity.GetComponent<VelocityComponent>()->x += 1.0f;
+		}
+	});
+	context.Run("1% dirty", entities.size(), [&]() { DoNotOptimize(manager->Hash()); }, [&]() {
+		for (std::size_t i = 0; i < entities.size(); i += Symbiote::Core::ComponentColumn::PageSize / sizeof(PositionComponent) * 100) {
+			entities[i].GetComponent<PositionComponent>()->x += 1.0f;
+		}
+	});
+}
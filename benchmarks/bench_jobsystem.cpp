@@ -0,0 +1,34 @@
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "core/jobs/jobsystem.hpp"
+
+#include "benchmark.hpp"
+
+BENCHMARK(JobSystem, SpawnOverhead) {
+	static constexpr std::size_t JobCount = 100000;
+	Symbiote::Core::JobSystem jobs;
+	std::atomic<std::size_t> sum = {0};
+	context.Run(JobCount, [&]() {
+		Symbiote::Core::JobSystem::Counter counter;
+		for (std::size_t i = 0; i < JobCount; i++) {
+			jobs.Schedule([&sum]() { sum += 1; }, &counter);
+		}
+		jobs.Wait(counter);
+	});
+}
+
+BENCHMARK(JobSystem, ParallelForScaling) {
+	std::vector<float> values(1 << 22, 1.0f);
+	for (std::size_t threadCount = 1; threadCount <= Symbiote::Core::JobSystem::DefaultThreadCount(); threadCount *= 2) {
+		Symbiote::Core::JobSystem jobs(threadCount);
+		context.Run(std::to_string(threadCount) + "threads", values.size(), [&]() {
+			jobs.ParallelFor(0, values.size(), 1 << 14, [&values](std::size_t begin, std::size_t end) {
+				for (auto i = begin; i < end; i++) {
+					values[i] = values[i] * 1.0001f + 0.5f;
+				}
+			});
+		});
+	}
+}
@@ -0,0 +1,212 @@
+#include <cmath>
+#include <random>
+#include <optional>
+#include <vector>
+
+#include "core/ecs/entitymanager.hpp"
+#include "core/jobs/jobsystem.hpp"
+#include "core/math/batch.hpp"
+
+#include "game/systems/physics/physics.hpp"
+#include "game/systems/physics/narrowphase.hpp"
+#include "game/components/rigidbody/rigidbody.hpp"
+#include "game/components/transform/transform.hpp"
+
+#include "benchmark.hpp"
+
+static constexpr std::size_t BodyCount = 1000000;
+
+static auto CreateBodies(Symbiote::Core::EntityManager &manager, bool transforms) -> void {
+	manager.RegisterComponent<Symbiote::Game::RigidBodyComponent>();
+	manager.RegisterComponent<Symbiote::Game::TransformComponent>();
+	for (std::size_t i = 0; i < BodyCount; i++) {
+		auto entity = manager.CreateEntityWith<Symbiote::Game::RigidBodyComponent>();
+		if (transforms) {
+			entity.AddComponent<Symbiote::Game::TransformComponent>();
+		}
+		auto body = entity.GetComponent<Symbiote::Game::RigidBodyComponent>();
+		body->SetVelocity({1.0f, 0.0f});
+		body->SetAcceleration({0.0f, -9.8f});
+		body->SetLinearDamping(0.01f);
+	}
+}
+
+// the integration alone, over the arrays of the system
+BENCHMARK(Physics, Integrate) {
+	Symbiote::Core::JobSystem jobs;
+	Symbiote::Core::EntityManager manager;
+	auto physics = manager.AddSystem<Symbiote::Game::PhysicsSystem>(&jobs);
+	CreateBodies(manager, false);
+	physics->Update(1.0f / 60.0f);
+	context.Run("parallel", BodyCount, [&]() { physics->Update(1.0f / 60.0f); });
+}
+
+// the integration and the transforms written back
+BENCHMARK(Physics, Step) {
+	Symbiote::Core::JobSystem jobs;
+	Symbiote::Core::EntityManager manager;
+	auto physics = manager.AddSystem<Symbiote::Game::PhysicsSystem>(&jobs);
+	CreateBodies(manager, true);
+	context.Run("parallel", BodyCount, [&]() { physics->Update(1.0f / 60.0f); });
+}
+
+// the broadphase over bodies spread on a square, the density is the number of bodies per cell
+static auto BenchmarkBroadphase(BenchmarkContext &context, const char *variant, float density) -> void {
+	static constexpr std::size_t BroadphaseBodyCount = 100000;
+	Symbiote::Core::JobSystem jobs;
+	Symbiote::Core::EntityManager manager;
+	manager.RegisterComponent<Symbiote::Game::RigidBodyComponent>();
+	manager.RegisterComponent<Symbiote::Game::TransformComponent>();
+	auto physics = manager.AddSystem<Symbiote::Game::PhysicsSystem>(&jobs);
+	auto cellSize = physics->GetCellSize();
+	auto side = std::sqrt(BroadphaseBodyCount / density) * cellSize;
+	std::mt19937 random(42);
+	std::uniform_real_distribution<float> positions(0.0f, side);
+	std::uniform_real_distribution<float> velocities(-5.0f, 5.0f);
+	for (std::size_t i = 0; i < BroadphaseBodyCount; i++) {
+		auto entity = manager.CreateEntityWith<Symbiote::Game::RigidBodyComponent, Symbiote::Game::TransformComponent>();
+		entity.GetComponent<Symbiote::Game::TransformComponent>()->SetPosition({positions(random), positions(random)});
+		auto body = entity.GetComponent<Symbiote::Game::RigidBodyComponent>();
+		body->SetVelocity({velocities(random), velocities(random)});
+		body->SetCircle(cellSize * 0.25f);
+	}
+	physics->Update(1.0f / 60.0f);
+	context.Run(variant, BroadphaseBodyCount, [&]() { physics->Update(1.0f / 60.0f); });
+}
+
+BENCHMARK(Physics, Broadphase) {
+	BenchmarkBroadphase(context, "sparse", 0.1f);
+	BenchmarkBroadphase(context, "medium", 1.0f);
+	BenchmarkBroadphase(context, "dense", 8.0f);
+}
+
+// batches of queries from many agents over 100k bodies, one op is one query
+BENCHMARK(Physics, Queries) {
+	static constexpr std::size_t QueryBodyCount = 100000;
+	static constexpr std::size_t QueryCount = 10000;
+	Symbiote::Core::JobSystem jobs;
+	Symbiote::Core::EntityManager manager;
+	manager.RegisterComponent<Symbiote::Game::RigidBodyComponent>();
+	manager.RegisterComponent<Symbiote::Game::TransformComponent>();
+	auto physics = manager.AddSystem<Symbiote::Game::PhysicsSystem>(&jobs);
+	std::mt19937 random(42);
+	std::uniform_real_distribution<float> positions(0.0f, 1000.0f);
+	std::uniform_real_distribution<float> angles(0.0f, 6.28f);
+	for (std::size_t i = 0; i < QueryBodyCount; i++) {
+		auto entity = manager.CreateEntityWith<Symbiote::Game::RigidBodyComponent, Symbiote::Game::TransformComponent>();
+		entity.GetComponent<Symbiote::Game::TransformComponent>()->SetPosition({positions(random), positions(random)});
+		entity.GetComponent<Symbiote::Game::TransformComponent>()->SetRotation(angles(random));
+		auto body = entity.GetComponent<Symbiote::Game::RigidBodyComponent>();
+		i % 2 == 0 ? body->SetCircle(0.5f) : body->SetBox({0.5f, 1.0f});
+	}
+	physics->Update(1.0f / 60.0f);
+
+	std::vector<Symbiote::Game::PhysicsSystem::Ray> rays;
+	std::vector<Symbiote::Game::PhysicsSystem::Region> regions;
+	std::vector<Symbiote::Game::PhysicsSystem::Circle> circles;
+	for (std::size_t i = 0; i < QueryCount; i++) {
+		auto angle = angles(random);
+		auto position = glm::vec2(positions(random), positions(random));
+		rays.push_back({position, {std::cos(angle), std::sin(angle)}, 50.0f});
+		regions.push_back({position - 5.0f, position + 5.0f});
+		circles.push_back({position, 5.0f});
+	}
+	std::vector<std::optional<Symbiote::Game::PhysicsSystem::RaycastHit>> hits;
+	std::vector<std::vector<Symbiote::Core::Entity>> entities;
+	context.Run("raycast", QueryCount, [&]() { physics->Raycast(rays, hits); });
+	context.Run("aabb", QueryCount, [&]() { physics->QueryAABB(regions, entities); });
+	context.Run("circle", QueryCount, [&]() { physics->QueryCircle(circles, entities); });
+}
+// the narrowphase over overlapping pairs of mixed shapes, ops per second divided by a thousand are pairs per millisecond
+BENCHMARK(Physics, Narrowphase) {
+	static constexpr std::size_t ShapeCount = 20000;
+	std::mt19937 random(42);
+	std::uniform_real_distribution<float> positions(0.0f, 100.0f);
+	std::uniform_real_distribution<float> angles(-3.14f, 3.14f);
+	std::vector<Symbiote::Game::RigidBodyComponent::Shape> shapes;
+	std::vector<Symbiote::Core::Real> x, y, cos, sin, extentX, extentY;
+	for (std::size_t i = 0; i < ShapeCount; i++) {
+		auto angle = angles(random);
+		shapes.push_back(i % 2 == 0 ? Symbiote::Game::RigidBodyComponent::Shape::Circle : Symbiote::Game::RigidBodyComponent::Shape::Box);
+		x.push_back(positions(random));
+		y.push_back(positions(random));
+		cos.push_back(std::cos(angle));
+		sin.push_back(std::sin(angle));
+		extentX.push_back(0.6f);
+		extentY.push_back(i % 2 == 0 ? 0.6f : 0.4f);
+	}
+	// the pairs the broadphase would report
+	Symbiote::Game::SpatialHashGrid grid(2.0f);
+	std::vector<float> minX(ShapeCount), minY(ShapeCount), maxX(ShapeCount), maxY(ShapeCount);
+	std::vector<Symbiote::Core::Real> inverseMass(ShapeCount, 1.0f);
+	for (std::uint32_t i = 0; i < ShapeCount; i++) {
+		minX[i] = static_cast<float>(x[i]) - 0.75f;
+		minY[i] = static_cast<float>(y[i]) - 0.75f;
+		maxX[i] = static_cast<float>(x[i]) + 0.75f;
+		maxY[i] = static_cast<float>(y[i]) + 0.75f;
+		grid.Insert(i, grid.GetRange(minX[i], minY[i], maxX[i], maxY[i]));
+	}
+	std::vector<Symbiote::Game::SpatialHashGrid::Pair> pairs;
+	grid.FindPairs({minX.data(), minY.data(), maxX.data(), maxY.data(), inverseMass.data()}, pairs);
+
+	Symbiote::Game::Narrowphase narrowphase;
+	Symbiote::Game::Narrowphase::Shapes columns = {shapes.data(), x.data(), y.data(), cos.data(), sin.data(), extentX.data(), extentY.data()};
+	std::vector<Symbiote::Game::Narrowphase::Contact> contacts;
+	auto supported = Symbiote::Core::GetSupportedSimdLevel();
+	Symbiote::Core::SetSimdLevel(Symbiote::Core::SimdLevel::Scalar);
+	context.Run("scalar", pairs.size(), [&]() { narrowphase.Collide(columns, pairs, contacts); });
+	if (supported != Symbiote::Core::SimdLevel::Scalar) {
+		Symbiote::Core::SetSimdLevel(Symbiote::Core::SimdLevel::SSE2);
+		context.Run("sse2", pairs.size(), [&]() { narrowphase.Collide(columns, pairs, contacts); });
+	}
+	Symbiote::Core::SetSimdLevel(supported);
+}
+
+// whole steps of crowded scenes resting on a static ground, the contacts are solved by islands in parallel
+// with sleeping, the bodies at rest fall asleep during the first steps and the measured steps go through the bodies awake only
+static auto BenchmarkSolver(BenchmarkContext &context, const char *variant, bool pyramid, bool sleeping) -> void {
+	Symbiote::Core::JobSystem jobs;
+	Symbiote::Core::EntityManager manager;
+	manager.RegisterComponent<Symbiote::Game::RigidBodyComponent>();
+	manager.RegisterComponent<Symbiote::Game::TransformComponent>();
+	auto physics = manager.AddSystem<Symbiote::Game::PhysicsSystem>(&jobs);
+	physics->SetSleepingEnabled(sleeping);
+	auto create = [&](glm::vec2 position, glm::vec2 halfExtents, float mass) {
+		auto entity = manager.CreateEntityWith<Symbiote::Game::TransformComponent, Symbiote::Game::RigidBodyComponent>();
+		auto body = entity.GetComponent<Symbiote::Game::RigidBodyComponent>();
+		entity.GetComponent<Symbiote::Game::TransformComponent>()->SetPosition(position);
+		body->SetBox(halfExtents);
+		body->SetMass(mass);
+		body->SetAcceleration({0.0f, -10.0f});
+	};
+	create({0.0f, 0.0f}, {500.0f, 0.5f}, 0.0f);
+	if (pyramid) {
+		// a single island of bricks, its contacts are colored
+		for (auto row = 0; row < 20; row++) {
+			for (auto column = 0; column < 100 - row; column++) {
+				create({column + row * 0.5f - 50.0f, 0.75f + row * 0.5f}, {0.5f, 0.25f}, 1.0f);
+			}
+		}
+	} else {
+		// as many islands as stacks
+		for (auto stack = 0; stack < 200; stack++) {
+			for (auto box = 0; box < 10; box++) {
+				create({stack * 2.0f - 200.0f, 1.0f + box}, {0.5f, 0.5f}, 1.0f);
+			}
+		}
+	}
+	for (auto step = 0; step < 120; step++) {
+		physics->Update(1.0f / 60.0f);
+	}
+	context.Run(variant, physics->GetBodyCount(), [&]() { physics->Update(1.0f / 60.0f); });
+}
+
+BENCHMARK(Physics, Solver) {
+	BenchmarkSolver(context, "stacks", false, false);
+	BenchmarkSolver(context, "pyramid", true, false);
+}
+
+BENCHMARK(Physics, Sleeping) {
+	BenchmarkSolver(context, "awake", false, false);
+	BenchmarkSolver(context, "asleep", false, true);
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "core/ecs/entitymanager.hpp"
+
+#include "benchmark.hpp"
+#include "test_components/components.hpp"
+
+static constexpr std::size_t EntityCount = 10000;
+static constexpr std::uint64_t RollbackFrames = 8;
+
+static auto CreateRollbackEntityManager() -> std::unique_ptr<Symbiote::Core::EntityManager> {
+	auto manager = CreateEntityManager();
+	for (std::size_t i = 0; i < EntityCount; i++) {
+		auto entity = manager->CreateEntity();
+		entity.AddComponent<PositionComponent>(static_cast<float>(i), 0.0f);
+		entity.AddComponent<VelocityComponent>(1.0f, 0.5f, 0.0f);
+		if (i % 4 == 0) {
+			entity.AddComponent<TransformComponent>(static_cast<float>(i), 1.0f);
+		}
+	}
+	return manager;
+}
+
+static auto Simulate(Symbiote::Core::EntityManager &manager) -> void {
+	manager.With<PositionComponent, VelocityComponent>([](auto, auto position, auto velocity) {
+		position->x += velocity->x;
+		position->y += velocity->y;
+	});
+}
+
+BENCHMARK(Rollback, SaveFrame) {
+	auto manager = CreateRollbackEntityManager();
+	std::uint64_t tick = 0;
+	context.Run(EntityCount, [&]() {
+		Simulate(*manager);
+		manager->SaveFrame(tick++);
+	});
+}
+
+BENCHMARK(Rollback, RestoreFrame) {
+	auto manager = CreateRollbackEntityManager();
+	manager->SaveFrame(0);
+	context.Run(EntityCount, [&]() { manager->RestoreFrame(0); });
+}
+
+// a late input: the world goes 8 frames back and is simulated and saved again up to the present, within a 16ms frame
+BENCHMARK(Rollback, Resimulate8Frames) {
+	auto manager = CreateRollbackEntityManager();
+	std::uint64_t tick = 0;
+	for (; tick <= RollbackFrames; tick++) {
+		manager->SaveFrame(tick);
+		Simulate(*manager);
+	}
+	context.Run(EntityCount * RollbackFrames, [&]() {
+		manager->RestoreFrame(tick - RollbackFrames);
+		for (auto frame = tick - RollbackFrames; frame < tick; frame++) {
+			Simulate(*manager);
+			manager->SaveFrame(frame + 1);
+		}
+	});
+}
+
+BENCHMARK(Rollback, Fork) {
+	auto manager = CreateRollbackEntityManager();
+	context.Run(EntityCount, [&]() { DoNotOptimize(manager->Fork()); });
+}
+
+// AI lookahead: a fork is simulated 8 frames ahead then discarded, only the pages it wrote to are copied
+BENCHMARK(Rollback, ForkLookahead8Frames) {
+	auto manager = CreateRollbackEntityManager();
+	context.Run(EntityCount * RollbackFrames, [&]() {
+		auto fork = manager->Fork();
+		for (std::uint64_t frame = 0; frame < RollbackFrames; frame++) {
+			Simulate(*fork);
+		}
+	});
+}
@@ -0,0 +1,171 @@
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "core/ecs/entitymanager.hpp"
+#include "core/serialization/delta.hpp"
+#include "core/serialization/compression.hpp"
+
+#include "benchmark.hpp"
+#include "test_components/components.hpp"
+
+static constexpr std::size_t EntityCount = 1000000;
+
+static auto CreatePopulatedEntityManager() -> std::unique_ptr<Symbiote::Core::EntityManager> {
+	auto manager = CreateEntityManager();
+	for (std::size_t i = 0; i < EntityCount; i++) {
+		auto entity = manager->CreateEntityWith<TransformComponent, PhysicsComponent>();
+		entity.GetComponent<TransformComponent>()->mData = {static_cast<float>(i), static_cast<float>(i) * 0.5f};
+	}
+	return manager;
+}
+
+BENCHMARK(Serialization, Serialize) {
+	auto manager = CreatePopulatedEntityManager();
+	std::stringstream stream;
+	context.Run(
+		EntityCount, [&]() { manager->Serialize(stream); }, [&]() { stream = std::stringstream(); });
+}
+
+BENCHMARK(Serialization, Deserialize) {
+	auto manager = CreatePopulatedEntityManager();
+	std::stringstream saved;
+	manager->Serialize(saved);
+	auto bytes = saved.str();
+	std::stringstream stream;
+	context.Run(
+		EntityCount, [&]() { manager->Deserialize(stream); }, [&]() { stream = std::stringstream(bytes); });
+}
+
+static auto CreatePodEntityManager() -> std::unique_ptr<Symbiote::Core::EntityManager> {
+	auto manager = CreateEntityManager();
+	for (std::size_t i = 0; i < EntityCount; i++) {
+		auto entity = manager->CreateEntity();
+		entity.AddComponent<PositionComponent>(static_cast<float>(i), static_cast<float>(i) * 0.5f);
+		entity.AddComponent<VelocityComponent>(1.0f, 0.0f, 0.0f);
+	}
+	return manager;
+}
+
+static auto SavePodEntityManager(const char *path) -> void {
+	auto manager = CreatePodEntityManager();
+	std::ofstream file(path, std::ios::binary);
+	manager->Serialize(file);
+}
+
+BENCHMARK(Serialization, DeserializePodStream) {
+	const char *path = "bench_pod_snapshot.bin";
+	SavePodEntityManager(path);
+	auto manager = CreateEntityManager();
+	std::ifstream file;
+	context.Run(
+		EntityCount, [&]() { manager->Deserialize(file); }, [&]() { file = std::ifstream(path, std::ios::binary); });
+	std::remove(path);
+}
+
+BENCHMARK(Serialization, DeserializePodMapped) {
+	const char *path = "bench_pod_snapshot.bin";
+	SavePodEntityManager(path);
+	auto manager = CreateEntityManager();
+	context.Run(EntityCount, [&]() { manager->DeserializeMapped(path); });
+	std::remove(path);
+}
+
+// one percent of the positions move between the baseline and the target
+static auto SaveBaselineAndTarget(std::string &baseline, std::string &target) -> void {
+	auto manager = CreatePodEntityManager();
+	std::ostringstream os;
+	manager->Serialize(os);
+	baseline = os.str();
+	auto i = 0;
+	manager->With<PositionComponent>([&i](auto, auto position) {
+		if (i++ % 100 == 0) {
+			position->x += 1.0f;
+		}
+	});
+	os.str({});
+	manager->Serialize(os);
+	target = os.str();
+}
+
+BENCHMARK(Serialization, DeltaEncode) {
+	std::string baseline, target;
+	SaveBaselineAndTarget(baseline, target);
+	context.Run(EntityCount, [&]() { DoNotOptimize(Symbiote::Core::EncodeSnapshotDelta(baseline, target)); });
+}
+
+BENCHMARK(Serialization, DeltaApply) {
+	std::string baseline, target;
+	SaveBaselineAndTarget(baseline, target);
+	auto delta = Symbiote::Core::EncodeSnapshotDelta(baseline, target);
+	context.Run(EntityCount, [&]() { DoNotOptimize(Symbiote::Core::ApplySnapshotDelta(baseline, delta)); });
+}
+
+// the first percent of the positions move, the other pages are still shared with the baseline capture
+static auto MoveFirstPositions(Symbiote::Core::EntityManager &manager) -> void {
+	auto entities = manager.With<PositionComponent>();
+	for (std::size_t i = 0; i < EntityCount / 100; i++) {
+		entities[i].GetComponent<PositionComponent>()->x += 1.0f;
+	}
+}
+
+BENCHMARK(Serialization, SerializeDelta) {
+	auto manager = CreatePodEntityManager();
+	std::ostringstream os;
+	manager->Serialize(os);
+	auto baseline = os.str();
+	MoveFirstPositions(*manager);
+	context.Run(
+		EntityCount, [&]() { manager->SerializeDelta(baseline, os); }, [&]() { os.str({}); });
+}
+
+BENCHMARK(Serialization, SerializeDeltaFromCapture) {
+	auto manager = CreatePodEntityManager();
+	auto baseline = manager->CaptureDeltaBaseline();
+	MoveFirstPositions(*manager);
+	std::ostringstream os;
+	context.Run(
+		EntityCount, [&]() { manager->SerializeDelta(baseline, os); }, [&]() { os.str({}); });
+}
+
+// the game thread stall of an asynchronous save
+BENCHMARK(Serialization, CaptureSnapshotPod) {
+	auto manager = CreatePodEntityManager();
+	context.Run(EntityCount, [&]() { DoNotOptimize(manager->CaptureSnapshot()); });
+}
+
+BENCHMARK(Serialization, CaptureSnapshot) {
+	auto manager = CreatePopulatedEntityManager();
+	context.Run(EntityCount, [&]() { DoNotOptimize(manager->CaptureSnapshot()); });
+}
+
+static auto SaveCompressionWorld() -> std::string {
+	auto manager = CreatePodEntityManager();
+	auto i = 0;
+	manager->With<PositionComponent>([&i](auto entity, auto) {
+		if (i++ % 2 == 0) {
+			entity.template AddComponent<TransformComponent>(static_cast<float>(i), 1.0f);
+		}
+	});
+	std::ostringstream os;
+	manager->Serialize(os);
+	return os.str();
+}
+
+BENCHMARK(Serialization, CompressSnapshot) {
+	auto snapshot = SaveCompressionWorld();
+	context.Run(EntityCount, [&]() { DoNotOptimize(Symbiote::Core::CompressSnapshot(snapshot)); });
+}
+
+BENCHMARK(Serialization, DecompressSnapshot) {
+	auto compressed = Symbiote::Core::CompressSnapshot(SaveCompressionWorld());
+	context.Run(EntityCount, [&]() { DoNotOptimize(Symbiote::Core::DecompressSnapshot(compressed)); });
+}
+
+BENCHMARK(Serialization, DeserializeCompressed) {
+	auto compressed = Symbiote::Core::CompressSnapshot(SaveCompressionWorld());
+	auto manager = CreateEntityManager();
+	std::stringstream stream;
+	context.Run(
+		EntityCount, [&]() { manager->Deserialize(stream); }, [&]() { stream = std::stringstream(compressed); });
+}
@@ -0,0 +1,57 @@
+#include "core/ecs/entitymanager.hpp"
+
+#include "game/systems/transform/transform.hpp"
+#include "game/components/transform/transform.hpp"
+
+#include "benchmark.hpp"
+
+static constexpr std::size_t RootCount = 10000;
+static constexpr std::size_t ChildrenPerRoot = 9;
+
+// each root has a chain of children, a tenth of the transforms are roots
+static auto CreateHierarchies(Symbiote::Core::EntityManager &manager, std::vector<Symbiote::Game::TransformComponent *> &children) -> std::vector<Symbiote::Core::Entity> {
+	std::vector<Symbiote::Core::Entity> roots;
+	for (std::size_t i = 0; i < RootCount; i++) {
+		Symbiote::Core::Entity parent = {};
+		for (std::size_t depth = 0; depth <= ChildrenPerRoot; depth++) {
+			auto entity = manager.CreateEntity();
+			auto transform = entity.AddComponent<Symbiote::Game::TransformComponent>(glm::vec2(1.0f, 1.0f), glm::vec2(1.0f, 0.0f), 0.1f, parent);
+			if (depth == 0) {
+				roots.push_back(entity);
+			} else if (depth == 1) {
+				children.push_back(transform);
+			}
+			parent = entity;
+		}
+	}
+	return roots;
+}
+
+BENCHMARK(Transform, Update) {
+	Symbiote::Core::EntityManager manager;
+	manager.RegisterComponent<Symbiote::Game::TransformComponent>();
+	auto transforms = manager.AddSystem<Symbiote::Game::TransformSystem>();
+	std::vector<Symbiote::Game::TransformComponent *> children;
+	auto roots = CreateHierarchies(manager, children);
+	transforms->Update();
+
+	auto frame = 0.0f;
+	auto move = [&](std::size_t stride) {
+		frame += 1.0f;
+		for (std::size_t i = 0; i < roots.size(); i += stride) {
+			roots[i].GetComponent<Symbiote::Game::TransformComponent>()->SetPosition({frame, 0.0f});
+		}
+	};
+	// the first child of 1% of the roots moves to the next root, the order is rebuilt once for all of them
+	auto reparent = [&]() {
+		for (std::size_t i = 0; i < roots.size(); i += 100) {
+			children[i]->SetParent(roots[(i + static_cast<std::size_t>(frame) + 1) % roots.size()]);
+		}
+		frame += 1.0f;
+	};
+	auto count = RootCount * (ChildrenPerRoot + 1);
+	context.Run("all dirty", count, [&]() { transforms->Update(); }, [&]() { move(1); });
+	context.Run("1% dirty", count, [&]() { transforms->Update(); }, [&]() { move(100); });
+	context.Run("1% reparented", count, [&]() { transforms->Update(); }, reparent);
+	context.Run("clean", count, [&]() { transforms->Update(); });
+}
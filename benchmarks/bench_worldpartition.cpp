@@ -0,0 +1,53 @@
+#include "core/ecs/entitymanager.hpp"
+#include "core/ecs/worldpartition.hpp"
+#include "core/jobs/jobsystem.hpp"
+
+#include "benchmark.hpp"
+#include "test_components/components.hpp"
+
+static constexpr std::size_t EntityCount = 100000;
+static constexpr float CellSize = 16.0f;
+static constexpr std::size_t GridSize = 32;
+static constexpr std::size_t EntitiesPerRow = 316;
+
+static auto Locate(const Symbiote::Core::Entity &entity, float &x, float &y) -> bool {
+	auto transform = entity.GetComponent<TransformComponent>();
+	if (transform == nullptr) {
+		return false;
+	}
+	x = transform->GetX();
+	y = transform->GetY();
+	return true;
+}
+
+// the focus moves one cell back and forth, a row of cells is streamed out and another one in
+BENCHMARK(WorldPartition, CrossCell) {
+	Symbiote::Core::JobSystem jobs;
+	auto manager = CreateEntityManager();
+	for (std::size_t i = 0; i < EntityCount; i++) {
+		auto entity = manager->CreateEntity();
+		// entities are spread evenly over the grid
+		auto x = static_cast<float>(i % EntitiesPerRow) * CellSize * GridSize / EntitiesPerRow;
+		auto y = static_cast<float>(i / EntitiesPerRow) * CellSize * GridSize / EntitiesPerRow;
+		entity.AddComponent<TransformComponent>(x, y);
+		entity.AddComponent<PositionComponent>(x, y);
+		entity.AddComponent<VelocityComponent>(1.0f, 0.0f, 0.0f);
+	}
+	Symbiote::Core::WorldPartition::Settings settings;
+	settings.cellSize = CellSize;
+	settings.loadRadius = 4;
+	Symbiote::Core::WorldPartition partition(*manager, jobs, &Locate, settings);
+	auto center = CellSize * GridSize / 2.0f;
+	partition.Update(center, center);
+	partition.Flush();
+
+	auto step = 0;
+	auto cross = [&]() { partition.Update(center + CellSize * (step++ % 2), center); };
+	// the main thread stall: entities leaving the loaded area are moved out, the cells are saved on the job system
+	context.Run("stall", EntityCount, cross, [&]() { partition.Flush(); });
+	// the whole round trip, saving, loading and merging back the cells
+	context.Run("flush", EntityCount, [&]() {
+		cross();
+		partition.Flush();
+	});
+}
@@ -0,0 +1,146 @@
+#include <cmath>
+#include <chrono>
+#include <string>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <iostream>
+#include <algorithm>
+
+#include "benchmark.hpp"
+
+namespace {
+	struct RegisteredBenchmark {
+		const char *name;
+		BenchmarkFunction function;
+	};
+
+	auto GetRegisteredBenchmarks() -> std::vector<RegisteredBenchmark> & {
+		static std::vector<RegisteredBenchmark> benchmarks;
+		return benchmarks;
+	}
+
+	auto WriteJson(std::ostream &os, std::vector<BenchmarkResult> const &results) -> void {
+		os << std::fixed << std::setprecision(3);
+		os << "{\"benchmarks\":[";
+		for (std::size_t i = 0; i < results.size(); i++) {
+			const auto &result = results[i];
+			os << (i == 0 ? "" : ",") << "\n\t{\"name\":\"" << result.name << "\"";
+			os << ",\"samples\":" << result.samples;
+			os << ",\"operations\":" << result.operations;
+			os << ",\"median_ns\":" << result.medianNs;
+			os << ",\"mean_ns\":" << result.meanNs;
+			os << ",\"stddev_ns\":" << result.stddevNs;
+			os << ",\"min_ns\":" << result.minNs;
+			os << ",\"max_ns\":" << result.maxNs;
+			os << ",\"ops_per_second\":" << result.operationsPerSecond << "}";
+		}
+		os << "\n]}\n";
+	}
+
+	// variants have no slash: a filter without one may match any variant, a filter with one can only match across the slash before the variant
+	auto CanMatch(std::string const &name, std::string const &filter) -> bool {
+		if (filter.empty() || name.find(filter) != std::string::npos) {
+			return true;
+		}
+		auto slash = filter.rfind('/');
+		if (slash == std::string::npos) {
+			return true;
+		}
+		return slash <= name.size() && name.compare(name.size() - slash, slash, filter, 0, slash) == 0;
+	}
+} // namespace
+
+auto RegisterBenchmark(const char *name, BenchmarkFunction function) -> bool {
+	GetRegisteredBenchmarks().push_back({name, function});
+	return true;
+}
+
+BenchmarkContext::BenchmarkContext(std::string name, BenchmarkOptions const &options, std::vector<BenchmarkResult> &results) : mName(std::move(name)), mOptions(options), mResults(results) {
+}
+
+auto BenchmarkContext::Run(std::size_t operations, Body const &body, Body const &setup) -> void {
+	Run("", operations, body, setup);
+}
+
+auto BenchmarkContext::Run(std::string const &variant, std::size_t operations, Body const &body, Body const &setup) -> void {
+	BenchmarkResult result;
+	result.name = variant.empty() ? mName : mName + "/" + variant;
+	if (!mOptions.filter.empty() && result.name.find(mOptions.filter) == std::string::npos) {
+		return;
+	}
+
+	std::vector<double> samples;
+	for (std::size_t i = 0; i < mOptions.warmups + mOptions.samples; i++) {
+		if (setup) {
+			setup();
+		}
+		auto t0 = std::chrono::steady_clock::now();
+		body();
+		auto t1 = std::chrono::steady_clock::now();
+		if (i >= mOptions.warmups) {
+			samples.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count());
+		}
+	}
+
+	std::sort(samples.begin(), samples.end());
+	auto count = static_cast<double>(samples.size());
+	result.samples = samples.size();
+	result.operations = operations;
+	result.minNs = samples.front();
+	result.maxNs = samples.back();
+	result.medianNs = samples.size() % 2 == 1 ? samples[samples.size() / 2] : (samples[samples.size() / 2 - 1] + samples[samples.size() / 2]) / 2.0;
+	result.meanNs = std::accumulate(samples.begin(), samples.end(), 0.0) / count;
+	auto variance = std::accumulate(samples.begin(), samples.end(), 0.0, [&result](double sum, double sample) { return sum + (sample - result.meanNs) * (sample - result.meanNs); });
+	result.stddevNs = samples.size() > 1 ? std::sqrt(variance / (count - 1.0)) : 0.0;
+	result.operationsPerSecond = result.medianNs > 0.0 ? static_cast<double>(operations) * 1e9 / result.medianNs : 0.0;
+
+	std::cerr << std::left << std::setw(64) << result.name << std::right << std::fixed << std::setprecision(3);
+	std::cerr << " median " << std::setw(12) << result.medianNs / 1e6 << "ms";
+	std::cerr << " stddev " << std::setw(10) << result.stddevNs / 1e6 << "ms";
+	std::cerr << " " << std::setw(16) << std::setprecision(0) << result.operationsPerSecond << " ops/s" << std::endl;
+	mResults.emplace_back(std::move(result));
+}
+
+auto main(int argc, char **argv) -> int {
+	BenchmarkOptions options;
+	std::string output;
+	for (auto i = 1; i < argc; i++) {
+		std::string argument = argv[i];
+		if (argument == "--list") {
+			for (const auto &benchmark : GetRegisteredBenchmarks()) {
+				std::cout << benchmark.name << std::endl;
+			}
+			return 0;
+		} else if (argument == "--filter" && i + 1 < argc) {
+			options.filter = argv[++i];
+		} else if (argument == "--samples" && i + 1 < argc) {
+			options.samples = std::max(1, std::stoi(argv[++i]));
+		} else if (argument == "--warmups" && i + 1 < argc) {
+			options.warmups = std::max(0, std::stoi(argv[++i]));
+		} else if (argument == "--output" && i + 1 < argc) {
+			output = argv[++i];
+		} else {
+			std::cerr << "usage: " << argv[0] << " [--list] [--filter substring of group/name/variant] [--samples count] [--warmups count] [--output file.json]" << std::endl;
+			return 1;
+		}
+	}
+
+	std::vector<BenchmarkResult> results;
+	for (const auto &benchmark : GetRegisteredBenchmarks()) {
+		// skip the setup of benchmarks which can neither match the filter by name nor by variant
+		if (!CanMatch(benchmark.name, options.filter)) {
+			continue;
+		}
+		BenchmarkContext context(benchmark.name, options, results);
+		benchmark.function(context);
+	}
+
+	if (output.empty()) {
+		WriteJson(std::cout, results);
+	} else {
+		std::ofstream file(output);
+		WriteJson(file, results);
+	}
+	return 0;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <functional>
+
+// clang-format off
+#define BENCHMARK(GROUP, NAME) \
+	static auto GROUP##_##NAME##_Benchmark(BenchmarkContext &context) -> void; \
+	static const auto GROUP##_##NAME##_Registered = RegisterBenchmark(#GROUP "/" #NAME, &GROUP##_##NAME##_Benchmark); \
+	static auto GROUP##_##NAME##_Benchmark(BenchmarkContext &context) -> void
+// clang-format on
+
+struct BenchmarkOptions {
+	std::size_t samples = 15;
+	std::size_t warmups = 2;
+	std::string filter = {};
+};
+
+struct BenchmarkResult {
+	std::string name = {};
+	std::size_t samples = 0;
+	std::size_t operations = 0;
+	double medianNs = 0.0;
+	double meanNs = 0.0;
+	double stddevNs = 0.0;
+	double minNs = 0.0;
+	double maxNs = 0.0;
+	double operationsPerSecond = 0.0;
+};
+
+class BenchmarkContext final {
+public:
+	using Body = std::function<void()>;
+
+public:
+	BenchmarkContext(std::string name, BenchmarkOptions const &options, std::vector<BenchmarkResult> &results);
+	BenchmarkContext(BenchmarkContext &&) = delete;
+	BenchmarkContext(BenchmarkContext const &) = delete;
+	BenchmarkContext &operator=(BenchmarkContext const &) = delete;
+
+public:
+	auto Run(std::size_t operations, Body const &body, Body const &setup = {}) -> void;
+	// the variant is appended to the name after a slash, it has none itself
+	auto Run(std::string const &variant, std::size_t operations, Body const &body, Body const &setup = {}) -> void;
+
+private:
+	std::string mName;
+	BenchmarkOptions const &mOptions;
+	std::vector<BenchmarkResult> &mResults;
+};
+
+using BenchmarkFunction = void (*)(BenchmarkContext &context);
+
+auto RegisterBenchmark(const char *name, BenchmarkFunction function) -> bool;
+
+template<typename T>
+inline auto DoNotOptimize(T const &value) -> void {
+#if defined(__GNUC__)
+	__asm__ __volatile__("" : : "r,m"(value) : "memory");
+#else
+	static volatile const void *sink;
+	sink = &value;
+#endif
+}
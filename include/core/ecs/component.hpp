@@ -3,6 +3,7 @@
 #include <memory>
 #include <string>
 #include <iosfwd>
+#include <type_traits>
 
 #include "entity.hpp"
 
@@ -12,6 +13,8 @@
 
 #define DECLARE_ROOT_COMPONENT(NAME) static constexpr const char* ComponentName{#NAME}; virtual std::string GetComponentName() const
 #define DEFINE_ROOT_COMPONENT(NAME) std::string NAME::GetComponentName() const { return NAME::ComponentName; } constexpr const char* NAME::ComponentName
+
+#define DECLARE_POD_COMPONENT(NAME) static constexpr const char* ComponentName{#NAME}
 // clang-format on
 
 namespace Symbiote {
@@ -42,6 +45,10 @@ namespace Symbiote {
 			Entity mEntity = {};
 		};
 
+		// components which do not derive from Component are plain data, stored in columns and saved as raw pages
+		template<typename C>
+		constexpr bool IsPodComponent = !std::is_base_of<Component, C>::value;
+
 	} // namespace Core
 } // namespace Symbiote
 
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "entity.hpp"
+
+namespace Symbiote {
+	namespace Core {
+
+		// Paged storage for the trivially copyable (POD) components of one type.
+		// Components are packed densely, pages never move, so pointers stay valid until a component of the same type is removed or the page is shared.
+		// Pages are shared copy-on-write with captures: a shared page is copied before it is written to through a non-const accessor,
+		// a pointer taken before the capture still points into the shared page and must be fetched again to be written through.
+		class ComponentColumn final {
+		public:
+			static constexpr std::size_t PageSize = 16384;
+			static constexpr std::uint32_t InvalidSlot = std::numeric_limits<std::uint32_t>::max();
+
+		public:
+			struct Page {
+				char *data = nullptr;
+				std::shared_ptr<void> owner = {};
+			};
+
+		public:
+			ComponentColumn(std::string name, std::size_t elementSize, std::size_t elementAlignment);
+			ComponentColumn(ComponentColumn &&) = delete;
+			ComponentColumn(ComponentColumn const &) = delete;
+			ComponentColumn &operator=(ComponentColumn const &) = delete;
+
+		public:
+			auto Contains(Entity::PointerSize index) const -> bool;
+			auto Get(Entity::PointerSize index) -> void *;
+			auto Get(Entity::PointerSize index) const -> const void *;
+			auto Insert(Entity::PointerSize index) -> void *;
+			auto Erase(Entity::PointerSize index) -> void;
+			auto Clear() -> void;
+
+		public:
+			auto At(std::size_t slot) -> void *;
+			auto At(std::size_t slot) const -> const void *;
+
+		public:
+			auto Size() const -> std::size_t;
+			auto GetName() const -> const std::string &;
+			auto GetElementSize() const -> std::size_t;
+			auto GetElementAlignment() const -> std::size_t;
+			auto GetElementsPerPage() const -> std::size_t;
+			auto GetEntities() const -> const std::vector<Entity::PointerSize> &;
+
+		public:
+			auto GetPageCount() const -> std::size_t;
+			auto GetPage(std::size_t page) -> char *;
+			auto GetPage(std::size_t page) const -> const char *;
+			auto AllocatePages(std::vector<Entity::PointerSize> entities) -> void;
+			auto AdoptPages(std::vector<Entity::PointerSize> entities, char *pages, std::shared_ptr<void> owner) -> void;
+			auto SharePages() const -> std::vector<std::shared_ptr<const Page>>;
+			auto SharePages(std::vector<Entity::PointerSize> entities, std::vector<std::shared_ptr<const Page>> const &pages) -> void;
+
+		public:
+			auto Hash() const -> std::uint64_t;
+
+		public:
+			static auto PagePadding(std::uint64_t offset) -> std::uint32_t;
+
+		private:
+			auto AllocatePage() -> std::shared_ptr<Page>;
+			auto WritablePage(std::size_t page) -> char *;
+			auto RebuildSlots() -> void;
+
+		private:
+			std::string mName;
+			std::size_t mElementSize;
+			std::size_t mElementAlignment;
+			std::size_t mElementsPerPage;
+
+		private:
+			std::vector<std::shared_ptr<Page>> mPages = {};
+			std::vector<Entity::PointerSize> mEntities = {};
+			std::vector<std::uint32_t> mSlots = {};
+
+		private:
+			// hashes are kept until the page is written to or the entities change
+			mutable std::vector<std::uint64_t> mPageHashes = {};
+			mutable std::vector<bool> mPageHashed = {};
+			mutable std::uint64_t mEntitiesHash = 0;
+			mutable bool mEntitiesHashed = false;
+		};
+
+		auto NextPodComponentTypeIndex() -> std::size_t;
+
+		template<typename C>
+		auto PodComponentTypeIndex() -> std::size_t {
+			static const auto typeIndex = NextPodComponentTypeIndex();
+			return typeIndex;
+		}
+
+	} // namespace Core
+} // namespace Symbiote
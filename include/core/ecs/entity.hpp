@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <vector>
+#include <cstdint>
 #include <functional>
 #include <type_traits>
 
@@ -15,7 +16,7 @@ namespace Symbiote {
 			friend EntityManager;
 
 		public:
-			using PointerSize = std::uint16_t;
+			using PointerSize = std::uint32_t;
 
 		public:
 			Entity() = default;
@@ -61,6 +62,7 @@ namespace Symbiote {
 
 		public:
 			auto GetManager() -> EntityManager *;
+			auto GetManager() const -> const EntityManager *;
 
 		public:
 			friend auto operator==(const Entity &a, const Entity &b) -> bool;
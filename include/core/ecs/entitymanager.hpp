@@ -1,5 +1,7 @@
 #pragma once
 
+#include <map>
+#include <new>
 #include <memory>
 #include <vector>
 #include <string>
@@ -14,13 +16,34 @@
 #include "system.hpp"
 #include "entity.hpp"
 #include "component.hpp"
+#include "reflection.hpp"
+#include "componentcolumn.hpp"
+#include "snapshotcapture.hpp"
+#include "core/serialization/delta.hpp"
+#include "core/serialization/snapshotsaver.hpp"
+#include "core/profiler/profiler.hpp"
 
 namespace Symbiote {
 	namespace Core {
 
+		class JobSystem;
+		class WorldPartition;
+		class MemoryStreamBuffer;
+
 		class EntityManager final {
 		public:
 			friend Entity;
+			friend System;
+			friend WorldPartition;
+
+		public:
+			static constexpr std::uint32_t SnapshotMagic = 0x574D5953;
+			static constexpr std::uint32_t SnapshotVersion = 3;
+			static constexpr std::size_t DefaultRollbackFrameCount = 16;
+
+		public:
+			using BudgetWarningHandler = std::function<void(const System &system, SystemStatistics::Duration elapsed, SystemStatistics::Duration budget)>;
+			using ComponentCreator = std::function<std::unique_ptr<Component>()>;
 
 		public:
 			auto CreateEntity() -> Entity;
@@ -42,14 +65,44 @@ namespace Symbiote {
 			template<typename S>
 			auto HasSystem() -> bool;
 
+		public:
+			template<typename S>
+			auto GetSystemStatistics() const -> SystemStatistics::Summary;
+			auto GetSystemsStatistics() const -> std::vector<std::pair<std::string, SystemStatistics::Summary>>;
+			template<typename S>
+			auto SetSystemBudget(SystemStatistics::Duration budget) -> void;
+			auto SetBudgetWarningHandler(BudgetWarningHandler handler) -> void;
+
+		private:
+			auto WarnSystemBudgetOverrun(const System &system, SystemStatistics::Duration elapsed) const -> void;
+
 		public:
 			template<typename C>
 			auto RegisterComponent() -> void;
+			auto RegisterComponents(const EntityManager &other) -> void;
 #if defined(_DEBUG)
 			auto IsComponentRegistered(const std::string &componentName) const -> bool;
 			auto AssertComponentRegistered(const std::string &componentName) const -> void;
 #endif
 
+		public:
+			// read-only views convert from any callable without inspecting it, a non-const manager keeps picking the writable overloads
+			template<typename... C>
+			class ConstView final {
+			public:
+				template<typename F>
+				ConstView(F view) : mView(std::move(view)) {
+				}
+
+			public:
+				auto operator()(Entity entity, const C *...components) const -> void {
+					mView(entity, components...);
+				}
+
+			private:
+				std::function<void(Entity, const C *...)> mView;
+			};
+
 		public:
 			template<typename... C>
 			auto Any(typename std::common_type<std::function<void(Entity, C *...)>>::type view) -> void;
@@ -59,10 +112,63 @@ namespace Symbiote {
 			auto With(typename std::common_type<std::function<void(Entity, C *...)>>::type view) -> void;
 			template<typename... C>
 			auto With() -> std::vector<Entity>;
+			// components are read through const pages, pages shared with forks or rollback frames are not copied
+			template<typename... C>
+			auto Any(typename std::common_type<ConstView<C...>>::type view) const -> void;
+			template<typename... C>
+			auto Any() const -> std::vector<Entity>;
+			template<typename... C>
+			auto With(typename std::common_type<ConstView<C...>>::type view) const -> void;
+			template<typename... C>
+			auto With() const -> std::vector<Entity>;
 
 		public:
 			auto Serialize(std::ostream &os) const -> void;
-			auto Deserialize(std::istream &is) -> void;
+			auto SerializeCompressed(std::ostream &os, JobSystem *jobs = nullptr) const -> void;
+			// a capture shares the pages of POD components, pointers to them taken before are fetched again to write
+			auto CaptureSnapshot() const -> std::shared_ptr<const SnapshotCapture>;
+			auto SaveAsync(std::string path, SnapshotSaver::Callback callback = {}, bool compress = false) const -> std::future<SnapshotSaver::Result>;
+			auto Deserialize(std::istream &is, JobSystem *jobs = nullptr) -> void;
+			auto DeserializeMapped(const std::string &path) -> void;
+			auto SerializeDelta(const std::string &baseline, std::ostream &os, bool runLengthEncode = true) const -> void;
+			auto SerializeDelta(const SnapshotDeltaBaseline &baseline, std::ostream &os, bool runLengthEncode = true) const -> void;
+			auto CaptureDeltaBaseline() const -> SnapshotDeltaBaseline;
+			auto DeserializeDelta(const std::string &baseline, std::istream &is) -> void;
+
+		public:
+			// forks and rollback frames are captures too, see CaptureSnapshot
+			auto Fork() const -> std::unique_ptr<EntityManager>;
+			auto MoveEntities(EntityManager &source, const std::vector<Entity> &entities) -> std::vector<Entity>;
+
+		public:
+			auto Hash(JobSystem *jobs = nullptr) const -> std::uint64_t;
+
+		public:
+			auto SaveFrame(std::uint64_t tick) -> void;
+			auto RestoreFrame(std::uint64_t tick) -> void;
+			auto HasFrame(std::uint64_t tick) const -> bool;
+			auto SetRollbackFrameCount(std::size_t frameCount) -> void;
+			auto GetRollbackFrameCount() const -> std::size_t;
+
+		private:
+			struct ComponentGroup {
+				const ComponentColumn *pod = nullptr;
+				std::vector<Entity::PointerSize> entities = {};
+				std::vector<const Component *> components = {};
+			};
+
+		private:
+			auto GroupComponents() const -> std::map<std::string, ComponentGroup>;
+			auto DeserializeSnapshot(std::istream &is, MemoryStreamBuffer *mapped, std::shared_ptr<void> mapping, JobSystem *jobs) -> void;
+			auto RestoreCapture(const SnapshotCapture &capture) -> void;
+			auto LoadComponents(const ComponentCreator &creator, const ReflectedComponent *reflected, std::uint32_t layout, const std::vector<Entity::PointerSize> &entities, const std::uint32_t *offsets, const char *payload, std::size_t payloadSize) -> void;
+			auto ResolveComponentsDependencies() -> void;
+
+		private:
+			template<typename C>
+			auto GetColumn() const -> ComponentColumn *;
+			auto FindColumn(const std::string &componentName) const -> ComponentColumn *;
+			auto FindReflectedComponent(const std::string &componentName) const -> const ReflectedComponent *;
 
 		private:
 			auto IsEntityPointerValid(const Entity &entityPointer) const -> bool;
@@ -159,10 +265,27 @@ namespace Symbiote {
 			std::vector<Entity::PointerSize> mVersions = {};
 			std::vector<Entity::PointerSize> mFreeIndexes = {};
 			std::vector<std::vector<std::unique_ptr<Component>>> mEntityComponents = {};
+			std::vector<std::unique_ptr<ComponentColumn>> mColumns = {};
 
 		private:
 			std::vector<std::unique_ptr<System>> mSystems = {};
-			std::unordered_map<std::string, std::function<std::unique_ptr<Component>()>> mRegisteredComponents = {};
+			BudgetWarningHandler mBudgetWarningHandler = {};
+			std::unordered_map<std::string, ComponentCreator> mRegisteredComponents = {};
+			std::unordered_map<std::string, const ReflectedComponent *> mReflectedComponents = {};
+
+		private:
+			mutable std::unique_ptr<SnapshotSaver> mSnapshotSaver = {};
+
+		private:
+			// frames are stored at tick % frame count, pages they share with the world are copied on write
+			struct RollbackFrame {
+				std::uint64_t tick = 0;
+				std::shared_ptr<const SnapshotCapture> capture = {};
+			};
+
+		private:
+			std::size_t mRollbackFrameCount = DefaultRollbackFrameCount;
+			std::vector<RollbackFrame> mRollbackFrames = {};
 		};
 
 		template<typename C>
@@ -172,7 +295,8 @@ namespace Symbiote {
 
 		template<typename C>
 		auto Entity::GetComponent() const -> const C * {
-			return mManager->EntityGetComponent<C>(*this);
+			// const access never copies a page shared with a snapshot or a fork
+			return static_cast<const EntityManager *>(mManager)->EntityGetComponent<C>(*this);
 		}
 
 		template<typename C, typename... Args>
@@ -207,6 +331,7 @@ namespace Symbiote {
 
 		template<typename... C>
 		auto EntityManager::CreateEntityWith() -> Entity {
+			SYMBIOTE_PROFILE_SCOPE("EntityManager::CreateEntityWith");
 			auto entityPointer = CreateEntity();
 			(entityPointer.AddComponent<C>(), ...);
 			EntityResolveComponentDependencies(entityPointer);
@@ -255,26 +380,75 @@ namespace Symbiote {
 			return GetSystem<S>() != nullptr;
 		}
 
+		template<typename S>
+		auto EntityManager::GetSystemStatistics() const -> SystemStatistics::Summary {
+			auto system = GetSystem<S>();
+			if (system == nullptr) {
+				throw std::logic_error(std::string{"EntityManager::GetSystemStatistics: System "} + S::SystemName + std::string{" not found"});
+			}
+			return system->mStatistics.GetSummary();
+		}
+
+		template<typename S>
+		auto EntityManager::SetSystemBudget(SystemStatistics::Duration budget) -> void {
+			auto system = GetSystem<S>();
+			if (system == nullptr) {
+				throw std::logic_error(std::string{"EntityManager::SetSystemBudget: System "} + S::SystemName + std::string{" not found"});
+			}
+			system->mStatistics.SetBudget(budget);
+		}
+
 		template<typename C>
 		auto EntityManager::RegisterComponent() -> void {
-			mRegisteredComponents[C::ComponentName] = []() { return std::make_unique<C>(); };
+			if constexpr (IsPodComponent<C>) {
+				static_assert(std::is_trivially_copyable<C>::value, "EntityManager::RegisterComponent: POD components must be trivially copyable");
+				auto typeIndex = PodComponentTypeIndex<C>();
+				if (typeIndex >= mColumns.size()) {
+					mColumns.resize(typeIndex + 1);
+				}
+				if (mColumns[typeIndex] == nullptr) {
+					mColumns[typeIndex] = std::make_unique<ComponentColumn>(C::ComponentName, sizeof(C), alignof(C));
+				}
+			} else {
+				mRegisteredComponents[C::ComponentName] = []() { return std::make_unique<C>(); };
+				if constexpr (IsReflectedComponent<C>) {
+					mReflectedComponents[C::ComponentName] = &GetReflectedComponent<C>();
+				}
+			}
+		}
+
+		template<typename C>
+		auto EntityManager::GetColumn() const -> ComponentColumn * {
+			auto typeIndex = PodComponentTypeIndex<C>();
+			return typeIndex < mColumns.size() ? mColumns[typeIndex].get() : nullptr;
 		}
 
 		template<typename C>
 		auto EntityManager::EntityGetComponent(const Entity &entityPointer) -> C * {
 			AssertEntityPointerValid(entityPointer);
-			return const_cast<C *>(static_cast<const EntityManager *>(this)->EntityGetComponent<C>(entityPointer));
+			if constexpr (IsPodComponent<C>) {
+				// non-const access copies the page if it is shared with a snapshot
+				auto column = GetColumn<C>();
+				return column != nullptr ? static_cast<C *>(column->Get(entityPointer.mIndex)) : nullptr;
+			} else {
+				return const_cast<C *>(static_cast<const EntityManager *>(this)->EntityGetComponent<C>(entityPointer));
+			}
 		}
 
 		template<typename C>
 		auto EntityManager::EntityGetComponent(const Entity &entityPointer) const -> const C * {
 			AssertEntityPointerValid(entityPointer);
-			auto &components = mEntityComponents[entityPointer.mIndex];
-			auto found = std::find_if(components.begin(), components.end(), [](const auto &c) { return c->GetComponentName() == C::ComponentName; });
-			if (found != components.end()) {
-				return static_cast<C *>(found->get());
+			if constexpr (IsPodComponent<C>) {
+				const ComponentColumn *column = GetColumn<C>();
+				return column != nullptr ? static_cast<const C *>(column->Get(entityPointer.mIndex)) : nullptr;
+			} else {
+				auto &components = mEntityComponents[entityPointer.mIndex];
+				auto found = std::find_if(components.begin(), components.end(), [](const auto &c) { return c->GetComponentName() == C::ComponentName; });
+				if (found != components.end()) {
+					return static_cast<C *>(found->get());
+				}
+				return nullptr;
 			}
-			return nullptr;
 		}
 
 		template<typename C, typename... Args>
@@ -286,11 +460,19 @@ namespace Symbiote {
 			if (EntityHasComponent<C>(entityPointer)) {
 				throw std::logic_error(std::string{"Entity::AddComponent: Component "} + C::ComponentName + std::string{" already exists"});
 			}
-			auto component = std::make_unique<C>(std::forward<Args>(args)...);
-			auto componentPtr = component.get();
-			mEntityComponents[entityPointer.mIndex].emplace_back(std::move(component));
-			EntityConstructComponent(componentPtr, entityPointer);
-			return componentPtr;
+			if constexpr (IsPodComponent<C>) {
+				auto column = GetColumn<C>();
+				if (column == nullptr) {
+					throw std::logic_error(std::string{"Entity::AddComponent: Component "} + C::ComponentName + std::string{" not registered"});
+				}
+				return new (column->Insert(entityPointer.mIndex)) C{std::forward<Args>(args)...};
+			} else {
+				auto component = std::make_unique<C>(std::forward<Args>(args)...);
+				auto componentPtr = component.get();
+				mEntityComponents[entityPointer.mIndex].emplace_back(std::move(component));
+				EntityConstructComponent(componentPtr, entityPointer);
+				return componentPtr;
+			}
 		}
 
 		template<typename C>
@@ -299,13 +481,17 @@ namespace Symbiote {
 #if defined(_DEBUG)
 			AssertComponentRegistered(C::ComponentName);
 #endif
-			auto &components = mEntityComponents[entityPointer.mIndex];
 			if (!EntityHasComponent<C>(entityPointer)) {
 				throw std::logic_error(std::string{"Entity::RemoveComponent: Component "} + C::ComponentName + std::string{" not found"});
 			}
-			auto found = std::find_if(components.begin(), components.end(), [](const auto &c) { return C::ComponentName == c->GetComponentName(); });
-			if (found != components.end()) {
-				components.erase(found);
+			if constexpr (IsPodComponent<C>) {
+				GetColumn<C>()->Erase(entityPointer.mIndex);
+			} else {
+				auto &components = mEntityComponents[entityPointer.mIndex];
+				auto found = std::find_if(components.begin(), components.end(), [](const auto &c) { return C::ComponentName == c->GetComponentName(); });
+				if (found != components.end()) {
+					components.erase(found);
+				}
 			}
 		}
 
@@ -343,6 +529,7 @@ namespace Symbiote {
 
 		template<typename... C>
 		auto EntityManager::Any(typename std::common_type<std::function<void(Entity, C *...)>>::type view) -> void {
+			SYMBIOTE_PROFILE_SCOPE("EntityManager::Any");
 			for (auto entityPointer : *this) {
 				if (entityPointer.HasAnyComponent<C...>()) {
 					view(entityPointer, entityPointer.GetComponent<C>()...);
@@ -352,6 +539,7 @@ namespace Symbiote {
 
 		template<typename... C>
 		auto EntityManager::Any() -> std::vector<Entity> {
+			SYMBIOTE_PROFILE_SCOPE("EntityManager::Any");
 			std::vector<Entity> entityPointers;
 			for (auto entityPointer : *this) {
 				if (entityPointer.HasAnyComponent<C...>()) {
@@ -363,6 +551,7 @@ namespace Symbiote {
 
 		template<typename... C>
 		auto EntityManager::With(typename std::common_type<std::function<void(Entity, C *...)>>::type view) -> void {
+			SYMBIOTE_PROFILE_SCOPE("EntityManager::With");
 			for (auto entityPointer : *this) {
 				if (entityPointer.HasComponent<C...>()) {
 					view(entityPointer, entityPointer.GetComponent<C>()...);
@@ -372,6 +561,7 @@ namespace Symbiote {
 
 		template<typename... C>
 		auto EntityManager::With() -> std::vector<Entity> {
+			SYMBIOTE_PROFILE_SCOPE("EntityManager::With");
 			std::vector<Entity> entityPointers;
 			for (auto entityPointer : *this) {
 				if (entityPointer.HasComponent<C...>()) {
@@ -381,5 +571,49 @@ namespace Symbiote {
 			return entityPointers;
 		}
 
+		template<typename... C>
+		auto EntityManager::Any(typename std::common_type<ConstView<C...>>::type view) const -> void {
+			SYMBIOTE_PROFILE_SCOPE("EntityManager::Any");
+			for (const auto entityPointer : *this) {
+				if (entityPointer.HasAnyComponent<C...>()) {
+					view(entityPointer, entityPointer.GetComponent<C>()...);
+				}
+			}
+		}
+
+		template<typename... C>
+		auto EntityManager::Any() const -> std::vector<Entity> {
+			SYMBIOTE_PROFILE_SCOPE("EntityManager::Any");
+			std::vector<Entity> entityPointers;
+			for (const auto entityPointer : *this) {
+				if (entityPointer.HasAnyComponent<C...>()) {
+					entityPointers.emplace_back(entityPointer);
+				}
+			}
+			return entityPointers;
+		}
+
+		template<typename... C>
+		auto EntityManager::With(typename std::common_type<ConstView<C...>>::type view) const -> void {
+			SYMBIOTE_PROFILE_SCOPE("EntityManager::With");
+			for (const auto entityPointer : *this) {
+				if (entityPointer.HasComponent<C...>()) {
+					view(entityPointer, entityPointer.GetComponent<C>()...);
+				}
+			}
+		}
+
+		template<typename... C>
+		auto EntityManager::With() const -> std::vector<Entity> {
+			SYMBIOTE_PROFILE_SCOPE("EntityManager::With");
+			std::vector<Entity> entityPointers;
+			for (const auto entityPointer : *this) {
+				if (entityPointer.HasComponent<C...>()) {
+					entityPointers.emplace_back(entityPointer);
+				}
+			}
+			return entityPointers;
+		}
+
 	} // namespace Core
 } // namespace Symbiote
\ No newline at end of file
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <tuple>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+
+#include "component.hpp"
+#include "core/serialization/hash.hpp"
+
+// clang-format off
+#define SYMBIOTE_FIELD(NAME, MEMBER) Symbiote::Core::Field<NAME, &NAME::MEMBER>{#MEMBER}
+#define SYMBIOTE_FIELDS_1(N, a) SYMBIOTE_FIELD(N, a)
+#define SYMBIOTE_FIELDS_2(N, a, ...) SYMBIOTE_FIELD(N, a), SYMBIOTE_FIELDS_1(N, __VA_ARGS__)
+#define SYMBIOTE_FIELDS_3(N, a, ...) SYMBIOTE_FIELD(N, a), SYMBIOTE_FIELDS_2(N, __VA_ARGS__)
+#define SYMBIOTE_FIELDS_4(N, a, ...) SYMBIOTE_FIELD(N, a), SYMBIOTE_FIELDS_3(N, __VA_ARGS__)
+#define SYMBIOTE_FIELDS_5(N, a, ...) SYMBIOTE_FIELD(N, a), SYMBIOTE_FIELDS_4(N, __VA_ARGS__)
+#define SYMBIOTE_FIELDS_6(N, a, ...) SYMBIOTE_FIELD(N, a), SYMBIOTE_FIELDS_5(N, __VA_ARGS__)
+#define SYMBIOTE_FIELDS_7(N, a, ...) SYMBIOTE_FIELD(N, a), SYMBIOTE_FIELDS_6(N, __VA_ARGS__)
+#define SYMBIOTE_FIELDS_8(N, a, ...) SYMBIOTE_FIELD(N, a), SYMBIOTE_FIELDS_7(N, __VA_ARGS__)
+#define SYMBIOTE_FIELDS_9(N, a, ...) SYMBIOTE_FIELD(N, a), SYMBIOTE_FIELDS_8(N, __VA_ARGS__)
+#define SYMBIOTE_FIELDS_10(N, a, ...) SYMBIOTE_FIELD(N, a), SYMBIOTE_FIELDS_9(N, __VA_ARGS__)
+#define SYMBIOTE_FIELDS_11(N, a, ...) SYMBIOTE_FIELD(N, a), SYMBIOTE_FIELDS_10(N, __VA_ARGS__)
+#define SYMBIOTE_FIELDS_12(N, a, ...) SYMBIOTE_FIELD(N, a), SYMBIOTE_FIELDS_11(N, __VA_ARGS__)
+#define SYMBIOTE_FIELDS_COUNT(...) SYMBIOTE_FIELDS_COUNT_(__VA_ARGS__, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1)
+#define SYMBIOTE_FIELDS_COUNT_(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, N, ...) N
+#define SYMBIOTE_FIELDS_CONCAT(A, B) SYMBIOTE_FIELDS_CONCAT_(A, B)
+#define SYMBIOTE_FIELDS_CONCAT_(A, B) A##B
+
+#define DECLARE_FIELDS(NAME, ...) static constexpr auto ReflectedFields() { return std::make_tuple(SYMBIOTE_FIELDS_CONCAT(SYMBIOTE_FIELDS_, SYMBIOTE_FIELDS_COUNT(__VA_ARGS__))(NAME, __VA_ARGS__)); }
+// clang-format on
+
+namespace Symbiote {
+	namespace Core {
+
+		template<typename C, auto Member>
+		struct Field {
+			using Type = std::remove_cv_t<std::remove_reference_t<decltype(std::declval<C &>().*Member)>>;
+
+			const char *name;
+		};
+
+		// How a field is written, read, hashed and compared, specialize it for types which are not trivially copyable.
+		template<typename T, typename Enable = void>
+		struct FieldCodec {
+			static_assert(std::is_trivially_copyable<T>::value, "FieldCodec: specialize FieldCodec<T> for fields which are not trivially copyable");
+
+			static auto Write(std::string &out, T const &value) -> void {
+				out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+			}
+			static auto Read(const char *&data, const char *end, T &value) -> void {
+				if (static_cast<std::size_t>(end - data) < sizeof(T)) {
+					throw std::runtime_error("FieldCodec::Read: unexpected end of fields");
+				}
+				std::memcpy(&value, data, sizeof(T));
+				data += sizeof(T);
+			}
+			static auto Hash(T const &value, std::uint64_t hash) -> std::uint64_t {
+				return HashBytes(&value, sizeof(T), hash);
+			}
+			static auto Equal(T const &a, T const &b) -> bool {
+				return std::memcmp(&a, &b, sizeof(T)) == 0;
+			}
+		};
+
+		template<>
+		struct FieldCodec<std::string> {
+			static auto Write(std::string &out, std::string const &value) -> void {
+				FieldCodec<std::uint32_t>::Write(out, static_cast<std::uint32_t>(value.size()));
+				out.append(value);
+			}
+			static auto Read(const char *&data, const char *end, std::string &value) -> void {
+				std::uint32_t size;
+				FieldCodec<std::uint32_t>::Read(data, end, size);
+				if (static_cast<std::size_t>(end - data) < size) {
+					throw std::runtime_error("FieldCodec::Read: unexpected end of fields");
+				}
+				value.assign(data, size);
+				data += size;
+			}
+			static auto Hash(std::string const &value, std::uint64_t hash) -> std::uint64_t {
+				return HashBytes(value.data(), value.size(), FieldCodec<std::uint64_t>::Hash(value.size(), hash));
+			}
+			static auto Equal(std::string const &a, std::string const &b) -> bool {
+				return a == b;
+			}
+		};
+
+		template<typename T>
+		struct FieldCodec<std::vector<T>, std::enable_if_t<std::is_trivially_copyable<T>::value>> {
+			static auto Write(std::string &out, std::vector<T> const &value) -> void {
+				FieldCodec<std::uint32_t>::Write(out, static_cast<std::uint32_t>(value.size()));
+				out.append(reinterpret_cast<const char *>(value.data()), value.size() * sizeof(T));
+			}
+			static auto Read(const char *&data, const char *end, std::vector<T> &value) -> void {
+				std::uint32_t size;
+				FieldCodec<std::uint32_t>::Read(data, end, size);
+				if (static_cast<std::size_t>(end - data) / sizeof(T) < size) {
+					throw std::runtime_error("FieldCodec::Read: unexpected end of fields");
+				}
+				value.resize(size);
+				if (size != 0) {
+					std::memcpy(value.data(), data, size * sizeof(T));
+				}
+				data += size * sizeof(T);
+			}
+			static auto Hash(std::vector<T> const &value, std::uint64_t hash) -> std::uint64_t {
+				return HashBytes(value.data(), value.size() * sizeof(T), FieldCodec<std::uint64_t>::Hash(value.size(), hash));
+			}
+			static auto Equal(std::vector<T> const &a, std::vector<T> const &b) -> bool {
+				return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+			}
+		};
+
+		template<typename C, typename = void>
+		constexpr bool IsReflectedComponent = false;
+
+		template<typename C>
+		constexpr bool IsReflectedComponent<C, std::void_t<decltype(C::ReflectedFields())>> = true;
+
+		// Type-erased batch operations of a reflected component type, no virtual call per component.
+		struct ReflectedComponent {
+			std::uint32_t signature;
+			auto (*serialize)(const Component *const *components, std::size_t count, std::string &out) -> void;
+			auto (*deserialize)(Component *const *components, std::size_t count, const char *data, std::size_t size) -> void;
+			auto (*hash)(const Component *component, std::uint64_t hash) -> std::uint64_t;
+			auto (*equal)(const Component *a, const Component *b) -> bool;
+		};
+
+		// fields are written field-major: each field of the whole pool, then the next field
+		template<typename C, auto Member>
+		auto SerializeField(Field<C, Member> const &, const Component *const *components, std::size_t count, std::string &out) -> void {
+			using T = typename Field<C, Member>::Type;
+			if constexpr (std::is_trivially_copyable<T>::value) {
+				auto offset = out.size();
+				out.resize(offset + count * sizeof(T));
+				auto destination = &out[offset];
+				for (std::size_t i = 0; i < count; i++) {
+					std::memcpy(destination + i * sizeof(T), &(static_cast<const C *>(components[i])->*Member), sizeof(T));
+				}
+			} else {
+				for (std::size_t i = 0; i < count; i++) {
+					FieldCodec<T>::Write(out, static_cast<const C *>(components[i])->*Member);
+				}
+			}
+		}
+
+		template<typename C, auto Member>
+		auto DeserializeField(Field<C, Member> const &, Component *const *components, std::size_t count, const char *&data, const char *end) -> void {
+			using T = typename Field<C, Member>::Type;
+			if constexpr (std::is_trivially_copyable<T>::value) {
+				if (static_cast<std::size_t>(end - data) / sizeof(T) < count) {
+					throw std::runtime_error("DeserializeField: unexpected end of fields");
+				}
+				for (std::size_t i = 0; i < count; i++) {
+					std::memcpy(&(static_cast<C *>(components[i])->*Member), data + i * sizeof(T), sizeof(T));
+				}
+				data += count * sizeof(T);
+			} else {
+				for (std::size_t i = 0; i < count; i++) {
+					FieldCodec<T>::Read(data, end, static_cast<C *>(components[i])->*Member);
+				}
+			}
+		}
+
+		template<typename C>
+		auto SerializeFields(const Component *const *components, std::size_t count, std::string &out) -> void {
+			std::apply([&](auto const &... fields) { (SerializeField(fields, components, count, out), ...); }, C::ReflectedFields());
+		}
+
+		template<typename C>
+		auto DeserializeFields(Component *const *components, std::size_t count, const char *data, std::size_t size) -> void {
+			auto end = data + size;
+			std::apply([&](auto const &... fields) { (DeserializeField(fields, components, count, data, end), ...); }, C::ReflectedFields());
+			if (data != end) {
+				throw std::runtime_error(std::string{"DeserializeFields: fields of "} + C::ComponentName + std::string{" do not match the snapshot"});
+			}
+		}
+
+		template<typename C, auto Member>
+		constexpr auto FieldMember(Field<C, Member> const &) {
+			return Member;
+		}
+
+		template<typename C>
+		auto HashFields(C const &component, std::uint64_t hash = HashSeed) -> std::uint64_t {
+			std::apply([&](auto const &... fields) { ((hash = FieldCodec<typename std::decay_t<decltype(fields)>::Type>::Hash(component.*(FieldMember(fields)), hash)), ...); }, C::ReflectedFields());
+			return hash;
+		}
+
+		template<typename C>
+		auto FieldsEqual(C const &a, C const &b) -> bool {
+			return std::apply([&](auto const &... fields) { return (FieldCodec<typename std::decay_t<decltype(fields)>::Type>::Equal(a.*(FieldMember(fields)), b.*(FieldMember(fields))) && ...); }, C::ReflectedFields());
+		}
+
+		// field names and sizes, so that a snapshot of another version of the component is rejected
+		template<typename C, auto Member>
+		auto HashFieldSignature(Field<C, Member> const &field, std::uint64_t hash) -> std::uint64_t {
+			using T = typename Field<C, Member>::Type;
+			std::uint32_t size = std::is_trivially_copyable<T>::value ? sizeof(T) : 0;
+			hash = HashBytes(field.name, std::strlen(field.name), hash);
+			return HashBytes(&size, sizeof(size), hash);
+		}
+
+		template<typename C>
+		auto FieldsSignature() -> std::uint32_t {
+			auto hash = HashSeed;
+			std::apply([&](auto const &... fields) { ((hash = HashFieldSignature(fields, hash)), ...); }, C::ReflectedFields());
+			return static_cast<std::uint32_t>(hash ^ (hash >> 32));
+		}
+
+		template<typename C>
+		auto GetReflectedComponent() -> const ReflectedComponent & {
+			static const ReflectedComponent reflection = {
+				FieldsSignature<C>(),
+				&SerializeFields<C>,
+				&DeserializeFields<C>,
+				[](const Component *component, std::uint64_t hash) { return HashFields(*static_cast<const C *>(component), hash); },
+				[](const Component *a, const Component *b) { return FieldsEqual(*static_cast<const C *>(a), *static_cast<const C *>(b)); },
+			};
+			return reflection;
+		}
+
+	} // namespace Core
+} // namespace Symbiote
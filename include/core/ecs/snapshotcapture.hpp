@@ -0,0 +1,43 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <iosfwd>
+#include <cstdint>
+
+#include "entity.hpp"
+#include "componentcolumn.hpp"
+
+namespace Symbiote {
+	namespace Core {
+
+		// how the components of a type are laid out in their snapshot block
+		enum SnapshotLayout : std::uint32_t {
+			InstanceLayout = 0,
+			ColumnLayout = 1,
+			FieldLayout = 2,
+		};
+
+		// A consistent copy of a world, taken on the game thread and written from any thread.
+		// Instance and reflected components are serialized while capturing, column pages are shared copy-on-write.
+		struct SnapshotCapture {
+			struct Column {
+				std::string name = {};
+				std::uint32_t layout = InstanceLayout;
+				std::uint32_t elementSize = 0;
+				std::vector<Entity::PointerSize> entities = {};
+				std::vector<std::uint32_t> offsets = {};
+				std::string payload = {};
+				std::vector<std::shared_ptr<const ComponentColumn::Page>> pages = {};
+			};
+
+			std::vector<Entity::PointerSize> versions = {};
+			std::vector<Entity::PointerSize> freeIndexes = {};
+			std::vector<Column> columns = {};
+		};
+
+		auto WriteSnapshot(const SnapshotCapture &capture, std::ostream &os) -> void;
+
+	} // namespace Core
+} // namespace Symbiote
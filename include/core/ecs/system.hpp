@@ -2,6 +2,8 @@
 
 #include <string>
 
+#include "systemstatistics.hpp"
+
 // clang-format off
 #define DECLARE_SYSTEM(NAME) static constexpr const char* SystemName{#NAME}; virtual std::string GetSystemName() const override
 #define DEFINE_SYSTEM(NAME) std::string NAME::GetSystemName() const { return NAME::SystemName; } constexpr const char* NAME::SystemName
@@ -29,8 +31,30 @@ namespace Symbiote {
 			virtual auto OnLoad() -> void;
 			virtual auto OnResolveDependencies() -> void;
 
+		protected:
+			class UpdateTimer final {
+			public:
+				UpdateTimer(System &system);
+				UpdateTimer(UpdateTimer &&) = delete;
+				UpdateTimer(UpdateTimer const &) = delete;
+				UpdateTimer &operator=(UpdateTimer const &) = delete;
+
+			public:
+				~UpdateTimer();
+
+			private:
+				System &mSystem;
+				SystemStatistics::Clock::time_point mStart;
+			};
+
+		protected:
+			auto TimeUpdate() -> UpdateTimer;
+
 		protected:
 			EntityManager *mManager = nullptr;
+
+		private:
+			SystemStatistics mStatistics = {};
 		};
 
 	} // namespace Core
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+namespace Symbiote {
+	namespace Core {
+
+		class SystemStatistics final {
+		public:
+			using Clock = std::chrono::steady_clock;
+			using Duration = std::chrono::nanoseconds;
+
+		public:
+			static constexpr std::size_t WindowSize = 128;
+
+		public:
+			struct Summary {
+				Duration min = {};
+				Duration average = {};
+				Duration p95 = {};
+				Duration p99 = {};
+				Duration max = {};
+				Duration last = {};
+				Duration budget = {};
+				std::size_t samples = 0;
+				std::size_t overruns = 0;
+			};
+
+		public:
+			auto Record(Duration elapsed) -> bool;
+			auto Reset() -> void;
+
+		public:
+			auto GetSummary() const -> Summary;
+			auto GetBudget() const -> Duration;
+			auto SetBudget(Duration budget) -> void;
+
+		private:
+			std::array<Duration::rep, WindowSize> mSamples = {};
+			std::size_t mNextSample = 0;
+			std::size_t mSampleCount = 0;
+
+		private:
+			Duration mBudget = Duration::zero();
+			std::size_t mOverruns = 0;
+		};
+
+	} // namespace Core
+} // namespace Symbiote
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <exception>
+#include <functional>
+
+#include "entity.hpp"
+#include "core/jobs/jobsystem.hpp"
+
+namespace Symbiote {
+	namespace Core {
+
+		class EntityManager;
+
+		// Streams the entities of a world in and out by square cells around a focus point.
+		// Cells are saved and loaded on the job system, the main thread only moves entities between the world and a staging manager.
+		// Handles to entities of an unloaded cell are invalidated like destroyed entities, loading the cell gives out new handles in the order they were saved.
+		class WorldPartition final {
+		public:
+			using Cell = std::pair<std::int32_t, std::int32_t>;
+			// entities without a position are never streamed out
+			using Locator = std::function<bool(const Entity &entity, float &x, float &y)>;
+			using CellCallback = std::function<void(Cell cell, const std::vector<Entity> &entities)>;
+
+		public:
+			struct Settings {
+				float cellSize = 64.0f;
+				// cells within this distance of the focus cell are kept loaded
+				std::int32_t loadRadius = 1;
+				// cells are kept in memory when empty, written to directory/cell_x_y.bin otherwise
+				std::string directory = {};
+				bool compress = true;
+			};
+
+		public:
+			enum class CellState { Loaded, Saving, Saved, Loading };
+
+		public:
+			WorldPartition(EntityManager &manager, JobSystem &jobs, Locator locator, Settings settings);
+			WorldPartition(WorldPartition &&) = delete;
+			WorldPartition(WorldPartition const &) = delete;
+			WorldPartition &operator=(WorldPartition const &) = delete;
+
+		public:
+			~WorldPartition();
+
+		public:
+			auto Update(float x, float y) -> void;
+			auto Flush() -> void;
+
+		public:
+			auto GetCell(float x, float y) const -> Cell;
+			auto IsCellLoaded(Cell cell) const -> bool;
+			auto GetCellState(Cell cell) const -> CellState;
+			auto GetSavedCellCount() const -> std::size_t;
+
+		public:
+			// called with the handles about to be invalidated, before the entities leave the world
+			auto SetCellUnloadCallback(CellCallback callback) -> void;
+			// called with the new handles, once the entities joined the world
+			auto SetCellLoadCallback(CellCallback callback) -> void;
+
+		private:
+			struct Stream {
+				std::unique_ptr<EntityManager> staging = {};
+				std::shared_ptr<const std::string> blob = {};
+				std::exception_ptr error = {};
+				JobSystem::Counter counter;
+			};
+
+			struct CellRecord {
+				CellState state = CellState::Loaded;
+				std::shared_ptr<const std::string> blob = {};
+				std::shared_ptr<Stream> stream = {};
+			};
+
+		private:
+			auto IsCellWanted(Cell cell) const -> bool;
+			auto GetCellPath(Cell cell) const -> std::string;
+			auto CreateStaging() const -> std::unique_ptr<EntityManager>;
+			auto CompleteStreams(bool wait) -> void;
+			auto UnloadCells() -> void;
+			auto LoadCells() -> void;
+			auto SaveCell(Cell cell, CellRecord &record, const std::vector<Entity> &entities) -> void;
+			auto LoadCell(Cell cell, CellRecord &record) -> void;
+
+		private:
+			EntityManager &mManager;
+			JobSystem &mJobs;
+			Locator mLocator;
+			Settings mSettings;
+
+		private:
+			bool mFocused = false;
+			Cell mFocus = {};
+			std::map<Cell, CellRecord> mCells = {};
+
+		private:
+			CellCallback mUnloadCallback = {};
+			CellCallback mLoadCallback = {};
+		};
+
+	} // namespace Core
+} // namespace Symbiote
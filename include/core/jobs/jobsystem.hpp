@@ -0,0 +1,103 @@
+#pragma once
+
+#include <mutex>
+#include <deque>
+#include <exception>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <functional>
+#include <condition_variable>
+
+namespace Symbiote {
+	namespace Core {
+
+		class JobSystem final {
+		public:
+			using Job = std::function<void()>;
+			using RangeJob = std::function<void(std::size_t begin, std::size_t end)>;
+
+		public:
+			class Counter;
+
+		private:
+			struct Task {
+				Job job;
+				Counter *counter = nullptr;
+			};
+
+		public:
+			class Counter final {
+			public:
+				friend JobSystem;
+
+			public:
+				Counter() = default;
+				Counter(Counter &&) = delete;
+				Counter(Counter const &) = delete;
+				Counter &operator=(Counter const &) = delete;
+
+			public:
+				auto IsDone() const -> bool;
+				auto GetPending() const -> std::size_t;
+
+			private:
+				std::mutex mMutex;
+				std::vector<Task> mContinuations = {};
+				std::atomic<std::size_t> mPending = {0};
+				std::exception_ptr mException = {};
+			};
+
+		public:
+			explicit JobSystem(std::size_t threadCount = DefaultThreadCount());
+			JobSystem(JobSystem &&) = delete;
+			JobSystem(JobSystem const &) = delete;
+			JobSystem &operator=(JobSystem const &) = delete;
+
+		public:
+			~JobSystem();
+
+		public:
+			auto Schedule(Job job, Counter *counter = nullptr) -> void;
+			auto Schedule(Job job, Counter &dependency, Counter *counter = nullptr) -> void;
+			// the first exception thrown by a job of the counter is rethrown by Wait, a job without a counter must not throw
+			auto Wait(Counter &counter) -> void;
+
+		public:
+			auto ParallelFor(std::size_t begin, std::size_t end, std::size_t grainSize, RangeJob const &job) -> void;
+
+		public:
+			auto GetThreadCount() const -> std::size_t;
+			auto GetWorkerIndex() const -> std::size_t;
+
+		public:
+			static auto DefaultThreadCount() -> std::size_t;
+
+		private:
+			auto Push(Task task) -> void;
+			auto Pop(std::size_t workerIndex, Task &task) -> bool;
+			auto Execute(Task &task) -> void;
+			auto WorkerLoop(std::size_t workerIndex) -> void;
+
+		private:
+			struct WorkerQueue {
+				std::mutex mutex;
+				std::deque<Task> tasks;
+			};
+
+		private:
+			std::vector<std::thread> mThreads = {};
+			std::vector<std::unique_ptr<WorkerQueue>> mQueues = {};
+
+		private:
+			std::atomic<bool> mRunning = {true};
+			std::atomic<std::size_t> mQueued = {0};
+			std::atomic<std::size_t> mSleeping = {0};
+			std::mutex mSleepMutex;
+			std::condition_variable mSleepCondition;
+		};
+
+	} // namespace Core
+} // namespace Symbiote
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+
+namespace Symbiote {
+	namespace Core {
+
+		class FixedTimestep final {
+		public:
+			using Clock = std::chrono::steady_clock;
+
+		public:
+			using PollCallback = std::function<bool()>;
+			using RenderCallback = std::function<void(float alpha)>;
+			using SimulateCallback = std::function<void(float step)>;
+
+		public:
+			explicit FixedTimestep(float step = 1.0f / 60.0f, std::size_t maxSubsteps = 8, float maxFrameTime = 0.25f);
+			FixedTimestep(FixedTimestep &&) = delete;
+			FixedTimestep(FixedTimestep const &) = delete;
+			FixedTimestep &operator=(FixedTimestep const &) = delete;
+
+		public:
+			auto Run(PollCallback const &poll, SimulateCallback const &simulate, RenderCallback const &render) -> void;
+			auto Advance(float frameTime, SimulateCallback const &simulate) -> float;
+
+		public:
+			auto GetStep() const -> float;
+			auto GetAlpha() const -> float;
+			auto GetMaxSubsteps() const -> std::size_t;
+			auto GetMaxFrameTime() const -> float;
+
+		public:
+			auto GetFrameTime() const -> float;
+			auto GetSimulationTime() const -> float;
+			auto GetSimulatedTime() const -> double;
+			auto GetDroppedTime() const -> double;
+			auto GetSubsteps() const -> std::size_t;
+			auto GetFrameCount() const -> std::size_t;
+			auto GetStepCount() const -> std::size_t;
+
+		private:
+			float mStep;
+			float mMaxFrameTime;
+			std::size_t mMaxSubsteps;
+
+		private:
+			float mAlpha = 0.0f;
+			double mAccumulator = 0.0;
+
+		private:
+			float mFrameTime = 0.0f;
+			float mSimulationTime = 0.0f;
+			double mSimulatedTime = 0.0;
+			double mDroppedTime = 0.0;
+			std::size_t mSubsteps = 0;
+			std::size_t mFrameCount = 0;
+			std::size_t mStepCount = 0;
+		};
+
+	} // namespace Core
+} // namespace Symbiote
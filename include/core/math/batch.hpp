@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+
+#include "glm/mat3x3.hpp"
+
+#include "core/math/fixed.hpp"
+
+namespace Symbiote {
+	namespace Core {
+
+		// Instruction sets of the batch kernels, the best one supported by the processor is picked on startup.
+		enum class SimdLevel { Scalar, SSE2, AVX2 };
+
+		// Transforms stored as a structure of arrays, every array holds the same number of elements.
+		struct TransformArrays {
+			float *x = nullptr;
+			float *y = nullptr;
+			float *rotation = nullptr;
+			float *scaleX = nullptr;
+			float *scaleY = nullptr;
+		};
+
+		auto GetSimdLevel() -> SimdLevel;
+		auto GetSupportedSimdLevel() -> SimdLevel;
+		// meant for tests and benchmarks, not thread safe
+		auto SetSimdLevel(SimdLevel level) -> void;
+
+		// worlds[i] = parents[i] * locals[i], exact when the parent scale is uniform, worlds may alias locals
+		auto ComposeTransforms(const TransformArrays &parents, const TransformArrays &locals, const TransformArrays &worlds, std::size_t count) -> void;
+		// (outX[i], outY[i]) = matrix * (x[i], y[i], 1), the output may alias the input
+		auto TransformPoints(const glm::mat3 &matrix, const float *x, const float *y, float *outX, float *outY, std::size_t count) -> void;
+		// x[i] += velocityX[i] * deltaTime, same for y
+		auto IntegrateVelocities(float *x, float *y, const float *velocityX, const float *velocityY, float deltaTime, std::size_t count) -> void;
+		// the same in fixed point, every simd level gives the same bits, Q32.32 products need 128 bits and stay scalar
+		auto IntegrateVelocities(Q16 *x, Q16 *y, const Q16 *velocityX, const Q16 *velocityY, Q16 deltaTime, std::size_t count) -> void;
+		auto IntegrateVelocities(Q32 *x, Q32 *y, const Q32 *velocityX, const Q32 *velocityY, Q32 deltaTime, std::size_t count) -> void;
+
+	} // namespace Core
+} // namespace Symbiote
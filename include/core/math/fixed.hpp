@@ -0,0 +1,152 @@
+#pragma once
+
+#include <limits>
+#include <cstdint>
+#include <type_traits>
+
+namespace Symbiote {
+	namespace Core {
+
+		// products of Q32.32 numbers, 128 bits integers are an extension of gcc and clang
+		__extension__ typedef __int128 Int128;
+		__extension__ typedef unsigned __int128 UInt128;
+
+		// Signed fixed point number with FractionBits bits after the point, stored in Storage and multiplied or divided in Wide.
+		// Every operation is integer arithmetic so that results are the same whatever the compiler, its flags or the processor.
+		// Sums wrap on overflow, products round to the nearest, floats are rounded to the nearest and saturated, a division by zero saturates.
+		template <typename Storage, typename Wide, int FractionBits>
+		class Fixed final {
+		public:
+			using Raw = Storage;
+			using WideRaw = Wide;
+			static constexpr int Fraction = FractionBits;
+			static constexpr Storage One = static_cast<Storage>(1) << FractionBits;
+
+		public:
+			constexpr Fixed() = default;
+			constexpr Fixed(int value) : mRaw(static_cast<Storage>(static_cast<Storage>(value) * One)) {}
+			constexpr Fixed(float value) : mRaw(Round(static_cast<double>(value))) {}
+			constexpr Fixed(double value) : mRaw(Round(value)) {}
+
+		public:
+			static constexpr auto FromRaw(Storage raw) -> Fixed {
+				Fixed fixed;
+				fixed.mRaw = raw;
+				return fixed;
+			}
+
+			constexpr auto GetRaw() const -> Storage {
+				return mRaw;
+			}
+
+			// floats are exact to their precision, integers are truncated toward zero
+			template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+			explicit constexpr operator T() const {
+				if constexpr (std::is_floating_point_v<T>) {
+					return static_cast<T>(mRaw) * (static_cast<T>(1) / static_cast<T>(One));
+				} else {
+					return static_cast<T>(mRaw / One);
+				}
+			}
+
+		public:
+			friend constexpr auto operator+(Fixed a, Fixed b) -> Fixed {
+				return FromRaw(static_cast<Storage>(static_cast<Unsigned>(a.mRaw) + static_cast<Unsigned>(b.mRaw)));
+			}
+
+			friend constexpr auto operator-(Fixed a, Fixed b) -> Fixed {
+				return FromRaw(static_cast<Storage>(static_cast<Unsigned>(a.mRaw) - static_cast<Unsigned>(b.mRaw)));
+			}
+
+			friend constexpr auto operator-(Fixed a) -> Fixed {
+				return FromRaw(static_cast<Storage>(Unsigned(0) - static_cast<Unsigned>(a.mRaw)));
+			}
+
+			friend constexpr auto operator*(Fixed a, Fixed b) -> Fixed {
+				return FromRaw(static_cast<Storage>((static_cast<Wide>(a.mRaw) * b.mRaw + Half) >> FractionBits));
+			}
+
+			friend constexpr auto operator/(Fixed a, Fixed b) -> Fixed {
+				if (b.mRaw == 0) {
+					return FromRaw(a.mRaw < 0 ? std::numeric_limits<Storage>::min() : std::numeric_limits<Storage>::max());
+				}
+				return FromRaw(static_cast<Storage>(static_cast<Wide>(a.mRaw) * One / b.mRaw));
+			}
+
+			friend constexpr auto operator==(Fixed a, Fixed b) -> bool { return a.mRaw == b.mRaw; }
+			friend constexpr auto operator!=(Fixed a, Fixed b) -> bool { return a.mRaw != b.mRaw; }
+			friend constexpr auto operator<(Fixed a, Fixed b) -> bool { return a.mRaw < b.mRaw; }
+			friend constexpr auto operator<=(Fixed a, Fixed b) -> bool { return a.mRaw <= b.mRaw; }
+			friend constexpr auto operator>(Fixed a, Fixed b) -> bool { return a.mRaw > b.mRaw; }
+			friend constexpr auto operator>=(Fixed a, Fixed b) -> bool { return a.mRaw >= b.mRaw; }
+
+			constexpr auto operator+=(Fixed other) -> Fixed & { return *this = *this + other; }
+			constexpr auto operator-=(Fixed other) -> Fixed & { return *this = *this - other; }
+			constexpr auto operator*=(Fixed other) -> Fixed & { return *this = *this * other; }
+			constexpr auto operator/=(Fixed other) -> Fixed & { return *this = *this / other; }
+
+		private:
+			using Unsigned = std::make_unsigned_t<Storage>;
+			static constexpr Wide Half = static_cast<Wide>(1) << (FractionBits - 1);
+
+			static constexpr auto Round(double value) -> Storage {
+				// 2^(bits - 1) is exact as a double, the scaled float too
+				constexpr auto limit = static_cast<double>(static_cast<Storage>(1) << (sizeof(Storage) * 8 - 2)) * 2.0;
+				auto scaled = value * static_cast<double>(One);
+				if (!(scaled < limit)) {
+					return scaled < 0.0 ? std::numeric_limits<Storage>::min() : std::numeric_limits<Storage>::max();
+				}
+				if (scaled <= -limit) {
+					return std::numeric_limits<Storage>::min();
+				}
+				auto truncated = static_cast<Storage>(scaled);
+				auto rest = scaled - static_cast<double>(truncated);
+				return truncated + (rest >= 0.5 ? 1 : (rest <= -0.5 ? -1 : 0));
+			}
+
+		private:
+			Storage mRaw = 0;
+		};
+
+		using Q16 = Fixed<std::int32_t, std::int64_t, 16>;
+		using Q32 = Fixed<std::int64_t, Int128, 32>;
+
+		template <typename Storage, typename Wide, int FractionBits>
+		constexpr auto Abs(Fixed<Storage, Wide, FractionBits> value) -> Fixed<Storage, Wide, FractionBits> {
+			return value < 0 ? -value : value;
+		}
+
+		// rounded to the nearest, zero for negative numbers
+		auto Sqrt(Q16 value) -> Q16;
+		auto Sqrt(Q32 value) -> Q32;
+		// interpolated in a table of a quarter of sine computed with integers, within 5e-8 or half a step of the exact values
+		auto Sin(Q16 angle) -> Q16;
+		auto Sin(Q32 angle) -> Q32;
+		auto Cos(Q16 angle) -> Q16;
+		auto Cos(Q32 angle) -> Q32;
+
+	} // namespace Core
+} // namespace Symbiote
+
+namespace std {
+	template <typename Storage, typename Wide, int FractionBits>
+	class numeric_limits<Symbiote::Core::Fixed<Storage, Wide, FractionBits>> {
+		using Fixed = Symbiote::Core::Fixed<Storage, Wide, FractionBits>;
+
+	public:
+		static constexpr bool is_specialized = true;
+		static constexpr bool is_signed = true;
+		static constexpr bool is_integer = false;
+		static constexpr bool is_exact = true;
+		static constexpr bool has_infinity = false;
+		static constexpr bool has_quiet_NaN = false;
+		static constexpr bool is_iec559 = false;
+		static constexpr int digits = numeric_limits<Storage>::digits;
+
+		// the smallest step, as for floats where it is the step after one
+		static constexpr auto epsilon() -> Fixed { return Fixed::FromRaw(1); }
+		static constexpr auto min() -> Fixed { return Fixed::FromRaw(1); }
+		static constexpr auto max() -> Fixed { return Fixed::FromRaw(numeric_limits<Storage>::max()); }
+		static constexpr auto lowest() -> Fixed { return Fixed::FromRaw(numeric_limits<Storage>::min()); }
+	};
+} // namespace std
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cmath>
+
+#include "glm/vec2.hpp"
+
+#include "core/math/fixed.hpp"
+
+namespace Symbiote {
+	namespace Core {
+
+		// The numbers of the simulation, chosen when building.
+		// Floats give different results across compilers and flags, defining SYMBIOTE_FIXED_POINT as 16 or 32 simulates in Q16.16 or Q32.32 for lockstep.
+#if SYMBIOTE_FIXED_POINT == 16
+		using Real = Q16;
+#elif SYMBIOTE_FIXED_POINT == 32
+		using Real = Q32;
+#else
+		using Real = float;
+#endif
+
+		using RealVec2 = glm::vec<2, Real>;
+
+		// the float versions of the fixed point functions, so that the simulation is written once
+		inline auto Abs(float value) -> float {
+			return std::abs(value);
+		}
+
+		inline auto Sqrt(float value) -> float {
+			return std::sqrt(value);
+		}
+
+		inline auto Sin(float angle) -> float {
+			return std::sin(angle);
+		}
+
+		inline auto Cos(float angle) -> float {
+			return std::cos(angle);
+		}
+
+	} // namespace Core
+} // namespace Symbiote
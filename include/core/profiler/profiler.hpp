@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <iosfwd>
+
+// clang-format off
+#if defined(SYMBIOTE_PROFILER)
+#	define SYMBIOTE_PROFILE_CONCAT_IMPL(A, B) A##B
+#	define SYMBIOTE_PROFILE_CONCAT(A, B) SYMBIOTE_PROFILE_CONCAT_IMPL(A, B)
+#	define SYMBIOTE_PROFILE_SCOPE(NAME) const ::Symbiote::Core::ProfileScope SYMBIOTE_PROFILE_CONCAT(symbioteProfileScope, __LINE__){NAME}
+#else
+#	define SYMBIOTE_PROFILE_SCOPE(NAME) static_cast<void>(0)
+#endif
+// clang-format on
+
+namespace Symbiote {
+	namespace Core {
+
+		class Profiler final {
+		public:
+			static constexpr std::size_t BufferSize = 1 << 15;
+
+		public:
+			struct Event {
+				const char *name = nullptr;
+				std::uint64_t begin = 0;
+				std::uint64_t end = 0;
+				std::uint32_t threadId = 0;
+			};
+
+		public:
+			Profiler();
+			Profiler(Profiler &&) = delete;
+			Profiler(Profiler const &) = delete;
+			Profiler &operator=(Profiler const &) = delete;
+
+		public:
+			static auto Get() -> Profiler &;
+			static auto Now() -> std::uint64_t;
+
+		public:
+			auto Record(const char *name, std::uint64_t begin, std::uint64_t end) -> void;
+			auto Collect() const -> std::vector<Event>;
+			auto Clear() -> void;
+
+		public:
+			auto WriteChromeTrace(std::ostream &os) const -> void;
+
+		private:
+			struct ThreadBuffer {
+				std::thread::id owner = {};
+				std::uint32_t threadId = 0;
+				std::array<Event, BufferSize> events = {};
+				std::atomic<std::uint64_t> written = {0};
+				std::atomic<std::uint64_t> cleared = {0};
+			};
+
+		private:
+			auto GetThreadBuffer() -> ThreadBuffer &;
+
+		private:
+			std::uint64_t mId;
+			mutable std::mutex mMutex;
+			std::vector<std::unique_ptr<ThreadBuffer>> mBuffers = {};
+		};
+
+		class ProfileScope final {
+		public:
+			explicit ProfileScope(const char *name);
+			ProfileScope(ProfileScope &&) = delete;
+			ProfileScope(ProfileScope const &) = delete;
+			ProfileScope &operator=(ProfileScope const &) = delete;
+
+		public:
+			~ProfileScope();
+
+		private:
+			const char *mName;
+			std::uint64_t mBegin;
+		};
+
+	} // namespace Core
+} // namespace Symbiote
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <algorithm>
+#include <stdexcept>
+#include <streambuf>
+#include <type_traits>
+
+namespace Symbiote {
+	namespace Core {
+
+		// snapshots are written in native byte order, readers reject a byte-swapped magic
+		template<typename T>
+		auto WriteBinary(std::ostream &os, T const &value) -> void {
+			static_assert(std::is_trivially_copyable<T>::value, "WriteBinary: T is not trivially copyable");
+			os.write(reinterpret_cast<const char *>(&value), sizeof(T));
+		}
+
+		template<typename T>
+		auto WriteBinary(std::ostream &os, std::vector<T> const &values) -> void {
+			static_assert(std::is_trivially_copyable<T>::value, "WriteBinary: T is not trivially copyable");
+			os.write(reinterpret_cast<const char *>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+		}
+
+		template<typename T>
+		auto ReadBinary(std::istream &is, T &value) -> void {
+			static_assert(std::is_trivially_copyable<T>::value, "ReadBinary: T is not trivially copyable");
+			if (!is.read(reinterpret_cast<char *>(&value), sizeof(T))) {
+				throw std::runtime_error("ReadBinary: unexpected end of stream");
+			}
+		}
+
+		// counts come from the stream, the values are read in pieces so that a corrupt count fails before it allocates more than the stream holds
+		template<typename T>
+		auto ReadBinary(std::istream &is, std::vector<T> &values, std::size_t count) -> void {
+			static_assert(std::is_trivially_copyable<T>::value, "ReadBinary: T is not trivially copyable");
+			constexpr std::size_t PieceSize = (std::size_t{1} << 20) / sizeof(T) + 1;
+			values.clear();
+			for (std::size_t first = 0; first < count; first += PieceSize) {
+				auto size = std::min(PieceSize, count - first);
+				values.resize(first + size);
+				if (!is.read(reinterpret_cast<char *>(values.data() + first), static_cast<std::streamsize>(size * sizeof(T)))) {
+					throw std::runtime_error("ReadBinary: unexpected end of stream");
+				}
+			}
+		}
+
+		// counts the bytes written so that blocks can be aligned relative to the start of a snapshot
+		class BinaryWriter final {
+		public:
+			explicit BinaryWriter(std::ostream &os) : mStream(os) {}
+			BinaryWriter(BinaryWriter &&) = delete;
+			BinaryWriter(BinaryWriter const &) = delete;
+			BinaryWriter &operator=(BinaryWriter const &) = delete;
+
+		public:
+			template<typename T>
+			auto Write(T const &value) -> void {
+				WriteBinary(mStream, value);
+				mOffset += sizeof(T);
+			}
+			template<typename T>
+			auto Write(std::vector<T> const &values) -> void {
+				WriteBinary(mStream, values);
+				mOffset += values.size() * sizeof(T);
+			}
+			auto WriteBytes(const char *data, std::size_t size) -> void {
+				mStream.write(data, static_cast<std::streamsize>(size));
+				mOffset += size;
+			}
+			auto WriteZeros(std::size_t size) -> void {
+				static const char zeros[256] = {};
+				for (; size > sizeof(zeros); size -= sizeof(zeros)) {
+					WriteBytes(zeros, sizeof(zeros));
+				}
+				WriteBytes(zeros, size);
+			}
+			auto GetOffset() const -> std::uint64_t {
+				return mOffset;
+			}
+
+		private:
+			std::ostream &mStream;
+			std::uint64_t mOffset = 0;
+		};
+
+		class MemoryStreamBuffer final : public std::streambuf {
+		public:
+			MemoryStreamBuffer(const char *data, std::size_t size) {
+				auto begin = const_cast<char *>(data);
+				setg(begin, begin, begin + size);
+			}
+			MemoryStreamBuffer(MemoryStreamBuffer &&) = delete;
+			MemoryStreamBuffer(MemoryStreamBuffer const &) = delete;
+			MemoryStreamBuffer &operator=(MemoryStreamBuffer const &) = delete;
+
+		public:
+			auto Assign(const char *data, std::size_t size) -> void {
+				auto begin = const_cast<char *>(data);
+				setg(begin, begin, begin + size);
+			}
+			auto Remaining() const -> std::size_t {
+				return static_cast<std::size_t>(egptr() - gptr());
+			}
+			auto Current() const -> char * {
+				return gptr();
+			}
+			auto Skip(std::size_t size) -> bool {
+				if (size > Remaining()) {
+					return false;
+				}
+				setg(eback(), gptr() + size, egptr());
+				return true;
+			}
+		};
+
+	} // namespace Core
+} // namespace Symbiote
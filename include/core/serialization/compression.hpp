@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace Symbiote {
+	namespace Core {
+
+		class JobSystem;
+
+		constexpr std::uint32_t CompressedSnapshotMagic = 0x5A4D5953;
+		constexpr std::uint32_t CompressedSnapshotVersion = 1;
+
+		// LZ77 block codec in the spirit of LZ4: literal runs and matches of at least 4 bytes within a 64KiB window.
+		auto LzCompress(const char *data, std::size_t size, std::string &out) -> void;
+		auto LzDecompress(const char *data, std::size_t size, char *out, std::size_t outSize) -> void;
+
+		// Snapshots written by EntityManager::Serialize are cut in chunks along their column blocks.
+		// Entity indices and offsets are delta-encoded, component bytes are shuffled by float lanes, then each chunk is compressed on its own.
+		// Chunks are compressed and decompressed in parallel when a job system is given.
+		auto CompressSnapshot(const std::string &snapshot, JobSystem *jobs = nullptr) -> std::string;
+		auto DecompressSnapshot(const std::string &compressed, JobSystem *jobs = nullptr) -> std::string;
+		auto IsCompressedSnapshot(const std::string &bytes) -> bool;
+
+	} // namespace Core
+} // namespace Symbiote
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <iosfwd>
+#include <cstddef>
+#include <cstdint>
+
+namespace Symbiote {
+	namespace Core {
+
+		constexpr std::uint32_t SnapshotDeltaMagic = 0x444D5953;
+		constexpr std::uint32_t SnapshotDeltaVersion = 1;
+		constexpr std::uint32_t SnapshotChainMagic = 0x434D5953;
+
+		struct SnapshotCapture;
+
+		// A baseline kept on the sending side: the snapshot the receiver holds and the capture it was written from.
+		// Column pages the world still shares with the capture were not written since, they are skipped instead of compared.
+		struct SnapshotDeltaBaseline {
+			std::shared_ptr<const SnapshotCapture> capture = {};
+			std::string snapshot = {};
+			std::uint64_t hash = 0;
+		};
+
+		// Deltas between two snapshots written by EntityManager::Serialize.
+		// Tables are XOR-ed against the baseline, components against the baseline component of the same entity,
+		// reflected pools against the baseline pool, so that everything which did not change becomes zeros which the optional run-length encoding removes.
+		auto EncodeSnapshotDelta(const std::string &baseline, const std::string &target, bool runLengthEncode = true) -> std::string;
+		auto EncodeSnapshotDelta(const std::string &baseline, const SnapshotCapture &target, bool runLengthEncode = true) -> std::string;
+		auto EncodeSnapshotDelta(const SnapshotDeltaBaseline &baseline, const SnapshotCapture &target, bool runLengthEncode = true) -> std::string;
+		auto MakeSnapshotDeltaBaseline(std::shared_ptr<const SnapshotCapture> capture) -> SnapshotDeltaBaseline;
+		auto ApplySnapshotDelta(const std::string &baseline, const std::string &delta) -> std::string;
+
+		// Keyframe+delta stream: a full snapshot every keyframeInterval frames, deltas against the previous frame in between.
+		class SnapshotChainWriter final {
+		public:
+			explicit SnapshotChainWriter(std::ostream &os, std::size_t keyframeInterval = 60, bool runLengthEncode = true);
+			SnapshotChainWriter(SnapshotChainWriter &&) = delete;
+			SnapshotChainWriter(SnapshotChainWriter const &) = delete;
+			SnapshotChainWriter &operator=(SnapshotChainWriter const &) = delete;
+
+		public:
+			auto Write(std::string snapshot) -> void;
+			auto GetFrameCount() const -> std::size_t;
+
+		private:
+			std::ostream &mStream;
+			std::size_t mKeyframeInterval;
+			bool mRunLengthEncode;
+			std::size_t mFrameCount = 0;
+			std::string mPrevious = {};
+		};
+
+		class SnapshotChainReader final {
+		public:
+			explicit SnapshotChainReader(std::istream &is);
+			SnapshotChainReader(SnapshotChainReader &&) = delete;
+			SnapshotChainReader(SnapshotChainReader const &) = delete;
+			SnapshotChainReader &operator=(SnapshotChainReader const &) = delete;
+
+		public:
+			auto Read(std::size_t frame) -> const std::string &;
+			auto GetFrameCount() const -> std::size_t;
+			auto IsKeyframe(std::size_t frame) const -> bool;
+
+		private:
+			struct Frame {
+				bool keyframe = false;
+				std::string bytes = {};
+			};
+
+		private:
+			std::vector<Frame> mFrames = {};
+			std::size_t mCurrentFrame = 0;
+			std::string mCurrent = {};
+		};
+
+	} // namespace Core
+} // namespace Symbiote
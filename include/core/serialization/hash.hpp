@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+
+namespace Symbiote {
+	namespace Core {
+
+		constexpr std::uint64_t HashSeed = 14695981039346656037ull;
+
+		// FNV-1a over 64-bit words, the tail byte per byte
+		inline auto HashBytes(const void *data, std::size_t size, std::uint64_t hash = HashSeed) -> std::uint64_t {
+			auto bytes = static_cast<const char *>(data);
+			std::size_t i = 0;
+			for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t)) {
+				std::uint64_t word;
+				std::memcpy(&word, bytes + i, sizeof(word));
+				hash = (hash ^ word) * 1099511628211ull;
+			}
+			for (; i < size; i++) {
+				hash = (hash ^ static_cast<std::uint8_t>(bytes[i])) * 1099511628211ull;
+			}
+			return hash;
+		}
+
+		namespace HashDetail {
+			constexpr std::uint64_t Prime1 = 11400714785074694791ull;
+			constexpr std::uint64_t Prime2 = 14029467366897019727ull;
+			constexpr std::uint64_t Prime3 = 1609587929392839161ull;
+			constexpr std::uint64_t Prime4 = 9650029242287828579ull;
+
+			inline auto Rotate(std::uint64_t value, int bits) -> std::uint64_t {
+				return (value << bits) | (value >> (64 - bits));
+			}
+
+			inline auto Round(std::uint64_t lane, std::uint64_t word) -> std::uint64_t {
+				return Rotate(lane + word * Prime2, 31) * Prime1;
+			}
+
+			inline auto Merge(std::uint64_t hash, std::uint64_t lane) -> std::uint64_t {
+				return (hash ^ Round(0, lane)) * Prime1 + Prime4;
+			}
+		} // namespace HashDetail
+
+		// Four independent lanes over 32-byte stripes in the spirit of xxHash64, so that the multiplications pipeline or vectorize.
+		// Much faster than HashBytes on large buffers such as column pages, but a different hash.
+		inline auto HashWide(const void *data, std::size_t size, std::uint64_t seed = HashSeed) -> std::uint64_t {
+			using namespace HashDetail;
+			auto bytes = static_cast<const char *>(data);
+			std::uint64_t hash;
+			std::size_t i = 0;
+			if (size >= 4 * sizeof(std::uint64_t)) {
+				std::uint64_t lanes[4] = {seed + Prime1 + Prime2, seed + Prime2, seed, seed - Prime1};
+				for (; i + 4 * sizeof(std::uint64_t) <= size; i += 4 * sizeof(std::uint64_t)) {
+					std::uint64_t words[4];
+					std::memcpy(words, bytes + i, sizeof(words));
+					for (auto lane = 0; lane < 4; lane++) {
+						lanes[lane] = Round(lanes[lane], words[lane]);
+					}
+				}
+				hash = Rotate(lanes[0], 1) + Rotate(lanes[1], 7) + Rotate(lanes[2], 12) + Rotate(lanes[3], 18);
+				for (auto lane : lanes) {
+					hash = Merge(hash, lane);
+				}
+			} else {
+				hash = seed + Prime3;
+			}
+			hash += size;
+			for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t)) {
+				std::uint64_t word;
+				std::memcpy(&word, bytes + i, sizeof(word));
+				hash = Rotate(hash ^ Round(0, word), 27) * Prime1 + Prime4;
+			}
+			for (; i < size; i++) {
+				hash = Rotate(hash ^ (static_cast<std::uint8_t>(bytes[i]) * Prime3), 11) * Prime1;
+			}
+			hash ^= hash >> 33;
+			hash *= Prime2;
+			hash ^= hash >> 29;
+			hash *= Prime3;
+			hash ^= hash >> 32;
+			return hash;
+		}
+
+	} // namespace Core
+} // namespace Symbiote
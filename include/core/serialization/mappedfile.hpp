@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+namespace Symbiote {
+	namespace Core {
+
+		// Read-only file mapped copy-on-write: pages are shared with the page cache until they are written to.
+		class MappedFile final {
+		public:
+			explicit MappedFile(const std::string &path);
+			MappedFile(MappedFile &&) = delete;
+			MappedFile(MappedFile const &) = delete;
+			MappedFile &operator=(MappedFile const &) = delete;
+
+		public:
+			~MappedFile();
+
+		public:
+			auto GetData() const -> char *;
+			auto GetSize() const -> std::size_t;
+
+		private:
+			char *mData = nullptr;
+			std::size_t mSize = 0;
+#if defined(_WIN32)
+			void *mFile = nullptr;
+			void *mMapping = nullptr;
+#endif
+		};
+
+	} // namespace Core
+} // namespace Symbiote
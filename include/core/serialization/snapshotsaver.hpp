@@ -0,0 +1,72 @@
+#pragma once
+
+#include <mutex>
+#include <deque>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <cstdint>
+#include <functional>
+#include <condition_variable>
+
+#include "core/ecs/snapshotcapture.hpp"
+
+namespace Symbiote {
+	namespace Core {
+
+		// Writes captured snapshots to disk on a background thread, in the order they were captured.
+		class SnapshotSaver final {
+		public:
+			// stall is the time the game thread spent capturing, error is empty when the save succeeded
+			struct Result {
+				std::string path = {};
+				std::uint64_t size = 0;
+				std::chrono::nanoseconds stall = {};
+				std::chrono::nanoseconds writeTime = {};
+				std::string error = {};
+			};
+
+		public:
+			// called on the saver thread once the file is written or failed to be
+			using Callback = std::function<void(const Result &result)>;
+
+		public:
+			SnapshotSaver();
+			SnapshotSaver(SnapshotSaver &&) = delete;
+			SnapshotSaver(SnapshotSaver const &) = delete;
+			SnapshotSaver &operator=(SnapshotSaver const &) = delete;
+
+		public:
+			~SnapshotSaver();
+
+		public:
+			auto Save(std::shared_ptr<const SnapshotCapture> capture, std::string path, std::chrono::nanoseconds stall, Callback callback = {}, bool compress = false) -> std::future<Result>;
+			auto Wait() -> void;
+
+		private:
+			struct Request {
+				std::shared_ptr<const SnapshotCapture> capture;
+				Result result;
+				Callback callback;
+				bool compress = false;
+				std::promise<Result> promise;
+			};
+
+		private:
+			auto WorkerLoop() -> void;
+			auto Write(Request &request) -> void;
+
+		private:
+			std::mutex mMutex;
+			std::condition_variable mCondition;
+			std::condition_variable mIdleCondition;
+			std::deque<Request> mRequests = {};
+			bool mBusy = false;
+			bool mRunning = true;
+			std::thread mThread;
+		};
+
+	} // namespace Core
+} // namespace Symbiote
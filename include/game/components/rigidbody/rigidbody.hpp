@@ -1,14 +1,46 @@
 #pragma once
 
+#include <iosfwd>
+#include <cstdint>
+#include <optional>
+
+#include "glm/vec2.hpp"
+
 #include "core/ecs/component.hpp"
+#include "core/math/numeric.hpp"
 
 namespace Symbiote {
 	namespace Game {
 
+		class PhysicsSystem;
+
 		class RigidBodyComponent final : public Symbiote::Core::Component {
 		public:
 			DECLARE_COMPONENT(Symbiote::Game::RigidBodyComponent);
 
+		public:
+			friend PhysicsSystem;
+
+		public:
+			// collision shapes, a body without shape does not collide
+			enum class Shape : std::uint8_t { None, Circle, Box };
+
+		public:
+			// the state of a body, the physics system keeps it in its arrays while the body is simulated
+			struct State {
+				glm::vec2 position = {0, 0};
+				glm::vec2 velocity = {0, 0};
+				glm::vec2 acceleration = {0, 0};
+				glm::vec2 force = {0, 0};
+				float rotation = 0.0f;
+				float angularVelocity = 0.0f;
+				float inverseMass = 1.0f;
+				float linearDamping = 0.0f;
+				float angularDamping = 0.0f;
+				Shape shape = Shape::None;
+				glm::vec2 extents = {0, 0};
+			};
+
 		public:
 			RigidBodyComponent() = default;
 			RigidBodyComponent(RigidBodyComponent &&) = delete;
@@ -16,7 +48,86 @@ namespace Symbiote {
 			RigidBodyComponent &operator=(RigidBodyComponent const &) = delete;
 
 		public:
-			float mSpeed;
+			~RigidBodyComponent() override;
+
+		public:
+			// the body moves the transform of its entity, setting either position teleports both
+			auto GetPosition() const -> glm::vec2;
+			auto GetRotation() const -> float;
+			auto SetPosition(glm::vec2 const &position) -> void;
+			auto SetRotation(float rotation) -> void;
+
+		public:
+			auto GetVelocity() const -> glm::vec2;
+			auto GetAcceleration() const -> glm::vec2;
+			auto GetAngularVelocity() const -> float;
+			auto SetVelocity(glm::vec2 const &velocity) -> void;
+			auto SetAcceleration(glm::vec2 const &acceleration) -> void;
+			auto SetAngularVelocity(float angularVelocity) -> void;
+
+			// forces are applied on the next step only
+			auto AddForce(glm::vec2 const &force) -> void;
+
+		public:
+			// a body without mass is static: forces and acceleration do not change its velocity
+			auto GetMass() const -> float;
+			auto GetLinearDamping() const -> float;
+			auto GetAngularDamping() const -> float;
+			auto SetMass(float mass) -> void;
+			auto SetLinearDamping(float damping) -> void;
+			auto SetAngularDamping(float damping) -> void;
+
+		public:
+			// the extents are the radius of a circle in x, the half extents of a box
+			auto GetShape() const -> Shape;
+			auto GetExtents() const -> glm::vec2;
+			auto SetCircle(float radius) -> void;
+			auto SetBox(glm::vec2 const &halfExtents) -> void;
+			auto ClearShape() -> void;
+
+		public:
+			// a sleeping body is not simulated until something touches it, changing the body through any setter wakes it up
+			auto IsSleeping() const -> bool;
+			auto WakeUp() -> void;
+
+		public:
+			// the numbers of the simulation are saved as is, a restored, forked or streamed in body goes on from exactly where it was
+			// the impulses the solver kept from the last step are not saved, resting contacts start cold
+			auto Serialize(std::ostream &os) const -> void override;
+			auto Deserialize(std::istream &is) -> void override;
+
+		protected:
+			auto OnLoad() -> void override;
+			auto OnResolveDependencies() -> void override;
+
+		private:
+			// the state as the physics system keeps it, a fixed point body is more precise than its float state
+			struct SavedState {
+				Symbiote::Core::Real positionX = 0, positionY = 0, rotation = 0;
+				Symbiote::Core::Real velocityX = 0, velocityY = 0, angularVelocity = 0;
+				Symbiote::Core::Real accelerationX = 0, accelerationY = 0;
+				Symbiote::Core::Real forceX = 0, forceY = 0;
+				Symbiote::Core::Real inverseMass = 0, linearDamping = 0, angularDamping = 0;
+				Symbiote::Core::Real extentX = 0, extentY = 0;
+				Symbiote::Core::Real sleepTime = 0;
+				Shape shape = Shape::None;
+			};
+
+		private:
+			auto GetState() const -> State;
+			auto SetState(State const &state) -> void;
+
+		private:
+			State mState = {};
+			// kept while the body is not simulated after being loaded or untracked, a setter drops it for the float state
+			std::optional<SavedState> mSaved = {};
+
+		private:
+			PhysicsSystem *mSystem = nullptr;
+			std::uint32_t mBody = 0;
+			bool mUnresolved = false;
+			// a body tracked with its saved state is where it was saved, its transform does not place it
+			bool mPlaced = false;
 		};
 
 	} // namespace Game
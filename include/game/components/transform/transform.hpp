@@ -1,22 +1,35 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 #include "glm/vec2.hpp"
+#include "glm/mat3x3.hpp"
 
 #include "core/ecs/component.hpp"
 
 namespace Symbiote {
 	namespace Game {
 
+		class PhysicsSystem;
+		class TransformSystem;
+		class RigidBodyComponent;
+
 		enum class TransformCoordinates { Local, World };
 
 		class TransformComponent final : public Symbiote::Core::Component {
 		public:
 			DECLARE_COMPONENT(Symbiote::Game::TransformComponent);
 
+		public:
+			friend PhysicsSystem;
+			friend TransformSystem;
+
 		public:
 			using Scale = glm::vec2;
 			using Position = glm::vec2;
 			using Rotation = float;
+			using Matrix = glm::mat3;
 
 		public:
 			TransformComponent() = default;
@@ -25,13 +38,17 @@ namespace Symbiote {
 			TransformComponent &operator=(TransformComponent const &) = delete;
 
 		public:
-			TransformComponent(Scale const &scale, Position const &position, Rotation rotation, TransformComponent *parent = nullptr);
+			TransformComponent(Scale const &scale, Position const &position, Rotation rotation, Symbiote::Core::Entity parent = {});
 
 		public:
-			auto GetParent() -> TransformComponent *;
-			auto GetParent() const -> const TransformComponent *;
+			~TransformComponent() override;
 
-			auto SetParent(TransformComponent *parent) -> void;
+		public:
+			// the parent is an entity with a transform, a default entity makes the transform a root
+			auto GetParent() const -> Symbiote::Core::Entity;
+			auto GetDepth() const -> std::size_t;
+
+			auto SetParent(Symbiote::Core::Entity parent) -> void;
 
 		public:
 			auto GetScale(TransformCoordinates coordinates = TransformCoordinates::Local) const -> Scale;
@@ -42,13 +59,48 @@ namespace Symbiote {
 			auto SetPosition(Position const &position, TransformCoordinates coordinates = TransformCoordinates::Local) -> void;
 			auto SetRotation(Rotation const &rotation, TransformCoordinates coordinates = TransformCoordinates::Local) -> void;
 
+		public:
+			// the world matrix is the one of the last TransformSystem::Update, transforms changed since are recomputed when read
+			auto GetLocalMatrix() const -> Matrix;
+			auto GetWorldMatrix() const -> const Matrix &;
+
+		public:
+			auto StorePreviousState() -> void;
+
+			auto GetInterpolatedScale(float alpha) const -> Scale;
+			auto GetInterpolatedPosition(float alpha) const -> Position;
+			auto GetInterpolatedRotation(float alpha) const -> Rotation;
+			// the world matrix between the previous and the current state, as drawn by the renderer
+			auto GetInterpolatedMatrix(float alpha) const -> Matrix;
+
+		protected:
+			auto OnLoad() -> void override;
+
+		private:
+			auto MarkDirty() -> void;
+			auto ResolveParent() const -> const TransformComponent *;
+
 		private:
-			TransformComponent *mParent = nullptr;
+			Symbiote::Core::Entity mParent = {};
 
 		private:
 			Scale mLocalScale = {1, 1};
 			Position mLocalPosition = {0, 0};
 			Rotation mLocalRotation = 0.0f;
+
+		private:
+			// the system stores the hierarchy, mNode is the index of the transform in its depth-first order
+			TransformSystem *mSystem = nullptr;
+			std::uint32_t mNode = 0;
+			mutable Matrix mWorld = Matrix(1.0f);
+			mutable std::uint64_t mWorldGeneration = 0;
+			// the body the physics system moves this transform with, it forgets the transform when it is removed
+			RigidBodyComponent *mBody = nullptr;
+
+		private:
+			Scale mPreviousScale = {1, 1};
+			Position mPreviousPosition = {0, 0};
+			Rotation mPreviousRotation = 0.0f;
 		};
 
 	} // namespace Game
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+#include "glm/vec2.hpp"
+
+namespace Symbiote {
+	namespace Game {
+
+		// Bounding volume hierarchy of fattened bounding boxes, a body only moves in the tree when it leaves its fat box.
+		// The tree is kept balanced with rotations on the path of every insertion and removal.
+		class AabbTree final {
+		public:
+			static constexpr std::int32_t NullNode = -1;
+
+		public:
+			explicit AabbTree(float margin);
+			AabbTree(AabbTree &&) = delete;
+			AabbTree(AabbTree const &) = delete;
+			AabbTree &operator=(AabbTree const &) = delete;
+
+		public:
+			// proxies are the leaves of the tree, they keep their index until they are destroyed
+			auto CreateProxy(glm::vec2 const &min, glm::vec2 const &max, std::uint32_t body) -> std::int32_t;
+			auto DestroyProxy(std::int32_t proxy) -> void;
+			// the fat box is extended along the displacement, returns whether the proxy was reinserted
+			auto MoveProxy(std::int32_t proxy, glm::vec2 const &min, glm::vec2 const &max, glm::vec2 const &displacement) -> bool;
+			// inserting leaves one at a time builds a looser tree than splitting them top down, worth it after bulk changes
+			auto Rebuild() -> void;
+
+		public:
+			auto GetBody(std::int32_t proxy) const -> std::uint32_t;
+			auto SetBody(std::int32_t proxy, std::uint32_t body) -> void;
+			auto GetFatMin(std::int32_t proxy) const -> glm::vec2;
+			auto GetFatMax(std::int32_t proxy) const -> glm::vec2;
+
+		public:
+			auto GetHeight() const -> std::int32_t;
+			auto GetProxyCount() const -> std::size_t;
+			// checks the links, heights, balance and bounds of every node
+			auto Validate() const -> bool;
+
+		public:
+			// calls callback(body) for every fat box overlapping the region, stops when it returns false
+			template <typename Callback>
+			auto Query(glm::vec2 const &min, glm::vec2 const &max, Callback &&callback) const -> void;
+			// calls callback(body, maxDistance) for every fat box crossed by the ray, the callback returns the new max distance
+			template <typename Callback>
+			auto Raycast(glm::vec2 const &origin, glm::vec2 const &direction, float maxDistance, Callback &&callback) const -> void;
+
+		private:
+			struct Node {
+				glm::vec2 min = {0, 0};
+				glm::vec2 max = {0, 0};
+				// the next free node when the node is not in the tree
+				std::int32_t parent = NullNode;
+				std::int32_t child1 = NullNode;
+				std::int32_t child2 = NullNode;
+				// leaves have a height of zero, free nodes of minus one
+				std::int32_t height = -1;
+				std::uint32_t body = 0;
+
+				auto IsLeaf() const -> bool {
+					return child1 == NullNode;
+				}
+			};
+
+		private:
+			auto AllocateNode() -> std::int32_t;
+			auto FreeNode(std::int32_t node) -> void;
+			auto InsertLeaf(std::int32_t leaf) -> void;
+			auto RemoveLeaf(std::int32_t leaf) -> void;
+			auto Refit(std::int32_t node) -> void;
+			auto Balance(std::int32_t node) -> std::int32_t;
+			auto Build(std::int32_t *leaves, std::size_t count) -> std::int32_t;
+			auto Validate(std::int32_t node, std::int32_t parent) const -> bool;
+
+		private:
+			float mMargin;
+			std::int32_t mRoot = NullNode;
+			std::int32_t mFree = NullNode;
+			std::size_t mProxyCount = 0;
+			std::vector<Node> mNodes = {};
+		};
+
+		template <typename Callback>
+		auto AabbTree::Query(glm::vec2 const &min, glm::vec2 const &max, Callback &&callback) const -> void {
+			if (mRoot == NullNode) {
+				return;
+			}
+			std::vector<std::int32_t> stack;
+			stack.reserve(64);
+			stack.push_back(mRoot);
+			while (!stack.empty()) {
+				auto &node = mNodes[stack.back()];
+				stack.pop_back();
+				if (node.min.x > max.x || node.min.y > max.y || min.x > node.max.x || min.y > node.max.y) {
+					continue;
+				}
+				if (node.IsLeaf()) {
+					if (!callback(node.body)) {
+						return;
+					}
+				} else {
+					stack.push_back(node.child1);
+					stack.push_back(node.child2);
+				}
+			}
+		}
+
+		template <typename Callback>
+		auto AabbTree::Raycast(glm::vec2 const &origin, glm::vec2 const &direction, float maxDistance, Callback &&callback) const -> void {
+			if (mRoot == NullNode) {
+				return;
+			}
+			auto inverse = glm::vec2(1.0f / direction.x, 1.0f / direction.y);
+			std::vector<std::int32_t> stack;
+			stack.reserve(64);
+			stack.push_back(mRoot);
+			while (!stack.empty() && maxDistance > 0.0f) {
+				auto &node = mNodes[stack.back()];
+				stack.pop_back();
+				// slab test, a ray parallel to an axis gives infinite distances
+				auto x1 = (node.min.x - origin.x) * inverse.x, x2 = (node.max.x - origin.x) * inverse.x;
+				auto y1 = (node.min.y - origin.y) * inverse.y, y2 = (node.max.y - origin.y) * inverse.y;
+				auto enter = std::max(std::max(std::min(x1, x2), std::min(y1, y2)), 0.0f);
+				auto exit = std::min(std::min(std::max(x1, x2), std::max(y1, y2)), maxDistance);
+				if (enter > exit) {
+					continue;
+				}
+				if (node.IsLeaf()) {
+					maxDistance = callback(node.body, maxDistance);
+				} else {
+					stack.push_back(node.child1);
+					stack.push_back(node.child2);
+				}
+			}
+		}
+
+	} // namespace Game
+} // namespace Symbiote
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+
+#include "core/math/numeric.hpp"
+
+namespace Symbiote {
+	namespace Core {
+		class JobSystem;
+	}
+
+	namespace Game {
+
+		// Uniform grid hashed by cell coordinates, a body is listed in every cell its bounding box overlaps.
+		class SpatialHashGrid final {
+		public:
+			struct Pair {
+				std::uint32_t a;
+				std::uint32_t b;
+			};
+
+			// inclusive range of cells, empty when min is above max
+			struct Range {
+				std::int32_t minX = 1;
+				std::int32_t minY = 1;
+				std::int32_t maxX = 0;
+				std::int32_t maxY = 0;
+			};
+
+			// bounding boxes of the bodies, a pair of bodies without inverse mass is never reported
+			// bodies from the first asleep on are asleep and never paired together, with the ranges of the bodies awake only their cells are visited
+			struct Bounds {
+				const float *minX = nullptr;
+				const float *minY = nullptr;
+				const float *maxX = nullptr;
+				const float *maxY = nullptr;
+				const Symbiote::Core::Real *inverseMass = nullptr;
+				std::uint32_t asleep = std::numeric_limits<std::uint32_t>::max();
+				const Range *ranges = nullptr;
+			};
+
+		public:
+			explicit SpatialHashGrid(float cellSize);
+			SpatialHashGrid(SpatialHashGrid &&) = delete;
+			SpatialHashGrid(SpatialHashGrid const &) = delete;
+			SpatialHashGrid &operator=(SpatialHashGrid const &) = delete;
+
+		public:
+			auto GetCellSize() const -> float;
+			auto GetCellCount() const -> std::size_t;
+			auto GetRange(float minX, float minY, float maxX, float maxY) const -> Range;
+
+		public:
+			auto Insert(std::uint32_t body, Range const &range) -> void;
+			auto Remove(std::uint32_t body, Range const &range) -> void;
+			auto Rename(std::uint32_t from, std::uint32_t to, Range const &range) -> void;
+			// removes every body, the ranges computed before are no longer valid
+			auto Clear(float cellSize) -> void;
+
+		public:
+			// each overlapping pair is reported once, by the cell holding the lower corner of the overlap
+			auto FindPairs(Bounds const &bounds, std::vector<Pair> &pairs, Symbiote::Core::JobSystem *jobs = nullptr) const -> void;
+
+		public:
+			static auto IsEmpty(Range const &range) -> bool;
+			static auto IsSame(Range const &a, Range const &b) -> bool;
+
+		private:
+			struct Cell {
+				std::int32_t x;
+				std::int32_t y;
+				std::vector<std::uint32_t> bodies;
+			};
+
+		private:
+			auto FindPairs(Bounds const &bounds, const std::uint32_t *cells, std::size_t begin, std::size_t end, std::vector<Pair> &pairs) const -> void;
+
+		private:
+			static auto Key(std::int32_t x, std::int32_t y) -> std::uint64_t;
+
+		private:
+			float mCellSize;
+			float mInverseCellSize;
+			std::vector<Cell> mCells = {};
+			std::unordered_map<std::uint64_t, std::uint32_t> mCellIndexes = {};
+			mutable std::vector<std::vector<Pair>> mChunkPairs = {};
+			// the cells visited when some bodies are asleep, marks avoid visiting a cell twice
+			mutable std::vector<std::uint32_t> mAwakeCells = {};
+			mutable std::vector<bool> mMarks = {};
+		};
+
+	} // namespace Game
+} // namespace Symbiote
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "core/math/numeric.hpp"
+
+#include "game/systems/physics/broadphase.hpp"
+#include "game/components/rigidbody/rigidbody.hpp"
+
+namespace Symbiote {
+	namespace Core {
+		class JobSystem;
+	}
+
+	namespace Game {
+
+		// Computes the contact manifolds of the pairs found by the broadphase.
+		// Pairs are sorted by shapes and gathered as structures of arrays, each kernel collides four pairs at a time, or one at a time in fixed point.
+		class Narrowphase final {
+		public:
+			struct ContactPoint {
+				Symbiote::Core::RealVec2 position = {0, 0};
+				// negative when the shapes overlap
+				Symbiote::Core::Real separation = 0;
+				// identifies the features in contact, it stays the same while the shapes keep touching the same way
+				std::uint32_t id = 0;
+			};
+
+			// the normal goes from the first body to the second one
+			struct Contact {
+				std::uint32_t a = 0;
+				std::uint32_t b = 0;
+				Symbiote::Core::RealVec2 normal = {0, 0};
+				std::uint32_t pointCount = 0;
+				ContactPoint points[2] = {};
+			};
+
+			// the shapes of the bodies, indexed by the bodies of the pairs
+			struct Shapes {
+				const RigidBodyComponent::Shape *shape = nullptr;
+				const Symbiote::Core::Real *x = nullptr;
+				const Symbiote::Core::Real *y = nullptr;
+				const Symbiote::Core::Real *cos = nullptr;
+				const Symbiote::Core::Real *sin = nullptr;
+				const Symbiote::Core::Real *extentX = nullptr;
+				const Symbiote::Core::Real *extentY = nullptr;
+			};
+
+		public:
+			static constexpr std::size_t PairsPerJob = 1024;
+
+		public:
+			Narrowphase() = default;
+			Narrowphase(Narrowphase &&) = delete;
+			Narrowphase(Narrowphase const &) = delete;
+			Narrowphase &operator=(Narrowphase const &) = delete;
+
+		public:
+			// contacts are in the same order whatever the number of threads, pairs whose shapes do not touch have none
+			auto Collide(Shapes const &shapes, std::vector<SpatialHashGrid::Pair> const &pairs, std::vector<Contact> &contacts, Symbiote::Core::JobSystem *jobs = nullptr) -> void;
+
+		private:
+			// the gathered lanes of one kind of pair, reused between calls
+			struct Chunk {
+				std::vector<std::uint32_t> pairs = {};
+				std::vector<Symbiote::Core::Real> lanes = {};
+				std::vector<Contact> contacts = {};
+			};
+
+		private:
+			auto Collide(Shapes const &shapes, std::vector<SpatialHashGrid::Pair> const &pairs, std::size_t begin, std::size_t end, Chunk &chunk) const -> void;
+
+		private:
+			std::vector<Chunk> mChunks = {};
+		};
+
+	} // namespace Game
+} // namespace Symbiote
\ No newline at end of file
@@ -1,22 +1,200 @@
 #pragma once
 
+#include <array>
+#include <functional>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+
+#include "glm/vec2.hpp"
+
 #include "core/ecs/system.hpp"
+#include "core/math/numeric.hpp"
+
+#include "game/systems/physics/solver.hpp"
+#include "game/systems/physics/aabbtree.hpp"
+#include "game/systems/physics/broadphase.hpp"
+#include "game/systems/physics/narrowphase.hpp"
+#include "game/components/rigidbody/rigidbody.hpp"
 
 namespace Symbiote {
+	namespace Core {
+		class JobSystem;
+	}
+
 	namespace Game {
 
+		class TransformComponent;
+
+		// Simulates the rigid bodies of the world, which move the local position and rotation of their transform.
+		// It owns their state as arrays of Symbiote::Core::Real, their broadphase, their contacts and their sleeping islands.
 		class PhysicsSystem final : public Symbiote::Core::System {
 		public:
 			DECLARE_SYSTEM(Symbiote::Game::PhysicsSystem);
 
+		public:
+			friend RigidBodyComponent;
+			friend TransformComponent;
+
+		public:
+			// a batch of bodies stays in cache between the passes of the integration, jobs take several batches
+			static constexpr std::size_t BatchSize = 1024;
+			static constexpr std::size_t BatchesPerJob = 16;
+			static constexpr float DefaultCellSize = 4.0f;
+			// bounding boxes in the query tree are fattened by the margin and the displacement of a step
+			static constexpr float AabbMargin = 0.1f;
+			static constexpr std::size_t QueriesPerJob = 64;
+			// a body slower than the tolerances for the time to sleep may fall asleep, with the rest of its island
+			static constexpr float LinearSleepTolerance = 0.01f;
+			static constexpr float AngularSleepTolerance = 0.035f;
+			static constexpr float TimeToSleep = 0.5f;
+
+		public:
+			struct Ray {
+				glm::vec2 origin = {0, 0};
+				glm::vec2 direction = {1, 0};
+				float maxDistance = 0.0f;
+			};
+
+			struct RaycastHit {
+				Symbiote::Core::Entity entity = {};
+				glm::vec2 point = {0, 0};
+				glm::vec2 normal = {0, 0};
+				float distance = 0.0f;
+			};
+
+			struct Region {
+				glm::vec2 min = {0, 0};
+				glm::vec2 max = {0, 0};
+			};
+
+			struct Circle {
+				glm::vec2 center = {0, 0};
+				float radius = 0.0f;
+			};
+
 		public:
 			PhysicsSystem() = default;
 			PhysicsSystem(PhysicsSystem &&) = delete;
 			PhysicsSystem(PhysicsSystem const &) = delete;
 			PhysicsSystem &operator=(PhysicsSystem const &) = delete;
 
+		public:
+			explicit PhysicsSystem(Symbiote::Core::JobSystem *jobs);
+
+		public:
+			~PhysicsSystem() override;
+
 		public:
 			auto Update(float deltaTime) -> void;
+
+		public:
+			auto GetBodyCount() const -> std::size_t;
+			auto GetAwakeCount() const -> std::size_t;
+			// bodies are indexes valid until the next update, the removal of a body or the wake up of a sleeping one
+			auto GetEntity(std::uint32_t body) const -> Symbiote::Core::Entity;
+			// a hash of the positions and velocities of the bodies, lockstep peers compare it to find out when they diverge
+			auto Hash() const -> std::uint64_t;
+
+		public:
+			// pairs of bodies whose bounding boxes overlap after the last update, at least one of them has mass and one of them is awake
+			auto GetPairs() const -> const std::vector<SpatialHashGrid::Pair> &;
+			// contacts between the shapes of the bodies after the last update
+			auto GetContacts() const -> const std::vector<Narrowphase::Contact> &;
+			// islands of bodies touching through contacts during the last update
+			auto GetIslandCount() const -> std::size_t;
+			auto GetSolverIterations() const -> std::size_t;
+			auto SetSolverIterations(std::size_t iterations) -> void;
+			// disabling sleeping wakes every body up
+			auto IsSleepingEnabled() const -> bool;
+			auto SetSleepingEnabled(bool enabled) -> void;
+			auto GetCellSize() const -> float;
+			auto SetCellSize(float cellSize) -> void;
+
+		public:
+			// queries see the shapes as of the last update, a shape containing the origin of a ray is not hit
+			auto Raycast(Ray const &ray) const -> std::optional<RaycastHit>;
+			auto QueryAABB(Region const &region, std::vector<Symbiote::Core::Entity> &entities) const -> void;
+			auto QueryCircle(Circle const &circle, std::vector<Symbiote::Core::Entity> &entities) const -> void;
+
+		public:
+			// batches of queries run in parallel on the job system, the results are in the order of the queries
+			auto Raycast(std::vector<Ray> const &rays, std::vector<std::optional<RaycastHit>> &hits) const -> void;
+			auto QueryAABB(std::vector<Region> const &regions, std::vector<std::vector<Symbiote::Core::Entity>> &entities) const -> void;
+			auto QueryCircle(std::vector<Circle> const &circles, std::vector<std::vector<Symbiote::Core::Entity>> &entities) const -> void;
+
+		private:
+			auto Track(RigidBodyComponent *body) -> void;
+			auto Untrack(RigidBodyComponent *body) -> void;
+			auto ResolveTransform(std::uint32_t body) -> bool;
+			static auto DetachTransform(TransformComponent *transform) -> void;
+			auto LoadBody(std::uint32_t body) const -> RigidBodyComponent::State;
+			auto StoreBody(std::uint32_t body, RigidBodyComponent::State const &state) -> void;
+			auto SaveBody(std::uint32_t body) const -> RigidBodyComponent::SavedState;
+			auto RestoreBody(std::uint32_t body, RigidBodyComponent::SavedState const &saved) -> void;
+			auto UpdateInertia(std::uint32_t body) -> void;
+			auto ForEachBatch(std::size_t count, std::function<void(std::size_t, std::size_t)> const &job) -> void;
+			auto IntegrateVelocities(std::size_t begin, std::size_t end, Symbiote::Core::Real deltaTime, bool forces) -> void;
+			auto IntegratePositions(std::size_t begin, std::size_t end, Symbiote::Core::Real deltaTime) -> void;
+			auto SolveContacts(Symbiote::Core::Real deltaTime) -> void;
+			auto UpdateBounds(std::size_t begin, std::size_t end) -> void;
+			auto UpdateBroadphase(Symbiote::Core::Real deltaTime) -> void;
+			auto FindContacts() -> void;
+			auto UpdateSleep() -> void;
+			auto WakeTouched() -> bool;
+			auto WakeIsland(std::uint32_t island) -> bool;
+			auto SwapBodies(std::uint32_t a, std::uint32_t b) -> void;
+			auto ApplyRenames() -> void;
+			auto RaycastBody(std::uint32_t body, Ray const &ray, RaycastHit &hit) const -> bool;
+			auto OverlapsRegion(std::uint32_t body, Region const &region) const -> bool;
+			auto OverlapsCircle(std::uint32_t body, Circle const &circle) const -> bool;
+			auto RunQueries(std::size_t count, std::function<void(std::size_t)> const &query) const -> void;
+
+		private:
+			struct Bodies {
+				std::vector<RigidBodyComponent *> components;
+				std::vector<TransformComponent *> transforms;
+				std::vector<Symbiote::Core::Real> positionX, positionY, rotation;
+				std::vector<Symbiote::Core::Real> velocityX, velocityY, angularVelocity;
+				std::vector<Symbiote::Core::Real> accelerationX, accelerationY;
+				std::vector<Symbiote::Core::Real> forceX, forceY;
+				std::vector<Symbiote::Core::Real> inverseMass, inverseInertia, linearDamping, angularDamping;
+				std::vector<RigidBodyComponent::Shape> shape;
+				std::vector<Symbiote::Core::Real> extentX, extentY, cos, sin;
+				std::vector<float> boundsMinX, boundsMinY, boundsMaxX, boundsMaxY;
+				std::vector<SpatialHashGrid::Range> cells, nextCells;
+				std::vector<std::int32_t> proxies;
+				std::vector<Symbiote::Core::Real> sleepTime;
+				std::vector<std::uint32_t> islands;
+
+				auto GetRealArrays() -> std::array<std::vector<Symbiote::Core::Real> *, 19>;
+				auto GetFloatArrays() -> std::array<std::vector<float> *, 4>;
+			};
+
+		private:
+			Symbiote::Core::JobSystem *mJobs = nullptr;
+			Bodies mBodies = {};
+			SpatialHashGrid mGrid = SpatialHashGrid(DefaultCellSize);
+			std::vector<SpatialHashGrid::Pair> mPairs = {};
+			Narrowphase mNarrowphase = {};
+			std::vector<Narrowphase::Contact> mContacts = {};
+			ContactSolver mSolver = {};
+			AabbTree mTree = AabbTree(AabbMargin);
+			std::vector<RigidBodyComponent *> mUnresolved = {};
+			std::uint32_t mAwake = 0;
+			std::uint32_t mNextIsland = 0;
+			std::unordered_map<std::uint32_t, std::vector<RigidBodyComponent *>> mSleepingIslands = {};
+			std::unordered_map<std::uint32_t, std::uint32_t> mOrigins = {};
+			std::unordered_map<std::uint32_t, std::uint32_t> mRenames = {};
+			std::vector<std::uint32_t> mIslandBodies = {};
+			std::vector<std::uint32_t> mWakes = {};
+			std::vector<std::vector<RigidBodyComponent *>> mSleepers = {};
+			bool mSleepingEnabled = true;
+			bool mRefresh = false;
+			bool mForces = false;
+			bool mAdopted = false;
 		};
 
 	} // namespace Game
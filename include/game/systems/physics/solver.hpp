@@ -0,0 +1,140 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+#include "core/math/numeric.hpp"
+
+#include "game/systems/physics/narrowphase.hpp"
+
+namespace Symbiote {
+	namespace Core {
+		class JobSystem;
+	}
+
+	namespace Game {
+
+		// Solves the contacts of a step with sequential impulses, the impulses of a step warm start the contact points with the same id on the next one.
+		// Bodies touching through contacts form islands with union-find, static bodies do not join islands so that the islands share no velocity to write.
+		// Islands are solved in parallel, the contacts of a large island are colored so that contacts of a color share no body and are solved in parallel.
+		class ContactSolver final {
+		public:
+			// the velocities are solved in place, bodies without mass are only read
+			struct Bodies {
+				Symbiote::Core::Real *velocityX = nullptr;
+				Symbiote::Core::Real *velocityY = nullptr;
+				Symbiote::Core::Real *angularVelocity = nullptr;
+				const Symbiote::Core::Real *x = nullptr;
+				const Symbiote::Core::Real *y = nullptr;
+				const Symbiote::Core::Real *inverseMass = nullptr;
+				const Symbiote::Core::Real *inverseInertia = nullptr;
+			};
+
+		public:
+			static constexpr std::size_t DefaultIterations = 8;
+			static constexpr std::size_t IslandsPerJob = 16;
+			static constexpr std::size_t ContactsPerJob = 256;
+			// islands with more contacts are colored, below the barriers between colors cost more than they save
+			static constexpr std::size_t ColoringThreshold = 1024;
+			static constexpr float Friction = 0.5f;
+			// the fraction of the penetration beyond the slop which is removed in a step, at most the max correction
+			static constexpr float Baumgarte = 0.2f;
+			static constexpr float LinearSlop = 0.005f;
+			static constexpr float MaxCorrection = 0.2f;
+			// two points whose block is worse conditioned are solved as one
+			static constexpr float MaxCondition = 1000.0f;
+
+		public:
+			ContactSolver() = default;
+			ContactSolver(ContactSolver &&) = delete;
+			ContactSolver(ContactSolver const &) = delete;
+			ContactSolver &operator=(ContactSolver const &) = delete;
+
+		public:
+			// the velocities are the same whatever the number of threads
+			auto Solve(Bodies const &bodies, std::size_t bodyCount, std::vector<Narrowphase::Contact> const &contacts, Symbiote::Core::Real deltaTime, Symbiote::Core::JobSystem *jobs = nullptr) -> void;
+			// forgets the impulses and islands of the last step, to call when the bodies change indexes
+			auto Reset() -> void;
+			// keeps the impulses of the last step for bodies which changed indexes, renames map the old indexes to the new ones
+			auto Rename(std::unordered_map<std::uint32_t, std::uint32_t> const &renames) -> void;
+
+		public:
+			// more iterations converge further, tall stacks need them to stand still
+			auto GetIterations() const -> std::size_t;
+			auto SetIterations(std::size_t iterations) -> void;
+
+		public:
+			// islands and colors of the last step
+			auto GetIslandCount() const -> std::size_t;
+			auto GetColorCount() const -> std::size_t;
+			// the bodies with mass of an island, bodies without contacts are in none
+			auto GetIslandBodies(std::size_t island, std::vector<std::uint32_t> &bodies) const -> void;
+
+		private:
+			struct Point {
+				Symbiote::Core::RealVec2 anchorA = {0, 0};
+				Symbiote::Core::RealVec2 anchorB = {0, 0};
+				Symbiote::Core::Real normalMass = 0;
+				Symbiote::Core::Real tangentMass = 0;
+				Symbiote::Core::Real bias = 0;
+				Symbiote::Core::Real normalImpulse = 0;
+				Symbiote::Core::Real tangentImpulse = 0;
+				std::uint32_t id = 0;
+			};
+
+			struct Constraint {
+				std::uint32_t a = 0;
+				std::uint32_t b = 0;
+				Symbiote::Core::RealVec2 normal = {0, 0};
+				std::uint32_t pointCount = 0;
+				Point points[2] = {};
+				// the effective mass of the normals of two points, solved together as a block
+				Symbiote::Core::Real k11 = 0;
+				Symbiote::Core::Real k12 = 0;
+				Symbiote::Core::Real k22 = 0;
+			};
+
+			// a range of the ordered constraints and of the bodies, colored islands also have a range of color offsets
+			struct Island {
+				std::size_t begin = 0;
+				std::size_t end = 0;
+				std::size_t bodyBegin = 0;
+				std::size_t bodyEnd = 0;
+				std::size_t colorBegin = 0;
+				std::size_t colorEnd = 0;
+			};
+
+		private:
+			auto Prepare(Bodies const &bodies, Narrowphase::Contact const &contact, Symbiote::Core::Real inverseDeltaTime, Constraint &constraint) const -> void;
+			auto BuildIslands(Bodies const &bodies, std::size_t bodyCount) -> void;
+			auto Color(Bodies const &bodies, Island &island) -> void;
+			auto Find(std::uint32_t body) -> std::uint32_t;
+			auto SolveIsland(Bodies const &bodies, Island const &island) -> void;
+			auto SolveColors(Bodies const &bodies, Island const &island, Symbiote::Core::JobSystem *jobs) -> void;
+
+		private:
+			static auto WarmStart(Bodies const &bodies, Constraint const &constraint) -> void;
+			static auto SolveConstraint(Bodies const &bodies, Constraint &constraint) -> void;
+
+		private:
+			std::vector<Constraint> mConstraints = {};
+			// the constraints of the last step, found by their pair of bodies
+			std::vector<Constraint> mPrevious = {};
+			std::unordered_map<std::uint64_t, std::uint32_t> mCache = {};
+			std::vector<std::uint32_t> mParents = {};
+			std::vector<std::uint32_t> mIslandIds = {};
+			std::vector<std::uint32_t> mLabels = {};
+			std::vector<std::uint32_t> mOrder = {};
+			std::vector<std::uint32_t> mBodies = {};
+			std::vector<std::uint32_t> mScratch = {};
+			std::vector<std::uint64_t> mMasks = {};
+			std::vector<Island> mIslands = {};
+			std::vector<std::size_t> mColors = {};
+			std::size_t mColorCount = 0;
+			std::size_t mIterations = DefaultIterations;
+		};
+
+	} // namespace Game
+} // namespace Symbiote
\ No newline at end of file
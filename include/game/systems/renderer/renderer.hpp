@@ -1,8 +1,10 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include <glm/fwd.hpp>
+#include <glm/mat3x3.hpp>
 
 #include "core/ecs/system.hpp"
 #include "game/systems/renderer/vulkan/vulkan.hpp"
@@ -26,12 +28,14 @@ namespace Symbiote {
 			~RendererSystem();
 
 		public:
-			auto Render() -> void;
+			// alpha is how far the frame is between the last two simulated steps, transforms are drawn interpolated
+			auto Render(float alpha) -> void;
 			auto PollEvents() -> bool;
 
 		private:
 			SDL_Window *mWindow = nullptr;
 			VulkanRenderer mVulkanRenderer;
+			std::vector<glm::mat3> mSprites = {};
 		};
 
 	} // namespace Game
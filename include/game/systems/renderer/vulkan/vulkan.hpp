@@ -18,7 +18,8 @@ public:
 	~VulkanRenderer();
 
 public:
-	auto Render() -> void;
+	// sprites are world matrices, each one is drawn as a square around its position
+	auto Render(std::vector<glm::mat3> const &sprites) -> void;
 
 private:
 	VkInstance mInstance = {};
@@ -39,6 +40,13 @@ private:
 	VkQueue mQueue;
 	VkCommandPool mCommandPool;
 	VkSwapchainKHR mSwapchainKHR;
+	VkExtent2D mSwapchainExtent;
 	std::vector<VkImage> mSwapchainImages;
 	std::vector<VkCommandBuffer> mCommandBuffers;
+	VkClearColorValue mClearColor;
+
+private:
+	// the texels of the largest sprite, copied into the swapchain image for each sprite
+	VkBuffer mSpriteBuffer;
+	VkDeviceMemory mSpriteMemory;
 };
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "glm/mat3x3.hpp"
+
+#include "core/ecs/entity.hpp"
+#include "core/ecs/system.hpp"
+
+namespace Symbiote {
+	namespace Game {
+
+		class TransformComponent;
+
+		// Keeps the world matrices of transforms up to date.
+		// Transforms are stored in depth-first order, a subtree is a contiguous range which is updated in a single sweep.
+		class TransformSystem final : public Symbiote::Core::System {
+		public:
+			DECLARE_SYSTEM(Symbiote::Game::TransformSystem);
+
+		public:
+			friend TransformComponent;
+
+		public:
+			TransformSystem() = default;
+			TransformSystem(TransformSystem &&) = delete;
+			TransformSystem(TransformSystem const &) = delete;
+			TransformSystem &operator=(TransformSystem const &) = delete;
+
+		public:
+			~TransformSystem() override;
+
+		public:
+			auto Update() -> void;
+
+		public:
+			auto GetUpdatedCount() const -> std::size_t;
+
+		private:
+			static constexpr std::uint32_t NoParent = UINT32_MAX;
+
+			struct Node {
+				TransformComponent *transform = nullptr;
+				std::uint32_t parent = NoParent;
+				bool dirty = true;
+			};
+
+		private:
+			auto Track(TransformComponent *transform) -> void;
+			auto Untrack(TransformComponent *transform) -> void;
+			auto RebuildOrder() -> void;
+
+		private:
+			std::vector<Node> mNodes = {};
+			std::vector<glm::mat3> mWorlds = {};
+			std::vector<std::uint32_t> mSubtreeEnds = {};
+			std::vector<std::uint32_t> mDirty = {};
+			// entities destroyed with their transform since the order was rebuilt, their children are destroyed too
+			std::vector<Symbiote::Core::Entity> mDestroyed = {};
+			std::uint64_t mGeneration = 1;
+			std::size_t mUpdatedCount = 0;
+			bool mOrderStale = false;
+			bool mPending = false;
+			bool mAdopted = false;
+		};
+
+	} // namespace Game
+} // namespace Symbiote
@@ -0,0 +1,216 @@
+#include <atomic>
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+#include "core/ecs/componentcolumn.hpp"
+#include "core/serialization/hash.hpp"
+
+namespace Symbiote {
+	namespace Core {
+
+		ComponentColumn::ComponentColumn(std::string name, std::size_t elementSize, std::size_t elementAlignment) : mName(std::move(name)), mElementSize(elementSize), mElementAlignment(elementAlignment), mElementsPerPage(elementSize == 0 ? 0 : PageSize / elementSize) {
+			if (elementSize == 0 || elementSize > PageSize || elementAlignment > PageSize) {
+				throw std::logic_error(std::string{"ComponentColumn::ComponentColumn: Component "} + mName + std::string{" does not fit in a page"});
+			}
+		}
+
+		auto ComponentColumn::Contains(Entity::PointerSize index) const -> bool {
+			return index < mSlots.size() && mSlots[index] != InvalidSlot;
+		}
+
+		auto ComponentColumn::Get(Entity::PointerSize index) -> void * {
+			return Contains(index) ? At(mSlots[index]) : nullptr;
+		}
+
+		auto ComponentColumn::Get(Entity::PointerSize index) const -> const void * {
+			return Contains(index) ? At(mSlots[index]) : nullptr;
+		}
+
+		auto ComponentColumn::Insert(Entity::PointerSize index) -> void * {
+			if (Contains(index)) {
+				throw std::logic_error(std::string{"ComponentColumn::Insert: Component "} + mName + std::string{" already exists"});
+			}
+			auto slot = mEntities.size();
+			if (slot / mElementsPerPage >= mPages.size()) {
+				mPages.push_back(AllocatePage());
+			}
+			if (index >= mSlots.size()) {
+				mSlots.resize(index + 1, InvalidSlot);
+			}
+			mSlots[index] = static_cast<std::uint32_t>(slot);
+			mEntities.push_back(index);
+			mEntitiesHashed = false;
+			return At(slot);
+		}
+
+		auto ComponentColumn::Erase(Entity::PointerSize index) -> void {
+			if (!Contains(index)) {
+				throw std::logic_error(std::string{"ComponentColumn::Erase: Component "} + mName + std::string{" not found"});
+			}
+			auto slot = mSlots[index];
+			auto last = mEntities.size() - 1;
+			if (slot != last) {
+				std::memcpy(At(slot), At(last), mElementSize);
+				mEntities[slot] = mEntities[last];
+				mSlots[mEntities[slot]] = slot;
+			}
+			// unused slots are kept zeroed so snapshots of equal columns are byte for byte equal
+			std::memset(At(last), 0, mElementSize);
+			mEntities.pop_back();
+			mSlots[index] = InvalidSlot;
+			mEntitiesHashed = false;
+		}
+
+		auto ComponentColumn::Clear() -> void {
+			mPages.clear();
+			mEntities.clear();
+			mSlots.clear();
+			mPageHashes.clear();
+			mPageHashed.clear();
+			mEntitiesHashed = false;
+		}
+
+		auto ComponentColumn::At(std::size_t slot) -> void * {
+			return WritablePage(slot / mElementsPerPage) + (slot % mElementsPerPage) * mElementSize;
+		}
+
+		auto ComponentColumn::At(std::size_t slot) const -> const void * {
+			return mPages[slot / mElementsPerPage]->data + (slot % mElementsPerPage) * mElementSize;
+		}
+
+		auto ComponentColumn::Size() const -> std::size_t {
+			return mEntities.size();
+		}
+
+		auto ComponentColumn::GetName() const -> const std::string & {
+			return mName;
+		}
+
+		auto ComponentColumn::GetElementSize() const -> std::size_t {
+			return mElementSize;
+		}
+
+		auto ComponentColumn::GetElementAlignment() const -> std::size_t {
+			return mElementAlignment;
+		}
+
+		auto ComponentColumn::GetElementsPerPage() const -> std::size_t {
+			return mElementsPerPage;
+		}
+
+		auto ComponentColumn::GetEntities() const -> const std::vector<Entity::PointerSize> & {
+			return mEntities;
+		}
+
+		auto ComponentColumn::GetPageCount() const -> std::size_t {
+			return (mEntities.size() + mElementsPerPage - 1) / mElementsPerPage;
+		}
+
+		auto ComponentColumn::GetPage(std::size_t page) -> char * {
+			return WritablePage(page);
+		}
+
+		auto ComponentColumn::GetPage(std::size_t page) const -> const char * {
+			return mPages[page]->data;
+		}
+
+		auto ComponentColumn::AllocatePages(std::vector<Entity::PointerSize> entities) -> void {
+			Clear();
+			mEntities = std::move(entities);
+			while (mPages.size() < GetPageCount()) {
+				mPages.push_back(AllocatePage());
+			}
+			RebuildSlots();
+		}
+
+		auto ComponentColumn::AdoptPages(std::vector<Entity::PointerSize> entities, char *pages, std::shared_ptr<void> owner) -> void {
+			Clear();
+			mEntities = std::move(entities);
+			for (std::size_t page = 0; page < GetPageCount(); page++) {
+				mPages.push_back(std::make_shared<Page>(Page{pages + page * PageSize, owner}));
+			}
+			RebuildSlots();
+		}
+
+		auto ComponentColumn::SharePages() const -> std::vector<std::shared_ptr<const Page>> {
+			return {mPages.begin(), mPages.begin() + static_cast<std::ptrdiff_t>(GetPageCount())};
+		}
+
+		auto ComponentColumn::SharePages(std::vector<Entity::PointerSize> entities, std::vector<std::shared_ptr<const Page>> const &pages) -> void {
+			Clear();
+			mEntities = std::move(entities);
+			if (pages.size() != GetPageCount()) {
+				throw std::logic_error(std::string{"ComponentColumn::SharePages: Component "} + mName + std::string{" pages do not match its entities"});
+			}
+			// shared pages are never written to, WritablePage copies them first
+			for (const auto &page : pages) {
+				mPages.push_back(std::const_pointer_cast<Page>(page));
+			}
+			RebuildSlots();
+		}
+
+		auto ComponentColumn::Hash() const -> std::uint64_t {
+			auto pageCount = GetPageCount();
+			mPageHashes.resize(pageCount);
+			mPageHashed.resize(pageCount, false);
+			for (std::size_t page = 0; page < pageCount; page++) {
+				if (!mPageHashed[page]) {
+					auto count = std::min(mElementsPerPage, mEntities.size() - page * mElementsPerPage);
+					mPageHashes[page] = HashWide(mPages[page]->data, count * mElementSize);
+					mPageHashed[page] = true;
+				}
+			}
+			if (!mEntitiesHashed) {
+				mEntitiesHash = HashWide(mEntities.data(), mEntities.size() * sizeof(Entity::PointerSize));
+				mEntitiesHashed = true;
+			}
+			return HashWide(mPageHashes.data(), mPageHashes.size() * sizeof(std::uint64_t), mEntitiesHash);
+		}
+
+		auto ComponentColumn::PagePadding(std::uint64_t offset) -> std::uint32_t {
+			return static_cast<std::uint32_t>((PageSize - offset % PageSize) % PageSize);
+		}
+
+		auto ComponentColumn::AllocatePage() -> std::shared_ptr<Page> {
+			auto alignment = std::align_val_t{std::max(mElementAlignment, alignof(std::max_align_t))};
+			auto data = static_cast<char *>(::operator new(PageSize, alignment));
+			std::memset(data, 0, PageSize);
+			return std::make_shared<Page>(Page{data, std::shared_ptr<void>(data, [alignment](void *page) { ::operator delete(page, alignment); })});
+		}
+
+		auto ComponentColumn::WritablePage(std::size_t page) -> char * {
+			if (page < mPageHashed.size()) {
+				mPageHashed[page] = false;
+			}
+			// the page is still referenced by a snapshot or a fork, it is copied before being written to
+			if (mPages[page].use_count() > 1) {
+				auto copy = AllocatePage();
+				std::memcpy(copy->data, mPages[page]->data, PageSize);
+				mPages[page] = std::move(copy);
+			}
+			return mPages[page]->data;
+		}
+
+		auto ComponentColumn::RebuildSlots() -> void {
+			mSlots.clear();
+			for (std::size_t slot = 0; slot < mEntities.size(); slot++) {
+				auto index = mEntities[slot];
+				if (index >= mSlots.size()) {
+					mSlots.resize(index + 1, InvalidSlot);
+				}
+				if (mSlots[index] != InvalidSlot) {
+					throw std::runtime_error(std::string{"ComponentColumn::RebuildSlots: Component "} + mName + std::string{" appears twice for one entity"});
+				}
+				mSlots[index] = static_cast<std::uint32_t>(slot);
+			}
+		}
+
+		auto NextPodComponentTypeIndex() -> std::size_t {
+			static std::atomic<std::size_t> sNextTypeIndex = {0};
+			return sNextTypeIndex++;
+		}
+
+	} // namespace Core
+} // namespace Symbiote
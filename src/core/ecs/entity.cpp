@@ -30,6 +30,10 @@ namespace Symbiote {
 			return mManager;
 		}
 
+		auto Entity::GetManager() const -> const EntityManager * {
+			return mManager;
+		}
+
 		auto operator==(const Entity &a, const Entity &b) -> bool {
 			return a.mIndex == b.mIndex && a.mVersion == b.mVersion;
 		}
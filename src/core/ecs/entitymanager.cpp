@@ -1,15 +1,25 @@
+#include <map>
+#include <limits>
 #include <cstring>
 #include <ostream>
 #include <istream>
 #include <sstream>
+#include <iostream>
 #include <algorithm>
 
 #include "core/ecs/entitymanager.hpp"
+#include "core/jobs/jobsystem.hpp"
+#include "core/serialization/delta.hpp"
+#include "core/serialization/hash.hpp"
+#include "core/serialization/binary.hpp"
+#include "core/serialization/compression.hpp"
+#include "core/serialization/mappedfile.hpp"
 
 namespace Symbiote {
 	namespace Core {
 
 		auto EntityManager::CreateEntity() -> Entity {
+			SYMBIOTE_PROFILE_SCOPE("EntityManager::CreateEntity");
 			Entity::PointerSize index;
 			Entity::PointerSize version;
 			if (mFreeIndexes.empty()) {
@@ -26,74 +36,533 @@ namespace Symbiote {
 		}
 
 		auto EntityManager::DestroyEntity(Entity &entityPointer) -> void {
+			SYMBIOTE_PROFILE_SCOPE("EntityManager::DestroyEntity");
 			AssertEntityPointerValid(entityPointer);
 			mVersions[entityPointer.mIndex] += 1;
 			mEntityComponents[entityPointer.mIndex].clear();
+			for (auto &column : mColumns) {
+				if (column != nullptr && column->Contains(entityPointer.mIndex)) {
+					column->Erase(entityPointer.mIndex);
+				}
+			}
 			mFreeIndexes.push_back(entityPointer.mIndex);
 		}
 
 		auto EntityManager::Serialize(std::ostream &os) const -> void {
-			for (auto entityPointer : *this) {
-				os << '{';
-				os.write(reinterpret_cast<char *>(&entityPointer.mIndex), sizeof(entityPointer.mIndex));
-				os.write(reinterpret_cast<char *>(&entityPointer.mVersion), sizeof(entityPointer.mVersion));
-				for (const auto &component : mEntityComponents[entityPointer.mIndex]) {
-					os.write(component->GetComponentName().c_str(), 1 + component->GetComponentName().size());
-					component->Serialize(os);
+			SYMBIOTE_PROFILE_SCOPE("EntityManager::Serialize");
+			WriteSnapshot(*CaptureSnapshot(), os);
+		}
+
+		auto EntityManager::SerializeCompressed(std::ostream &os, JobSystem *jobs) const -> void {
+			SYMBIOTE_PROFILE_SCOPE("EntityManager::SerializeCompressed");
+			std::ostringstream snapshot;
+			WriteSnapshot(*CaptureSnapshot(), snapshot);
+			auto compressed = CompressSnapshot(snapshot.str(), jobs);
+			os.write(compressed.data(), static_cast<std::streamsize>(compressed.size()));
+		}
+
+		auto EntityManager::CaptureSnapshot() const -> std::shared_ptr<const SnapshotCapture> {
+			SYMBIOTE_PROFILE_SCOPE("EntityManager::CaptureSnapshot");
+			auto columns = GroupComponents();
+			auto capture = std::make_shared<SnapshotCapture>();
+			capture->versions = mVersions;
+			capture->freeIndexes = mFreeIndexes;
+			capture->columns.reserve(columns.size());
+			std::ostringstream payload;
+			for (auto &column : columns) {
+				SnapshotCapture::Column captured;
+				captured.name = column.first;
+				if (auto pod = column.second.pod) {
+					captured.layout = ColumnLayout;
+					captured.elementSize = static_cast<std::uint32_t>(pod->GetElementSize());
+					captured.entities = pod->GetEntities();
+					captured.pages = pod->SharePages();
+				} else if (auto reflected = FindReflectedComponent(column.first)) {
+					// reflected components are written field by field for the whole pool, without offsets
+					captured.layout = FieldLayout;
+					captured.elementSize = reflected->signature;
+					reflected->serialize(column.second.components.data(), column.second.components.size(), captured.payload);
+					captured.entities = std::move(column.second.entities);
+				} else {
+					payload.str({});
+					captured.offsets.assign(1, 0);
+					for (auto component : column.second.components) {
+						component->Serialize(payload);
+						captured.offsets.push_back(static_cast<std::uint32_t>(payload.tellp()));
+					}
+					captured.payload = payload.str();
+					captured.entities = std::move(column.second.entities);
 				}
-				os << '}';
+				capture->columns.emplace_back(std::move(captured));
 			}
+			return capture;
 		}
 
-		auto EntityManager::Deserialize(std::istream &is) -> void {
-			Clear();
-			enum class ParsingState {
-				eEntity,
-				eComponentName,
+		auto EntityManager::Fork() const -> std::unique_ptr<EntityManager> {
+			SYMBIOTE_PROFILE_SCOPE("EntityManager::Fork");
+			// column pages are shared copy-on-write both ways, instance components are copied through their serialized form
+			// systems are not forked, the fork runs the ones added to it
+			auto fork = std::make_unique<EntityManager>();
+			fork->RegisterComponents(*this);
+			fork->RestoreCapture(*CaptureSnapshot());
+			return fork;
+		}
+
+		auto EntityManager::MoveEntities(EntityManager &source, const std::vector<Entity> &entities) -> std::vector<Entity> {
+			SYMBIOTE_PROFILE_SCOPE("EntityManager::MoveEntities");
+			if (&source == this) {
+				throw std::logic_error("EntityManager::MoveEntities: cannot move entities into their own manager");
+			}
+			// components are moved, not copied, the entities are destroyed in the source manager
+			std::vector<Entity> moved;
+			moved.reserve(entities.size());
+			for (auto entityPointer : entities) {
+				source.AssertEntityPointerValid(entityPointer);
+				auto movedPointer = CreateEntity();
+				auto &components = source.mEntityComponents[entityPointer.mIndex];
+				for (auto &component : components) {
+#if defined(_DEBUG)
+					AssertComponentRegistered(component->GetComponentName());
+#endif
+					mEntityComponents[movedPointer.mIndex].emplace_back(std::move(component));
+				}
+				components.clear();
+				for (std::size_t typeIndex = 0; typeIndex < source.mColumns.size(); typeIndex++) {
+					const ComponentColumn *column = source.mColumns[typeIndex].get();
+					if (column == nullptr || !column->Contains(entityPointer.mIndex)) {
+						continue;
+					}
+					if (typeIndex >= mColumns.size() || mColumns[typeIndex] == nullptr) {
+						throw std::logic_error(column->GetName() + std::string{" is not registered"});
+					}
+					std::memcpy(mColumns[typeIndex]->Insert(movedPointer.mIndex), column->Get(entityPointer.mIndex), column->GetElementSize());
+				}
+				source.DestroyEntity(entityPointer);
+				for (auto &component : mEntityComponents[movedPointer.mIndex]) {
+					EntityConstructComponent(component.get(), movedPointer);
+				}
+				moved.push_back(movedPointer);
+			}
+			for (const auto &movedPointer : moved) {
+				EntityResolveComponentDependencies(movedPointer);
+			}
+			return moved;
+		}
+
+		auto EntityManager::Hash(JobSystem *jobs) const -> std::uint64_t {
+			SYMBIOTE_PROFILE_SCOPE("EntityManager::Hash");
+			auto groups = GroupComponents();
+			std::vector<std::pair<const std::string *, ComponentGroup *>> columns;
+			for (auto &group : groups) {
+				columns.emplace_back(&group.first, &group.second);
+			}
+			std::vector<std::uint64_t> hashes(columns.size());
+			auto hashColumns = [this, &columns, &hashes](std::size_t begin, std::size_t end) {
+				std::ostringstream os;
+				for (auto i = begin; i < end; i++) {
+					auto &name = *columns[i].first;
+					auto &column = *columns[i].second;
+					std::uint64_t hash;
+					if (column.pod != nullptr) {
+						// only the pages written to since the last hash are hashed again
+						hash = column.pod->Hash();
+					} else {
+						hash = HashWide(column.entities.data(), column.entities.size() * sizeof(Entity::PointerSize));
+						if (auto reflected = FindReflectedComponent(name)) {
+							for (auto component : column.components) {
+								hash = reflected->hash(component, hash);
+							}
+						} else {
+							for (auto component : column.components) {
+								os.str({});
+								component->Serialize(os);
+								auto bytes = os.str();
+								hash = HashWide(bytes.data(), bytes.size(), hash);
+							}
+						}
+					}
+					hashes[i] = HashBytes(name.data(), name.size(), hash);
+				}
+			};
+			if (jobs != nullptr) {
+				jobs->ParallelFor(0, columns.size(), 1, hashColumns);
+			} else {
+				hashColumns(0, columns.size());
+			}
+			auto hash = HashWide(mVersions.data(), mVersions.size() * sizeof(Entity::PointerSize));
+			hash = HashWide(mFreeIndexes.data(), mFreeIndexes.size() * sizeof(Entity::PointerSize), hash);
+			return HashWide(hashes.data(), hashes.size() * sizeof(std::uint64_t), hash);
+		}
+
+		auto EntityManager::GroupComponents() const -> std::map<std::string, ComponentGroup> {
+			// types are ordered by name so that equal worlds always produce equal bytes
+			std::map<std::string, ComponentGroup> groups;
+			for (Entity::PointerSize index = 0; index < mNextIndex; index++) {
+				for (const auto &component : mEntityComponents[index]) {
+					auto &group = groups[component->GetComponentName()];
+					group.entities.push_back(index);
+					group.components.push_back(component.get());
+				}
+			}
+			for (const auto &pod : mColumns) {
+				if (pod != nullptr && pod->Size() != 0) {
+					groups[pod->GetName()].pod = pod.get();
+				}
+			}
+			return groups;
+		}
+
+		auto EntityManager::SaveAsync(std::string path, SnapshotSaver::Callback callback, bool compress) const -> std::future<SnapshotSaver::Result> {
+			SYMBIOTE_PROFILE_SCOPE("EntityManager::SaveAsync");
+			auto begin = std::chrono::steady_clock::now();
+			auto capture = CaptureSnapshot();
+			auto stall = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin);
+			if (mSnapshotSaver == nullptr) {
+				mSnapshotSaver = std::make_unique<SnapshotSaver>();
+			}
+			return mSnapshotSaver->Save(std::move(capture), std::move(path), stall, std::move(callback), compress);
+		}
+
+		auto EntityManager::Deserialize(std::istream &is, JobSystem *jobs) -> void {
+			SYMBIOTE_PROFILE_SCOPE("EntityManager::Deserialize");
+			DeserializeSnapshot(is, nullptr, nullptr, jobs);
+		}
+
+		auto EntityManager::DeserializeMapped(const std::string &path) -> void {
+			SYMBIOTE_PROFILE_SCOPE("EntityManager::DeserializeMapped");
+			auto file = std::make_shared<MappedFile>(path);
+			MemoryStreamBuffer buffer(file->GetData(), file->GetSize());
+			std::istream is(&buffer);
+			DeserializeSnapshot(is, &buffer, file, nullptr);
+		}
+
+		auto EntityManager::SerializeDelta(const std::string &baseline, std::ostream &os, bool runLengthEncode) const -> void {
+			SYMBIOTE_PROFILE_SCOPE("EntityManager::SerializeDelta");
+			// the world is compared through its capture, it is never written out as a whole
+			auto delta = EncodeSnapshotDelta(baseline, *CaptureSnapshot(), runLengthEncode);
+			os.write(delta.data(), static_cast<std::streamsize>(delta.size()));
+		}
+
+		auto EntityManager::SerializeDelta(const SnapshotDeltaBaseline &baseline, std::ostream &os, bool runLengthEncode) const -> void {
+			SYMBIOTE_PROFILE_SCOPE("EntityManager::SerializeDelta");
+			auto delta = EncodeSnapshotDelta(baseline, *CaptureSnapshot(), runLengthEncode);
+			os.write(delta.data(), static_cast<std::streamsize>(delta.size()));
+		}
+
+		auto EntityManager::CaptureDeltaBaseline() const -> SnapshotDeltaBaseline {
+			SYMBIOTE_PROFILE_SCOPE("EntityManager::CaptureDeltaBaseline");
+			return MakeSnapshotDeltaBaseline(CaptureSnapshot());
+		}
+
+		auto EntityManager::DeserializeDelta(const std::string &baseline, std::istream &is) -> void {
+			SYMBIOTE_PROFILE_SCOPE("EntityManager::DeserializeDelta");
+			std::ostringstream delta;
+			delta << is.rdbuf();
+			auto target = ApplySnapshotDelta(baseline, delta.str());
+			MemoryStreamBuffer buffer(target.data(), target.size());
+			std::istream targetStream(&buffer);
+			DeserializeSnapshot(targetStream, nullptr, nullptr, nullptr);
+		}
+
+		auto EntityManager::DeserializeSnapshot(std::istream &is, MemoryStreamBuffer *mapped, std::shared_ptr<void> mapping, JobSystem *jobs) -> void {
+			std::uint32_t magic, version, slotCount, freeCount, typeCount;
+			ReadBinary(is, magic);
+			if (magic == CompressedSnapshotMagic) {
+				// compressed snapshots are inflated in memory, their pages cannot be adopted from a mapping
+				std::ostringstream compressed;
+				WriteBinary(compressed, magic);
+				compressed << is.rdbuf();
+				auto snapshot = DecompressSnapshot(compressed.str(), jobs);
+				MemoryStreamBuffer buffer(snapshot.data(), snapshot.size());
+				std::istream snapshotStream(&buffer);
+				DeserializeSnapshot(snapshotStream, nullptr, nullptr, nullptr);
+				return;
+			}
+			if (magic != SnapshotMagic) {
+				throw std::runtime_error("EntityManager::Deserialize: not a snapshot or wrong byte order");
+			}
+			ReadBinary(is, version);
+			if (version == 0 || version > SnapshotVersion) {
+				throw std::runtime_error(std::string{"EntityManager::Deserialize: unsupported snapshot version "} + std::to_string(version));
+			}
+			// the tables are read and checked before the world is cleared, a corrupt header leaves it as it was
+			std::vector<Entity::PointerSize> versions, freeIndexes;
+			ReadBinary(is, slotCount);
+			ReadBinary(is, freeCount);
+			ReadBinary(is, typeCount);
+			ReadBinary(is, versions, slotCount);
+			ReadBinary(is, freeIndexes, freeCount);
+
+			std::vector<bool> freeSlots(slotCount, false);
+			for (auto index : freeIndexes) {
+				if (index >= slotCount) {
+					throw std::runtime_error("EntityManager::Deserialize: corrupt free list");
+				}
+				freeSlots[index] = true;
+			}
+
+			struct Type {
+				const ComponentCreator *creator = nullptr;
+				ComponentColumn *column = nullptr;
+				const ReflectedComponent *reflected = nullptr;
+				std::uint32_t layout = InstanceLayout;
 			};
-			auto state = ParsingState::eEntity;
-			std::unique_ptr<Entity> entityPointer;
-			std::string componentName;
-			while (!is.eof()) {
-				char token;
-				is >> token;
-				if (state == ParsingState::eEntity) {
-					if (token == '0') {
-						break;
-					} else if (token == '{') {
-						entityPointer = std::make_unique<Entity>(this);
-						is.read(reinterpret_cast<char *>(&entityPointer->mIndex), sizeof(entityPointer->mIndex));
-						is.read(reinterpret_cast<char *>(&entityPointer->mVersion), sizeof(entityPointer->mVersion));
-						for (auto i = mNextIndex; i < entityPointer->mIndex; i++) {
-							mFreeIndexes.emplace_back(i);
+			std::vector<Type> types;
+			for (std::uint32_t i = 0; i < typeCount; i++) {
+				std::uint32_t nameSize;
+				std::vector<char> name;
+				ReadBinary(is, nameSize);
+				ReadBinary(is, name, nameSize);
+				std::string componentName(name.begin(), name.end());
+				// version 1 snapshots only contain component instances
+				std::uint32_t layout = InstanceLayout, elementSize = 0;
+				if (version >= 2) {
+					ReadBinary(is, layout);
+					ReadBinary(is, elementSize);
+				}
+				if (layout == ColumnLayout) {
+					auto column = FindColumn(componentName);
+					if (column == nullptr) {
+						throw std::logic_error(componentName + std::string{" is not registered"});
+					}
+					if (column->GetElementSize() != elementSize) {
+						throw std::runtime_error(std::string{"EntityManager::Deserialize: "} + componentName + std::string{" size does not match the snapshot"});
+					}
+					types.push_back({nullptr, column, nullptr, layout});
+				} else if (layout == InstanceLayout || layout == FieldLayout) {
+					auto componentCreator = mRegisteredComponents.find(componentName);
+					if (componentCreator == mRegisteredComponents.end()) {
+						throw std::logic_error(componentName + std::string{" is not registered"});
+					}
+					auto reflected = FindReflectedComponent(componentName);
+					if (layout == FieldLayout && (reflected == nullptr || reflected->signature != elementSize)) {
+						throw std::runtime_error(std::string{"EntityManager::Deserialize: "} + componentName + std::string{" fields do not match the snapshot"});
+					}
+					types.push_back({&componentCreator->second, nullptr, reflected, layout});
+				} else {
+					throw std::runtime_error("EntityManager::Deserialize: unknown column layout");
+				}
+			}
+
+			Clear();
+			mVersions = std::move(versions);
+			mFreeIndexes = std::move(freeIndexes);
+			mNextIndex = static_cast<Entity::PointerSize>(slotCount);
+			mEntityComponents.resize(slotCount);
+			try {
+				// each instance block is read in one go, then its components are constructed from memory
+				std::vector<char> block;
+				std::vector<Entity::PointerSize> entities;
+				std::vector<std::uint32_t> offsets;
+				for (std::uint32_t i = 0; i < typeCount; i++) {
+					std::uint32_t typeIndex, count;
+					std::uint64_t blockSize;
+					ReadBinary(is, typeIndex);
+					ReadBinary(is, blockSize);
+					if (typeIndex >= typeCount) {
+						throw std::runtime_error("EntityManager::Deserialize: corrupt column block");
+					}
+					if (auto column = types[typeIndex].column) {
+						// column pages are raw component bytes, adopted from the mapping or read straight into fresh pages
+						std::uint32_t padding;
+						ReadBinary(is, count);
+						ReadBinary(is, entities, count);
+						ReadBinary(is, padding);
+						auto pageCount = (count + column->GetElementsPerPage() - 1) / column->GetElementsPerPage();
+						auto pagesSize = static_cast<std::uint64_t>(pageCount * ComponentColumn::PageSize);
+						if (blockSize != sizeof(count) + count * sizeof(Entity::PointerSize) + sizeof(padding) + padding + pagesSize) {
+							throw std::runtime_error("EntityManager::Deserialize: corrupt column block");
+						}
+						for (auto index : entities) {
+							if (index >= slotCount || freeSlots[index]) {
+								throw std::runtime_error("EntityManager::Deserialize: corrupt column block");
+							}
+						}
+						if (!is.ignore(padding) || is.gcount() != static_cast<std::streamsize>(padding)) {
+							throw std::runtime_error("EntityManager::Deserialize: unexpected end of stream");
+						}
+						if (mapped != nullptr && reinterpret_cast<std::uintptr_t>(mapped->Current()) % alignof(std::max_align_t) == 0) {
+							auto pages = mapped->Current();
+							if (!mapped->Skip(pagesSize)) {
+								throw std::runtime_error("EntityManager::Deserialize: unexpected end of stream");
+							}
+							column->AdoptPages(std::move(entities), pages, mapping);
+						} else {
+							column->AllocatePages(std::move(entities));
+							for (std::size_t page = 0; page < pageCount; page++) {
+								if (!is.read(column->GetPage(page), ComponentColumn::PageSize)) {
+									throw std::runtime_error("EntityManager::Deserialize: unexpected end of stream");
+								}
+							}
 						}
-						mNextIndex = static_cast<Entity::PointerSize>(entityPointer->mIndex + 1);
-						mVersions.resize(mNextIndex);
-						mEntityComponents.resize(mNextIndex);
-						mVersions[entityPointer->mIndex] = entityPointer->mVersion;
-						state = ParsingState::eComponentName;
+						continue;
 					}
-				} else if (state == ParsingState::eComponentName) {
-					if (token == '}') {
-						entityPointer->ResolveComponentDependencies();
-						state = ParsingState::eEntity;
-					} else if (token == '\0') {
-						auto componentCreator = mRegisteredComponents.find(componentName);
-						if (componentCreator == mRegisteredComponents.end()) {
-							throw std::logic_error(componentName + std::string{" is not registered"});
+					if (blockSize > std::numeric_limits<std::size_t>::max()) {
+						throw std::runtime_error("EntityManager::Deserialize: corrupt column block");
+					}
+					ReadBinary(is, block, static_cast<std::size_t>(blockSize));
+					MemoryStreamBuffer blockBuffer(block.data(), block.size());
+					std::istream blockStream(&blockBuffer);
+					ReadBinary(blockStream, count);
+					ReadBinary(blockStream, entities, count);
+					for (auto index : entities) {
+						if (index >= slotCount || freeSlots[index]) {
+							throw std::runtime_error("EntityManager::Deserialize: corrupt column block");
+						}
+					}
+					if (types[typeIndex].layout == InstanceLayout) {
+						ReadBinary(blockStream, offsets, std::size_t{count} + 1);
+						if (offsets.front() != 0 || offsets.back() != blockBuffer.Remaining() || !std::is_sorted(offsets.begin(), offsets.end())) {
+							throw std::runtime_error("EntityManager::Deserialize: corrupt column block");
 						}
-						auto component = componentCreator->second();
-						auto componentPtr = component.get();
-						mEntityComponents[entityPointer->mIndex].emplace_back(std::move(component));
-						componentPtr->Deserialize(is);
-						EntityConstructComponent(componentPtr, *(entityPointer.get()));
-						componentName.clear();
-						state = ParsingState::eComponentName;
+					}
+					auto payload = block.data() + block.size() - blockBuffer.Remaining();
+					LoadComponents(*types[typeIndex].creator, types[typeIndex].reflected, types[typeIndex].layout, entities, offsets.data(), payload, blockBuffer.Remaining());
+				}
+			} catch (...) {
+				// a world is never left half loaded
+				Clear();
+				throw;
+			}
+			ResolveComponentsDependencies();
+		}
+
+		auto EntityManager::SaveFrame(std::uint64_t tick) -> void {
+			SYMBIOTE_PROFILE_SCOPE("EntityManager::SaveFrame");
+			if (mRollbackFrames.size() != mRollbackFrameCount) {
+				mRollbackFrames.assign(mRollbackFrameCount, {});
+			}
+			// saving a tick rewrites history, the frames after it belong to another timeline
+			for (auto &frame : mRollbackFrames) {
+				if (frame.capture != nullptr && frame.tick > tick) {
+					frame = {};
+				}
+			}
+			mRollbackFrames[tick % mRollbackFrameCount] = {tick, CaptureSnapshot()};
+		}
+
+		auto EntityManager::RestoreFrame(std::uint64_t tick) -> void {
+			SYMBIOTE_PROFILE_SCOPE("EntityManager::RestoreFrame");
+			if (!HasFrame(tick)) {
+				throw std::logic_error(std::string{"EntityManager::RestoreFrame: frame "} + std::to_string(tick) + std::string{" is not kept"});
+			}
+			// the capture is kept alive while restoring, the frame may be restored again
+			auto capture = mRollbackFrames[tick % mRollbackFrameCount].capture;
+			RestoreCapture(*capture);
+		}
+
+		auto EntityManager::HasFrame(std::uint64_t tick) const -> bool {
+			if (mRollbackFrames.empty()) {
+				return false;
+			}
+			const auto &frame = mRollbackFrames[tick % mRollbackFrames.size()];
+			return frame.capture != nullptr && frame.tick == tick;
+		}
+
+		auto EntityManager::SetRollbackFrameCount(std::size_t frameCount) -> void {
+			if (frameCount == 0) {
+				throw std::logic_error("EntityManager::SetRollbackFrameCount: frameCount must be at least 1");
+			}
+			mRollbackFrameCount = frameCount;
+			mRollbackFrames.clear();
+		}
+
+		auto EntityManager::GetRollbackFrameCount() const -> std::size_t {
+			return mRollbackFrameCount;
+		}
+
+		auto EntityManager::RestoreCapture(const SnapshotCapture &capture) -> void {
+			Clear();
+			mVersions = capture.versions;
+			mFreeIndexes = capture.freeIndexes;
+			mNextIndex = static_cast<Entity::PointerSize>(mVersions.size());
+			mEntityComponents.resize(mVersions.size());
+			for (const auto &column : capture.columns) {
+				if (column.layout == ColumnLayout) {
+					// column pages are shared with the capture again, nothing is copied until they are written to
+					auto pod = FindColumn(column.name);
+					if (pod == nullptr) {
+						throw std::logic_error(column.name + std::string{" is not registered"});
+					}
+					pod->SharePages(column.entities, column.pages);
+					continue;
+				}
+				auto componentCreator = mRegisteredComponents.find(column.name);
+				if (componentCreator == mRegisteredComponents.end()) {
+					throw std::logic_error(column.name + std::string{" is not registered"});
+				}
+				LoadComponents(componentCreator->second, FindReflectedComponent(column.name), column.layout, column.entities, column.offsets.data(), column.payload.data(), column.payload.size());
+			}
+			ResolveComponentsDependencies();
+		}
+
+		auto EntityManager::LoadComponents(const ComponentCreator &creator, const ReflectedComponent *reflected, std::uint32_t layout, const std::vector<Entity::PointerSize> &entities, const std::uint32_t *offsets, const char *payload, std::size_t payloadSize) -> void {
+			std::vector<Component *> components;
+			components.reserve(entities.size());
+			for (auto index : entities) {
+				mEntityComponents[index].emplace_back(creator());
+				components.push_back(mEntityComponents[index].back().get());
+			}
+			if (layout == FieldLayout) {
+				// the fields of the whole pool are read at once
+				reflected->deserialize(components.data(), components.size(), payload, payloadSize);
+			} else {
+				MemoryStreamBuffer componentBuffer(nullptr, 0);
+				std::istream componentStream(&componentBuffer);
+				for (std::size_t j = 0; j < components.size(); j++) {
+					if (reflected != nullptr) {
+						// instances saved before the component was reflected, one component is its fields in order
+						reflected->deserialize(&components[j], 1, payload + offsets[j], offsets[j + 1] - offsets[j]);
 					} else {
-						componentName += token;
+						componentBuffer.Assign(payload + offsets[j], offsets[j + 1] - offsets[j]);
+						componentStream.clear();
+						components[j]->Deserialize(componentStream);
 					}
 				}
 			}
+			for (std::size_t j = 0; j < components.size(); j++) {
+				EntityConstructComponent(components[j], Entity(this, entities[j], mVersions[entities[j]]));
+			}
+		}
+
+		auto EntityManager::ResolveComponentsDependencies() -> void {
+			for (Entity::PointerSize index = 0; index < mNextIndex; index++) {
+				if (!mEntityComponents[index].empty()) {
+					EntityResolveComponentDependencies(Entity(this, index, mVersions[index]));
+				}
+			}
+		}
+
+		auto EntityManager::RegisterComponents(const EntityManager &other) -> void {
+			for (const auto &registered : other.mRegisteredComponents) {
+				mRegisteredComponents.insert(registered);
+			}
+			for (const auto &reflected : other.mReflectedComponents) {
+				mReflectedComponents.insert(reflected);
+			}
+			if (other.mColumns.size() > mColumns.size()) {
+				mColumns.resize(other.mColumns.size());
+			}
+			for (std::size_t typeIndex = 0; typeIndex < other.mColumns.size(); typeIndex++) {
+				const auto &column = other.mColumns[typeIndex];
+				if (column != nullptr && mColumns[typeIndex] == nullptr) {
+					mColumns[typeIndex] = std::make_unique<ComponentColumn>(column->GetName(), column->GetElementSize(), column->GetElementAlignment());
+				}
+			}
+		}
+
+		auto EntityManager::FindColumn(const std::string &componentName) const -> ComponentColumn * {
+			for (const auto &column : mColumns) {
+				if (column != nullptr && column->GetName() == componentName) {
+					return column.get();
+				}
+			}
+			return nullptr;
+		}
+
+		auto EntityManager::FindReflectedComponent(const std::string &componentName) const -> const ReflectedComponent * {
+			auto found = mReflectedComponents.find(componentName);
+			return found != mReflectedComponents.end() ? found->second : nullptr;
 		}
 
 		auto EntityManager::IsEntityPointerValid(const Entity &entityPointer) const -> bool {
@@ -122,9 +591,30 @@ namespace Symbiote {
 			}
 		}
 
+		auto EntityManager::GetSystemsStatistics() const -> std::vector<std::pair<std::string, SystemStatistics::Summary>> {
+			std::vector<std::pair<std::string, SystemStatistics::Summary>> statistics;
+			for (const auto &system : mSystems) {
+				statistics.emplace_back(system->GetSystemName(), system->mStatistics.GetSummary());
+			}
+			return statistics;
+		}
+
+		auto EntityManager::SetBudgetWarningHandler(BudgetWarningHandler handler) -> void {
+			mBudgetWarningHandler = std::move(handler);
+		}
+
+		auto EntityManager::WarnSystemBudgetOverrun(const System &system, SystemStatistics::Duration elapsed) const -> void {
+			auto budget = system.mStatistics.GetBudget();
+			if (mBudgetWarningHandler) {
+				mBudgetWarningHandler(system, elapsed, budget);
+			} else {
+				std::cerr << "EntityManager: System " << system.GetSystemName() << " took " << elapsed.count() << "ns, over its " << budget.count() << "ns budget" << std::endl;
+			}
+		}
+
 #if defined(_DEBUG)
 		auto EntityManager::IsComponentRegistered(const std::string &componentName) const -> bool {
-			return mRegisteredComponents.find(componentName) != mRegisteredComponents.end();
+			return mRegisteredComponents.find(componentName) != mRegisteredComponents.end() || FindColumn(componentName) != nullptr;
 		}
 
 		auto EntityManager::AssertComponentRegistered(const std::string &componentName) const -> void {
@@ -151,10 +641,16 @@ namespace Symbiote {
 		}
 
 		auto EntityManager::Clear() -> void {
+			SYMBIOTE_PROFILE_SCOPE("EntityManager::Clear");
 			mNextIndex = 0;
 			mVersions.clear();
 			mFreeIndexes.clear();
 			mEntityComponents.clear();
+			for (auto &column : mColumns) {
+				if (column != nullptr) {
+					column->Clear();
+				}
+			}
 		}
 
 		auto EntityManager::Size() const -> std::size_t {
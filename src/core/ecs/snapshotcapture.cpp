@@ -0,0 +1,56 @@
+#include <ostream>
+
+#include "core/ecs/entitymanager.hpp"
+#include "core/ecs/snapshotcapture.hpp"
+#include "core/serialization/binary.hpp"
+
+namespace Symbiote {
+	namespace Core {
+
+		auto WriteSnapshot(const SnapshotCapture &capture, std::ostream &os) -> void {
+			SYMBIOTE_PROFILE_SCOPE("WriteSnapshot");
+			BinaryWriter writer(os);
+			writer.Write(EntityManager::SnapshotMagic);
+			writer.Write(EntityManager::SnapshotVersion);
+			writer.Write(static_cast<std::uint32_t>(capture.versions.size()));
+			writer.Write(static_cast<std::uint32_t>(capture.freeIndexes.size()));
+			writer.Write(static_cast<std::uint32_t>(capture.columns.size()));
+			writer.Write(capture.versions);
+			writer.Write(capture.freeIndexes);
+			for (const auto &column : capture.columns) {
+				writer.Write(static_cast<std::uint32_t>(column.name.size()));
+				writer.WriteBytes(column.name.data(), column.name.size());
+				writer.Write(column.layout);
+				writer.Write(column.elementSize);
+			}
+
+			std::uint32_t typeIndex = 0;
+			for (const auto &column : capture.columns) {
+				auto count = static_cast<std::uint32_t>(column.entities.size());
+				if (column.layout == ColumnLayout) {
+					// pages start on a page boundary so that a mapped snapshot can adopt them in place
+					auto padding = ComponentColumn::PagePadding(writer.GetOffset() + sizeof(typeIndex) + sizeof(std::uint64_t) + sizeof(count) + count * sizeof(Entity::PointerSize) + sizeof(std::uint32_t));
+					auto blockSize = static_cast<std::uint64_t>(sizeof(count) + count * sizeof(Entity::PointerSize) + sizeof(padding) + padding + column.pages.size() * ComponentColumn::PageSize);
+					writer.Write(typeIndex++);
+					writer.Write(blockSize);
+					writer.Write(count);
+					writer.Write(column.entities);
+					writer.Write(padding);
+					writer.WriteZeros(padding);
+					for (const auto &page : column.pages) {
+						writer.WriteBytes(page->data, ComponentColumn::PageSize);
+					}
+				} else {
+					auto blockSize = static_cast<std::uint64_t>(sizeof(count) + count * sizeof(Entity::PointerSize) + column.offsets.size() * sizeof(std::uint32_t) + column.payload.size());
+					writer.Write(typeIndex++);
+					writer.Write(blockSize);
+					writer.Write(count);
+					writer.Write(column.entities);
+					writer.Write(column.offsets);
+					writer.WriteBytes(column.payload.data(), column.payload.size());
+				}
+			}
+		}
+
+	} // namespace Core
+} // namespace Symbiote
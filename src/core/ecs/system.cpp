@@ -1,4 +1,5 @@
 #include "core/ecs/system.hpp"
+#include "core/ecs/entitymanager.hpp"
 
 DEFINE_ROOT_SYSTEM(Symbiote::Core::System);
 
@@ -15,6 +16,20 @@ namespace Symbiote {
 		auto System::OnResolveDependencies() -> void {
 		}
 
+		auto System::TimeUpdate() -> UpdateTimer {
+			return {*this};
+		}
+
+		System::UpdateTimer::UpdateTimer(System &system) : mSystem(system), mStart(SystemStatistics::Clock::now()) {
+		}
+
+		System::UpdateTimer::~UpdateTimer() {
+			auto elapsed = std::chrono::duration_cast<SystemStatistics::Duration>(SystemStatistics::Clock::now() - mStart);
+			if (!mSystem.mStatistics.Record(elapsed) && mSystem.mManager != nullptr) {
+				mSystem.mManager->WarnSystemBudgetOverrun(mSystem, elapsed);
+			}
+		}
+
 	} // namespace Core
 } // namespace Symbiote
 
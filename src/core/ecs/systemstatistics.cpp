@@ -0,0 +1,56 @@
+#include <numeric>
+#include <algorithm>
+
+#include "core/ecs/systemstatistics.hpp"
+
+namespace Symbiote {
+	namespace Core {
+
+		auto SystemStatistics::Record(Duration elapsed) -> bool {
+			mSamples[mNextSample] = elapsed.count();
+			mNextSample = (mNextSample + 1) % WindowSize;
+			mSampleCount = std::min(mSampleCount + 1, WindowSize);
+			if (mBudget != Duration::zero() && elapsed > mBudget) {
+				mOverruns += 1;
+				return false;
+			}
+			return true;
+		}
+
+		auto SystemStatistics::Reset() -> void {
+			mNextSample = 0;
+			mSampleCount = 0;
+			mOverruns = 0;
+		}
+
+		auto SystemStatistics::GetSummary() const -> Summary {
+			Summary summary;
+			summary.budget = mBudget;
+			summary.samples = mSampleCount;
+			summary.overruns = mOverruns;
+			if (mSampleCount == 0) {
+				return summary;
+			}
+			// percentiles are only computed on query, recording stays a single store
+			auto sorted = mSamples;
+			std::sort(sorted.begin(), sorted.begin() + mSampleCount);
+			auto percentile = [&](std::size_t p) { return Duration(sorted[std::min(mSampleCount - 1, (mSampleCount * p + 99) / 100 - 1)]); };
+			summary.min = Duration(sorted[0]);
+			summary.max = Duration(sorted[mSampleCount - 1]);
+			summary.average = Duration(std::accumulate(sorted.begin(), sorted.begin() + mSampleCount, Duration::rep{0}) / static_cast<Duration::rep>(mSampleCount));
+			summary.p95 = percentile(95);
+			summary.p99 = percentile(99);
+			summary.last = Duration(mSamples[(mNextSample + WindowSize - 1) % WindowSize]);
+			return summary;
+		}
+
+		auto SystemStatistics::GetBudget() const -> Duration {
+			return mBudget;
+		}
+
+		auto SystemStatistics::SetBudget(Duration budget) -> void {
+			mBudget = budget;
+		}
+
+	} // namespace Core
+} // namespace Symbiote
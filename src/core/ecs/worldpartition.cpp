@@ -0,0 +1,263 @@
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "core/ecs/entitymanager.hpp"
+#include "core/ecs/worldpartition.hpp"
+#include "core/serialization/binary.hpp"
+
+namespace Symbiote {
+	namespace Core {
+
+		namespace {
+			// staged entities are in the order they were saved in
+			auto StagedEntities(EntityManager &staging) -> std::vector<Entity> {
+				std::vector<Entity> entities;
+				entities.reserve(staging.Size());
+				for (auto entity : staging) {
+					entities.push_back(entity);
+				}
+				return entities;
+			}
+		} // namespace
+
+		WorldPartition::WorldPartition(EntityManager &manager, JobSystem &jobs, Locator locator, Settings settings) : mManager(manager), mJobs(jobs), mLocator(std::move(locator)), mSettings(std::move(settings)) {
+			if (!(mSettings.cellSize > 0.0f) || mSettings.loadRadius < 0) {
+				throw std::logic_error("WorldPartition::WorldPartition: cellSize must be positive and loadRadius must not be negative");
+			}
+		}
+
+		WorldPartition::~WorldPartition() {
+			// cells being saved are written before the partition goes away, cells being loaded are dropped
+			for (auto &cell : mCells) {
+				if (cell.second.stream != nullptr) {
+					mJobs.Wait(cell.second.stream->counter);
+				}
+			}
+		}
+
+		auto WorldPartition::Update(float x, float y) -> void {
+			SYMBIOTE_PROFILE_SCOPE("WorldPartition::Update");
+			CompleteStreams(false);
+			auto focus = GetCell(x, y);
+			if (!mFocused || focus != mFocus) {
+				mFocused = true;
+				mFocus = focus;
+				UnloadCells();
+			}
+			LoadCells();
+		}
+
+		auto WorldPartition::Flush() -> void {
+			SYMBIOTE_PROFILE_SCOPE("WorldPartition::Flush");
+			// a cell wanted again while it was being saved is loaded once the save is done
+			CompleteStreams(true);
+			LoadCells();
+			CompleteStreams(true);
+		}
+
+		auto WorldPartition::GetCell(float x, float y) const -> Cell {
+			return {static_cast<std::int32_t>(std::floor(x / mSettings.cellSize)), static_cast<std::int32_t>(std::floor(y / mSettings.cellSize))};
+		}
+
+		auto WorldPartition::IsCellLoaded(Cell cell) const -> bool {
+			return GetCellState(cell) == CellState::Loaded;
+		}
+
+		auto WorldPartition::GetCellState(Cell cell) const -> CellState {
+			// cells which were never unloaded are part of the world
+			auto found = mCells.find(cell);
+			return found != mCells.end() ? found->second.state : CellState::Loaded;
+		}
+
+		auto WorldPartition::GetSavedCellCount() const -> std::size_t {
+			std::size_t count = 0;
+			for (const auto &cell : mCells) {
+				count += cell.second.state == CellState::Saved ? 1 : 0;
+			}
+			return count;
+		}
+
+		auto WorldPartition::SetCellUnloadCallback(CellCallback callback) -> void {
+			mUnloadCallback = std::move(callback);
+		}
+
+		auto WorldPartition::SetCellLoadCallback(CellCallback callback) -> void {
+			mLoadCallback = std::move(callback);
+		}
+
+		auto WorldPartition::IsCellWanted(Cell cell) const -> bool {
+			return mFocused && std::abs(cell.first - mFocus.first) <= mSettings.loadRadius && std::abs(cell.second - mFocus.second) <= mSettings.loadRadius;
+		}
+
+		auto WorldPartition::GetCellPath(Cell cell) const -> std::string {
+			if (mSettings.directory.empty()) {
+				return {};
+			}
+			return mSettings.directory + "/cell_" + std::to_string(cell.first) + "_" + std::to_string(cell.second) + ".bin";
+		}
+
+		auto WorldPartition::CreateStaging() const -> std::unique_ptr<EntityManager> {
+			auto staging = std::make_unique<EntityManager>();
+			staging->RegisterComponents(mManager);
+			return staging;
+		}
+
+		auto WorldPartition::CompleteStreams(bool wait) -> void {
+			std::exception_ptr error;
+			for (auto &cell : mCells) {
+				auto &record = cell.second;
+				if (record.stream == nullptr || (!wait && !record.stream->counter.IsDone())) {
+					continue;
+				}
+				mJobs.Wait(record.stream->counter);
+				auto stream = std::move(record.stream);
+				if (stream->error != nullptr) {
+					if (record.state == CellState::Saving) {
+						// the entities of a cell which failed to save go back to the world
+						mManager.MoveEntities(*stream->staging, StagedEntities(*stream->staging));
+						record.state = CellState::Loaded;
+					} else {
+						// the cell keeps its blob, a failed load is retried on the next update
+						record.state = CellState::Saved;
+					}
+					error = error != nullptr ? error : stream->error;
+					continue;
+				}
+				if (record.state == CellState::Saving) {
+					record.state = CellState::Saved;
+					record.blob = std::move(stream->blob);
+				} else if (record.state == CellState::Loading) {
+					if (!IsCellWanted(cell.first)) {
+						// the focus moved away while loading, the saved cell is still valid
+						record.state = CellState::Saved;
+						continue;
+					}
+					auto entities = mManager.MoveEntities(*stream->staging, StagedEntities(*stream->staging));
+					record.state = CellState::Loaded;
+					record.blob.reset();
+					if (mLoadCallback) {
+						mLoadCallback(cell.first, entities);
+					}
+				}
+			}
+			// the other streams are completed before the first error is reported
+			if (error != nullptr) {
+				std::rethrow_exception(error);
+			}
+		}
+
+		auto WorldPartition::UnloadCells() -> void {
+			SYMBIOTE_PROFILE_SCOPE("WorldPartition::UnloadCells");
+			// entities are bucketed by the cell they are in now, those in a cell which is not loaded stay until it is
+			std::vector<bool> freeSlots(mManager.mNextIndex, false);
+			for (auto index : mManager.mFreeIndexes) {
+				freeSlots[index] = true;
+			}
+			std::map<Cell, std::vector<Entity>> unloaded;
+			for (Entity::PointerSize index = 0; index < mManager.mNextIndex; index++) {
+				if (freeSlots[index]) {
+					continue;
+				}
+				float x, y;
+				Entity entity(&mManager, index, mManager.mVersions[index]);
+				if (!mLocator(entity, x, y)) {
+					continue;
+				}
+				auto cell = GetCell(x, y);
+				if (!IsCellWanted(cell) && IsCellLoaded(cell)) {
+					unloaded[cell].push_back(entity);
+				}
+			}
+			for (auto &cell : unloaded) {
+				if (mUnloadCallback) {
+					mUnloadCallback(cell.first, cell.second);
+				}
+				SaveCell(cell.first, mCells[cell.first], cell.second);
+			}
+			// loaded cells left without entities have nothing to save
+			for (auto cell = mCells.begin(); cell != mCells.end();) {
+				if (cell->second.state == CellState::Loaded && !IsCellWanted(cell->first)) {
+					cell = mCells.erase(cell);
+				} else {
+					++cell;
+				}
+			}
+		}
+
+		auto WorldPartition::LoadCells() -> void {
+			for (auto &cell : mCells) {
+				if (cell.second.state == CellState::Saved && IsCellWanted(cell.first)) {
+					LoadCell(cell.first, cell.second);
+				}
+			}
+		}
+
+		auto WorldPartition::SaveCell(Cell cell, CellRecord &record, const std::vector<Entity> &entities) -> void {
+			SYMBIOTE_PROFILE_SCOPE("WorldPartition::SaveCell");
+			auto stream = std::make_shared<Stream>();
+			stream->staging = CreateStaging();
+			stream->staging->MoveEntities(mManager, entities);
+			record.state = CellState::Saving;
+			record.blob.reset();
+			record.stream = stream;
+			mJobs.Schedule(
+				[stream, path = GetCellPath(cell), compress = mSettings.compress]() {
+					SYMBIOTE_PROFILE_SCOPE("WorldPartition::SaveCell::Job");
+					try {
+						std::ostringstream os;
+						if (compress) {
+							stream->staging->SerializeCompressed(os);
+						} else {
+							stream->staging->Serialize(os);
+						}
+						if (path.empty()) {
+							stream->blob = std::make_shared<const std::string>(os.str());
+						} else {
+							auto blob = os.str();
+							std::ofstream file(path, std::ios::binary | std::ios::trunc);
+							if (!file.write(blob.data(), static_cast<std::streamsize>(blob.size()))) {
+								throw std::runtime_error(std::string{"WorldPartition::SaveCell: cannot write "} + path);
+							}
+						}
+						// the entities of the cell are destroyed here rather than on the main thread
+						stream->staging.reset();
+					} catch (...) {
+						stream->error = std::current_exception();
+					}
+				},
+				&stream->counter);
+		}
+
+		auto WorldPartition::LoadCell(Cell cell, CellRecord &record) -> void {
+			SYMBIOTE_PROFILE_SCOPE("WorldPartition::LoadCell");
+			auto stream = std::make_shared<Stream>();
+			stream->staging = CreateStaging();
+			stream->blob = record.blob;
+			record.state = CellState::Loading;
+			record.stream = stream;
+			mJobs.Schedule(
+				[stream, path = GetCellPath(cell)]() {
+					SYMBIOTE_PROFILE_SCOPE("WorldPartition::LoadCell::Job");
+					try {
+						if (stream->blob != nullptr) {
+							MemoryStreamBuffer buffer(stream->blob->data(), stream->blob->size());
+							std::istream is(&buffer);
+							stream->staging->Deserialize(is);
+						} else {
+							std::ifstream file(path, std::ios::binary);
+							if (!file) {
+								throw std::runtime_error(std::string{"WorldPartition::LoadCell: cannot open "} + path);
+							}
+							stream->staging->Deserialize(file);
+						}
+					} catch (...) {
+						stream->error = std::current_exception();
+					}
+				},
+				&stream->counter);
+		}
+
+	} // namespace Core
+} // namespace Symbiote
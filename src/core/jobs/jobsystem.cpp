@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <utility>
+#include <stdexcept>
+
+#include "core/jobs/jobsystem.hpp"
+#include "core/profiler/profiler.hpp"
+
+namespace Symbiote {
+	namespace Core {
+
+		namespace {
+			struct WorkerContext {
+				const JobSystem *system = nullptr;
+				std::size_t index = 0;
+			};
+
+			thread_local WorkerContext tWorkerContext = {};
+		} // namespace
+
+		auto JobSystem::Counter::IsDone() const -> bool {
+			return mPending.load() == 0;
+		}
+
+		auto JobSystem::Counter::GetPending() const -> std::size_t {
+			return mPending.load();
+		}
+
+		JobSystem::JobSystem(std::size_t threadCount) {
+			if (threadCount == 0) {
+				throw std::logic_error("JobSystem::JobSystem: threadCount must be at least 1");
+			}
+			for (std::size_t i = 0; i < threadCount; i++) {
+				mQueues.emplace_back(std::make_unique<WorkerQueue>());
+			}
+			// the calling thread is worker 0, it executes jobs whenever it waits on a counter
+			tWorkerContext = {this, 0};
+			for (std::size_t i = 1; i < threadCount; i++) {
+				mThreads.emplace_back([this, i]() { WorkerLoop(i); });
+			}
+		}
+
+		JobSystem::~JobSystem() {
+			{
+				std::lock_guard<std::mutex> lock(mSleepMutex);
+				mRunning = false;
+			}
+			mSleepCondition.notify_all();
+			for (auto &thread : mThreads) {
+				thread.join();
+			}
+			if (tWorkerContext.system == this) {
+				tWorkerContext = {};
+			}
+		}
+
+		auto JobSystem::Schedule(Job job, Counter *counter) -> void {
+			if (counter != nullptr) {
+				counter->mPending += 1;
+			}
+			Push({std::move(job), counter});
+		}
+
+		auto JobSystem::Schedule(Job job, Counter &dependency, Counter *counter) -> void {
+			if (counter != nullptr) {
+				counter->mPending += 1;
+			}
+			{
+				std::lock_guard<std::mutex> lock(dependency.mMutex);
+				if (dependency.mPending.load() != 0) {
+					dependency.mContinuations.push_back({std::move(job), counter});
+					return;
+				}
+			}
+			Push({std::move(job), counter});
+		}
+
+		auto JobSystem::Wait(Counter &counter) -> void {
+			SYMBIOTE_PROFILE_SCOPE("JobSystem::Wait");
+			auto workerIndex = GetWorkerIndex();
+			while (counter.mPending.load() != 0) {
+				Task task;
+				if (Pop(workerIndex, task)) {
+					Execute(task);
+				} else {
+					std::this_thread::yield();
+				}
+			}
+			// synchronizes with the thread which completed the last job, it may still hold the counter lock
+			std::exception_ptr exception;
+			{
+				std::lock_guard<std::mutex> lock(counter.mMutex);
+				std::swap(exception, counter.mException);
+			}
+			if (exception != nullptr) {
+				std::rethrow_exception(exception);
+			}
+		}
+
+		auto JobSystem::ParallelFor(std::size_t begin, std::size_t end, std::size_t grainSize, RangeJob const &job) -> void {
+			if (begin >= end) {
+				return;
+			}
+			auto count = end - begin;
+			if (grainSize == 0) {
+				grainSize = std::max<std::size_t>(1, count / (GetThreadCount() * 4));
+			}
+			if (GetThreadCount() == 1 || count <= grainSize) {
+				for (auto first = begin; first < end; first += std::min(grainSize, end - first)) {
+					job(first, first + std::min(grainSize, end - first));
+				}
+				return;
+			}
+			Counter counter;
+			for (auto first = begin; first < end; first += std::min(grainSize, end - first)) {
+				auto last = first + std::min(grainSize, end - first);
+				Schedule([&job, first, last]() { job(first, last); }, &counter);
+			}
+			Wait(counter);
+		}
+
+		auto JobSystem::GetThreadCount() const -> std::size_t {
+			return mQueues.size();
+		}
+
+		auto JobSystem::GetWorkerIndex() const -> std::size_t {
+			return tWorkerContext.system == this ? tWorkerContext.index : 0;
+		}
+
+		auto JobSystem::DefaultThreadCount() -> std::size_t {
+			return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+		}
+
+		auto JobSystem::Push(Task task) -> void {
+			auto &queue = *mQueues[GetWorkerIndex()];
+			{
+				std::lock_guard<std::mutex> lock(queue.mutex);
+				queue.tasks.emplace_back(std::move(task));
+			}
+			mQueued += 1;
+			if (mSleeping.load() != 0) {
+				{ std::lock_guard<std::mutex> lock(mSleepMutex); }
+				mSleepCondition.notify_one();
+			}
+		}
+
+		auto JobSystem::Pop(std::size_t workerIndex, Task &task) -> bool {
+			if (mQueued.load() == 0) {
+				return false;
+			}
+			// owner pops the most recent task (LIFO) for cache locality...
+			{
+				auto &queue = *mQueues[workerIndex];
+				std::lock_guard<std::mutex> lock(queue.mutex);
+				if (!queue.tasks.empty()) {
+					task = std::move(queue.tasks.back());
+					queue.tasks.pop_back();
+					mQueued -= 1;
+					return true;
+				}
+			}
+			// ...and thieves steal the oldest task (FIFO) from the other workers
+			for (std::size_t i = 1; i < mQueues.size(); i++) {
+				auto &queue = *mQueues[(workerIndex + i) % mQueues.size()];
+				std::lock_guard<std::mutex> lock(queue.mutex);
+				if (!queue.tasks.empty()) {
+					task = std::move(queue.tasks.front());
+					queue.tasks.pop_front();
+					mQueued -= 1;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		auto JobSystem::Execute(Task &task) -> void {
+			std::exception_ptr exception;
+			{
+				SYMBIOTE_PROFILE_SCOPE("JobSystem::Job");
+				try {
+					task.job();
+				} catch (...) {
+					if (task.counter == nullptr) {
+						throw;
+					}
+					exception = std::current_exception();
+				}
+			}
+			if (task.counter == nullptr) {
+				return;
+			}
+			std::vector<Task> continuations;
+			{
+				std::lock_guard<std::mutex> lock(task.counter->mMutex);
+				if (exception != nullptr && task.counter->mException == nullptr) {
+					task.counter->mException = exception;
+				}
+				if (--task.counter->mPending == 0) {
+					continuations.swap(task.counter->mContinuations);
+				}
+			}
+			for (auto &continuation : continuations) {
+				Push(std::move(continuation));
+			}
+		}
+
+		auto JobSystem::WorkerLoop(std::size_t workerIndex) -> void {
+			tWorkerContext = {this, workerIndex};
+			while (mRunning.load()) {
+				Task task;
+				if (Pop(workerIndex, task)) {
+					Execute(task);
+					continue;
+				}
+				std::unique_lock<std::mutex> lock(mSleepMutex);
+				mSleeping += 1;
+				mSleepCondition.wait(lock, [this]() { return !mRunning.load() || mQueued.load() != 0; });
+				mSleeping -= 1;
+			}
+		}
+
+	} // namespace Core
+} // namespace Symbiote
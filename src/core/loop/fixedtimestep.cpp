@@ -0,0 +1,100 @@
+#include <cmath>
+#include <stdexcept>
+#include <algorithm>
+
+#include "core/loop/fixedtimestep.hpp"
+
+namespace Symbiote {
+	namespace Core {
+
+		FixedTimestep::FixedTimestep(float step, std::size_t maxSubsteps, float maxFrameTime) : mStep(step), mMaxFrameTime(maxFrameTime), mMaxSubsteps(maxSubsteps) {
+			if (step <= 0.0f || maxSubsteps == 0 || maxFrameTime < step) {
+				throw std::logic_error("FixedTimestep::FixedTimestep: invalid step, substeps or frame time");
+			}
+		}
+
+		auto FixedTimestep::Run(PollCallback const &poll, SimulateCallback const &simulate, RenderCallback const &render) -> void {
+			auto previous = Clock::now();
+			while (poll()) {
+				auto now = Clock::now();
+				auto alpha = Advance(std::chrono::duration<float>(now - previous).count(), simulate);
+				previous = now;
+				render(alpha);
+			}
+		}
+
+		auto FixedTimestep::Advance(float frameTime, SimulateCallback const &simulate) -> float {
+			mFrameTime = frameTime;
+			mFrameCount += 1;
+			mSubsteps = 0;
+			// clamp long frames (debugger, loading hitch) so the simulation never tries to catch up on all of it
+			mAccumulator += std::min(std::max(frameTime, 0.0f), mMaxFrameTime);
+
+			auto t0 = Clock::now();
+			while (mAccumulator >= mStep && mSubsteps < mMaxSubsteps) {
+				simulate(mStep);
+				mAccumulator -= mStep;
+				mSimulatedTime += mStep;
+				mSubsteps += 1;
+				mStepCount += 1;
+			}
+			auto t1 = Clock::now();
+			mSimulationTime = std::chrono::duration<float>(t1 - t0).count();
+
+			// spiral of death: the simulation is slower than real time, drop the steps we cannot afford
+			if (mAccumulator >= mStep) {
+				auto dropped = std::floor(mAccumulator / mStep) * mStep;
+				mAccumulator -= dropped;
+				mDroppedTime += dropped;
+			}
+
+			mAlpha = static_cast<float>(mAccumulator / mStep);
+			return mAlpha;
+		}
+
+		auto FixedTimestep::GetStep() const -> float {
+			return mStep;
+		}
+
+		auto FixedTimestep::GetAlpha() const -> float {
+			return mAlpha;
+		}
+
+		auto FixedTimestep::GetMaxSubsteps() const -> std::size_t {
+			return mMaxSubsteps;
+		}
+
+		auto FixedTimestep::GetMaxFrameTime() const -> float {
+			return mMaxFrameTime;
+		}
+
+		auto FixedTimestep::GetFrameTime() const -> float {
+			return mFrameTime;
+		}
+
+		auto FixedTimestep::GetSimulationTime() const -> float {
+			return mSimulationTime;
+		}
+
+		auto FixedTimestep::GetSimulatedTime() const -> double {
+			return mSimulatedTime;
+		}
+
+		auto FixedTimestep::GetDroppedTime() const -> double {
+			return mDroppedTime;
+		}
+
+		auto FixedTimestep::GetSubsteps() const -> std::size_t {
+			return mSubsteps;
+		}
+
+		auto FixedTimestep::GetFrameCount() const -> std::size_t {
+			return mFrameCount;
+		}
+
+		auto FixedTimestep::GetStepCount() const -> std::size_t {
+			return mStepCount;
+		}
+
+	} // namespace Core
+} // namespace Symbiote
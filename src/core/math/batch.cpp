@@ -0,0 +1,364 @@
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+#include "glm/glm.hpp"
+#include "glm/simd/common.h"
+
+#include "core/math/batch.hpp"
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+#define SYMBIOTE_BATCH_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define SYMBIOTE_TARGET_AVX2
+#else
+#define SYMBIOTE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace Symbiote {
+	namespace Core {
+
+		namespace {
+			// sine and cosine reduced to [-pi/4, pi/4] around the nearest multiple of pi/2, every path computes the same polynomials
+			constexpr float TwoOverPi = 0.636619772367581f;
+			constexpr float HalfPi1 = 1.5703125f;
+			constexpr float HalfPi2 = 4.837512969970703125e-4f;
+			constexpr float HalfPi3 = 7.549789948768648e-8f;
+			constexpr float Sin1 = -1.9515295891e-4f;
+			constexpr float Sin2 = 8.3321608736e-3f;
+			constexpr float Sin3 = -1.6666654611e-1f;
+			constexpr float Cos1 = 2.443315711809948e-5f;
+			constexpr float Cos2 = -1.388731625493765e-3f;
+			constexpr float Cos3 = 4.166664568298827e-2f;
+
+			auto SinCos(float x, float &sin, float &cos) -> void {
+				auto quadrant = static_cast<std::int32_t>(std::nearbyint(x * TwoOverPi));
+				auto j = static_cast<float>(quadrant);
+				auto r = ((x - j * HalfPi1) - j * HalfPi2) - j * HalfPi3;
+				auto z = r * r;
+				auto s = ((Sin1 * z + Sin2) * z + Sin3) * z * r + r;
+				auto c = ((Cos1 * z + Cos2) * z + Cos3) * z * z - 0.5f * z + 1.0f;
+				auto swap = (quadrant & 1) != 0;
+				sin = swap ? c : s;
+				cos = swap ? s : c;
+				if ((quadrant & 2) != 0) {
+					sin = -sin;
+				}
+				if (((quadrant + 1) & 2) != 0) {
+					cos = -cos;
+				}
+			}
+
+			auto ComposeScalar(const TransformArrays &parents, const TransformArrays &locals, const TransformArrays &worlds, std::size_t begin, std::size_t end) -> void {
+				for (auto i = begin; i < end; i++) {
+					float sin, cos;
+					SinCos(parents.rotation[i], sin, cos);
+					auto x = locals.x[i] * parents.scaleX[i];
+					auto y = locals.y[i] * parents.scaleY[i];
+					worlds.x[i] = parents.x[i] + (cos * x - sin * y);
+					worlds.y[i] = parents.y[i] + (sin * x + cos * y);
+					worlds.rotation[i] = parents.rotation[i] + locals.rotation[i];
+					worlds.scaleX[i] = parents.scaleX[i] * locals.scaleX[i];
+					worlds.scaleY[i] = parents.scaleY[i] * locals.scaleY[i];
+				}
+			}
+
+			auto TransformPointsScalar(const glm::mat3 &matrix, const float *x, const float *y, float *outX, float *outY, std::size_t begin, std::size_t end) -> void {
+				for (auto i = begin; i < end; i++) {
+					auto px = x[i];
+					auto py = y[i];
+					outX[i] = (matrix[0][0] * px + matrix[1][0] * py) + matrix[2][0];
+					outY[i] = (matrix[0][1] * px + matrix[1][1] * py) + matrix[2][1];
+				}
+			}
+
+			auto IntegrateScalar(float *x, float *y, const float *velocityX, const float *velocityY, float deltaTime, std::size_t begin, std::size_t end) -> void {
+				for (auto i = begin; i < end; i++) {
+					x[i] += velocityX[i] * deltaTime;
+					y[i] += velocityY[i] * deltaTime;
+				}
+			}
+
+			template <typename Fixed>
+			auto IntegrateFixedScalar(Fixed *x, Fixed *y, const Fixed *velocityX, const Fixed *velocityY, Fixed deltaTime, std::size_t begin, std::size_t end) -> void {
+				for (auto i = begin; i < end; i++) {
+					x[i] += velocityX[i] * deltaTime;
+					y[i] += velocityY[i] * deltaTime;
+				}
+			}
+
+#if SYMBIOTE_BATCH_X86
+			// four transforms at a time, with the glm simd helpers
+			auto SinCosSSE2(__m128 x, __m128 &sin, __m128 &cos) -> void {
+				auto quadrant = _mm_cvtps_epi32(glm_vec4_mul(x, _mm_set1_ps(TwoOverPi)));
+				auto j = _mm_cvtepi32_ps(quadrant);
+				auto r = glm_vec4_sub(glm_vec4_sub(glm_vec4_sub(x, glm_vec4_mul(j, _mm_set1_ps(HalfPi1))), glm_vec4_mul(j, _mm_set1_ps(HalfPi2))), glm_vec4_mul(j, _mm_set1_ps(HalfPi3)));
+				auto z = glm_vec4_mul(r, r);
+				auto s = glm_vec4_add(glm_vec4_mul(glm_vec4_mul(glm_vec4_add(glm_vec4_mul(glm_vec4_add(glm_vec4_mul(_mm_set1_ps(Sin1), z), _mm_set1_ps(Sin2)), z), _mm_set1_ps(Sin3)), z), r), r);
+				auto c = glm_vec4_add(glm_vec4_sub(glm_vec4_mul(glm_vec4_mul(glm_vec4_add(glm_vec4_mul(glm_vec4_add(glm_vec4_mul(_mm_set1_ps(Cos1), z), _mm_set1_ps(Cos2)), z), _mm_set1_ps(Cos3)), z), z), glm_vec4_mul(_mm_set1_ps(0.5f), z)), _mm_set1_ps(1.0f));
+				auto swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+				auto sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(2)), 30));
+				auto cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30));
+				sin = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, c), _mm_andnot_ps(swap, s)), sinSign);
+				cos = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, s), _mm_andnot_ps(swap, c)), cosSign);
+			}
+
+			auto ComposeSSE2(const TransformArrays &parents, const TransformArrays &locals, const TransformArrays &worlds, std::size_t count) -> void {
+				std::size_t i = 0;
+				for (; i + 4 <= count; i += 4) {
+					__m128 sin, cos;
+					auto rotation = _mm_loadu_ps(parents.rotation + i);
+					auto scaleX = _mm_loadu_ps(parents.scaleX + i);
+					auto scaleY = _mm_loadu_ps(parents.scaleY + i);
+					SinCosSSE2(rotation, sin, cos);
+					auto x = glm_vec4_mul(_mm_loadu_ps(locals.x + i), scaleX);
+					auto y = glm_vec4_mul(_mm_loadu_ps(locals.y + i), scaleY);
+					auto worldX = glm_vec4_add(_mm_loadu_ps(parents.x + i), glm_vec4_sub(glm_vec4_mul(cos, x), glm_vec4_mul(sin, y)));
+					auto worldY = glm_vec4_add(_mm_loadu_ps(parents.y + i), glm_vec4_add(glm_vec4_mul(sin, x), glm_vec4_mul(cos, y)));
+					auto worldRotation = glm_vec4_add(rotation, _mm_loadu_ps(locals.rotation + i));
+					auto worldScaleX = glm_vec4_mul(scaleX, _mm_loadu_ps(locals.scaleX + i));
+					auto worldScaleY = glm_vec4_mul(scaleY, _mm_loadu_ps(locals.scaleY + i));
+					_mm_storeu_ps(worlds.x + i, worldX);
+					_mm_storeu_ps(worlds.y + i, worldY);
+					_mm_storeu_ps(worlds.rotation + i, worldRotation);
+					_mm_storeu_ps(worlds.scaleX + i, worldScaleX);
+					_mm_storeu_ps(worlds.scaleY + i, worldScaleY);
+				}
+				ComposeScalar(parents, locals, worlds, i, count);
+			}
+
+			auto TransformPointsSSE2(const glm::mat3 &matrix, const float *x, const float *y, float *outX, float *outY, std::size_t count) -> void {
+				auto m00 = _mm_set1_ps(matrix[0][0]), m01 = _mm_set1_ps(matrix[0][1]);
+				auto m10 = _mm_set1_ps(matrix[1][0]), m11 = _mm_set1_ps(matrix[1][1]);
+				auto m20 = _mm_set1_ps(matrix[2][0]), m21 = _mm_set1_ps(matrix[2][1]);
+				std::size_t i = 0;
+				for (; i + 4 <= count; i += 4) {
+					auto px = _mm_loadu_ps(x + i);
+					auto py = _mm_loadu_ps(y + i);
+					_mm_storeu_ps(outX + i, glm_vec4_add(glm_vec4_add(glm_vec4_mul(m00, px), glm_vec4_mul(m10, py)), m20));
+					_mm_storeu_ps(outY + i, glm_vec4_add(glm_vec4_add(glm_vec4_mul(m01, px), glm_vec4_mul(m11, py)), m21));
+				}
+				TransformPointsScalar(matrix, x, y, outX, outY, i, count);
+			}
+
+			auto IntegrateSSE2(float *x, float *y, const float *velocityX, const float *velocityY, float deltaTime, std::size_t count) -> void {
+				auto dt = _mm_set1_ps(deltaTime);
+				std::size_t i = 0;
+				for (; i + 4 <= count; i += 4) {
+					_mm_storeu_ps(x + i, glm_vec4_add(_mm_loadu_ps(x + i), glm_vec4_mul(_mm_loadu_ps(velocityX + i), dt)));
+					_mm_storeu_ps(y + i, glm_vec4_add(_mm_loadu_ps(y + i), glm_vec4_mul(_mm_loadu_ps(velocityY + i), dt)));
+				}
+				IntegrateScalar(x, y, velocityX, velocityY, deltaTime, i, count);
+			}
+
+			// Q16.16 products rounded as the scalar path does, sse2 only multiplies unsigned lanes so the products are corrected for the signs
+			auto MultiplyQ16SSE2(__m128i a, __m128i b) -> __m128i {
+				auto half = _mm_set1_epi64x(std::int64_t(1) << 15);
+				auto even = _mm_srli_epi64(_mm_add_epi64(_mm_mul_epu32(a, b), half), 16);
+				auto odd = _mm_srli_epi64(_mm_add_epi64(_mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32)), half), 16);
+				auto product = _mm_or_si128(_mm_and_si128(even, _mm_set1_epi64x(0xFFFFFFFF)), _mm_slli_epi64(odd, 32));
+				auto correction = _mm_add_epi32(_mm_and_si128(_mm_srai_epi32(a, 31), b), _mm_and_si128(_mm_srai_epi32(b, 31), a));
+				return _mm_sub_epi32(product, _mm_slli_epi32(correction, 16));
+			}
+
+			auto IntegrateQ16SSE2(Q16 *x, Q16 *y, const Q16 *velocityX, const Q16 *velocityY, Q16 deltaTime, std::size_t count) -> void {
+				auto dt = _mm_set1_epi32(deltaTime.GetRaw());
+				std::size_t i = 0;
+				for (; i + 4 <= count; i += 4) {
+					auto px = reinterpret_cast<__m128i *>(x + i), py = reinterpret_cast<__m128i *>(y + i);
+					_mm_storeu_si128(px, _mm_add_epi32(_mm_loadu_si128(px), MultiplyQ16SSE2(_mm_loadu_si128(reinterpret_cast<const __m128i *>(velocityX + i)), dt)));
+					_mm_storeu_si128(py, _mm_add_epi32(_mm_loadu_si128(py), MultiplyQ16SSE2(_mm_loadu_si128(reinterpret_cast<const __m128i *>(velocityY + i)), dt)));
+				}
+				IntegrateFixedScalar(x, y, velocityX, velocityY, deltaTime, i, count);
+			}
+
+			// eight transforms at a time, compiled for avx2 whatever the build flags and only called when the processor supports it
+			SYMBIOTE_TARGET_AVX2 auto SinCosAVX2(__m256 x, __m256 &sin, __m256 &cos) -> void {
+				auto quadrant = _mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(TwoOverPi)));
+				auto j = _mm256_cvtepi32_ps(quadrant);
+				auto r = _mm256_sub_ps(_mm256_sub_ps(_mm256_sub_ps(x, _mm256_mul_ps(j, _mm256_set1_ps(HalfPi1))), _mm256_mul_ps(j, _mm256_set1_ps(HalfPi2))), _mm256_mul_ps(j, _mm256_set1_ps(HalfPi3)));
+				auto z = _mm256_mul_ps(r, r);
+				auto s = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(Sin1), z), _mm256_set1_ps(Sin2)), z), _mm256_set1_ps(Sin3)), z), r), r);
+				auto c = _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(_mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(Cos1), z), _mm256_set1_ps(Cos2)), z), _mm256_set1_ps(Cos3)), z), z), _mm256_mul_ps(_mm256_set1_ps(0.5f), z)), _mm256_set1_ps(1.0f));
+				auto swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrant, _mm256_set1_epi32(1)), _mm256_set1_epi32(1)));
+				auto sinSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(quadrant, _mm256_set1_epi32(2)), 30));
+				auto cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(quadrant, _mm256_set1_epi32(1)), _mm256_set1_epi32(2)), 30));
+				sin = _mm256_xor_ps(_mm256_blendv_ps(s, c, swap), sinSign);
+				cos = _mm256_xor_ps(_mm256_blendv_ps(c, s, swap), cosSign);
+			}
+
+			SYMBIOTE_TARGET_AVX2 auto ComposeAVX2(const TransformArrays &parents, const TransformArrays &locals, const TransformArrays &worlds, std::size_t count) -> void {
+				std::size_t i = 0;
+				for (; i + 8 <= count; i += 8) {
+					__m256 sin, cos;
+					auto rotation = _mm256_loadu_ps(parents.rotation + i);
+					auto scaleX = _mm256_loadu_ps(parents.scaleX + i);
+					auto scaleY = _mm256_loadu_ps(parents.scaleY + i);
+					SinCosAVX2(rotation, sin, cos);
+					auto x = _mm256_mul_ps(_mm256_loadu_ps(locals.x + i), scaleX);
+					auto y = _mm256_mul_ps(_mm256_loadu_ps(locals.y + i), scaleY);
+					auto worldX = _mm256_add_ps(_mm256_loadu_ps(parents.x + i), _mm256_sub_ps(_mm256_mul_ps(cos, x), _mm256_mul_ps(sin, y)));
+					auto worldY = _mm256_add_ps(_mm256_loadu_ps(parents.y + i), _mm256_add_ps(_mm256_mul_ps(sin, x), _mm256_mul_ps(cos, y)));
+					auto worldRotation = _mm256_add_ps(rotation, _mm256_loadu_ps(locals.rotation + i));
+					auto worldScaleX = _mm256_mul_ps(scaleX, _mm256_loadu_ps(locals.scaleX + i));
+					auto worldScaleY = _mm256_mul_ps(scaleY, _mm256_loadu_ps(locals.scaleY + i));
+					_mm256_storeu_ps(worlds.x + i, worldX);
+					_mm256_storeu_ps(worlds.y + i, worldY);
+					_mm256_storeu_ps(worlds.rotation + i, worldRotation);
+					_mm256_storeu_ps(worlds.scaleX + i, worldScaleX);
+					_mm256_storeu_ps(worlds.scaleY + i, worldScaleY);
+				}
+				ComposeScalar(parents, locals, worlds, i, count);
+			}
+
+			SYMBIOTE_TARGET_AVX2 auto TransformPointsAVX2(const glm::mat3 &matrix, const float *x, const float *y, float *outX, float *outY, std::size_t count) -> void {
+				auto m00 = _mm256_set1_ps(matrix[0][0]), m01 = _mm256_set1_ps(matrix[0][1]);
+				auto m10 = _mm256_set1_ps(matrix[1][0]), m11 = _mm256_set1_ps(matrix[1][1]);
+				auto m20 = _mm256_set1_ps(matrix[2][0]), m21 = _mm256_set1_ps(matrix[2][1]);
+				std::size_t i = 0;
+				for (; i + 8 <= count; i += 8) {
+					auto px = _mm256_loadu_ps(x + i);
+					auto py = _mm256_loadu_ps(y + i);
+					_mm256_storeu_ps(outX + i, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m00, px), _mm256_mul_ps(m10, py)), m20));
+					_mm256_storeu_ps(outY + i, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m01, px), _mm256_mul_ps(m11, py)), m21));
+				}
+				TransformPointsScalar(matrix, x, y, outX, outY, i, count);
+			}
+
+			SYMBIOTE_TARGET_AVX2 auto IntegrateAVX2(float *x, float *y, const float *velocityX, const float *velocityY, float deltaTime, std::size_t count) -> void {
+				auto dt = _mm256_set1_ps(deltaTime);
+				std::size_t i = 0;
+				for (; i + 8 <= count; i += 8) {
+					_mm256_storeu_ps(x + i, _mm256_add_ps(_mm256_loadu_ps(x + i), _mm256_mul_ps(_mm256_loadu_ps(velocityX + i), dt)));
+					_mm256_storeu_ps(y + i, _mm256_add_ps(_mm256_loadu_ps(y + i), _mm256_mul_ps(_mm256_loadu_ps(velocityY + i), dt)));
+				}
+				IntegrateScalar(x, y, velocityX, velocityY, deltaTime, i, count);
+			}
+
+			SYMBIOTE_TARGET_AVX2 auto MultiplyQ16AVX2(__m256i a, __m256i b) -> __m256i {
+				auto half = _mm256_set1_epi64x(std::int64_t(1) << 15);
+				auto even = _mm256_srli_epi64(_mm256_add_epi64(_mm256_mul_epi32(a, b), half), 16);
+				auto odd = _mm256_srli_epi64(_mm256_add_epi64(_mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32)), half), 16);
+				return _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+			}
+
+			SYMBIOTE_TARGET_AVX2 auto IntegrateQ16AVX2(Q16 *x, Q16 *y, const Q16 *velocityX, const Q16 *velocityY, Q16 deltaTime, std::size_t count) -> void {
+				auto dt = _mm256_set1_epi32(deltaTime.GetRaw());
+				std::size_t i = 0;
+				for (; i + 8 <= count; i += 8) {
+					auto px = reinterpret_cast<__m256i *>(x + i), py = reinterpret_cast<__m256i *>(y + i);
+					_mm256_storeu_si256(px, _mm256_add_epi32(_mm256_loadu_si256(px), MultiplyQ16AVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(velocityX + i)), dt)));
+					_mm256_storeu_si256(py, _mm256_add_epi32(_mm256_loadu_si256(py), MultiplyQ16AVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(velocityY + i)), dt)));
+				}
+				IntegrateFixedScalar(x, y, velocityX, velocityY, deltaTime, i, count);
+			}
+
+			auto SupportsAVX2() -> bool {
+#if defined(_MSC_VER)
+				int registers[4];
+				__cpuid(registers, 0);
+				if (registers[0] < 7) {
+					return false;
+				}
+				// the operating system must save the ymm registers
+				__cpuid(registers, 1);
+				if ((registers[2] & (1 << 27)) == 0 || (_xgetbv(0) & 6) != 6) {
+					return false;
+				}
+				__cpuidex(registers, 7, 0);
+				return (registers[1] & (1 << 5)) != 0;
+#else
+				__builtin_cpu_init();
+				return __builtin_cpu_supports("avx2");
+#endif
+			}
+#endif
+
+			auto DetectSimdLevel() -> SimdLevel {
+#if SYMBIOTE_BATCH_X86
+				return SupportsAVX2() ? SimdLevel::AVX2 : SimdLevel::SSE2;
+#else
+				return SimdLevel::Scalar;
+#endif
+			}
+
+			const SimdLevel SupportedLevel = DetectSimdLevel();
+			SimdLevel CurrentLevel = SupportedLevel;
+		} // namespace
+
+		auto GetSimdLevel() -> SimdLevel {
+			return CurrentLevel;
+		}
+
+		auto GetSupportedSimdLevel() -> SimdLevel {
+			return SupportedLevel;
+		}
+
+		auto SetSimdLevel(SimdLevel level) -> void {
+			if (static_cast<int>(level) > static_cast<int>(SupportedLevel)) {
+				throw std::logic_error("SetSimdLevel: the processor does not support this instruction set");
+			}
+			CurrentLevel = level;
+		}
+
+		auto ComposeTransforms(const TransformArrays &parents, const TransformArrays &locals, const TransformArrays &worlds, std::size_t count) -> void {
+			switch (CurrentLevel) {
+#if SYMBIOTE_BATCH_X86
+				case SimdLevel::AVX2:
+					return ComposeAVX2(parents, locals, worlds, count);
+				case SimdLevel::SSE2:
+					return ComposeSSE2(parents, locals, worlds, count);
+#endif
+				default:
+					return ComposeScalar(parents, locals, worlds, 0, count);
+			}
+		}
+
+		auto TransformPoints(const glm::mat3 &matrix, const float *x, const float *y, float *outX, float *outY, std::size_t count) -> void {
+			switch (CurrentLevel) {
+#if SYMBIOTE_BATCH_X86
+				case SimdLevel::AVX2:
+					return TransformPointsAVX2(matrix, x, y, outX, outY, count);
+				case SimdLevel::SSE2:
+					return TransformPointsSSE2(matrix, x, y, outX, outY, count);
+#endif
+				default:
+					return TransformPointsScalar(matrix, x, y, outX, outY, 0, count);
+			}
+		}
+
+		auto IntegrateVelocities(float *x, float *y, const float *velocityX, const float *velocityY, float deltaTime, std::size_t count) -> void {
+			switch (CurrentLevel) {
+#if SYMBIOTE_BATCH_X86
+				case SimdLevel::AVX2:
+					return IntegrateAVX2(x, y, velocityX, velocityY, deltaTime, count);
+				case SimdLevel::SSE2:
+					return IntegrateSSE2(x, y, velocityX, velocityY, deltaTime, count);
+#endif
+				default:
+					return IntegrateScalar(x, y, velocityX, velocityY, deltaTime, 0, count);
+			}
+		}
+
+		auto IntegrateVelocities(Q16 *x, Q16 *y, const Q16 *velocityX, const Q16 *velocityY, Q16 deltaTime, std::size_t count) -> void {
+			switch (CurrentLevel) {
+#if SYMBIOTE_BATCH_X86
+				case SimdLevel::AVX2:
+					return IntegrateQ16AVX2(x, y, velocityX, velocityY, deltaTime, count);
+				case SimdLevel::SSE2:
+					return IntegrateQ16SSE2(x, y, velocityX, velocityY, deltaTime, count);
+#endif
+				default:
+					return IntegrateFixedScalar(x, y, velocityX, velocityY, deltaTime, 0, count);
+			}
+		}
+
+		auto IntegrateVelocities(Q32 *x, Q32 *y, const Q32 *velocityX, const Q32 *velocityY, Q32 deltaTime, std::size_t count) -> void {
+			IntegrateFixedScalar(x, y, velocityX, velocityY, deltaTime, 0, count);
+		}
+
+	} // namespace Core
+} // namespace Symbiote
@@ -0,0 +1,130 @@
+#include <cstddef>
+#include <cstdint>
+
+#include "core/math/fixed.hpp"
+
+namespace Symbiote {
+	namespace Core {
+
+		namespace {
+			// a quarter of sine in SineSteps steps as Q2.30, the Taylor series is summed in Q3.61 so that the table is the same for every build
+			constexpr int SineBits = 12;
+			constexpr std::size_t SineSteps = std::size_t(1) << SineBits;
+			constexpr Int128 HalfPiQ61 = 3622009729038561421;
+			// 2 / pi, to turn radians into quarter turns with a product in the wide type
+			constexpr std::int64_t TwoOverPiQ30 = 683565276;
+			constexpr std::int64_t TwoOverPiQ62 = 2935890503282001226;
+
+			struct SineTable {
+				std::int32_t values[SineSteps + 1] = {};
+			};
+
+			constexpr auto MakeSineTable() -> SineTable {
+				SineTable table;
+				for (std::size_t step = 0; step <= SineSteps; step++) {
+					auto x = HalfPiQ61 * static_cast<Int128>(step) / static_cast<Int128>(SineSteps);
+					auto square = (x * x) >> 61;
+					auto term = x;
+					auto sum = x;
+					for (int n = 1; n < 12; n++) {
+						term = -((term * square) >> 61) / ((2 * n) * (2 * n + 1));
+						sum += term;
+					}
+					table.values[step] = static_cast<std::int32_t>((sum + (static_cast<Int128>(1) << 30)) >> 31);
+				}
+				return table;
+			}
+
+			constexpr SineTable Sines = MakeSineTable();
+
+			// the square root of an integer, rounded to the nearest
+			template <typename Unsigned>
+			auto SquareRoot(Unsigned value) -> Unsigned {
+				Unsigned root = 0;
+				auto bit = static_cast<Unsigned>(1) << (sizeof(Unsigned) * 8 - 2);
+				while (bit > value) {
+					bit >>= 2;
+				}
+				while (bit != 0) {
+					if (value >= root + bit) {
+						value -= root + bit;
+						root = (root >> 1) + bit;
+					} else {
+						root >>= 1;
+					}
+					bit >>= 2;
+				}
+				// value is what remains beyond root^2
+				return value > root ? root + 1 : root;
+			}
+
+			template <typename Fixed, typename Unsigned>
+			auto SquareRoot(Fixed value) -> Fixed {
+				if (value.GetRaw() <= 0) {
+					return Fixed(0);
+				}
+				return Fixed::FromRaw(static_cast<typename Fixed::Raw>(SquareRoot(static_cast<Unsigned>(value.GetRaw()) << Fixed::Fraction)));
+			}
+
+			// angles in quarter turns keep 32 bits after the point whatever the type
+			constexpr int QuarterBits = 32;
+			constexpr std::int64_t Quarter = std::int64_t(1) << QuarterBits;
+
+			template <typename Fixed>
+			auto SineOfQuarters(typename Fixed::WideRaw quarters) -> Fixed {
+				constexpr auto fraction = Fixed::Fraction;
+				constexpr auto restBits = QuarterBits - SineBits;
+				auto quadrant = static_cast<int>((quarters >> QuarterBits) & 3);
+				auto position = static_cast<std::int64_t>(quarters & (Quarter - 1));
+				if ((quadrant & 1) != 0) {
+					position = Quarter - position;
+				}
+				auto index = static_cast<std::size_t>(position >> restBits);
+				auto rest = position & ((std::int64_t(1) << restBits) - 1);
+				std::int64_t value = Sines.values[index];
+				if (index < SineSteps) {
+					value += ((Sines.values[index + 1] - value) * rest + (std::int64_t(1) << (restBits - 1))) >> restBits;
+				}
+				if constexpr (fraction >= 30) {
+					value <<= fraction - 30;
+				} else {
+					value = (value + (std::int64_t(1) << (29 - fraction))) >> (30 - fraction);
+				}
+				return Fixed::FromRaw(static_cast<typename Fixed::Raw>(quadrant >= 2 ? -value : value));
+			}
+
+			auto ToQuarters(Q16 angle) -> std::int64_t {
+				return (static_cast<std::int64_t>(angle.GetRaw()) * TwoOverPiQ30) >> (30 + Q16::Fraction - QuarterBits);
+			}
+
+			auto ToQuarters(Q32 angle) -> Int128 {
+				return (static_cast<Int128>(angle.GetRaw()) * TwoOverPiQ62) >> (62 + Q32::Fraction - QuarterBits);
+			}
+		} // namespace
+
+		auto Sqrt(Q16 value) -> Q16 {
+			return SquareRoot<Q16, std::uint64_t>(value);
+		}
+
+		auto Sqrt(Q32 value) -> Q32 {
+			return SquareRoot<Q32, UInt128>(value);
+		}
+
+		auto Sin(Q16 angle) -> Q16 {
+			return SineOfQuarters<Q16>(ToQuarters(angle));
+		}
+
+		auto Sin(Q32 angle) -> Q32 {
+			return SineOfQuarters<Q32>(ToQuarters(angle));
+		}
+
+		auto Cos(Q16 angle) -> Q16 {
+			return SineOfQuarters<Q16>(ToQuarters(angle) + Quarter);
+		}
+
+		auto Cos(Q32 angle) -> Q32 {
+			return SineOfQuarters<Q32>(ToQuarters(angle) + Quarter);
+		}
+
+	} // namespace Core
+} // namespace Symbiote
@@ -0,0 +1,120 @@
+#include <chrono>
+#include <ostream>
+#include <algorithm>
+
+#include "core/profiler/profiler.hpp"
+
+namespace Symbiote {
+	namespace Core {
+
+		namespace {
+			const auto sEpoch = std::chrono::steady_clock::now();
+			std::atomic<std::uint64_t> sNextProfilerId = {1};
+
+			auto WriteJsonString(std::ostream &os, const char *string) -> void {
+				os << '"';
+				for (auto c = string; *c != '\0'; c++) {
+					if (*c == '"' || *c == '\\') {
+						os << '\\';
+					}
+					os << *c;
+				}
+				os << '"';
+			}
+		} // namespace
+
+		Profiler::Profiler() : mId(sNextProfilerId++) {
+		}
+
+		auto Profiler::Get() -> Profiler & {
+			static Profiler profiler;
+			return profiler;
+		}
+
+		auto Profiler::Now() -> std::uint64_t {
+			return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - sEpoch).count());
+		}
+
+		auto Profiler::Record(const char *name, std::uint64_t begin, std::uint64_t end) -> void {
+			auto &buffer = GetThreadBuffer();
+			// single producer: only the owning thread writes, readers use the published counter
+			auto written = buffer.written.load(std::memory_order_relaxed);
+			buffer.events[written % BufferSize] = {name, begin, end, buffer.threadId};
+			buffer.written.store(written + 1, std::memory_order_release);
+		}
+
+		auto Profiler::Collect() const -> std::vector<Event> {
+			std::vector<Event> events;
+			std::lock_guard<std::mutex> lock(mMutex);
+			for (const auto &buffer : mBuffers) {
+				auto written = buffer->written.load(std::memory_order_acquire);
+				// the slot after the newest event may already be in the middle of a write, keep it out of the window
+				auto first = std::max(buffer->cleared.load(), written >= BufferSize ? written - BufferSize + 1 : 0);
+				auto collected = events.size();
+				for (auto i = first; i < written; i++) {
+					events.emplace_back(buffer->events[i % BufferSize]);
+				}
+				// drop the events the owning thread may have overwritten while we were copying
+				auto overwritten = buffer->written.load(std::memory_order_acquire);
+				if (overwritten + 1 > first + BufferSize) {
+					auto torn = std::min<std::uint64_t>(written - first, overwritten + 1 - BufferSize - first);
+					events.erase(events.begin() + collected, events.begin() + collected + torn);
+				}
+			}
+			std::sort(events.begin(), events.end(), [](const auto &a, const auto &b) { return a.begin < b.begin; });
+			return events;
+		}
+
+		auto Profiler::Clear() -> void {
+			std::lock_guard<std::mutex> lock(mMutex);
+			for (auto &buffer : mBuffers) {
+				buffer->cleared.store(buffer->written.load());
+			}
+		}
+
+		auto Profiler::WriteChromeTrace(std::ostream &os) const -> void {
+			auto events = Collect();
+			auto precision = os.precision(3);
+			auto flags = os.setf(std::ios::fixed, std::ios::floatfield);
+			os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+			for (std::size_t i = 0; i < events.size(); i++) {
+				const auto &event = events[i];
+				os << (i == 0 ? "" : ",") << "{\"name\":";
+				WriteJsonString(os, event.name);
+				os << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.threadId;
+				os << ",\"ts\":" << static_cast<double>(event.begin) / 1000.0;
+				os << ",\"dur\":" << static_cast<double>(event.end - event.begin) / 1000.0 << "}";
+			}
+			os << "]}";
+			os.precision(precision);
+			os.setf(flags, std::ios::floatfield);
+		}
+
+		auto Profiler::GetThreadBuffer() -> ThreadBuffer & {
+			thread_local ThreadBuffer *tBuffer = nullptr;
+			thread_local std::uint64_t tProfilerId = 0;
+			if (tProfilerId == mId) {
+				return *tBuffer;
+			}
+			std::lock_guard<std::mutex> lock(mMutex);
+			auto found = std::find_if(mBuffers.begin(), mBuffers.end(), [](const auto &buffer) { return buffer->owner == std::this_thread::get_id(); });
+			if (found == mBuffers.end()) {
+				mBuffers.emplace_back(std::make_unique<ThreadBuffer>());
+				mBuffers.back()->owner = std::this_thread::get_id();
+				mBuffers.back()->threadId = static_cast<std::uint32_t>(mBuffers.size());
+				found = mBuffers.end() - 1;
+			}
+			tBuffer = found->get();
+			tProfilerId = mId;
+			return *tBuffer;
+		}
+
+		ProfileScope::ProfileScope(const char *name) : mName(name), mBegin(Profiler::Now()) {
+		}
+
+		ProfileScope::~ProfileScope() {
+			Profiler::Get().Record(mName, mBegin, Profiler::Now());
+		}
+
+	} // namespace Core
+} // namespace Symbiote
@@ -0,0 +1,436 @@
+#include <cstring>
+#include <istream>
+#include <sstream>
+#include <stdexcept>
+
+#include "core/ecs/entitymanager.hpp"
+#include "core/jobs/jobsystem.hpp"
+#include "core/serialization/binary.hpp"
+#include "core/serialization/compression.hpp"
+#include "core/profiler/profiler.hpp"
+
+namespace Symbiote {
+	namespace Core {
+
+		namespace {
+			constexpr std::size_t MinMatch = 4;
+			constexpr std::size_t MaxOffset = 65535;
+			constexpr std::uint32_t HashBits = 16;
+			constexpr std::size_t MaxChunkSize = 1 << 20;
+
+			enum ChunkFilter : std::uint32_t {
+				RawFilter = 0,
+				DeltaFilter = 1,
+				ShuffleFilter = 2,
+			};
+
+			struct Chunk {
+				std::uint32_t filter = RawFilter;
+				std::size_t offset = 0;
+				std::size_t size = 0;
+				std::size_t compressedOffset = 0;
+				std::size_t compressedSize = 0;
+			};
+
+			auto Read32(const char *data) -> std::uint32_t {
+				std::uint32_t value;
+				std::memcpy(&value, data, sizeof(value));
+				return value;
+			}
+
+			auto Hash(std::uint32_t value) -> std::uint32_t {
+				return (value * 2654435761u) >> (32 - HashBits);
+			}
+
+			auto MatchLength(const char *data, std::size_t size, std::size_t position, std::size_t candidate) -> std::size_t {
+				auto length = MinMatch;
+				while (position + length + sizeof(std::uint64_t) <= size) {
+					std::uint64_t a, b;
+					std::memcpy(&a, data + position + length, sizeof(a));
+					std::memcpy(&b, data + candidate + length, sizeof(b));
+					if (a != b) {
+						break;
+					}
+					length += sizeof(std::uint64_t);
+				}
+				while (position + length < size && data[position + length] == data[candidate + length]) {
+					length += 1;
+				}
+				return length;
+			}
+
+			auto WriteLength(std::string &out, std::size_t length) -> void {
+				while (length >= 255) {
+					out.push_back(static_cast<char>(255));
+					length -= 255;
+				}
+				out.push_back(static_cast<char>(length));
+			}
+
+			auto ReadLength(const char *&data, const char *end) -> std::size_t {
+				std::size_t length = 0;
+				std::uint8_t byte;
+				do {
+					if (data == end) {
+						throw std::runtime_error("LzDecompress: unexpected end of block");
+					}
+					byte = static_cast<std::uint8_t>(*data++);
+					length += byte;
+				} while (byte == 255);
+				return length;
+			}
+
+			// token (literal count, match length - 4), literals, little endian offset; the last sequence has no match
+			auto WriteSequence(std::string &out, const char *literals, std::size_t literalCount, std::size_t offset, std::size_t matchLength) -> void {
+				auto matchCode = matchLength - MinMatch;
+				out.push_back(static_cast<char>((std::min<std::size_t>(literalCount, 15) << 4) | std::min<std::size_t>(matchCode, 15)));
+				if (literalCount >= 15) {
+					WriteLength(out, literalCount - 15);
+				}
+				out.append(literals, literalCount);
+				out.push_back(static_cast<char>(offset & 0xFF));
+				out.push_back(static_cast<char>(offset >> 8));
+				if (matchCode >= 15) {
+					WriteLength(out, matchCode - 15);
+				}
+			}
+
+			// matches may overlap their source, a period of at least 8 bytes lets the copy go word by word
+			auto CopyMatch(char *out, std::size_t offset, std::size_t length) -> void {
+				auto source = out - offset;
+				if (offset < sizeof(std::uint64_t)) {
+					auto period = offset * ((sizeof(std::uint64_t) + offset - 1) / offset);
+					auto head = std::min(period, length);
+					for (std::size_t i = 0; i < head; i++) {
+						out[i] = source[i];
+					}
+					out += head;
+					length -= head;
+					source = out - period;
+				}
+				while (length >= sizeof(std::uint64_t)) {
+					std::memcpy(out, source, sizeof(std::uint64_t));
+					out += sizeof(std::uint64_t);
+					source += sizeof(std::uint64_t);
+					length -= sizeof(std::uint64_t);
+				}
+				for (std::size_t i = 0; i < length; i++) {
+					out[i] = source[i];
+				}
+			}
+
+			auto DeltaEncode(char *data, std::size_t size) -> void {
+				std::uint32_t previous = 0;
+				for (std::size_t i = 0; i + sizeof(std::uint32_t) <= size; i += sizeof(std::uint32_t)) {
+					auto value = Read32(data + i);
+					auto delta = value - previous;
+					std::memcpy(data + i, &delta, sizeof(delta));
+					previous = value;
+				}
+			}
+
+			auto DeltaDecode(char *data, std::size_t size) -> void {
+				std::uint32_t previous = 0;
+				for (std::size_t i = 0; i + sizeof(std::uint32_t) <= size; i += sizeof(std::uint32_t)) {
+					previous += Read32(data + i);
+					std::memcpy(data + i, &previous, sizeof(previous));
+				}
+			}
+
+			// byte 0 of every float, then byte 1... the tail which is not a whole float is kept as is
+			auto Shuffle(const char *data, std::size_t size, char *out) -> void {
+				auto count = size / sizeof(float);
+				for (std::size_t i = 0; i < count; i++) {
+					auto value = Read32(data + i * sizeof(float));
+					out[i] = static_cast<char>(value);
+					out[count + i] = static_cast<char>(value >> 8);
+					out[count * 2 + i] = static_cast<char>(value >> 16);
+					out[count * 3 + i] = static_cast<char>(value >> 24);
+				}
+				std::memcpy(out + count * sizeof(float), data + count * sizeof(float), size - count * sizeof(float));
+			}
+
+			auto Unshuffle(const char *data, std::size_t size, char *out) -> void {
+				auto count = size / sizeof(float);
+				auto lanes = reinterpret_cast<const std::uint8_t *>(data);
+				for (std::size_t i = 0; i < count; i++) {
+					auto value = static_cast<std::uint32_t>(lanes[i]) | static_cast<std::uint32_t>(lanes[count + i]) << 8 | static_cast<std::uint32_t>(lanes[count * 2 + i]) << 16 | static_cast<std::uint32_t>(lanes[count * 3 + i]) << 24;
+					std::memcpy(out + i * sizeof(float), &value, sizeof(value));
+				}
+				std::memcpy(out + count * sizeof(float), data + count * sizeof(float), size - count * sizeof(float));
+			}
+
+			auto AddChunk(std::vector<Chunk> &chunks, std::uint32_t filter, std::size_t offset, std::size_t size) -> void {
+				if (filter == RawFilter && !chunks.empty() && chunks.back().filter == RawFilter && chunks.back().offset + chunks.back().size == offset && chunks.back().size + size <= MaxChunkSize) {
+					chunks.back().size += size;
+					return;
+				}
+				// big columns are cut further so that they are spread over the workers too
+				for (std::size_t first = 0; first < size; first += MaxChunkSize) {
+					Chunk chunk;
+					chunk.filter = filter;
+					chunk.offset = offset + first;
+					chunk.size = std::min(MaxChunkSize, size - first);
+					chunks.push_back(chunk);
+				}
+			}
+
+			auto CutSnapshot(const std::string &snapshot) -> std::vector<Chunk> {
+				MemoryStreamBuffer buffer(snapshot.data(), snapshot.size());
+				std::istream is(&buffer);
+				auto position = [&buffer, &snapshot]() { return static_cast<std::size_t>(buffer.Current() - snapshot.data()); };
+				auto skip = [&buffer](std::uint64_t size) {
+					if (!buffer.Skip(size)) {
+						throw std::runtime_error("CompressSnapshot: corrupt snapshot");
+					}
+				};
+				std::uint32_t magic, version, slotCount, freeCount, typeCount;
+				ReadBinary(is, magic);
+				ReadBinary(is, version);
+				if (magic != EntityManager::SnapshotMagic || version != EntityManager::SnapshotVersion) {
+					throw std::runtime_error("CompressSnapshot: not a current snapshot");
+				}
+				ReadBinary(is, slotCount);
+				ReadBinary(is, freeCount);
+				ReadBinary(is, typeCount);
+				skip((static_cast<std::uint64_t>(slotCount) + freeCount) * sizeof(Entity::PointerSize));
+				std::vector<std::uint32_t> layouts(typeCount);
+				for (auto &layout : layouts) {
+					std::uint32_t nameSize, elementSize;
+					ReadBinary(is, nameSize);
+					skip(nameSize);
+					ReadBinary(is, layout);
+					ReadBinary(is, elementSize);
+				}
+
+				std::vector<Chunk> chunks;
+				AddChunk(chunks, RawFilter, 0, position());
+				for (std::uint32_t i = 0; i < typeCount; i++) {
+					auto begin = position();
+					std::uint32_t typeIndex, count;
+					std::uint64_t blockSize;
+					ReadBinary(is, typeIndex);
+					ReadBinary(is, blockSize);
+					if (typeIndex >= typeCount || blockSize > buffer.Remaining()) {
+						throw std::runtime_error("CompressSnapshot: corrupt snapshot");
+					}
+					auto blockEnd = position() + blockSize;
+					ReadBinary(is, count);
+					AddChunk(chunks, RawFilter, begin, position() - begin);
+					auto entities = static_cast<std::uint64_t>(count) * sizeof(Entity::PointerSize);
+					if (entities > blockEnd - position()) {
+						throw std::runtime_error("CompressSnapshot: corrupt snapshot");
+					}
+					AddChunk(chunks, DeltaFilter, position(), entities);
+					skip(entities);
+					if (layouts[typeIndex] == ColumnLayout) {
+						begin = position();
+						std::uint32_t padding;
+						ReadBinary(is, padding);
+						if (padding > blockEnd - position()) {
+							throw std::runtime_error("CompressSnapshot: corrupt snapshot");
+						}
+						skip(padding);
+						AddChunk(chunks, RawFilter, begin, position() - begin);
+					} else if (layouts[typeIndex] == InstanceLayout) {
+						auto offsets = (static_cast<std::uint64_t>(count) + 1) * sizeof(std::uint32_t);
+						if (offsets > blockEnd - position()) {
+							throw std::runtime_error("CompressSnapshot: corrupt snapshot");
+						}
+						AddChunk(chunks, DeltaFilter, position(), offsets);
+						skip(offsets);
+					}
+					AddChunk(chunks, ShuffleFilter, position(), blockEnd - position());
+					skip(blockEnd - position());
+				}
+				AddChunk(chunks, RawFilter, position(), buffer.Remaining());
+				return chunks;
+			}
+
+			auto ForEachChunk(JobSystem *jobs, std::size_t count, JobSystem::RangeJob const &job) -> void {
+				if (jobs != nullptr) {
+					jobs->ParallelFor(0, count, 1, job);
+				} else {
+					job(0, count);
+				}
+			}
+		} // namespace
+
+		auto LzCompress(const char *data, std::size_t size, std::string &out) -> void {
+			std::vector<std::uint32_t> table(std::size_t{1} << HashBits, 0);
+			std::size_t anchor = 0;
+			std::size_t position = 0;
+			std::size_t misses = 0;
+			while (position + MinMatch <= size) {
+				auto value = Read32(data + position);
+				auto hash = Hash(value);
+				std::size_t candidate = table[hash];
+				table[hash] = static_cast<std::uint32_t>(position);
+				if (candidate >= position || position - candidate > MaxOffset || Read32(data + candidate) != value) {
+					// incompressible data is skipped faster and faster
+					position += 1 + (misses++ >> 6);
+					continue;
+				}
+				while (position > anchor && candidate > 0 && data[position - 1] == data[candidate - 1]) {
+					position -= 1;
+					candidate -= 1;
+				}
+				auto length = MatchLength(data, size, position, candidate);
+				WriteSequence(out, data + anchor, position - anchor, position - candidate, length);
+				position += length;
+				anchor = position;
+				misses = 0;
+				if (position + MinMatch <= size + 2) {
+					table[Hash(Read32(data + position - 2))] = static_cast<std::uint32_t>(position - 2);
+				}
+			}
+			if (anchor < size) {
+				auto literalCount = size - anchor;
+				out.push_back(static_cast<char>(std::min<std::size_t>(literalCount, 15) << 4));
+				if (literalCount >= 15) {
+					WriteLength(out, literalCount - 15);
+				}
+				out.append(data + anchor, literalCount);
+			}
+		}
+
+		auto LzDecompress(const char *data, std::size_t size, char *out, std::size_t outSize) -> void {
+			auto end = data + size;
+			std::size_t position = 0;
+			while (data != end) {
+				auto token = static_cast<std::uint8_t>(*data++);
+				std::size_t literalCount = token >> 4;
+				if (literalCount == 15) {
+					literalCount += ReadLength(data, end);
+				}
+				if (literalCount > static_cast<std::size_t>(end - data) || literalCount > outSize - position) {
+					throw std::runtime_error("LzDecompress: corrupt block");
+				}
+				std::memcpy(out + position, data, literalCount);
+				data += literalCount;
+				position += literalCount;
+				if (data == end) {
+					break;
+				}
+				if (end - data < 2) {
+					throw std::runtime_error("LzDecompress: unexpected end of block");
+				}
+				std::size_t offset = static_cast<std::uint8_t>(data[0]) | static_cast<std::size_t>(static_cast<std::uint8_t>(data[1])) << 8;
+				data += 2;
+				std::size_t length = (token & 15) + MinMatch;
+				if ((token & 15) == 15) {
+					length += ReadLength(data, end);
+				}
+				if (offset == 0 || offset > position || length > outSize - position) {
+					throw std::runtime_error("LzDecompress: corrupt block");
+				}
+				CopyMatch(out + position, offset, length);
+				position += length;
+			}
+			if (position != outSize) {
+				throw std::runtime_error("LzDecompress: corrupt block");
+			}
+		}
+
+		auto CompressSnapshot(const std::string &snapshot, JobSystem *jobs) -> std::string {
+			SYMBIOTE_PROFILE_SCOPE("CompressSnapshot");
+			auto chunks = CutSnapshot(snapshot);
+			std::vector<std::string> compressed(chunks.size());
+			ForEachChunk(jobs, chunks.size(), [&snapshot, &chunks, &compressed](std::size_t begin, std::size_t end) {
+				std::string filtered;
+				for (auto i = begin; i < end; i++) {
+					auto &chunk = chunks[i];
+					auto data = snapshot.data() + chunk.offset;
+					if (chunk.filter == DeltaFilter) {
+						filtered.assign(data, chunk.size);
+						DeltaEncode(&filtered[0], filtered.size());
+						data = filtered.data();
+					} else if (chunk.filter == ShuffleFilter) {
+						filtered.resize(chunk.size);
+						Shuffle(data, chunk.size, &filtered[0]);
+						data = filtered.data();
+					}
+					LzCompress(data, chunk.size, compressed[i]);
+				}
+			});
+
+			std::ostringstream os;
+			BinaryWriter writer(os);
+			writer.Write(CompressedSnapshotMagic);
+			writer.Write(CompressedSnapshotVersion);
+			writer.Write(static_cast<std::uint64_t>(snapshot.size()));
+			writer.Write(static_cast<std::uint32_t>(chunks.size()));
+			for (std::size_t i = 0; i < chunks.size(); i++) {
+				writer.Write(chunks[i].filter);
+				writer.Write(static_cast<std::uint64_t>(chunks[i].size));
+				writer.Write(static_cast<std::uint64_t>(compressed[i].size()));
+			}
+			for (const auto &bytes : compressed) {
+				writer.WriteBytes(bytes.data(), bytes.size());
+			}
+			return os.str();
+		}
+
+		auto DecompressSnapshot(const std::string &compressed, JobSystem *jobs) -> std::string {
+			SYMBIOTE_PROFILE_SCOPE("DecompressSnapshot");
+			MemoryStreamBuffer buffer(compressed.data(), compressed.size());
+			std::istream is(&buffer);
+			std::uint32_t magic, version, chunkCount;
+			std::uint64_t snapshotSize;
+			ReadBinary(is, magic);
+			ReadBinary(is, version);
+			if (magic != CompressedSnapshotMagic || version != CompressedSnapshotVersion) {
+				throw std::runtime_error("DecompressSnapshot: not a compressed snapshot");
+			}
+			ReadBinary(is, snapshotSize);
+			ReadBinary(is, chunkCount);
+			std::vector<Chunk> chunks(chunkCount);
+			std::uint64_t offset = 0, compressedOffset = 0;
+			for (auto &chunk : chunks) {
+				std::uint64_t size, compressedSize;
+				ReadBinary(is, chunk.filter);
+				ReadBinary(is, size);
+				ReadBinary(is, compressedSize);
+				if (chunk.filter > ShuffleFilter || size > snapshotSize - offset || compressedSize > buffer.Remaining()) {
+					throw std::runtime_error("DecompressSnapshot: corrupt chunk table");
+				}
+				chunk.offset = static_cast<std::size_t>(offset);
+				chunk.size = static_cast<std::size_t>(size);
+				chunk.compressedOffset = static_cast<std::size_t>(compressedOffset);
+				chunk.compressedSize = static_cast<std::size_t>(compressedSize);
+				offset += size;
+				compressedOffset += compressedSize;
+			}
+			if (offset != snapshotSize || compressedOffset != buffer.Remaining()) {
+				throw std::runtime_error("DecompressSnapshot: corrupt chunk table");
+			}
+
+			// chunks are decoded straight to their place in the snapshot
+			std::string snapshot(static_cast<std::size_t>(snapshotSize), '\0');
+			auto data = buffer.Current();
+			ForEachChunk(jobs, chunks.size(), [&snapshot, &chunks, data](std::size_t begin, std::size_t end) {
+				std::vector<char> shuffled;
+				for (auto i = begin; i < end; i++) {
+					auto &chunk = chunks[i];
+					auto out = &snapshot[0] + chunk.offset;
+					if (chunk.filter == ShuffleFilter) {
+						shuffled.resize(chunk.size);
+						LzDecompress(data + chunk.compressedOffset, chunk.compressedSize, shuffled.data(), chunk.size);
+						Unshuffle(shuffled.data(), chunk.size, out);
+					} else {
+						LzDecompress(data + chunk.compressedOffset, chunk.compressedSize, out, chunk.size);
+						if (chunk.filter == DeltaFilter) {
+							DeltaDecode(out, chunk.size);
+						}
+					}
+				}
+			});
+			return snapshot;
+		}
+
+		auto IsCompressedSnapshot(const std::string &bytes) -> bool {
+			return bytes.size() >= sizeof(CompressedSnapshotMagic) && Read32(bytes.data()) == CompressedSnapshotMagic;
+		}
+
+	} // namespace Core
+} // namespace Symbiote
@@ -0,0 +1,716 @@
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+
+#include "core/ecs/entitymanager.hpp"
+#include "core/serialization/delta.hpp"
+#include "core/serialization/hash.hpp"
+#include "core/serialization/binary.hpp"
+#include "core/profiler/profiler.hpp"
+
+namespace Symbiote {
+	namespace Core {
+
+		namespace {
+			enum SnapshotChainFrame : std::uint32_t {
+				KeyFrame = 0,
+				DeltaFrame = 1,
+			};
+
+			struct BlockView {
+				std::string name = {};
+				std::uint32_t layout = InstanceLayout;
+				std::uint32_t elementSize = 0;
+				std::vector<Entity::PointerSize> entities = {};
+				std::vector<std::uint32_t> sizes = {};
+				std::vector<const char *> records = {};
+				std::vector<const char *> pages = {};
+				std::size_t perPage = 0;
+				const char *payload = nullptr;
+				std::size_t payloadSize = 0;
+
+				// column records are found in their page, instance records through their offset
+				auto RecordData(std::size_t record) const -> const char * {
+					return layout == ColumnLayout ? pages[record / perPage] + record % perPage * elementSize : records[record];
+				}
+				auto RecordSize(std::size_t record) const -> std::uint32_t {
+					return layout == ColumnLayout ? elementSize : sizes[record];
+				}
+			};
+
+			struct SnapshotView {
+				std::vector<Entity::PointerSize> versions = {};
+				std::vector<Entity::PointerSize> freeIndexes = {};
+				std::vector<BlockView> blocks = {};
+			};
+
+			auto ParseSnapshot(const std::string &bytes) -> SnapshotView {
+				MemoryStreamBuffer buffer(bytes.data(), bytes.size());
+				std::istream is(&buffer);
+				std::uint32_t magic, version, slotCount, freeCount, typeCount;
+				ReadBinary(is, magic);
+				ReadBinary(is, version);
+				if (magic != EntityManager::SnapshotMagic || version != EntityManager::SnapshotVersion) {
+					throw std::runtime_error("ParseSnapshot: not a current snapshot");
+				}
+				ReadBinary(is, slotCount);
+				ReadBinary(is, freeCount);
+				ReadBinary(is, typeCount);
+
+				SnapshotView view;
+				ReadBinary(is, view.versions, slotCount);
+				ReadBinary(is, view.freeIndexes, freeCount);
+				view.blocks.resize(typeCount);
+				for (auto &block : view.blocks) {
+					std::uint32_t nameSize;
+					ReadBinary(is, nameSize);
+					block.name.resize(nameSize);
+					if (!is.read(&block.name[0], nameSize)) {
+						throw std::runtime_error("ParseSnapshot: unexpected end of stream");
+					}
+					ReadBinary(is, block.layout);
+					ReadBinary(is, block.elementSize);
+				}
+				std::vector<std::uint32_t> offsets;
+				for (std::uint32_t i = 0; i < typeCount; i++) {
+					std::uint32_t typeIndex, count;
+					std::uint64_t blockSize;
+					ReadBinary(is, typeIndex);
+					ReadBinary(is, blockSize);
+					if (typeIndex >= typeCount || blockSize > buffer.Remaining()) {
+						throw std::runtime_error("ParseSnapshot: corrupt column block");
+					}
+					auto blockEnd = buffer.Current() + blockSize;
+					auto &block = view.blocks[typeIndex];
+					ReadBinary(is, count);
+					ReadBinary(is, block.entities, count);
+					if (block.layout == ColumnLayout) {
+						std::uint32_t padding;
+						ReadBinary(is, padding);
+						if (block.elementSize == 0 || block.elementSize > ComponentColumn::PageSize) {
+							throw std::runtime_error("ParseSnapshot: corrupt column block");
+						}
+						block.perPage = ComponentColumn::PageSize / block.elementSize;
+						auto pageCount = (count + block.perPage - 1) / block.perPage;
+						if (buffer.Current() + padding + pageCount * ComponentColumn::PageSize > blockEnd) {
+							throw std::runtime_error("ParseSnapshot: corrupt column block");
+						}
+						for (std::size_t page = 0; page < pageCount; page++) {
+							block.pages.push_back(buffer.Current() + padding + page * ComponentColumn::PageSize);
+						}
+					} else if (block.layout == FieldLayout) {
+						block.payload = buffer.Current();
+						block.payloadSize = static_cast<std::size_t>(blockEnd - block.payload);
+					} else {
+						ReadBinary(is, offsets, count + 1);
+						auto payload = buffer.Current();
+						block.sizes.resize(count);
+						block.records.resize(count);
+						for (std::uint32_t j = 0; j < count; j++) {
+							if (offsets[j] > offsets[j + 1] || payload + offsets[j + 1] > blockEnd) {
+								throw std::runtime_error("ParseSnapshot: corrupt column block");
+							}
+							block.sizes[j] = offsets[j + 1] - offsets[j];
+							block.records[j] = payload + offsets[j];
+						}
+					}
+					if (buffer.Current() > blockEnd || !buffer.Skip(static_cast<std::size_t>(blockEnd - buffer.Current()))) {
+						throw std::runtime_error("ParseSnapshot: corrupt column block");
+					}
+				}
+				return view;
+			}
+
+			// the same view over a capture, its column pages are the pages the world shares with it
+			auto ViewCapture(const SnapshotCapture &capture) -> SnapshotView {
+				SnapshotView view;
+				view.versions = capture.versions;
+				view.freeIndexes = capture.freeIndexes;
+				view.blocks.resize(capture.columns.size());
+				for (std::size_t i = 0; i < capture.columns.size(); i++) {
+					const auto &column = capture.columns[i];
+					auto &block = view.blocks[i];
+					block.name = column.name;
+					block.layout = column.layout;
+					block.elementSize = column.elementSize;
+					block.entities = column.entities;
+					if (column.layout == ColumnLayout) {
+						block.perPage = ComponentColumn::PageSize / column.elementSize;
+						for (const auto &page : column.pages) {
+							block.pages.push_back(page->data);
+						}
+					} else if (column.layout == FieldLayout) {
+						block.payload = column.payload.data();
+						block.payloadSize = column.payload.size();
+					} else {
+						block.sizes.resize(column.entities.size());
+						block.records.resize(column.entities.size());
+						for (std::size_t j = 0; j < column.entities.size(); j++) {
+							block.sizes[j] = column.offsets[j + 1] - column.offsets[j];
+							block.records[j] = column.payload.data() + column.offsets[j];
+						}
+					}
+				}
+				return view;
+			}
+
+			auto XorBytes(char *data, std::size_t size, const char *reference, std::size_t referenceSize) -> void {
+				size = std::min(size, referenceSize);
+				std::size_t i = 0;
+				for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t)) {
+					std::uint64_t word, referenceWord;
+					std::memcpy(&word, data + i, sizeof(word));
+					std::memcpy(&referenceWord, reference + i, sizeof(referenceWord));
+					word ^= referenceWord;
+					std::memcpy(data + i, &word, sizeof(word));
+				}
+				for (; i < size; i++) {
+					data[i] ^= reference[i];
+				}
+			}
+
+			auto WriteVarint(std::string &out, std::uint64_t value) -> void {
+				while (value >= 0x80) {
+					out.push_back(static_cast<char>(value | 0x80));
+					value >>= 7;
+				}
+				out.push_back(static_cast<char>(value));
+			}
+
+			auto ReadVarint(const char *&data, const char *end) -> std::uint64_t {
+				std::uint64_t value = 0;
+				for (auto shift = 0; shift < 64; shift += 7) {
+					if (data == end) {
+						break;
+					}
+					auto byte = static_cast<std::uint8_t>(*data++);
+					value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+					if ((byte & 0x80) == 0) {
+						return value;
+					}
+				}
+				throw std::runtime_error("ApplySnapshotDelta: corrupt run-length encoding");
+			}
+
+			auto IsZeroRun(const char *data, const char *end) -> bool {
+				std::uint64_t word;
+				if (end - data < static_cast<std::ptrdiff_t>(sizeof(word))) {
+					return false;
+				}
+				std::memcpy(&word, data, sizeof(word));
+				return word == 0;
+			}
+
+			// (zero count, literal count, literal bytes) runs, literals only end on at least 8 zero bytes
+			// bytes are appended piece by piece, zeros known in advance are counted without being scanned
+			class Encoder final {
+			public:
+				explicit Encoder(bool runLengthEncode) : mRunLengthEncode(runLengthEncode) {}
+
+			public:
+				auto AppendZeros(std::size_t count) -> void {
+					mSize += count;
+					if (mRunLengthEncode) {
+						mZeros += count;
+					} else {
+						mData.append(count, '\0');
+					}
+				}
+				auto Append(const char *data, std::size_t size) -> void {
+					mSize += size;
+					if (!mRunLengthEncode) {
+						mData.append(data, size);
+						return;
+					}
+					auto end = data + size;
+					while (data != end) {
+						auto literal = data;
+						while (IsZeroRun(literal, end)) {
+							literal += sizeof(std::uint64_t);
+						}
+						while (literal != end && *literal == 0) {
+							literal += 1;
+						}
+						mZeros += static_cast<std::uint64_t>(literal - data);
+						auto literalEnd = literal;
+						while (literalEnd != end && !IsZeroRun(literalEnd, end)) {
+							literalEnd += 1;
+						}
+						if (literalEnd != literal) {
+							WriteVarint(mData, mZeros);
+							WriteVarint(mData, static_cast<std::uint64_t>(literalEnd - literal));
+							mData.append(literal, literalEnd);
+							mZeros = 0;
+						}
+						data = literalEnd;
+					}
+				}
+				auto Write(BinaryWriter &writer) -> void {
+					if (mZeros != 0) {
+						WriteVarint(mData, mZeros);
+						WriteVarint(mData, 0);
+						mZeros = 0;
+					}
+					writer.Write(static_cast<std::uint64_t>(mSize));
+					writer.Write(static_cast<std::uint64_t>(mData.size()));
+					writer.WriteBytes(mData.data(), mData.size());
+				}
+
+			private:
+				bool mRunLengthEncode;
+				std::size_t mSize = 0;
+				std::uint64_t mZeros = 0;
+				std::string mData = {};
+			};
+
+			auto RunLengthDecode(const char *data, std::size_t size, std::string &out) -> void {
+				auto end = data + size;
+				std::size_t position = 0;
+				while (data != end) {
+					auto zeros = ReadVarint(data, end);
+					auto literals = ReadVarint(data, end);
+					if (zeros > out.size() - position || literals > out.size() - position - zeros || literals > static_cast<std::uint64_t>(end - data)) {
+						throw std::runtime_error("ApplySnapshotDelta: corrupt run-length encoding");
+					}
+					position += zeros;
+					std::memcpy(&out[position], data, literals);
+					position += literals;
+					data += literals;
+				}
+			}
+
+			auto WriteEncoded(BinaryWriter &writer, const std::string &data, bool runLengthEncode) -> void {
+				Encoder encoder(runLengthEncode);
+				encoder.Append(data.data(), data.size());
+				encoder.Write(writer);
+			}
+
+			auto ReadEncoded(std::istream &is, MemoryStreamBuffer &buffer, bool runLengthEncoded) -> std::string {
+				std::uint64_t size, encodedSize;
+				ReadBinary(is, size);
+				ReadBinary(is, encodedSize);
+				if (encodedSize > buffer.Remaining() || (!runLengthEncoded && encodedSize != size)) {
+					throw std::runtime_error("ApplySnapshotDelta: corrupt delta");
+				}
+				std::string data;
+				if (runLengthEncoded) {
+					data.assign(size, '\0');
+					RunLengthDecode(buffer.Current(), encodedSize, data);
+				} else {
+					data.assign(buffer.Current(), encodedSize);
+				}
+				buffer.Skip(encodedSize);
+				return data;
+			}
+
+			template<typename T>
+			auto ToBytes(std::vector<T> const &values) -> std::string {
+				return {reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T)};
+			}
+
+			template<typename T>
+			auto FromBytes(const std::string &bytes, std::vector<T> &values) -> void {
+				if (bytes.size() % sizeof(T) != 0) {
+					throw std::runtime_error("ApplySnapshotDelta: corrupt delta");
+				}
+				values.resize(bytes.size() / sizeof(T));
+				if (!bytes.empty()) {
+					std::memcpy(values.data(), bytes.data(), bytes.size());
+				}
+			}
+
+			// entity index -> record index in a baseline block
+			auto IndexRecords(const BlockView &block) -> std::vector<std::uint32_t> {
+				std::vector<std::uint32_t> records;
+				if (!block.entities.empty()) {
+					records.resize(*std::max_element(block.entities.begin(), block.entities.end()) + 1, ComponentColumn::InvalidSlot);
+				}
+				for (std::uint32_t i = 0; i < block.entities.size(); i++) {
+					records[block.entities[i]] = i;
+				}
+				return records;
+			}
+
+			auto FindRecord(std::vector<std::uint32_t> const &records, Entity::PointerSize index) -> std::uint32_t {
+				return index < records.size() ? records[index] : ComponentColumn::InvalidSlot;
+			}
+
+			// the same components in the same order, compared page per page instead of component per component
+			auto IsSameColumn(const BlockView &block, const BlockView &baselineBlock) -> bool {
+				return block.layout == ColumnLayout && baselineBlock.layout == ColumnLayout && block.elementSize == baselineBlock.elementSize && block.entities == baselineBlock.entities;
+			}
+
+			template<typename F>
+			auto ForEachPage(const BlockView &block, F const &function) -> void {
+				auto perPage = ComponentColumn::PageSize / block.elementSize;
+				for (std::size_t first = 0; first < block.entities.size(); first += perPage) {
+					function(first, std::min(perPage, block.entities.size() - first) * block.elementSize);
+				}
+			}
+
+			auto FindBlock(const SnapshotView &view, const BlockView &block) -> const BlockView * {
+				for (const auto &candidate : view.blocks) {
+					if (candidate.name == block.name && candidate.layout == block.layout && candidate.elementSize == block.elementSize) {
+						return &candidate;
+					}
+				}
+				return nullptr;
+			}
+
+			auto EncodeDelta(const SnapshotView &baselineView, std::uint64_t baselineSize, std::uint64_t baselineHash, const SnapshotView &targetView, bool runLengthEncode) -> std::string {
+				std::ostringstream os;
+				BinaryWriter writer(os);
+				writer.Write(SnapshotDeltaMagic);
+				writer.Write(SnapshotDeltaVersion);
+				writer.Write(static_cast<std::uint32_t>(runLengthEncode ? 1 : 0));
+				writer.Write(baselineSize);
+				writer.Write(baselineHash);
+				writer.Write(static_cast<std::uint32_t>(targetView.versions.size()));
+				writer.Write(static_cast<std::uint32_t>(targetView.freeIndexes.size()));
+				writer.Write(static_cast<std::uint32_t>(targetView.blocks.size()));
+
+				auto versions = ToBytes(targetView.versions);
+				auto baselineVersions = ToBytes(baselineView.versions);
+				XorBytes(&versions[0], versions.size(), baselineVersions.data(), baselineVersions.size());
+				WriteEncoded(writer, versions, runLengthEncode);
+				auto freeIndexes = ToBytes(targetView.freeIndexes);
+				auto baselineFreeIndexes = ToBytes(baselineView.freeIndexes);
+				XorBytes(&freeIndexes[0], freeIndexes.size(), baselineFreeIndexes.data(), baselineFreeIndexes.size());
+				WriteEncoded(writer, freeIndexes, runLengthEncode);
+				for (const auto &block : targetView.blocks) {
+					writer.Write(static_cast<std::uint32_t>(block.name.size()));
+					writer.WriteBytes(block.name.data(), block.name.size());
+					writer.Write(block.layout);
+					writer.Write(block.elementSize);
+				}
+
+				static const BlockView emptyBlock = {};
+				for (const auto &block : targetView.blocks) {
+					auto baselineBlock = FindBlock(baselineView, block);
+					if (baselineBlock == nullptr) {
+						baselineBlock = &emptyBlock;
+					}
+					writer.Write(static_cast<std::uint32_t>(block.entities.size()));
+
+					// components are compared with the baseline component of the same entity, new ones are stored as is
+					std::vector<std::uint32_t> sizes(block.entities.size(), 0);
+					if (IsSameColumn(block, *baselineBlock)) {
+						// pages the world still shares with a baseline capture were not written since, they are zeros without being compared
+						Encoder entities(runLengthEncode), records(runLengthEncode);
+						entities.AppendZeros(block.entities.size() * sizeof(Entity::PointerSize));
+						entities.Write(writer);
+						WriteEncoded(writer, ToBytes(sizes), runLengthEncode);
+						std::string page;
+						ForEachPage(block, [&records, &page, &block, baselineBlock](std::size_t first, std::size_t size) {
+							if (block.RecordData(first) == baselineBlock->RecordData(first)) {
+								records.AppendZeros(size);
+								return;
+							}
+							page.assign(block.RecordData(first), size);
+							XorBytes(&page[0], size, baselineBlock->RecordData(first), size);
+							records.Append(page.data(), size);
+						});
+						records.Write(writer);
+						continue;
+					}
+
+					auto entities = ToBytes(block.entities);
+					auto baselineEntities = ToBytes(baselineBlock->entities);
+					XorBytes(&entities[0], entities.size(), baselineEntities.data(), baselineEntities.size());
+					WriteEncoded(writer, entities, runLengthEncode);
+					std::string records;
+					if (block.layout == FieldLayout) {
+						// field-major payloads are compared position by position, their size is the only record size
+						records.assign(block.payload, block.payloadSize);
+						XorBytes(&records[0], records.size(), baselineBlock->payload, baselineBlock->payloadSize);
+						sizes.assign(1, static_cast<std::uint32_t>(block.payloadSize ^ baselineBlock->payloadSize));
+						WriteEncoded(writer, ToBytes(sizes), runLengthEncode);
+						WriteEncoded(writer, records, runLengthEncode);
+						continue;
+					}
+					auto baselineRecords = IndexRecords(*baselineBlock);
+					for (std::size_t i = 0; i < block.entities.size(); i++) {
+						auto offset = records.size();
+						auto size = block.RecordSize(i);
+						records.append(block.RecordData(i), size);
+						sizes[i] = size;
+						auto record = FindRecord(baselineRecords, block.entities[i]);
+						if (record != ComponentColumn::InvalidSlot) {
+							sizes[i] ^= baselineBlock->RecordSize(record);
+							if (size == baselineBlock->RecordSize(record)) {
+								XorBytes(&records[offset], size, baselineBlock->RecordData(record), size);
+							}
+						}
+					}
+					WriteEncoded(writer, ToBytes(sizes), runLengthEncode);
+					WriteEncoded(writer, records, runLengthEncode);
+				}
+				return os.str();
+			}
+		} // namespace
+
+		auto EncodeSnapshotDelta(const std::string &baseline, const std::string &target, bool runLengthEncode) -> std::string {
+			SYMBIOTE_PROFILE_SCOPE("EncodeSnapshotDelta");
+			return EncodeDelta(ParseSnapshot(baseline), baseline.size(), HashBytes(baseline.data(), baseline.size()), ParseSnapshot(target), runLengthEncode);
+		}
+
+		auto EncodeSnapshotDelta(const std::string &baseline, const SnapshotCapture &target, bool runLengthEncode) -> std::string {
+			SYMBIOTE_PROFILE_SCOPE("EncodeSnapshotDelta");
+			return EncodeDelta(ParseSnapshot(baseline), baseline.size(), HashBytes(baseline.data(), baseline.size()), ViewCapture(target), runLengthEncode);
+		}
+
+		auto EncodeSnapshotDelta(const SnapshotDeltaBaseline &baseline, const SnapshotCapture &target, bool runLengthEncode) -> std::string {
+			SYMBIOTE_PROFILE_SCOPE("EncodeSnapshotDelta");
+			if (baseline.capture == nullptr) {
+				throw std::logic_error("EncodeSnapshotDelta: baseline has no capture");
+			}
+			return EncodeDelta(ViewCapture(*baseline.capture), baseline.snapshot.size(), baseline.hash, ViewCapture(target), runLengthEncode);
+		}
+
+		auto MakeSnapshotDeltaBaseline(std::shared_ptr<const SnapshotCapture> capture) -> SnapshotDeltaBaseline {
+			SYMBIOTE_PROFILE_SCOPE("MakeSnapshotDeltaBaseline");
+			std::ostringstream os;
+			WriteSnapshot(*capture, os);
+			SnapshotDeltaBaseline baseline;
+			baseline.capture = std::move(capture);
+			baseline.snapshot = os.str();
+			baseline.hash = HashBytes(baseline.snapshot.data(), baseline.snapshot.size());
+			return baseline;
+		}
+
+		auto ApplySnapshotDelta(const std::string &baseline, const std::string &delta) -> std::string {
+			SYMBIOTE_PROFILE_SCOPE("ApplySnapshotDelta");
+			MemoryStreamBuffer buffer(delta.data(), delta.size());
+			std::istream is(&buffer);
+			std::uint32_t magic, version, flags, slotCount, freeCount, typeCount;
+			std::uint64_t baselineSize, baselineHash;
+			ReadBinary(is, magic);
+			ReadBinary(is, version);
+			if (magic != SnapshotDeltaMagic || version != SnapshotDeltaVersion) {
+				throw std::runtime_error("ApplySnapshotDelta: not a snapshot delta");
+			}
+			ReadBinary(is, flags);
+			ReadBinary(is, baselineSize);
+			ReadBinary(is, baselineHash);
+			if (baselineSize != baseline.size() || baselineHash != HashBytes(baseline.data(), baseline.size())) {
+				throw std::runtime_error("ApplySnapshotDelta: delta was encoded against another baseline");
+			}
+			ReadBinary(is, slotCount);
+			ReadBinary(is, freeCount);
+			ReadBinary(is, typeCount);
+			auto runLengthEncoded = (flags & 1) != 0;
+			auto baselineView = ParseSnapshot(baseline);
+
+			std::vector<Entity::PointerSize> versions, freeIndexes;
+			auto bytes = ReadEncoded(is, buffer, runLengthEncoded);
+			auto baselineBytes = ToBytes(baselineView.versions);
+			XorBytes(&bytes[0], bytes.size(), baselineBytes.data(), baselineBytes.size());
+			FromBytes(bytes, versions);
+			bytes = ReadEncoded(is, buffer, runLengthEncoded);
+			baselineBytes = ToBytes(baselineView.freeIndexes);
+			XorBytes(&bytes[0], bytes.size(), baselineBytes.data(), baselineBytes.size());
+			FromBytes(bytes, freeIndexes);
+			if (versions.size() != slotCount || freeIndexes.size() != freeCount) {
+				throw std::runtime_error("ApplySnapshotDelta: corrupt delta");
+			}
+
+			std::vector<BlockView> blocks(typeCount);
+			for (auto &block : blocks) {
+				std::uint32_t nameSize;
+				ReadBinary(is, nameSize);
+				block.name.resize(nameSize);
+				if (!is.read(&block.name[0], nameSize)) {
+					throw std::runtime_error("ApplySnapshotDelta: unexpected end of stream");
+				}
+				ReadBinary(is, block.layout);
+				ReadBinary(is, block.elementSize);
+				if (block.layout == ColumnLayout && (block.elementSize == 0 || block.elementSize > ComponentColumn::PageSize)) {
+					throw std::runtime_error("ApplySnapshotDelta: corrupt delta");
+				}
+			}
+
+			std::ostringstream os;
+			BinaryWriter writer(os);
+			writer.Write(EntityManager::SnapshotMagic);
+			writer.Write(EntityManager::SnapshotVersion);
+			writer.Write(slotCount);
+			writer.Write(freeCount);
+			writer.Write(typeCount);
+			writer.Write(versions);
+			writer.Write(freeIndexes);
+			for (const auto &block : blocks) {
+				writer.Write(static_cast<std::uint32_t>(block.name.size()));
+				writer.WriteBytes(block.name.data(), block.name.size());
+				writer.Write(block.layout);
+				writer.Write(block.elementSize);
+			}
+
+			static const BlockView emptyBlock = {};
+			std::uint32_t typeIndex = 0;
+			for (auto &block : blocks) {
+				auto baselineBlock = FindBlock(baselineView, block);
+				if (baselineBlock == nullptr) {
+					baselineBlock = &emptyBlock;
+				}
+				std::uint32_t count;
+				ReadBinary(is, count);
+
+				bytes = ReadEncoded(is, buffer, runLengthEncoded);
+				baselineBytes = ToBytes(baselineBlock->entities);
+				XorBytes(&bytes[0], bytes.size(), baselineBytes.data(), baselineBytes.size());
+				FromBytes(bytes, block.entities);
+				FromBytes(ReadEncoded(is, buffer, runLengthEncoded), block.sizes);
+				auto records = ReadEncoded(is, buffer, runLengthEncoded);
+				if (block.layout == FieldLayout) {
+					if (block.entities.size() != count || block.sizes.size() != 1 || (block.sizes[0] ^ baselineBlock->payloadSize) != records.size()) {
+						throw std::runtime_error("ApplySnapshotDelta: corrupt delta");
+					}
+					XorBytes(&records[0], records.size(), baselineBlock->payload, baselineBlock->payloadSize);
+					writer.Write(typeIndex++);
+					writer.Write(static_cast<std::uint64_t>(sizeof(count) + count * sizeof(Entity::PointerSize) + records.size()));
+					writer.Write(count);
+					writer.Write(block.entities);
+					writer.WriteBytes(records.data(), records.size());
+					continue;
+				}
+				if (block.entities.size() != count || block.sizes.size() != count) {
+					throw std::runtime_error("ApplySnapshotDelta: corrupt delta");
+				}
+				std::uint64_t offset = 0;
+				auto sameColumn = IsSameColumn(block, *baselineBlock) && records.size() == count * static_cast<std::uint64_t>(block.elementSize);
+				if (sameColumn) {
+					ForEachPage(block, [&records, &block, baselineBlock](std::size_t first, std::size_t size) {
+						XorBytes(&records[first * block.elementSize], size, baselineBlock->RecordData(first), size);
+					});
+					std::fill(block.sizes.begin(), block.sizes.end(), block.elementSize);
+					offset = records.size();
+				}
+				auto baselineRecords = sameColumn ? std::vector<std::uint32_t>{} : IndexRecords(*baselineBlock);
+				for (std::size_t i = 0; !sameColumn && i < count; i++) {
+					auto record = FindRecord(baselineRecords, block.entities[i]);
+					if (record != ComponentColumn::InvalidSlot) {
+						block.sizes[i] ^= baselineBlock->RecordSize(record);
+					}
+					if (block.sizes[i] > records.size() - offset || (block.layout == ColumnLayout && block.sizes[i] != block.elementSize)) {
+						throw std::runtime_error("ApplySnapshotDelta: corrupt delta");
+					}
+					if (record != ComponentColumn::InvalidSlot && block.sizes[i] == baselineBlock->RecordSize(record)) {
+						XorBytes(&records[offset], block.sizes[i], baselineBlock->RecordData(record), block.sizes[i]);
+					}
+					offset += block.sizes[i];
+				}
+				if (offset != records.size()) {
+					throw std::runtime_error("ApplySnapshotDelta: corrupt delta");
+				}
+
+				if (block.layout == ColumnLayout) {
+					auto perPage = ComponentColumn::PageSize / block.elementSize;
+					auto pageCount = (count + perPage - 1) / perPage;
+					auto padding = ComponentColumn::PagePadding(writer.GetOffset() + sizeof(typeIndex) + sizeof(std::uint64_t) + sizeof(count) + count * sizeof(Entity::PointerSize) + sizeof(std::uint32_t));
+					writer.Write(typeIndex++);
+					writer.Write(static_cast<std::uint64_t>(sizeof(count) + count * sizeof(Entity::PointerSize) + sizeof(padding) + padding + pageCount * ComponentColumn::PageSize));
+					writer.Write(count);
+					writer.Write(block.entities);
+					writer.Write(padding);
+					writer.WriteZeros(padding);
+					for (std::size_t page = 0; page < pageCount; page++) {
+						auto pageBytes = std::min<std::size_t>(perPage, count - page * perPage) * block.elementSize;
+						writer.WriteBytes(records.data() + page * perPage * block.elementSize, pageBytes);
+						writer.WriteZeros(ComponentColumn::PageSize - pageBytes);
+					}
+				} else {
+					std::vector<std::uint32_t> offsets(1, 0);
+					for (auto size : block.sizes) {
+						offsets.push_back(offsets.back() + size);
+					}
+					writer.Write(typeIndex++);
+					writer.Write(static_cast<std::uint64_t>(sizeof(count) + count * sizeof(Entity::PointerSize) + offsets.size() * sizeof(std::uint32_t) + records.size()));
+					writer.Write(count);
+					writer.Write(block.entities);
+					writer.Write(offsets);
+					writer.WriteBytes(records.data(), records.size());
+				}
+			}
+			return os.str();
+		}
+
+		SnapshotChainWriter::SnapshotChainWriter(std::ostream &os, std::size_t keyframeInterval, bool runLengthEncode) : mStream(os), mKeyframeInterval(keyframeInterval), mRunLengthEncode(runLengthEncode) {
+			if (keyframeInterval == 0) {
+				throw std::logic_error("SnapshotChainWriter::SnapshotChainWriter: keyframeInterval must be at least 1");
+			}
+			WriteBinary(mStream, SnapshotChainMagic);
+		}
+
+		auto SnapshotChainWriter::Write(std::string snapshot) -> void {
+			auto keyframe = mFrameCount % mKeyframeInterval == 0;
+			auto frame = keyframe ? snapshot : EncodeSnapshotDelta(mPrevious, snapshot, mRunLengthEncode);
+			WriteBinary(mStream, static_cast<std::uint32_t>(keyframe ? KeyFrame : DeltaFrame));
+			WriteBinary(mStream, static_cast<std::uint64_t>(frame.size()));
+			mStream.write(frame.data(), static_cast<std::streamsize>(frame.size()));
+			mPrevious = std::move(snapshot);
+			mFrameCount += 1;
+		}
+
+		auto SnapshotChainWriter::GetFrameCount() const -> std::size_t {
+			return mFrameCount;
+		}
+
+		SnapshotChainReader::SnapshotChainReader(std::istream &is) {
+			std::uint32_t magic;
+			ReadBinary(is, magic);
+			if (magic != SnapshotChainMagic) {
+				throw std::runtime_error("SnapshotChainReader::SnapshotChainReader: not a snapshot chain");
+			}
+			std::uint32_t kind;
+			while (is.read(reinterpret_cast<char *>(&kind), sizeof(kind))) {
+				std::uint64_t size;
+				ReadBinary(is, size);
+				Frame frame;
+				frame.keyframe = kind == KeyFrame;
+				frame.bytes.resize(size);
+				if (!is.read(&frame.bytes[0], static_cast<std::streamsize>(size))) {
+					throw std::runtime_error("SnapshotChainReader::SnapshotChainReader: unexpected end of stream");
+				}
+				if (mFrames.empty() && !frame.keyframe) {
+					throw std::runtime_error("SnapshotChainReader::SnapshotChainReader: chain does not start with a keyframe");
+				}
+				mFrames.emplace_back(std::move(frame));
+			}
+			mCurrentFrame = mFrames.size();
+		}
+
+		auto SnapshotChainReader::Read(std::size_t frame) -> const std::string & {
+			if (frame >= mFrames.size()) {
+				throw std::logic_error("SnapshotChainReader::Read: frame out of range");
+			}
+			// replays from the closest keyframe unless the current frame is on the way
+			auto first = frame;
+			while (!mFrames[first].keyframe) {
+				first -= 1;
+			}
+			if (mCurrentFrame < mFrames.size() && mCurrentFrame >= first && mCurrentFrame <= frame) {
+				first = mCurrentFrame + 1;
+			} else {
+				mCurrent = mFrames[first].bytes;
+				first += 1;
+			}
+			for (auto i = first; i <= frame; i++) {
+				mCurrent = mFrames[i].keyframe ? mFrames[i].bytes : ApplySnapshotDelta(mCurrent, mFrames[i].bytes);
+			}
+			mCurrentFrame = frame;
+			return mCurrent;
+		}
+
+		auto SnapshotChainReader::GetFrameCount() const -> std::size_t {
+			return mFrames.size();
+		}
+
+		auto SnapshotChainReader::IsKeyframe(std::size_t frame) const -> bool {
+			return mFrames.at(frame).keyframe;
+		}
+
+	} // namespace Core
+} // namespace Symbiote
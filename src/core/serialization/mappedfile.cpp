@@ -0,0 +1,83 @@
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "core/serialization/mappedfile.hpp"
+
+namespace Symbiote {
+	namespace Core {
+
+#if defined(_WIN32)
+		MappedFile::MappedFile(const std::string &path) {
+			mFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (mFile == INVALID_HANDLE_VALUE) {
+				mFile = nullptr;
+				throw std::runtime_error(std::string{"MappedFile::MappedFile: cannot open "} + path);
+			}
+			LARGE_INTEGER size;
+			if (!GetFileSizeEx(mFile, &size) || size.QuadPart == 0) {
+				CloseHandle(mFile);
+				throw std::runtime_error(std::string{"MappedFile::MappedFile: cannot map empty file "} + path);
+			}
+			mSize = static_cast<std::size_t>(size.QuadPart);
+			mMapping = CreateFileMappingA(mFile, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+			if (mMapping != nullptr) {
+				mData = static_cast<char *>(MapViewOfFile(mMapping, FILE_MAP_COPY, 0, 0, 0));
+			}
+			if (mData == nullptr) {
+				if (mMapping != nullptr) {
+					CloseHandle(mMapping);
+				}
+				CloseHandle(mFile);
+				throw std::runtime_error(std::string{"MappedFile::MappedFile: cannot map "} + path);
+			}
+		}
+
+		MappedFile::~MappedFile() {
+			UnmapViewOfFile(mData);
+			CloseHandle(mMapping);
+			CloseHandle(mFile);
+		}
+#else
+		MappedFile::MappedFile(const std::string &path) {
+			auto fd = open(path.c_str(), O_RDONLY);
+			if (fd < 0) {
+				throw std::runtime_error(std::string{"MappedFile::MappedFile: cannot open "} + path);
+			}
+			struct stat status;
+			if (fstat(fd, &status) != 0 || status.st_size == 0) {
+				close(fd);
+				throw std::runtime_error(std::string{"MappedFile::MappedFile: cannot map empty file "} + path);
+			}
+			mSize = static_cast<std::size_t>(status.st_size);
+			// private writable mapping: touched pages are copied, the file is never modified
+			auto data = mmap(nullptr, mSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+			close(fd);
+			if (data == MAP_FAILED) {
+				throw std::runtime_error(std::string{"MappedFile::MappedFile: cannot map "} + path);
+			}
+			mData = static_cast<char *>(data);
+		}
+
+		MappedFile::~MappedFile() {
+			munmap(mData, mSize);
+		}
+#endif
+
+		auto MappedFile::GetData() const -> char * {
+			return mData;
+		}
+
+		auto MappedFile::GetSize() const -> std::size_t {
+			return mSize;
+		}
+
+	} // namespace Core
+} // namespace Symbiote
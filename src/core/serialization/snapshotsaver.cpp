@@ -0,0 +1,109 @@
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "core/profiler/profiler.hpp"
+#include "core/serialization/compression.hpp"
+#include "core/serialization/snapshotsaver.hpp"
+
+namespace Symbiote {
+	namespace Core {
+
+		SnapshotSaver::SnapshotSaver() : mThread([this]() { WorkerLoop(); }) {
+		}
+
+		SnapshotSaver::~SnapshotSaver() {
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				mRunning = false;
+			}
+			mCondition.notify_all();
+			mThread.join();
+		}
+
+		auto SnapshotSaver::Save(std::shared_ptr<const SnapshotCapture> capture, std::string path, std::chrono::nanoseconds stall, Callback callback, bool compress) -> std::future<Result> {
+			Request request;
+			request.capture = std::move(capture);
+			request.result.path = std::move(path);
+			request.result.stall = stall;
+			request.callback = std::move(callback);
+			request.compress = compress;
+			auto future = request.promise.get_future();
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				mRequests.emplace_back(std::move(request));
+			}
+			mCondition.notify_one();
+			return future;
+		}
+
+		auto SnapshotSaver::Wait() -> void {
+			std::unique_lock<std::mutex> lock(mMutex);
+			mIdleCondition.wait(lock, [this]() { return mRequests.empty() && !mBusy; });
+		}
+
+		auto SnapshotSaver::WorkerLoop() -> void {
+			std::unique_lock<std::mutex> lock(mMutex);
+			while (true) {
+				// pending saves are still written when the saver is destroyed
+				mCondition.wait(lock, [this]() { return !mRunning || !mRequests.empty(); });
+				if (mRequests.empty()) {
+					return;
+				}
+				auto request = std::move(mRequests.front());
+				mRequests.pop_front();
+				mBusy = true;
+				lock.unlock();
+				Write(request);
+				lock.lock();
+				mBusy = false;
+				mIdleCondition.notify_all();
+			}
+		}
+
+		auto SnapshotSaver::Write(Request &request) -> void {
+			SYMBIOTE_PROFILE_SCOPE("SnapshotSaver::Write");
+			auto &result = request.result;
+			auto begin = std::chrono::steady_clock::now();
+			try {
+				// written next to the destination then renamed, an interrupted save never leaves a truncated file
+				auto temporaryPath = result.path + ".tmp";
+				{
+					std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+					if (!file) {
+						throw std::runtime_error(std::string{"SnapshotSaver::Write: cannot open "} + temporaryPath);
+					}
+					if (request.compress) {
+						std::ostringstream snapshot;
+						WriteSnapshot(*request.capture, snapshot);
+						auto compressed = CompressSnapshot(snapshot.str());
+						file.write(compressed.data(), static_cast<std::streamsize>(compressed.size()));
+					} else {
+						WriteSnapshot(*request.capture, file);
+					}
+					result.size = static_cast<std::uint64_t>(file.tellp());
+					if (!file.flush()) {
+						throw std::runtime_error(std::string{"SnapshotSaver::Write: cannot write "} + temporaryPath);
+					}
+				}
+#if defined(_WIN32)
+				std::remove(result.path.c_str());
+#endif
+				if (std::rename(temporaryPath.c_str(), result.path.c_str()) != 0) {
+					throw std::runtime_error(std::string{"SnapshotSaver::Write: cannot rename "} + temporaryPath);
+				}
+			} catch (std::exception const &exception) {
+				result.error = exception.what();
+			}
+			// releases the captured pages before anyone is notified
+			request.capture.reset();
+			result.writeTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin);
+			if (request.callback) {
+				request.callback(result);
+			}
+			request.promise.set_value(result);
+		}
+
+	} // namespace Core
+} // namespace Symbiote
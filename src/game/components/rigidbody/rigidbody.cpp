@@ -1,3 +1,242 @@
+#include <istream>
+#include <ostream>
+
+#include "core/ecs/entitymanager.hpp"
+#include "core/serialization/binary.hpp"
+
+#include "game/systems/physics/physics.hpp"
 #include "game/components/rigidbody/rigidbody.hpp"
+#include "game/components/transform/transform.hpp"
+
+DEFINE_COMPONENT(Symbiote::Game::RigidBodyComponent);
+
+namespace Symbiote {
+	namespace Game {
+
+		namespace {
+			template<typename S, typename F>
+			auto ForEachNumber(S &saved, F const &function) -> void {
+				for (auto number : {&saved.positionX, &saved.positionY, &saved.rotation, &saved.velocityX, &saved.velocityY, &saved.angularVelocity, &saved.accelerationX, &saved.accelerationY, &saved.forceX, &saved.forceY, &saved.inverseMass, &saved.linearDamping, &saved.angularDamping, &saved.extentX, &saved.extentY, &saved.sleepTime}) {
+					function(*number);
+				}
+			}
+		} // namespace
+
+		RigidBodyComponent::~RigidBodyComponent() {
+			if (mSystem != nullptr) {
+				mSystem->Untrack(this);
+			}
+		}
+
+		auto RigidBodyComponent::GetPosition() const -> glm::vec2 {
+			return GetState().position;
+		}
+
+		auto RigidBodyComponent::GetRotation() const -> float {
+			return GetState().rotation;
+		}
+
+		auto RigidBodyComponent::SetPosition(glm::vec2 const &position) -> void {
+			auto state = GetState();
+			state.position = position;
+			SetState(state);
+			if (auto transform = mEntity.GetComponent<TransformComponent>(); transform != nullptr) {
+				transform->SetPosition(position);
+			}
+		}
+
+		auto RigidBodyComponent::SetRotation(float rotation) -> void {
+			auto state = GetState();
+			state.rotation = rotation;
+			SetState(state);
+			if (auto transform = mEntity.GetComponent<TransformComponent>(); transform != nullptr) {
+				transform->SetRotation(rotation);
+			}
+		}
+
+		auto RigidBodyComponent::GetVelocity() const -> glm::vec2 {
+			return GetState().velocity;
+		}
+
+		auto RigidBodyComponent::GetAcceleration() const -> glm::vec2 {
+			return GetState().acceleration;
+		}
+
+		auto RigidBodyComponent::GetAngularVelocity() const -> float {
+			return GetState().angularVelocity;
+		}
+
+		auto RigidBodyComponent::SetVelocity(glm::vec2 const &velocity) -> void {
+			auto state = GetState();
+			state.velocity = velocity;
+			SetState(state);
+		}
+
+		auto RigidBodyComponent::SetAcceleration(glm::vec2 const &acceleration) -> void {
+			auto state = GetState();
+			state.acceleration = acceleration;
+			SetState(state);
+		}
+
+		auto RigidBodyComponent::SetAngularVelocity(float angularVelocity) -> void {
+			auto state = GetState();
+			state.angularVelocity = angularVelocity;
+			SetState(state);
+		}
+
+		auto RigidBodyComponent::AddForce(glm::vec2 const &force) -> void {
+			auto state = GetState();
+			state.force += force;
+			SetState(state);
+		}
+
+		auto RigidBodyComponent::GetMass() const -> float {
+			auto inverseMass = GetState().inverseMass;
+			return inverseMass > 0.0f ? 1.0f / inverseMass : 0.0f;
+		}
+
+		auto RigidBodyComponent::GetLinearDamping() const -> float {
+			return GetState().linearDamping;
+		}
+
+		auto RigidBodyComponent::GetAngularDamping() const -> float {
+			return GetState().angularDamping;
+		}
+
+		auto RigidBodyComponent::SetMass(float mass) -> void {
+			auto state = GetState();
+			state.inverseMass = mass > 0.0f ? 1.0f / mass : 0.0f;
+			SetState(state);
+		}
+
+		auto RigidBodyComponent::SetLinearDamping(float damping) -> void {
+			auto state = GetState();
+			state.linearDamping = damping;
+			SetState(state);
+		}
+
+		auto RigidBodyComponent::SetAngularDamping(float damping) -> void {
+			auto state = GetState();
+			state.angularDamping = damping;
+			SetState(state);
+		}
+
+		auto RigidBodyComponent::GetShape() const -> Shape {
+			return GetState().shape;
+		}
+
+		auto RigidBodyComponent::GetExtents() const -> glm::vec2 {
+			return GetState().extents;
+		}
+
+		auto RigidBodyComponent::SetCircle(float radius) -> void {
+			auto state = GetState();
+			state.shape = Shape::Circle;
+			state.extents = {radius, radius};
+			SetState(state);
+		}
+
+		auto RigidBodyComponent::SetBox(glm::vec2 const &halfExtents) -> void {
+			auto state = GetState();
+			state.shape = Shape::Box;
+			state.extents = halfExtents;
+			SetState(state);
+		}
+
+		auto RigidBodyComponent::ClearShape() -> void {
+			auto state = GetState();
+			state.shape = Shape::None;
+			state.extents = {0, 0};
+			SetState(state);
+		}
+
+		auto RigidBodyComponent::IsSleeping() const -> bool {
+			return mSystem != nullptr && mBody >= mSystem->mAwake;
+		}
+
+		auto RigidBodyComponent::WakeUp() -> void {
+			SetState(GetState());
+		}
+
+		auto RigidBodyComponent::Serialize(std::ostream &os) const -> void {
+			SavedState saved;
+			if (mSystem != nullptr) {
+				saved = mSystem->SaveBody(mBody);
+			} else if (mSaved.has_value()) {
+				saved = *mSaved;
+			} else {
+				saved.positionX = mState.position.x;
+				saved.positionY = mState.position.y;
+				saved.rotation = mState.rotation;
+				saved.velocityX = mState.velocity.x;
+				saved.velocityY = mState.velocity.y;
+				saved.angularVelocity = mState.angularVelocity;
+				saved.accelerationX = mState.acceleration.x;
+				saved.accelerationY = mState.acceleration.y;
+				saved.forceX = mState.force.x;
+				saved.forceY = mState.force.y;
+				saved.inverseMass = mState.inverseMass;
+				saved.linearDamping = mState.linearDamping;
+				saved.angularDamping = mState.angularDamping;
+				saved.extentX = mState.extents.x;
+				saved.extentY = mState.extents.y;
+				saved.shape = mState.shape;
+			}
+			// field by field, the padding of the structure would make equal bodies hash differently
+			ForEachNumber(saved, [&os](Symbiote::Core::Real number) { Symbiote::Core::WriteBinary(os, number); });
+			Symbiote::Core::WriteBinary(os, saved.shape);
+		}
+
+		auto RigidBodyComponent::Deserialize(std::istream &is) -> void {
+			SavedState saved;
+			ForEachNumber(saved, [&is](Symbiote::Core::Real &number) { Symbiote::Core::ReadBinary(is, number); });
+			Symbiote::Core::ReadBinary(is, saved.shape);
+			mState.position = {static_cast<float>(saved.positionX), static_cast<float>(saved.positionY)};
+			mState.velocity = {static_cast<float>(saved.velocityX), static_cast<float>(saved.velocityY)};
+			mState.acceleration = {static_cast<float>(saved.accelerationX), static_cast<float>(saved.accelerationY)};
+			mState.force = {static_cast<float>(saved.forceX), static_cast<float>(saved.forceY)};
+			mState.rotation = static_cast<float>(saved.rotation);
+			mState.angularVelocity = static_cast<float>(saved.angularVelocity);
+			mState.inverseMass = static_cast<float>(saved.inverseMass);
+			mState.linearDamping = static_cast<float>(saved.linearDamping);
+			mState.angularDamping = static_cast<float>(saved.angularDamping);
+			mState.shape = saved.shape;
+			mState.extents = {static_cast<float>(saved.extentX), static_cast<float>(saved.extentY)};
+			mSaved = saved;
+		}
+
+		auto RigidBodyComponent::OnLoad() -> void {
+			// the body joins the physics system of the world it was created or moved into
+			auto system = mEntity.GetManager()->GetSystem<PhysicsSystem>();
+			if (system != mSystem) {
+				if (mSystem != nullptr) {
+					mSystem->Untrack(this);
+				}
+				if (system != nullptr) {
+					system->Track(this);
+				}
+			}
+			Component::OnLoad();
+		}
+
+		auto RigidBodyComponent::OnResolveDependencies() -> void {
+			if (mSystem != nullptr) {
+				mSystem->ResolveTransform(mBody);
+			}
+		}
+
+		auto RigidBodyComponent::GetState() const -> State {
+			return mSystem != nullptr ? mSystem->LoadBody(mBody) : mState;
+		}
+
+		auto RigidBodyComponent::SetState(State const &state) -> void {
+			if (mSystem != nullptr) {
+				mSystem->StoreBody(mBody, state);
+			} else {
+				mState = state;
+				mSaved.reset();
+			}
+		}
 
-DEFINE_COMPONENT(Symbiote::Game::RigidBodyComponent);
\ No newline at end of file
+	} // namespace Game
+} // namespace Symbiote
\ No newline at end of file
@@ -1,5 +1,13 @@
-#include <cassert>
+#include <cmath>
+#include <stdexcept>
 
+#include <glm/common.hpp>
+#include <glm/matrix.hpp>
+#include <glm/geometric.hpp>
+
+#include "core/ecs/entitymanager.hpp"
+#include "game/systems/physics/physics.hpp"
+#include "game/systems/transform/transform.hpp"
 #include "game/components/transform/transform.hpp"
 
 DEFINE_COMPONENT(Symbiote::Game::TransformComponent);
@@ -7,52 +15,208 @@ DEFINE_COMPONENT(Symbiote::Game::TransformComponent);
 namespace Symbiote {
 	namespace Game {
 
-		TransformComponent::TransformComponent(Scale const &scale, Position const &position, Rotation rotation, TransformComponent *parent) : mParent(parent), mLocalScale(scale), mLocalPosition(position), mLocalRotation(rotation) {
+		namespace {
+			auto WorldScale(TransformComponent::Matrix const &world) -> TransformComponent::Scale {
+				auto x = glm::length(glm::vec2(world[0]));
+				auto determinant = world[0][0] * world[1][1] - world[1][0] * world[0][1];
+				return {x, x != 0.0f ? determinant / x : 0.0f};
+			}
+
+			auto WorldRotation(TransformComponent::Matrix const &world) -> TransformComponent::Rotation {
+				return std::atan2(world[0][1], world[0][0]);
+			}
+
+			auto ComposeMatrix(TransformComponent::Scale const &scale, TransformComponent::Position const &position, TransformComponent::Rotation rotation) -> TransformComponent::Matrix {
+				auto cos = std::cos(rotation);
+				auto sin = std::sin(rotation);
+				return {cos * scale.x, sin * scale.x, 0.0f, -sin * scale.y, cos * scale.y, 0.0f, position.x, position.y, 1.0f};
+			}
+		} // namespace
+
+		TransformComponent::TransformComponent(Scale const &scale, Position const &position, Rotation rotation, Symbiote::Core::Entity parent) : mLocalScale(scale), mLocalPosition(position), mLocalRotation(rotation), mPreviousScale(scale), mPreviousPosition(position), mPreviousRotation(rotation) {
+			SetParent(parent);
 		}
 
-		auto TransformComponent::GetParent() -> TransformComponent * {
-			return mParent;
+		TransformComponent::~TransformComponent() {
+			// children are destroyed by the system on its next update
+			if (mSystem != nullptr) {
+				mSystem->Untrack(this);
+			}
+			if (mBody != nullptr) {
+				PhysicsSystem::DetachTransform(this);
+			}
 		}
 
-		auto TransformComponent::GetParent() const -> const TransformComponent * {
+		auto TransformComponent::GetParent() const -> Symbiote::Core::Entity {
 			return mParent;
 		}
 
-		auto TransformComponent::SetParent(TransformComponent *parent) -> void {
+		auto TransformComponent::GetDepth() const -> std::size_t {
+			std::size_t depth = 0;
+			for (auto ancestor = ResolveParent(); ancestor != nullptr; ancestor = ancestor->ResolveParent()) {
+				depth += 1;
+			}
+			return depth;
+		}
+
+		auto TransformComponent::SetParent(Symbiote::Core::Entity parent) -> void {
+			if (parent == mParent && parent.GetManager() == mParent.GetManager()) {
+				return;
+			}
+			if (parent.GetManager() != nullptr) {
+				if (!parent.IsValid() || parent.GetComponent<TransformComponent>() == nullptr) {
+					throw std::logic_error("TransformComponent::SetParent: the parent must be an entity with a transform");
+				}
+				for (const TransformComponent *ancestor = parent.GetComponent<TransformComponent>(); ancestor != nullptr; ancestor = ancestor->ResolveParent()) {
+					if (ancestor == this) {
+						throw std::logic_error("TransformComponent::SetParent: a transform cannot be parented to itself or one of its children");
+					}
+				}
+			}
 			mParent = parent;
+			if (mSystem != nullptr) {
+				// the depth-first order is rebuilt once per update, however many transforms were reparented
+				const TransformComponent *parentTransform = parent.GetManager() != nullptr ? parent.GetComponent<TransformComponent>() : nullptr;
+				mSystem->mNodes[mNode].parent = parentTransform != nullptr && parentTransform->mSystem == mSystem ? parentTransform->mNode : TransformSystem::NoParent;
+				mSystem->mOrderStale = true;
+			}
+			MarkDirty();
 		}
 
 		auto TransformComponent::GetScale(TransformCoordinates coordinates) const -> Scale {
-			if (coordinates == TransformCoordinates::World && mParent != nullptr) {
-				return mParent->mLocalScale * mLocalScale;
+			if (coordinates == TransformCoordinates::World && ResolveParent() != nullptr) {
+				return WorldScale(GetWorldMatrix());
 			}
 			return mLocalScale;
 		}
 
 		auto TransformComponent::GetPosition(TransformCoordinates coordinates) const -> Position {
-			if (coordinates == TransformCoordinates::World && mParent != nullptr) {
-				return mParent->mLocalPosition * mLocalPosition;
+			if (coordinates == TransformCoordinates::World && ResolveParent() != nullptr) {
+				return glm::vec2(GetWorldMatrix()[2]);
 			}
 			return mLocalPosition;
 		}
 
 		auto TransformComponent::GetRotation(TransformCoordinates coordinates) const -> Rotation {
-			if (coordinates == TransformCoordinates::World && mParent != nullptr) {
-				return mParent->mLocalRotation * mLocalRotation;
+			if (coordinates == TransformCoordinates::World && ResolveParent() != nullptr) {
+				return WorldRotation(GetWorldMatrix());
 			}
 			return mLocalRotation;
 		}
 
 		auto TransformComponent::SetScale(Scale const &scale, TransformCoordinates coordinates) -> void {
-			mLocalScale = scale;
+			auto parent = coordinates == TransformCoordinates::World ? ResolveParent() : nullptr;
+			if (parent != nullptr) {
+				mLocalScale = scale / WorldScale(parent->GetWorldMatrix());
+			} else {
+				mLocalScale = scale;
+			}
+			MarkDirty();
 		}
 
 		auto TransformComponent::SetPosition(Position const &position, TransformCoordinates coordinates) -> void {
-			mLocalPosition = position;
+			auto parent = coordinates == TransformCoordinates::World ? ResolveParent() : nullptr;
+			if (parent != nullptr) {
+				mLocalPosition = glm::vec2(glm::inverse(parent->GetWorldMatrix()) * glm::vec3(position, 1.0f));
+			} else {
+				mLocalPosition = position;
+			}
+			MarkDirty();
 		}
 
 		auto TransformComponent::SetRotation(Rotation const &rotation, TransformCoordinates coordinates) -> void {
-			mLocalRotation = rotation;
+			auto parent = coordinates == TransformCoordinates::World ? ResolveParent() : nullptr;
+			if (parent != nullptr) {
+				mLocalRotation = rotation - WorldRotation(parent->GetWorldMatrix());
+			} else {
+				mLocalRotation = rotation;
+			}
+			MarkDirty();
+		}
+
+		auto TransformComponent::GetLocalMatrix() const -> Matrix {
+			return ComposeMatrix(mLocalScale, mLocalPosition, mLocalRotation);
+		}
+
+		auto TransformComponent::GetWorldMatrix() const -> const Matrix & {
+			if (mSystem != nullptr && (!mSystem->mPending || mWorldGeneration == mSystem->mGeneration)) {
+				return mWorld;
+			}
+			// changed since the last update, the result is kept until the next change to the hierarchy
+			auto parent = ResolveParent();
+			mWorld = parent != nullptr ? parent->GetWorldMatrix() * GetLocalMatrix() : GetLocalMatrix();
+			if (mSystem != nullptr) {
+				mWorldGeneration = mSystem->mGeneration;
+			}
+			return mWorld;
+		}
+
+		auto TransformComponent::StorePreviousState() -> void {
+			mPreviousScale = mLocalScale;
+			mPreviousPosition = mLocalPosition;
+			mPreviousRotation = mLocalRotation;
+		}
+
+		auto TransformComponent::GetInterpolatedScale(float alpha) const -> Scale {
+			return glm::mix(mPreviousScale, mLocalScale, alpha);
+		}
+
+		auto TransformComponent::GetInterpolatedPosition(float alpha) const -> Position {
+			return glm::mix(mPreviousPosition, mLocalPosition, alpha);
+		}
+
+		auto TransformComponent::GetInterpolatedRotation(float alpha) const -> Rotation {
+			return glm::mix(mPreviousRotation, mLocalRotation, alpha);
+		}
+
+		auto TransformComponent::GetInterpolatedMatrix(float alpha) const -> Matrix {
+			// parents are interpolated too, a child follows its parent between two steps
+			auto local = ComposeMatrix(GetInterpolatedScale(alpha), GetInterpolatedPosition(alpha), GetInterpolatedRotation(alpha));
+			auto parent = ResolveParent();
+			return parent != nullptr ? parent->GetInterpolatedMatrix(alpha) * local : local;
+		}
+
+		auto TransformComponent::OnLoad() -> void {
+			// the component may have been moved from another world, where its parent handle means nothing
+			if (mParent.GetManager() != nullptr && mParent.GetManager() != mEntity.GetManager()) {
+				mParent = {};
+			}
+			// it joins the transform system of its new world
+			auto system = mEntity.GetManager()->GetSystem<TransformSystem>();
+			if (system != mSystem) {
+				if (mSystem != nullptr) {
+					mSystem->Untrack(this);
+				}
+				if (system != nullptr) {
+					system->Track(this);
+				}
+			}
+			Component::OnLoad();
+		}
+
+		auto TransformComponent::MarkDirty() -> void {
+			if (mSystem != nullptr) {
+				auto &node = mSystem->mNodes[mNode];
+				if (!node.dirty) {
+					node.dirty = true;
+					mSystem->mDirty.push_back(mNode);
+				}
+				mSystem->mPending = true;
+				mSystem->mGeneration += 1;
+			}
+		}
+
+		auto TransformComponent::ResolveParent() const -> const TransformComponent * {
+			if (mSystem != nullptr) {
+				auto parent = mSystem->mNodes[mNode].parent;
+				if (parent != TransformSystem::NoParent && mSystem->mNodes[parent].transform != nullptr) {
+					return mSystem->mNodes[parent].transform;
+				}
+			}
+			if (!mParent.IsValid()) {
+				return nullptr;
+			}
+			return mParent.GetComponent<TransformComponent>();
 		}
 
 	} // namespace Game
@@ -0,0 +1,289 @@
+#include <cstdlib>
+#include <algorithm>
+
+#include "glm/common.hpp"
+
+#include "game/systems/physics/aabbtree.hpp"
+
+namespace Symbiote {
+	namespace Game {
+
+		namespace {
+			auto GetPerimeter(glm::vec2 const &min, glm::vec2 const &max) -> float {
+				return 2.0f * ((max.x - min.x) + (max.y - min.y));
+			}
+		} // namespace
+
+		AabbTree::AabbTree(float margin) : mMargin(margin) {
+		}
+
+		auto AabbTree::CreateProxy(glm::vec2 const &min, glm::vec2 const &max, std::uint32_t body) -> std::int32_t {
+			auto proxy = AllocateNode();
+			auto &node = mNodes[proxy];
+			node.min = min - glm::vec2(mMargin, mMargin);
+			node.max = max + glm::vec2(mMargin, mMargin);
+			node.body = body;
+			node.height = 0;
+			InsertLeaf(proxy);
+			mProxyCount += 1;
+			return proxy;
+		}
+
+		auto AabbTree::DestroyProxy(std::int32_t proxy) -> void {
+			RemoveLeaf(proxy);
+			FreeNode(proxy);
+			mProxyCount -= 1;
+		}
+
+		auto AabbTree::MoveProxy(std::int32_t proxy, glm::vec2 const &min, glm::vec2 const &max, glm::vec2 const &displacement) -> bool {
+			auto &node = mNodes[proxy];
+			if (node.min.x <= min.x && node.min.y <= min.y && max.x <= node.max.x && max.y <= node.max.y) {
+				return false;
+			}
+			RemoveLeaf(proxy);
+			// the box is predicted to move along the displacement, it stays in the tree for several steps
+			node.min = min - glm::vec2(mMargin, mMargin) + glm::min(displacement, glm::vec2(0, 0));
+			node.max = max + glm::vec2(mMargin, mMargin) + glm::max(displacement, glm::vec2(0, 0));
+			InsertLeaf(proxy);
+			return true;
+		}
+
+		auto AabbTree::Rebuild() -> void {
+			std::vector<std::int32_t> leaves;
+			leaves.reserve(mProxyCount);
+			for (std::int32_t node = 0; node < static_cast<std::int32_t>(mNodes.size()); node++) {
+				if (mNodes[node].height == 0) {
+					leaves.push_back(node);
+				} else if (mNodes[node].height > 0) {
+					FreeNode(node);
+				}
+			}
+			mRoot = leaves.empty() ? NullNode : Build(leaves.data(), leaves.size());
+			if (mRoot != NullNode) {
+				mNodes[mRoot].parent = NullNode;
+			}
+		}
+
+		auto AabbTree::Build(std::int32_t *leaves, std::size_t count) -> std::int32_t {
+			if (count == 1) {
+				return leaves[0];
+			}
+			// the leaves are split at the median of their centers along the longest axis
+			auto min = mNodes[leaves[0]].min + mNodes[leaves[0]].max;
+			auto max = min;
+			for (std::size_t i = 1; i < count; i++) {
+				auto center = mNodes[leaves[i]].min + mNodes[leaves[i]].max;
+				min = glm::min(min, center);
+				max = glm::max(max, center);
+			}
+			auto axis = max.x - min.x >= max.y - min.y ? 0 : 1;
+			auto half = count / 2;
+			std::nth_element(leaves, leaves + half, leaves + count, [&](std::int32_t a, std::int32_t b) {
+				return mNodes[a].min[axis] + mNodes[a].max[axis] < mNodes[b].min[axis] + mNodes[b].max[axis];
+			});
+			auto index = AllocateNode();
+			auto child1 = Build(leaves, half);
+			auto child2 = Build(leaves + half, count - half);
+			auto &node = mNodes[index];
+			node.child1 = child1;
+			node.child2 = child2;
+			node.min = glm::min(mNodes[child1].min, mNodes[child2].min);
+			node.max = glm::max(mNodes[child1].max, mNodes[child2].max);
+			node.height = 1 + std::max(mNodes[child1].height, mNodes[child2].height);
+			mNodes[child1].parent = index;
+			mNodes[child2].parent = index;
+			return index;
+		}
+
+		auto AabbTree::GetBody(std::int32_t proxy) const -> std::uint32_t {
+			return mNodes[proxy].body;
+		}
+
+		auto AabbTree::SetBody(std::int32_t proxy, std::uint32_t body) -> void {
+			mNodes[proxy].body = body;
+		}
+
+		auto AabbTree::GetFatMin(std::int32_t proxy) const -> glm::vec2 {
+			return mNodes[proxy].min;
+		}
+
+		auto AabbTree::GetFatMax(std::int32_t proxy) const -> glm::vec2 {
+			return mNodes[proxy].max;
+		}
+
+		auto AabbTree::GetHeight() const -> std::int32_t {
+			return mRoot != NullNode ? mNodes[mRoot].height : 0;
+		}
+
+		auto AabbTree::GetProxyCount() const -> std::size_t {
+			return mProxyCount;
+		}
+
+		auto AabbTree::Validate() const -> bool {
+			return mRoot == NullNode || Validate(mRoot, NullNode);
+		}
+
+		auto AabbTree::Validate(std::int32_t index, std::int32_t parent) const -> bool {
+			auto &node = mNodes[index];
+			if (node.parent != parent) {
+				return false;
+			}
+			if (node.IsLeaf()) {
+				return node.height == 0;
+			}
+			auto &child1 = mNodes[node.child1];
+			auto &child2 = mNodes[node.child2];
+			if (node.height != 1 + std::max(child1.height, child2.height) || std::abs(child1.height - child2.height) > 1) {
+				return false;
+			}
+			if (node.min != glm::min(child1.min, child2.min) || node.max != glm::max(child1.max, child2.max)) {
+				return false;
+			}
+			return Validate(node.child1, index) && Validate(node.child2, index);
+		}
+
+		auto AabbTree::AllocateNode() -> std::int32_t {
+			if (mFree == NullNode) {
+				mNodes.emplace_back();
+				return static_cast<std::int32_t>(mNodes.size() - 1);
+			}
+			auto node = mFree;
+			mFree = mNodes[node].parent;
+			mNodes[node] = Node();
+			return node;
+		}
+
+		auto AabbTree::FreeNode(std::int32_t node) -> void {
+			mNodes[node].parent = mFree;
+			mNodes[node].height = -1;
+			mFree = node;
+		}
+
+		auto AabbTree::InsertLeaf(std::int32_t leaf) -> void {
+			if (mRoot == NullNode) {
+				mRoot = leaf;
+				mNodes[leaf].parent = NullNode;
+				return;
+			}
+			// descends towards the sibling which grows the perimeter of the tree the least
+			auto leafMin = mNodes[leaf].min;
+			auto leafMax = mNodes[leaf].max;
+			auto index = mRoot;
+			while (!mNodes[index].IsLeaf()) {
+				auto &node = mNodes[index];
+				auto perimeter = GetPerimeter(node.min, node.max);
+				auto combined = GetPerimeter(glm::min(node.min, leafMin), glm::max(node.max, leafMax));
+				auto cost = 2.0f * combined;
+				auto inheritance = 2.0f * (combined - perimeter);
+				auto childCost = [&](Node const &child) {
+					auto grown = GetPerimeter(glm::min(child.min, leafMin), glm::max(child.max, leafMax));
+					return (child.IsLeaf() ? grown : grown - GetPerimeter(child.min, child.max)) + inheritance;
+				};
+				auto cost1 = childCost(mNodes[node.child1]);
+				auto cost2 = childCost(mNodes[node.child2]);
+				if (cost < cost1 && cost < cost2) {
+					break;
+				}
+				index = cost1 < cost2 ? node.child1 : node.child2;
+			}
+			auto sibling = index;
+			auto oldParent = mNodes[sibling].parent;
+			auto newParent = AllocateNode();
+			auto &parent = mNodes[newParent];
+			parent.parent = oldParent;
+			parent.child1 = sibling;
+			parent.child2 = leaf;
+			parent.min = glm::min(mNodes[sibling].min, leafMin);
+			parent.max = glm::max(mNodes[sibling].max, leafMax);
+			parent.height = mNodes[sibling].height + 1;
+			if (oldParent != NullNode) {
+				auto &grandParent = mNodes[oldParent];
+				(grandParent.child1 == sibling ? grandParent.child1 : grandParent.child2) = newParent;
+			} else {
+				mRoot = newParent;
+			}
+			mNodes[sibling].parent = newParent;
+			mNodes[leaf].parent = newParent;
+			Refit(mNodes[leaf].parent);
+		}
+
+		auto AabbTree::RemoveLeaf(std::int32_t leaf) -> void {
+			if (leaf == mRoot) {
+				mRoot = NullNode;
+				return;
+			}
+			auto parent = mNodes[leaf].parent;
+			auto grandParent = mNodes[parent].parent;
+			auto sibling = mNodes[parent].child1 == leaf ? mNodes[parent].child2 : mNodes[parent].child1;
+			// the sibling takes the place of the parent
+			mNodes[sibling].parent = grandParent;
+			if (grandParent != NullNode) {
+				auto &node = mNodes[grandParent];
+				(node.child1 == parent ? node.child1 : node.child2) = sibling;
+				FreeNode(parent);
+				Refit(grandParent);
+			} else {
+				mRoot = sibling;
+				FreeNode(parent);
+			}
+		}
+
+		auto AabbTree::Refit(std::int32_t index) -> void {
+			// ancestors are balanced and their bounds and heights recomputed up to the root
+			while (index != NullNode) {
+				index = Balance(index);
+				auto &node = mNodes[index];
+				auto &child1 = mNodes[node.child1];
+				auto &child2 = mNodes[node.child2];
+				node.height = 1 + std::max(child1.height, child2.height);
+				node.min = glm::min(child1.min, child2.min);
+				node.max = glm::max(child1.max, child2.max);
+				index = node.parent;
+			}
+		}
+
+		auto AabbTree::Balance(std::int32_t indexA) -> std::int32_t {
+			auto &a = mNodes[indexA];
+			if (a.IsLeaf() || a.height < 2) {
+				return indexA;
+			}
+			auto indexB = a.child1;
+			auto indexC = a.child2;
+			auto balance = mNodes[indexC].height - mNodes[indexB].height;
+			if (balance >= -1 && balance <= 1) {
+				return indexA;
+			}
+			// the higher child is rotated up, the lower of its children takes its place under a
+			auto indexUp = balance > 1 ? indexC : indexB;
+			auto indexStay = balance > 1 ? indexB : indexC;
+			auto &up = mNodes[indexUp];
+			auto indexF = up.child1;
+			auto indexG = up.child2;
+			up.child1 = indexA;
+			up.parent = a.parent;
+			a.parent = indexUp;
+			if (up.parent != NullNode) {
+				auto &parent = mNodes[up.parent];
+				(parent.child1 == indexA ? parent.child1 : parent.child2) = indexUp;
+			} else {
+				mRoot = indexUp;
+			}
+			auto indexHigh = mNodes[indexF].height > mNodes[indexG].height ? indexF : indexG;
+			auto indexLow = indexHigh == indexF ? indexG : indexF;
+			auto &stay = mNodes[indexStay];
+			auto &high = mNodes[indexHigh];
+			auto &low = mNodes[indexLow];
+			up.child2 = indexHigh;
+			(balance > 1 ? a.child2 : a.child1) = indexLow;
+			low.parent = indexA;
+			a.min = glm::min(stay.min, low.min);
+			a.max = glm::max(stay.max, low.max);
+			a.height = 1 + std::max(stay.height, low.height);
+			up.min = glm::min(a.min, high.min);
+			up.max = glm::max(a.max, high.max);
+			up.height = 1 + std::max(a.height, high.height);
+			return indexUp;
+		}
+
+	} // namespace Game
+} // namespace Symbiote
\ No newline at end of file
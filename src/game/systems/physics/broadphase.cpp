@@ -0,0 +1,171 @@
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include "core/jobs/jobsystem.hpp"
+
+#include "game/systems/physics/broadphase.hpp"
+
+namespace Symbiote {
+	namespace Game {
+
+		namespace {
+			constexpr std::size_t CellsPerJob = 256;
+		} // namespace
+
+		SpatialHashGrid::SpatialHashGrid(float cellSize) : mCellSize(cellSize), mInverseCellSize(1.0f / cellSize) {
+		}
+
+		auto SpatialHashGrid::GetCellSize() const -> float {
+			return mCellSize;
+		}
+
+		auto SpatialHashGrid::GetCellCount() const -> std::size_t {
+			return mCells.size();
+		}
+
+		auto SpatialHashGrid::GetRange(float minX, float minY, float maxX, float maxY) const -> Range {
+			return {static_cast<std::int32_t>(std::floor(minX * mInverseCellSize)), static_cast<std::int32_t>(std::floor(minY * mInverseCellSize)), static_cast<std::int32_t>(std::floor(maxX * mInverseCellSize)), static_cast<std::int32_t>(std::floor(maxY * mInverseCellSize))};
+		}
+
+		auto SpatialHashGrid::Insert(std::uint32_t body, Range const &range) -> void {
+			for (auto y = range.minY; y <= range.maxY; y++) {
+				for (auto x = range.minX; x <= range.maxX; x++) {
+					auto [found, inserted] = mCellIndexes.emplace(Key(x, y), static_cast<std::uint32_t>(mCells.size()));
+					if (inserted) {
+						mCells.push_back({x, y, {}});
+					}
+					mCells[found->second].bodies.push_back(body);
+				}
+			}
+		}
+
+		auto SpatialHashGrid::Remove(std::uint32_t body, Range const &range) -> void {
+			for (auto y = range.minY; y <= range.maxY; y++) {
+				for (auto x = range.minX; x <= range.maxX; x++) {
+					auto found = mCellIndexes.find(Key(x, y));
+					auto index = found->second;
+					auto &bodies = mCells[index].bodies;
+					*std::find(bodies.begin(), bodies.end(), body) = bodies.back();
+					bodies.pop_back();
+					if (bodies.empty()) {
+						// the last cell takes the place of the empty one
+						mCellIndexes.erase(found);
+						if (index != mCells.size() - 1) {
+							mCells[index] = std::move(mCells.back());
+							mCellIndexes[Key(mCells[index].x, mCells[index].y)] = index;
+						}
+						mCells.pop_back();
+					}
+				}
+			}
+		}
+
+		auto SpatialHashGrid::Rename(std::uint32_t from, std::uint32_t to, Range const &range) -> void {
+			for (auto y = range.minY; y <= range.maxY; y++) {
+				for (auto x = range.minX; x <= range.maxX; x++) {
+					auto &bodies = mCells[mCellIndexes.find(Key(x, y))->second].bodies;
+					*std::find(bodies.begin(), bodies.end(), from) = to;
+				}
+			}
+		}
+
+		auto SpatialHashGrid::Clear(float cellSize) -> void {
+			mCellSize = cellSize;
+			mInverseCellSize = 1.0f / cellSize;
+			mCells.clear();
+			mCellIndexes.clear();
+		}
+
+		auto SpatialHashGrid::FindPairs(Bounds const &bounds, std::vector<Pair> &pairs, Symbiote::Core::JobSystem *jobs) const -> void {
+			pairs.clear();
+			// with bodies asleep, only the cells of the bodies awake can hold a pair
+			const std::uint32_t *cells = nullptr;
+			auto cellCount = mCells.size();
+			if (bounds.ranges != nullptr && bounds.asleep != std::numeric_limits<std::uint32_t>::max()) {
+				mAwakeCells.clear();
+				mMarks.resize(mCells.size());
+				for (std::uint32_t body = 0; body < bounds.asleep; body++) {
+					auto &range = bounds.ranges[body];
+					for (auto y = range.minY; y <= range.maxY; y++) {
+						for (auto x = range.minX; x <= range.maxX; x++) {
+							auto cell = mCellIndexes.find(Key(x, y))->second;
+							if (!mMarks[cell]) {
+								mMarks[cell] = true;
+								mAwakeCells.push_back(cell);
+							}
+						}
+					}
+				}
+				for (auto cell : mAwakeCells) {
+					mMarks[cell] = false;
+				}
+				cells = mAwakeCells.data();
+				cellCount = mAwakeCells.size();
+			}
+			auto chunks = (cellCount + CellsPerJob - 1) / CellsPerJob;
+			mChunkPairs.resize(std::max(chunks, mChunkPairs.size()));
+			auto job = [&](std::size_t begin, std::size_t end) {
+				auto &chunk = mChunkPairs[begin / CellsPerJob];
+				chunk.clear();
+				FindPairs(bounds, cells, begin, end, chunk);
+			};
+			if (jobs != nullptr) {
+				jobs->ParallelFor(0, cellCount, CellsPerJob, job);
+			} else {
+				for (std::size_t begin = 0; begin < cellCount; begin += CellsPerJob) {
+					job(begin, std::min(cellCount, begin + CellsPerJob));
+				}
+			}
+			// chunks are appended in cell order, the pairs come out in the same order whatever the number of threads
+			std::size_t count = 0;
+			for (std::size_t chunk = 0; chunk < chunks; chunk++) {
+				count += mChunkPairs[chunk].size();
+			}
+			pairs.reserve(count);
+			for (std::size_t chunk = 0; chunk < chunks; chunk++) {
+				pairs.insert(pairs.end(), mChunkPairs[chunk].begin(), mChunkPairs[chunk].end());
+			}
+		}
+
+		auto SpatialHashGrid::FindPairs(Bounds const &bounds, const std::uint32_t *cells, std::size_t begin, std::size_t end, std::vector<Pair> &pairs) const -> void {
+			for (auto index = begin; index < end; index++) {
+				auto cell = cells != nullptr ? cells[index] : index;
+				auto &bodies = mCells[cell].bodies;
+				auto cellX = mCells[cell].x;
+				auto cellY = mCells[cell].y;
+				for (std::size_t i = 0; i < bodies.size(); i++) {
+					auto a = bodies[i];
+					for (std::size_t j = i + 1; j < bodies.size(); j++) {
+						auto b = bodies[j];
+						if ((bounds.inverseMass[a] == 0 && bounds.inverseMass[b] == 0) || (a >= bounds.asleep && b >= bounds.asleep)) {
+							continue;
+						}
+						auto minX = std::max(bounds.minX[a], bounds.minX[b]);
+						auto minY = std::max(bounds.minY[a], bounds.minY[b]);
+						if (minX > std::min(bounds.maxX[a], bounds.maxX[b]) || minY > std::min(bounds.maxY[a], bounds.maxY[b])) {
+							continue;
+						}
+						if (static_cast<std::int32_t>(std::floor(minX * mInverseCellSize)) != cellX || static_cast<std::int32_t>(std::floor(minY * mInverseCellSize)) != cellY) {
+							continue;
+						}
+						pairs.push_back({std::min(a, b), std::max(a, b)});
+					}
+				}
+			}
+		}
+
+		auto SpatialHashGrid::IsEmpty(Range const &range) -> bool {
+			return range.minX > range.maxX || range.minY > range.maxY;
+		}
+
+		auto SpatialHashGrid::IsSame(Range const &a, Range const &b) -> bool {
+			return a.minX == b.minX && a.minY == b.minY && a.maxX == b.maxX && a.maxY == b.maxY;
+		}
+
+		auto SpatialHashGrid::Key(std::int32_t x, std::int32_t y) -> std::uint64_t {
+			return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint32_t>(y);
+		}
+
+	} // namespace Game
+} // namespace Symbiote
\ No newline at end of file
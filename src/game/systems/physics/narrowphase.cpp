@@ -0,0 +1,451 @@
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include "glm/glm.hpp"
+#include "glm/simd/common.h"
+
+#include "core/math/batch.hpp"
+#include "core/jobs/jobsystem.hpp"
+
+#include "game/systems/physics/narrowphase.hpp"
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT && !SYMBIOTE_FIXED_POINT
+#define SYMBIOTE_NARROWPHASE_X86 1
+#include <immintrin.h>
+#endif
+
+namespace Symbiote {
+	namespace Game {
+
+		namespace {
+			using Symbiote::Core::Real;
+
+			// at least a step of fixed point numbers
+			constexpr Real Epsilon = std::max(Real(1e-6f), std::numeric_limits<Real>::epsilon());
+			// the reference face is taken on the second box only when it separates clearly more, so that it does not flicker
+			constexpr Real ReferenceTolerance = 5e-4f;
+
+			// the kernels are written once over a lane type, a number for the scalar path and four floats for sse2
+			template <typename F>
+			auto Load(const Real *values) -> F;
+			template <typename F>
+			auto Splat(Real value) -> F;
+
+			template <>
+			auto Load<Real>(const Real *values) -> Real {
+				return *values;
+			}
+
+			template <>
+			auto Splat<Real>(Real value) -> Real {
+				return value;
+			}
+
+			auto Store(Real *values, Real value) -> void {
+				*values = value;
+			}
+
+			auto Min(Real a, Real b) -> Real {
+				return std::min(a, b);
+			}
+
+			auto Max(Real a, Real b) -> Real {
+				return std::max(a, b);
+			}
+
+			using Symbiote::Core::Abs;
+			using Symbiote::Core::Sqrt;
+
+			template <typename T>
+			auto Select(bool mask, T a, T b) -> T {
+				return mask ? a : b;
+			}
+
+#if SYMBIOTE_NARROWPHASE_X86
+			// comparisons give masks of all bits set, which select with and/andnot
+			struct Float4 {
+				__m128 v;
+			};
+
+			template <>
+			auto Load<Float4>(const float *values) -> Float4 {
+				return {_mm_loadu_ps(values)};
+			}
+
+			template <>
+			auto Splat<Float4>(float value) -> Float4 {
+				return {_mm_set1_ps(value)};
+			}
+
+			auto Store(float *values, Float4 value) -> void {
+				_mm_storeu_ps(values, value.v);
+			}
+
+			auto operator+(Float4 a, Float4 b) -> Float4 {
+				return {glm_vec4_add(a.v, b.v)};
+			}
+
+			auto operator-(Float4 a, Float4 b) -> Float4 {
+				return {glm_vec4_sub(a.v, b.v)};
+			}
+
+			auto operator-(Float4 a) -> Float4 {
+				return {_mm_xor_ps(a.v, _mm_set1_ps(-0.0f))};
+			}
+
+			auto operator*(Float4 a, Float4 b) -> Float4 {
+				return {glm_vec4_mul(a.v, b.v)};
+			}
+
+			auto operator/(Float4 a, Float4 b) -> Float4 {
+				return {glm_vec4_div(a.v, b.v)};
+			}
+
+			auto operator<(Float4 a, Float4 b) -> Float4 {
+				return {_mm_cmplt_ps(a.v, b.v)};
+			}
+
+			auto operator<=(Float4 a, Float4 b) -> Float4 {
+				return {_mm_cmple_ps(a.v, b.v)};
+			}
+
+			auto operator>(Float4 a, Float4 b) -> Float4 {
+				return {_mm_cmpgt_ps(a.v, b.v)};
+			}
+
+			auto operator>=(Float4 a, Float4 b) -> Float4 {
+				return {_mm_cmpge_ps(a.v, b.v)};
+			}
+
+			auto operator&(Float4 a, Float4 b) -> Float4 {
+				return {_mm_and_ps(a.v, b.v)};
+			}
+
+			auto Min(Float4 a, Float4 b) -> Float4 {
+				return {_mm_min_ps(a.v, b.v)};
+			}
+
+			auto Max(Float4 a, Float4 b) -> Float4 {
+				return {_mm_max_ps(a.v, b.v)};
+			}
+
+			auto Abs(Float4 a) -> Float4 {
+				return {glm_vec4_abs(a.v)};
+			}
+
+			auto Sqrt(Float4 a) -> Float4 {
+				return {_mm_sqrt_ps(a.v)};
+			}
+
+			auto Select(Float4 mask, Float4 a, Float4 b) -> Float4 {
+				return {_mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v))};
+			}
+#endif
+
+			// the pairs of a kind are gathered in these arrays, the kernels write their results next to them
+			enum Lane { AX, AY, ACos, ASin, AExtentX, AExtentY, BX, BY, BCos, BSin, BExtentX, BExtentY, NormalX, NormalY, X1, Y1, Separation1, Keep1, X2, Y2, Separation2, Keep2, Id1, Id2, LaneCount };
+
+			struct Lanes {
+				Real *lanes[LaneCount];
+
+				auto operator[](Lane lane) const -> Real * {
+					return lanes[lane];
+				}
+			};
+
+			// a kernel collides the pairs of the lanes starting at i
+			template <typename F>
+			auto CollideCircles(Lanes const &lanes, std::size_t i) -> void {
+				auto ax = Load<F>(lanes[AX] + i), ay = Load<F>(lanes[AY] + i), ar = Load<F>(lanes[AExtentX] + i);
+				auto bx = Load<F>(lanes[BX] + i), by = Load<F>(lanes[BY] + i), br = Load<F>(lanes[BExtentX] + i);
+				auto zero = Splat<F>(0.0f), one = Splat<F>(1.0f), half = Splat<F>(0.5f);
+				auto dx = bx - ax, dy = by - ay;
+				auto distance = Sqrt(dx * dx + dy * dy);
+				// concentric circles are pushed apart along x
+				auto concentric = distance <= Splat<F>(Epsilon);
+				auto inverse = one / Max(distance, Splat<F>(Epsilon));
+				auto nx = Select(concentric, one, dx * inverse);
+				auto ny = Select(concentric, zero, dy * inverse);
+				auto separation = distance - (ar + br);
+				// the point is halfway between the two surfaces
+				Store(lanes[NormalX] + i, nx);
+				Store(lanes[NormalY] + i, ny);
+				Store(lanes[X1] + i, half * (ax + bx + nx * (ar - br)));
+				Store(lanes[Y1] + i, half * (ay + by + ny * (ar - br)));
+				Store(lanes[Separation1] + i, separation);
+				Store(lanes[Keep1] + i, Select(separation <= zero, one, zero));
+				Store(lanes[Keep2] + i, zero);
+				Store(lanes[Id1] + i, zero);
+			}
+
+			// a is the box and b the circle
+			template <typename F>
+			auto CollideBoxCircle(Lanes const &lanes, std::size_t i) -> void {
+				auto ax = Load<F>(lanes[AX] + i), ay = Load<F>(lanes[AY] + i), cos = Load<F>(lanes[ACos] + i), sin = Load<F>(lanes[ASin] + i);
+				auto hx = Load<F>(lanes[AExtentX] + i), hy = Load<F>(lanes[AExtentY] + i);
+				auto bx = Load<F>(lanes[BX] + i), by = Load<F>(lanes[BY] + i), radius = Load<F>(lanes[BExtentX] + i);
+				auto zero = Splat<F>(0.0f), one = Splat<F>(1.0f), half = Splat<F>(0.5f);
+				// the center of the circle in the frame of the box, and its closest point on the box
+				auto dx = bx - ax, dy = by - ay;
+				auto lx = cos * dx + sin * dy;
+				auto ly = cos * dy - sin * dx;
+				auto qx = Max(-hx, Min(hx, lx));
+				auto qy = Max(-hy, Min(hy, ly));
+				auto ox = lx - qx, oy = ly - qy;
+				auto distance = Sqrt(ox * ox + oy * oy);
+				auto inverse = one / Max(distance, Splat<F>(Epsilon));
+				// a center inside the box is pushed out through the closest face
+				auto inside = distance <= Splat<F>(Epsilon);
+				auto signX = Select(lx < zero, -one, one);
+				auto signY = Select(ly < zero, -one, one);
+				auto penetrationX = hx - Abs(lx), penetrationY = hy - Abs(ly);
+				auto throughX = penetrationX < penetrationY;
+				auto nlx = Select(inside, Select(throughX, signX, zero), ox * inverse);
+				auto nly = Select(inside, Select(throughX, zero, signY), oy * inverse);
+				auto separation = Select(inside, -Min(penetrationX, penetrationY), distance) - radius;
+				qx = Select(inside & throughX, signX * hx, qx);
+				qy = Select(inside & (penetrationX >= penetrationY), signY * hy, qy);
+				auto nx = cos * nlx - sin * nly;
+				auto ny = sin * nlx + cos * nly;
+				auto px = ax + cos * qx - sin * qy;
+				auto py = ay + sin * qx + cos * qy;
+				Store(lanes[NormalX] + i, nx);
+				Store(lanes[NormalY] + i, ny);
+				Store(lanes[X1] + i, px + nx * separation * half);
+				Store(lanes[Y1] + i, py + ny * separation * half);
+				Store(lanes[Separation1] + i, separation);
+				Store(lanes[Keep1] + i, Select(separation <= zero, one, zero));
+				Store(lanes[Keep2] + i, zero);
+				Store(lanes[Id1] + i, zero);
+			}
+
+			// separating axes on the faces of both boxes, then the incident edge clipped by the sides of the reference face
+			template <typename F>
+			auto CollideBoxes(Lanes const &lanes, std::size_t i) -> void {
+				auto ax = Load<F>(lanes[AX] + i), ay = Load<F>(lanes[AY] + i), aux = Load<F>(lanes[ACos] + i), auy = Load<F>(lanes[ASin] + i);
+				auto ahx = Load<F>(lanes[AExtentX] + i), ahy = Load<F>(lanes[AExtentY] + i);
+				auto bx = Load<F>(lanes[BX] + i), by = Load<F>(lanes[BY] + i), bux = Load<F>(lanes[BCos] + i), buy = Load<F>(lanes[BSin] + i);
+				auto bhx = Load<F>(lanes[BExtentX] + i), bhy = Load<F>(lanes[BExtentY] + i);
+				auto zero = Splat<F>(0.0f), one = Splat<F>(1.0f), half = Splat<F>(0.5f);
+				auto avx = -auy, avy = aux, bvx = -buy, bvy = bux;
+				auto dx = bx - ax, dy = by - ay;
+				auto uu = Abs(aux * bux + auy * buy), uv = Abs(aux * bvx + auy * bvy);
+				auto vu = Abs(avx * bux + avy * buy), vv = Abs(avx * bvx + avy * bvy);
+				auto separationAU = Abs(dx * aux + dy * auy) - ahx - (bhx * uu + bhy * uv);
+				auto separationAV = Abs(dx * avx + dy * avy) - ahy - (bhx * vu + bhy * vv);
+				auto separationBU = Abs(dx * bux + dy * buy) - bhx - (ahx * uu + ahy * vu);
+				auto separationBV = Abs(dx * bvx + dy * bvy) - bhy - (ahx * uv + ahy * vv);
+				auto separationA = Max(separationAU, separationAV);
+				auto separationB = Max(separationBU, separationBV);
+				auto touching = Max(separationA, separationB) <= zero;
+
+				// the reference box owns the face of least penetration, the other box is incident
+				auto flip = separationB > separationA + Splat<F>(ReferenceTolerance);
+				auto rx = Select(flip, bx, ax), ry = Select(flip, by, ay);
+				auto rux = Select(flip, bux, aux), ruy = Select(flip, buy, auy);
+				auto rhx = Select(flip, bhx, ahx), rhy = Select(flip, bhy, ahy);
+				auto ix = Select(flip, ax, bx), iy = Select(flip, ay, by);
+				auto iux = Select(flip, aux, bux), iuy = Select(flip, auy, buy);
+				auto ihx = Select(flip, ahx, bhx), ihy = Select(flip, ahy, bhy);
+				auto referenceU = Select(flip, separationBU >= separationBV, separationAU >= separationAV);
+				auto axisX = Select(referenceU, rux, -ruy);
+				auto axisY = Select(referenceU, ruy, rux);
+				auto normalExtent = Select(referenceU, rhx, rhy);
+				auto tangentExtent = Select(referenceU, rhy, rhx);
+				auto referenceSign = Select((ix - rx) * axisX + (iy - ry) * axisY < zero, -one, one);
+				auto nx = axisX * referenceSign, ny = axisY * referenceSign;
+				auto tx = -ny, ty = nx;
+				auto fx = rx + nx * normalExtent, fy = ry + ny * normalExtent;
+
+				// the incident face is the most antiparallel to the normal
+				auto du = iux * nx + iuy * ny;
+				auto dv = iux * ny - iuy * nx;
+				auto incidentU = Abs(du) >= Abs(dv);
+				auto incidentSign = Select(Select(incidentU, du, dv) > zero, -one, one);
+				auto inx = Select(incidentU, iux, -iuy) * incidentSign;
+				auto iny = Select(incidentU, iuy, iux) * incidentSign;
+				auto incidentExtent = Select(incidentU, ihx, ihy);
+				auto incidentLength = Select(incidentU, ihy, ihx);
+				auto cx = ix + inx * incidentExtent, cy = iy + iny * incidentExtent;
+				auto e1x = cx - iny * incidentLength, e1y = cy + inx * incidentLength;
+				auto e2x = cx + iny * incidentLength, e2y = cy - inx * incidentLength;
+
+				// the edge is cut where it leaves the sides of the reference face
+				auto x1 = (e1x - fx) * tx + (e1y - fy) * ty;
+				auto x2 = (e2x - fx) * tx + (e2y - fy) * ty;
+				auto length = x2 - x1;
+				length = Select(Abs(length) < Splat<F>(Epsilon), Splat<F>(Epsilon), length);
+				auto sa = (-tangentExtent - x1) / length;
+				auto sb = (tangentExtent - x1) / length;
+				auto s1 = Max(zero, Min(sa, sb));
+				auto s2 = Min(one, Max(sa, sb));
+				auto p1x = e1x + (e2x - e1x) * s1, p1y = e1y + (e2y - e1y) * s1;
+				auto p2x = e1x + (e2x - e1x) * s2, p2y = e1y + (e2y - e1y) * s2;
+				auto separation1 = (p1x - fx) * nx + (p1y - fy) * ny;
+				auto separation2 = (p2x - fx) * nx + (p2y - fy) * ny;
+				auto clipped = touching & (s1 <= s2);
+
+				// features are the reference face, the incident face and the end of the edge
+				auto referenceFace = Select(flip, Splat<F>(8.0f), zero) + Select(referenceU, zero, Splat<F>(2.0f)) + Select(referenceSign < zero, one, zero);
+				auto incidentFace = Select(incidentU, zero, Splat<F>(2.0f)) + Select(incidentSign < zero, one, zero);
+				auto id = referenceFace * Splat<F>(16.0f) + incidentFace * Splat<F>(2.0f);
+				Store(lanes[NormalX] + i, Select(flip, -nx, nx));
+				Store(lanes[NormalY] + i, Select(flip, -ny, ny));
+				Store(lanes[X1] + i, p1x - nx * separation1 * half);
+				Store(lanes[Y1] + i, p1y - ny * separation1 * half);
+				Store(lanes[Separation1] + i, separation1);
+				Store(lanes[Keep1] + i, Select(clipped & (separation1 <= zero), one, zero));
+				Store(lanes[X2] + i, p2x - nx * separation2 * half);
+				Store(lanes[Y2] + i, p2y - ny * separation2 * half);
+				Store(lanes[Separation2] + i, separation2);
+				Store(lanes[Keep2] + i, Select(clipped & (separation2 <= zero) & (s2 > s1 + Splat<F>(Epsilon)), one, zero));
+				Store(lanes[Id1] + i, id);
+				Store(lanes[Id2] + i, id + one);
+			}
+
+			using Kernel = auto (*)(Lanes const &lanes, std::size_t i) -> void;
+
+			enum Kind { CircleCircle, BoxCircle, BoxBox, KindCount };
+
+			auto GetKernel(Kind kind, std::size_t &width) -> Kernel {
+#if SYMBIOTE_NARROWPHASE_X86
+				if (Symbiote::Core::GetSimdLevel() != Symbiote::Core::SimdLevel::Scalar) {
+					width = 4;
+					switch (kind) {
+						case CircleCircle:
+							return CollideCircles<Float4>;
+						case BoxCircle:
+							return CollideBoxCircle<Float4>;
+						default:
+							return CollideBoxes<Float4>;
+					}
+				}
+#endif
+				width = 1;
+				switch (kind) {
+					case CircleCircle:
+						return CollideCircles<Real>;
+					case BoxCircle:
+						return CollideBoxCircle<Real>;
+					default:
+						return CollideBoxes<Real>;
+				}
+			}
+
+			auto GetKind(RigidBodyComponent::Shape a, RigidBodyComponent::Shape b) -> Kind {
+				if (a == RigidBodyComponent::Shape::Circle && b == RigidBodyComponent::Shape::Circle) {
+					return CircleCircle;
+				}
+				if (a == RigidBodyComponent::Shape::Box && b == RigidBodyComponent::Shape::Box) {
+					return BoxBox;
+				}
+				return BoxCircle;
+			}
+		} // namespace
+
+		auto Narrowphase::Collide(Shapes const &shapes, std::vector<SpatialHashGrid::Pair> const &pairs, std::vector<Contact> &contacts, Symbiote::Core::JobSystem *jobs) -> void {
+			contacts.clear();
+			auto chunks = (pairs.size() + PairsPerJob - 1) / PairsPerJob;
+			if (mChunks.size() < chunks) {
+				mChunks.resize(chunks);
+			}
+			auto job = [&](std::size_t begin, std::size_t end) { Collide(shapes, pairs, begin, end, mChunks[begin / PairsPerJob]); };
+			if (jobs != nullptr) {
+				jobs->ParallelFor(0, pairs.size(), PairsPerJob, job);
+			} else {
+				for (std::size_t begin = 0; begin < pairs.size(); begin += PairsPerJob) {
+					job(begin, std::min(pairs.size(), begin + PairsPerJob));
+				}
+			}
+			std::size_t count = 0;
+			for (std::size_t chunk = 0; chunk < chunks; chunk++) {
+				count += mChunks[chunk].contacts.size();
+			}
+			contacts.reserve(count);
+			for (std::size_t chunk = 0; chunk < chunks; chunk++) {
+				contacts.insert(contacts.end(), mChunks[chunk].contacts.begin(), mChunks[chunk].contacts.end());
+			}
+		}
+
+		auto Narrowphase::Collide(Shapes const &shapes, std::vector<SpatialHashGrid::Pair> const &pairs, std::size_t begin, std::size_t end, Chunk &chunk) const -> void {
+			chunk.contacts.clear();
+			// lanes are padded to a whole number of kernel widths
+			auto stride = end - begin + 8;
+			chunk.lanes.resize(stride * LaneCount);
+			Lanes lanes;
+			for (std::size_t lane = 0; lane < LaneCount; lane++) {
+				lanes.lanes[lane] = chunk.lanes.data() + lane * stride;
+			}
+			// the pairs are sorted by kind in a single pass, each kind is then a contiguous range
+			std::size_t offsets[KindCount + 1] = {};
+			for (auto pair = begin; pair < end; pair++) {
+				auto a = shapes.shape[pairs[pair].a], b = shapes.shape[pairs[pair].b];
+				if (a != RigidBodyComponent::Shape::None && b != RigidBodyComponent::Shape::None) {
+					offsets[GetKind(a, b) + 1] += 1;
+				}
+			}
+			for (auto kind = 0; kind < KindCount; kind++) {
+				offsets[kind + 1] += offsets[kind];
+			}
+			chunk.pairs.resize(offsets[KindCount]);
+			std::size_t cursors[KindCount] = {offsets[0], offsets[1], offsets[2]};
+			for (auto pair = begin; pair < end; pair++) {
+				auto a = shapes.shape[pairs[pair].a], b = shapes.shape[pairs[pair].b];
+				if (a != RigidBodyComponent::Shape::None && b != RigidBodyComponent::Shape::None) {
+					chunk.pairs[cursors[GetKind(a, b)]++] = static_cast<std::uint32_t>(pair);
+				}
+			}
+			for (auto kind = 0; kind < KindCount; kind++) {
+				auto first = offsets[kind];
+				auto count = offsets[kind + 1] - first;
+				if (count == 0) {
+					continue;
+				}
+				std::size_t width;
+				auto kernel = GetKernel(static_cast<Kind>(kind), width);
+				auto padded = (count + width - 1) / width * width;
+				for (std::size_t i = 0; i < padded; i++) {
+					auto &pair = pairs[chunk.pairs[first + std::min(i, count - 1)]];
+					// a circle colliding a box is gathered after the box
+					auto swap = shapes.shape[pair.a] == RigidBodyComponent::Shape::Circle && shapes.shape[pair.b] == RigidBodyComponent::Shape::Box;
+					auto a = swap ? pair.b : pair.a, b = swap ? pair.a : pair.b;
+					lanes[AX][i] = shapes.x[a];
+					lanes[AY][i] = shapes.y[a];
+					lanes[ACos][i] = shapes.cos[a];
+					lanes[ASin][i] = shapes.sin[a];
+					lanes[AExtentX][i] = shapes.extentX[a];
+					lanes[AExtentY][i] = shapes.extentY[a];
+					lanes[BX][i] = shapes.x[b];
+					lanes[BY][i] = shapes.y[b];
+					lanes[BCos][i] = shapes.cos[b];
+					lanes[BSin][i] = shapes.sin[b];
+					lanes[BExtentX][i] = shapes.extentX[b];
+					lanes[BExtentY][i] = shapes.extentY[b];
+				}
+				for (std::size_t i = 0; i < padded; i += width) {
+					kernel(lanes, i);
+				}
+				for (std::size_t i = 0; i < count; i++) {
+					if (lanes[Keep1][i] == 0.0f && lanes[Keep2][i] == 0.0f) {
+						continue;
+					}
+					auto &pair = pairs[chunk.pairs[first + i]];
+					auto sign = Real(shapes.shape[pair.a] == RigidBodyComponent::Shape::Circle && shapes.shape[pair.b] == RigidBodyComponent::Shape::Box ? -1 : 1);
+					Contact contact;
+					contact.a = pair.a;
+					contact.b = pair.b;
+					contact.normal = Symbiote::Core::RealVec2(lanes[NormalX][i], lanes[NormalY][i]) * sign;
+					if (lanes[Keep1][i] != 0.0f) {
+						contact.points[contact.pointCount++] = {{lanes[X1][i], lanes[Y1][i]}, lanes[Separation1][i], static_cast<std::uint32_t>(lanes[Id1][i])};
+					}
+					if (lanes[Keep2][i] != 0.0f) {
+						contact.points[contact.pointCount++] = {{lanes[X2][i], lanes[Y2][i]}, lanes[Separation2][i], static_cast<std::uint32_t>(lanes[Id2][i])};
+					}
+					chunk.contacts.push_back(contact);
+				}
+			}
+		}
+
+	} // namespace Game
+} // namespace Symbiote
\ No newline at end of file
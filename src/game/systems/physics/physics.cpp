@@ -1,7 +1,16 @@
-#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#include "glm/common.hpp"
+#include "glm/geometric.hpp"
 
 #include "core/ecs/entity.hpp"
 #include "core/ecs/entitymanager.hpp"
+#include "core/jobs/jobsystem.hpp"
+#include "core/math/batch.hpp"
+#include "core/serialization/hash.hpp"
 
 #include "game/systems/physics/physics.hpp"
 #include "game/components/rigidbody/rigidbody.hpp"
@@ -12,8 +21,904 @@ DEFINE_SYSTEM(Symbiote::Game::PhysicsSystem);
 namespace Symbiote {
 	namespace Game {
 
+		namespace {
+			using Symbiote::Core::Real;
+
+			// the query tree is rebuilt when more than a quarter of its leaves were inserted during an update
+			constexpr std::size_t TreeRebuildRatio = 4;
+			// the island of an awake body, and the index a body takes in the grid while two bodies swap
+			constexpr std::uint32_t NoIsland = std::numeric_limits<std::uint32_t>::max();
+			constexpr std::uint32_t Swapping = std::numeric_limits<std::uint32_t>::max();
+
+			// the state is kept as Real so that a fixed point build steps the same way whatever the compiler or the processor
+			// queries, bounds and transforms are floats converted from it
+			auto ToFloat(Real value) -> float {
+				return static_cast<float>(value);
+			}
+		} // namespace
+
+		PhysicsSystem::PhysicsSystem(Symbiote::Core::JobSystem *jobs) : mJobs(jobs) {
+		}
+
+		PhysicsSystem::~PhysicsSystem() {
+			// bodies outlive the system with their last state
+			for (std::uint32_t body = 0; body < mBodies.components.size(); body++) {
+				auto component = mBodies.components[body];
+				component->mState = LoadBody(body);
+				component->mSaved = SaveBody(body);
+				component->mSystem = nullptr;
+				if (mBodies.transforms[body] != nullptr) {
+					mBodies.transforms[body]->mBody = nullptr;
+				}
+			}
+		}
+
 		auto PhysicsSystem::Update(float deltaTime) -> void {
-			this->mManager->With<RigidBodyComponent, TransformComponent>([&](auto e, auto rigidbody, auto transform) { transform->SetPosition(transform->GetPosition() * rigidbody->mSpeed * deltaTime); });
+			SYMBIOTE_PROFILE_SCOPE(SystemName);
+			auto timer = TimeUpdate();
+			if (!mAdopted) {
+				// bodies created before the system was added
+				mAdopted = true;
+				mManager->With<RigidBodyComponent>([this](auto, auto body) {
+					if (body->mSystem == nullptr) {
+						Track(body);
+					}
+				});
+			}
+			// bodies are usually created before the transform of their entity, the lookup happens once
+			// a transform added later is found by Entity::ResolveComponentDependencies
+			for (auto body : mUnresolved) {
+				body->mUnresolved = false;
+				ResolveTransform(body->mBody);
+			}
+			mUnresolved.clear();
+			Real step = deltaTime;
+			if (mRefresh) {
+				// bodies woke up since the last update, their contacts are found before they are solved
+				mRefresh = false;
+				UpdateBroadphase(0);
+				FindContacts();
+			}
+			ApplyRenames();
+			// sleeping bodies are after the bodies awake, they are neither integrated nor written back
+			std::size_t count = mAwake;
+			auto forces = mForces;
+			if (mContacts.empty()) {
+				// nothing to solve, both passes run on a batch while it is in cache
+				mSolver.Reset();
+				ForEachBatch(count, [&](std::size_t begin, std::size_t end) {
+					IntegrateVelocities(begin, end, step, forces);
+					IntegratePositions(begin, end, step);
+				});
+			} else {
+				// the contacts found at the end of the last update are solved between the velocities and the positions
+				ForEachBatch(count, [&](std::size_t begin, std::size_t end) { IntegrateVelocities(begin, end, step, forces); });
+				SolveContacts(step);
+				ForEachBatch(count, [&](std::size_t begin, std::size_t end) { IntegratePositions(begin, end, step); });
+			}
+			mForces = false;
+			// transforms are written from this thread, they register their changes with the transform system
+			for (std::size_t body = 0; body < count; body++) {
+				auto transform = mBodies.transforms[body];
+				if (transform == nullptr) {
+					continue;
+				}
+				auto position = glm::vec2(ToFloat(mBodies.positionX[body]), ToFloat(mBodies.positionY[body]));
+				if (transform->GetPosition() != position) {
+					transform->SetPosition(position);
+				}
+				auto rotation = ToFloat(mBodies.rotation[body]);
+				if (transform->GetRotation() != rotation) {
+					transform->SetRotation(rotation);
+				}
+			}
+			UpdateBroadphase(step);
+			UpdateSleep();
+			FindContacts();
+		}
+
+		auto PhysicsSystem::GetBodyCount() const -> std::size_t {
+			return mBodies.components.size();
+		}
+
+		auto PhysicsSystem::GetAwakeCount() const -> std::size_t {
+			return mAwake;
+		}
+
+		auto PhysicsSystem::GetEntity(std::uint32_t body) const -> Symbiote::Core::Entity {
+			return mBodies.components[body]->mEntity;
+		}
+
+		auto PhysicsSystem::Hash() const -> std::uint64_t {
+			auto hash = Symbiote::Core::HashSeed;
+			for (auto array : {&mBodies.positionX, &mBodies.positionY, &mBodies.rotation, &mBodies.velocityX, &mBodies.velocityY, &mBodies.angularVelocity}) {
+				hash = Symbiote::Core::HashBytes(array->data(), array->size() * sizeof(Real), hash);
+			}
+			return hash;
+		}
+
+		auto PhysicsSystem::GetPairs() const -> const std::vector<SpatialHashGrid::Pair> & {
+			return mPairs;
+		}
+
+		auto PhysicsSystem::GetContacts() const -> const std::vector<Narrowphase::Contact> & {
+			return mContacts;
+		}
+
+		auto PhysicsSystem::GetIslandCount() const -> std::size_t {
+			return mSolver.GetIslandCount();
+		}
+
+		auto PhysicsSystem::GetSolverIterations() const -> std::size_t {
+			return mSolver.GetIterations();
+		}
+
+		auto PhysicsSystem::SetSolverIterations(std::size_t iterations) -> void {
+			mSolver.SetIterations(iterations);
+		}
+
+		auto PhysicsSystem::IsSleepingEnabled() const -> bool {
+			return mSleepingEnabled;
+		}
+
+		auto PhysicsSystem::SetSleepingEnabled(bool enabled) -> void {
+			mSleepingEnabled = enabled;
+			if (!enabled && mAwake < mBodies.components.size()) {
+				while (mAwake < mBodies.components.size()) {
+					WakeIsland(mBodies.islands[mAwake]);
+				}
+				mPairs.clear();
+				mContacts.clear();
+				mRefresh = true;
+			}
+		}
+
+		auto PhysicsSystem::GetCellSize() const -> float {
+			return mGrid.GetCellSize();
+		}
+
+		auto PhysicsSystem::SetCellSize(float cellSize) -> void {
+			if (!(cellSize > 0.0f)) {
+				throw std::logic_error("PhysicsSystem::SetCellSize: cell size must be positive");
+			}
+			// bodies awake are inserted again on the next update, sleeping bodies right away
+			mGrid.Clear(cellSize);
+			std::fill(mBodies.cells.begin(), mBodies.cells.end(), SpatialHashGrid::Range{});
+			for (auto body = mAwake; body < mBodies.components.size(); body++) {
+				if (mBodies.shape[body] != RigidBodyComponent::Shape::None) {
+					mBodies.cells[body] = mGrid.GetRange(mBodies.boundsMinX[body], mBodies.boundsMinY[body], mBodies.boundsMaxX[body], mBodies.boundsMaxY[body]);
+					mGrid.Insert(body, mBodies.cells[body]);
+				}
+			}
+			mPairs.clear();
+			mContacts.clear();
+		}
+
+		auto PhysicsSystem::Raycast(Ray const &ray) const -> std::optional<RaycastHit> {
+			auto length = glm::length(ray.direction);
+			if (length == 0.0f) {
+				return std::nullopt;
+			}
+			auto normalized = ray;
+			normalized.direction = ray.direction / length;
+			std::optional<RaycastHit> closest;
+			mTree.Raycast(normalized.origin, normalized.direction, normalized.maxDistance, [&](std::uint32_t body, float maxDistance) {
+				RaycastHit hit;
+				normalized.maxDistance = maxDistance;
+				if (!RaycastBody(body, normalized, hit)) {
+					return maxDistance;
+				}
+				closest = hit;
+				return hit.distance;
+			});
+			return closest;
+		}
+
+		auto PhysicsSystem::QueryAABB(Region const &region, std::vector<Symbiote::Core::Entity> &entities) const -> void {
+			entities.clear();
+			mTree.Query(region.min, region.max, [&](std::uint32_t body) {
+				if (OverlapsRegion(body, region)) {
+					entities.push_back(mBodies.components[body]->mEntity);
+				}
+				return true;
+			});
+		}
+
+		auto PhysicsSystem::QueryCircle(Circle const &circle, std::vector<Symbiote::Core::Entity> &entities) const -> void {
+			entities.clear();
+			auto extents = glm::vec2(circle.radius, circle.radius);
+			mTree.Query(circle.center - extents, circle.center + extents, [&](std::uint32_t body) {
+				if (OverlapsCircle(body, circle)) {
+					entities.push_back(mBodies.components[body]->mEntity);
+				}
+				return true;
+			});
+		}
+
+		auto PhysicsSystem::Raycast(std::vector<Ray> const &rays, std::vector<std::optional<RaycastHit>> &hits) const -> void {
+			hits.resize(rays.size());
+			RunQueries(rays.size(), [&](std::size_t query) { hits[query] = Raycast(rays[query]); });
+		}
+
+		auto PhysicsSystem::QueryAABB(std::vector<Region> const &regions, std::vector<std::vector<Symbiote::Core::Entity>> &entities) const -> void {
+			entities.resize(regions.size());
+			RunQueries(regions.size(), [&](std::size_t query) { QueryAABB(regions[query], entities[query]); });
+		}
+
+		auto PhysicsSystem::QueryCircle(std::vector<Circle> const &circles, std::vector<std::vector<Symbiote::Core::Entity>> &entities) const -> void {
+			entities.resize(circles.size());
+			RunQueries(circles.size(), [&](std::size_t query) { QueryCircle(circles[query], entities[query]); });
+		}
+
+		auto PhysicsSystem::RunQueries(std::size_t count, std::function<void(std::size_t)> const &query) const -> void {
+			// queries only read the query tree and the arrays, they run on any thread
+			auto job = [&](std::size_t begin, std::size_t end) {
+				for (auto i = begin; i < end; i++) {
+					query(i);
+				}
+			};
+			if (mJobs != nullptr) {
+				mJobs->ParallelFor(0, count, QueriesPerJob, job);
+			} else {
+				job(0, count);
+			}
+		}
+
+		auto PhysicsSystem::RaycastBody(std::uint32_t body, Ray const &ray, RaycastHit &hit) const -> bool {
+			auto center = glm::vec2(ToFloat(mBodies.positionX[body]), ToFloat(mBodies.positionY[body]));
+			auto origin = ray.origin - center;
+			auto distance = 0.0f;
+			auto normal = glm::vec2(0, 0);
+			if (mBodies.shape[body] == RigidBodyComponent::Shape::Circle) {
+				auto radius = ToFloat(mBodies.extentX[body]);
+				auto b = glm::dot(origin, ray.direction);
+				auto c = glm::dot(origin, origin) - radius * radius;
+				auto discriminant = b * b - c;
+				if (c <= 0.0f || b > 0.0f || discriminant < 0.0f) {
+					return false;
+				}
+				distance = -b - std::sqrt(discriminant);
+				normal = (origin + ray.direction * distance) / radius;
+			} else {
+				// the ray is moved in the frame of the box, where its faces are slabs
+				auto cos = std::cos(ToFloat(mBodies.rotation[body]));
+				auto sin = std::sin(ToFloat(mBodies.rotation[body]));
+				auto local = glm::vec2(cos * origin.x + sin * origin.y, cos * origin.y - sin * origin.x);
+				auto direction = glm::vec2(cos * ray.direction.x + sin * ray.direction.y, cos * ray.direction.y - sin * ray.direction.x);
+				auto extents = glm::vec2(ToFloat(mBodies.extentX[body]), ToFloat(mBodies.extentY[body]));
+				auto enter = -std::numeric_limits<float>::infinity();
+				auto exit = std::numeric_limits<float>::infinity();
+				auto localNormal = glm::vec2(0, 0);
+				for (auto axis = 0; axis < 2; axis++) {
+					if (direction[axis] == 0.0f) {
+						if (std::abs(local[axis]) > extents[axis]) {
+							return false;
+						}
+						continue;
+					}
+					auto near = (-std::copysign(extents[axis], direction[axis]) - local[axis]) / direction[axis];
+					auto far = (std::copysign(extents[axis], direction[axis]) - local[axis]) / direction[axis];
+					if (near > enter) {
+						enter = near;
+						localNormal = {0, 0};
+						localNormal[axis] = -std::copysign(1.0f, direction[axis]);
+					}
+					exit = std::min(exit, far);
+				}
+				if (enter <= 0.0f || enter > exit) {
+					return false;
+				}
+				distance = enter;
+				normal = glm::vec2(cos * localNormal.x - sin * localNormal.y, sin * localNormal.x + cos * localNormal.y);
+			}
+			if (distance > ray.maxDistance) {
+				return false;
+			}
+			hit.entity = mBodies.components[body]->mEntity;
+			hit.point = ray.origin + ray.direction * distance;
+			hit.normal = normal;
+			hit.distance = distance;
+			return true;
+		}
+
+		auto PhysicsSystem::OverlapsRegion(std::uint32_t body, Region const &region) const -> bool {
+			if (mBodies.boundsMinX[body] > region.max.x || mBodies.boundsMinY[body] > region.max.y || region.min.x > mBodies.boundsMaxX[body] || region.min.y > mBodies.boundsMaxY[body]) {
+				return false;
+			}
+			auto center = glm::vec2(ToFloat(mBodies.positionX[body]), ToFloat(mBodies.positionY[body]));
+			if (mBodies.shape[body] == RigidBodyComponent::Shape::Circle) {
+				auto closest = glm::clamp(center, region.min, region.max);
+				auto radius = ToFloat(mBodies.extentX[body]);
+				return glm::dot(closest - center, closest - center) <= radius * radius;
+			}
+			// the axes of the region were tested with the bounds, the region is projected on the axes of the box
+			auto regionCenter = (region.min + region.max) * 0.5f;
+			auto regionExtents = (region.max - region.min) * 0.5f;
+			auto cos = std::cos(ToFloat(mBodies.rotation[body]));
+			auto sin = std::sin(ToFloat(mBodies.rotation[body]));
+			auto offset = regionCenter - center;
+			auto axisX = glm::vec2(cos, sin);
+			auto axisY = glm::vec2(-sin, cos);
+			auto projectedX = std::abs(axisX.x) * regionExtents.x + std::abs(axisX.y) * regionExtents.y;
+			auto projectedY = std::abs(axisY.x) * regionExtents.x + std::abs(axisY.y) * regionExtents.y;
+			return std::abs(glm::dot(offset, axisX)) <= ToFloat(mBodies.extentX[body]) + projectedX && std::abs(glm::dot(offset, axisY)) <= ToFloat(mBodies.extentY[body]) + projectedY;
+		}
+
+		auto PhysicsSystem::OverlapsCircle(std::uint32_t body, Circle const &circle) const -> bool {
+			auto offset = circle.center - glm::vec2(ToFloat(mBodies.positionX[body]), ToFloat(mBodies.positionY[body]));
+			if (mBodies.shape[body] == RigidBodyComponent::Shape::Circle) {
+				auto radius = ToFloat(mBodies.extentX[body]) + circle.radius;
+				return glm::dot(offset, offset) <= radius * radius;
+			}
+			// the closest point of the box to the circle, in the frame of the box
+			auto cos = std::cos(ToFloat(mBodies.rotation[body]));
+			auto sin = std::sin(ToFloat(mBodies.rotation[body]));
+			auto local = glm::vec2(cos * offset.x + sin * offset.y, cos * offset.y - sin * offset.x);
+			auto extents = glm::vec2(ToFloat(mBodies.extentX[body]), ToFloat(mBodies.extentY[body]));
+			auto closest = glm::clamp(local, -extents, extents);
+			return glm::dot(local - closest, local - closest) <= circle.radius * circle.radius;
+		}
+
+		auto PhysicsSystem::ForEachBatch(std::size_t count, std::function<void(std::size_t, std::size_t)> const &job) -> void {
+			// the bodies are integrated in batches which run in parallel on the job system
+			auto batches = [&](std::size_t begin, std::size_t end) {
+				for (auto batch = begin; batch < end; batch += BatchSize) {
+					job(batch, std::min(end, batch + BatchSize));
+				}
+			};
+			if (mJobs != nullptr) {
+				mJobs->ParallelFor(0, count, BatchSize * BatchesPerJob, batches);
+			} else {
+				batches(0, count);
+			}
+		}
+
+		auto PhysicsSystem::IntegrateVelocities(std::size_t begin, std::size_t end, Real deltaTime, bool forces) -> void {
+			auto &bodies = mBodies;
+			// the transforms hold the positions between steps, moving one teleports its body, otherwise the body keeps the precision of its numbers
+			for (auto body = begin; body < end; body++) {
+				auto transform = bodies.transforms[body];
+				if (transform != nullptr) {
+					auto position = transform->GetPosition();
+					if (position.x != ToFloat(bodies.positionX[body])) {
+						bodies.positionX[body] = position.x;
+					}
+					if (position.y != ToFloat(bodies.positionY[body])) {
+						bodies.positionY[body] = position.y;
+					}
+					if (transform->GetRotation() != ToFloat(bodies.rotation[body])) {
+						bodies.rotation[body] = transform->GetRotation();
+					}
+				}
+			}
+			// semi-implicit Euler: velocities first, then positions with the new velocities
+			auto velocityX = bodies.velocityX.data(), velocityY = bodies.velocityY.data(), angularVelocity = bodies.angularVelocity.data();
+			auto accelerationX = bodies.accelerationX.data(), accelerationY = bodies.accelerationY.data();
+			auto forceX = bodies.forceX.data(), forceY = bodies.forceY.data();
+			auto inverseMass = bodies.inverseMass.data(), linearDamping = bodies.linearDamping.data(), angularDamping = bodies.angularDamping.data();
+			if (forces) {
+				// forces last one step
+				for (auto body = begin; body < end; body++) {
+					velocityX[body] += forceX[body] * inverseMass[body] * deltaTime;
+					velocityY[body] += forceY[body] * inverseMass[body] * deltaTime;
+					forceX[body] = 0;
+					forceY[body] = 0;
+				}
+			}
+			for (auto body = begin; body < end; body++) {
+				auto dynamic = inverseMass[body] > 0 ? deltaTime : Real(0);
+				auto linear = Real(1) / (Real(1) + linearDamping[body] * deltaTime);
+				velocityX[body] = (velocityX[body] + accelerationX[body] * dynamic) * linear;
+				velocityY[body] = (velocityY[body] + accelerationY[body] * dynamic) * linear;
+				angularVelocity[body] = angularVelocity[body] / (Real(1) + angularDamping[body] * deltaTime);
+			}
+		}
+
+		auto PhysicsSystem::IntegratePositions(std::size_t begin, std::size_t end, Real deltaTime) -> void {
+			auto &bodies = mBodies;
+			for (auto body = begin; body < end; body++) {
+				bodies.rotation[body] += bodies.angularVelocity[body] * deltaTime;
+			}
+			Symbiote::Core::IntegrateVelocities(bodies.positionX.data() + begin, bodies.positionY.data() + begin, bodies.velocityX.data() + begin, bodies.velocityY.data() + begin, deltaTime, end - begin);
+			// the time at rest, any motion above the tolerances starts it over, the components come first as their squares overflow fixed point
+			auto linear = Real(LinearSleepTolerance) * Real(LinearSleepTolerance);
+			for (auto body = begin; body < end; body++) {
+				auto velocityX = bodies.velocityX[body], velocityY = bodies.velocityY[body];
+				auto fast = Symbiote::Core::Abs(velocityX) > LinearSleepTolerance || Symbiote::Core::Abs(velocityY) > LinearSleepTolerance;
+				auto moving = fast || velocityX * velocityX + velocityY * velocityY > linear || Symbiote::Core::Abs(bodies.angularVelocity[body]) > AngularSleepTolerance;
+				bodies.sleepTime[body] = moving ? Real(0) : bodies.sleepTime[body] + deltaTime;
+			}
+		}
+
+		auto PhysicsSystem::SolveContacts(Real deltaTime) -> void {
+			// the contacts were found at the positions the bodies start the step from, unless their transform teleported them
+			ContactSolver::Bodies bodies;
+			bodies.velocityX = mBodies.velocityX.data();
+			bodies.velocityY = mBodies.velocityY.data();
+			bodies.angularVelocity = mBodies.angularVelocity.data();
+			bodies.x = mBodies.positionX.data();
+			bodies.y = mBodies.positionY.data();
+			bodies.inverseMass = mBodies.inverseMass.data();
+			bodies.inverseInertia = mBodies.inverseInertia.data();
+			mSolver.Solve(bodies, mBodies.components.size(), mContacts, deltaTime, mJobs);
+		}
+
+		auto PhysicsSystem::UpdateBroadphase(Real deltaTime) -> void {
+			// sleeping bodies keep their bounds, cells and proxies
+			std::size_t count = mAwake;
+			ForEachBatch(count, [&](std::size_t begin, std::size_t end) { UpdateBounds(begin, end); });
+			// only the bodies which crossed a cell border move in the grid
+			auto &cells = mBodies.cells;
+			auto &nextCells = mBodies.nextCells;
+			for (std::uint32_t body = 0; body < count; body++) {
+				if (SpatialHashGrid::IsSame(cells[body], nextCells[body])) {
+					continue;
+				}
+				if (!SpatialHashGrid::IsEmpty(cells[body])) {
+					mGrid.Remove(body, cells[body]);
+				}
+				if (!SpatialHashGrid::IsEmpty(nextCells[body])) {
+					mGrid.Insert(body, nextCells[body]);
+				}
+				cells[body] = nextCells[body];
+			}
+			// the query tree answers raycasts and region queries, it only changes for the bodies which left their fat bounding box
+			auto &proxies = mBodies.proxies;
+			std::size_t inserted = 0;
+			for (std::uint32_t body = 0; body < count; body++) {
+				auto shaped = mBodies.shape[body] != RigidBodyComponent::Shape::None;
+				auto min = glm::vec2(mBodies.boundsMinX[body], mBodies.boundsMinY[body]);
+				auto max = glm::vec2(mBodies.boundsMaxX[body], mBodies.boundsMaxY[body]);
+				if (proxies[body] == AabbTree::NullNode) {
+					if (shaped) {
+						proxies[body] = mTree.CreateProxy(min, max, body);
+						inserted += 1;
+					}
+				} else if (!shaped) {
+					mTree.DestroyProxy(proxies[body]);
+					proxies[body] = AabbTree::NullNode;
+				} else {
+					auto displacement = glm::vec2(ToFloat(mBodies.velocityX[body] * deltaTime), ToFloat(mBodies.velocityY[body] * deltaTime));
+					inserted += mTree.MoveProxy(proxies[body], min, max, displacement) ? 1 : 0;
+				}
+			}
+			if (inserted * TreeRebuildRatio > mTree.GetProxyCount()) {
+				mTree.Rebuild();
+			}
+		}
+
+		auto PhysicsSystem::FindContacts() -> void {
+			SpatialHashGrid::Bounds bounds;
+			bounds.minX = mBodies.boundsMinX.data();
+			bounds.minY = mBodies.boundsMinY.data();
+			bounds.maxX = mBodies.boundsMaxX.data();
+			bounds.maxY = mBodies.boundsMaxY.data();
+			bounds.inverseMass = mBodies.inverseMass.data();
+			bounds.ranges = mBodies.cells.data();
+			Narrowphase::Shapes shapes;
+			shapes.shape = mBodies.shape.data();
+			shapes.x = mBodies.positionX.data();
+			shapes.y = mBodies.positionY.data();
+			shapes.cos = mBodies.cos.data();
+			shapes.sin = mBodies.sin.data();
+			shapes.extentX = mBodies.extentX.data();
+			shapes.extentY = mBodies.extentY.data();
+			// the grid reports the pairs of overlapping bounding boxes, the narrowphase turns them into contacts
+			// the islands woken up by a contact have no contacts between their own bodies yet, the pairs are found again
+			do {
+				bounds.asleep = mAwake < mBodies.components.size() ? mAwake : std::numeric_limits<std::uint32_t>::max();
+				mGrid.FindPairs(bounds, mPairs, mJobs);
+				mNarrowphase.Collide(shapes, mPairs, mContacts, mJobs);
+			} while (WakeTouched());
+		}
+
+		auto PhysicsSystem::UpdateSleep() -> void {
+			if (!mSleepingEnabled) {
+				return;
+			}
+			auto &bodies = mBodies;
+			// the bodies of an island fall asleep together once all of them are at rest, bodies in no island fall asleep alone
+			std::fill(bodies.islands.begin(), bodies.islands.begin() + mAwake, NoIsland);
+			mSleepers.clear();
+			for (std::size_t island = 0; island < mSolver.GetIslandCount(); island++) {
+				mSolver.GetIslandBodies(island, mIslandBodies);
+				auto rest = Real(TimeToSleep);
+				for (auto body : mIslandBodies) {
+					bodies.islands[body] = 0;
+					rest = std::min(rest, bodies.sleepTime[body]);
+				}
+				if (rest >= TimeToSleep) {
+					mSleepers.emplace_back();
+					for (auto body : mIslandBodies) {
+						mSleepers.back().push_back(bodies.components[body]);
+					}
+				}
+			}
+			for (std::uint32_t body = 0; body < mAwake; body++) {
+				if (bodies.islands[body] == NoIsland && bodies.sleepTime[body] >= TimeToSleep) {
+					mSleepers.push_back({bodies.components[body]});
+				}
+			}
+			for (auto &sleepers : mSleepers) {
+				auto island = mNextIsland++;
+				for (auto component : sleepers) {
+					mAwake -= 1;
+					SwapBodies(component->mBody, mAwake);
+					bodies.islands[mAwake] = island;
+					bodies.velocityX[mAwake] = 0;
+					bodies.velocityY[mAwake] = 0;
+					bodies.angularVelocity[mAwake] = 0;
+				}
+				mSleepingIslands[island] = std::move(sleepers);
+			}
+		}
+
+		auto PhysicsSystem::WakeTouched() -> bool {
+			// a body with mass touched by an awake body wakes its island up, static bodies stay asleep under the bodies resting on them
+			mWakes.clear();
+			for (auto &contact : mContacts) {
+				if (contact.a >= mAwake && mBodies.inverseMass[contact.a] > 0) {
+					mWakes.push_back(mBodies.islands[contact.a]);
+				} else if (contact.b >= mAwake && mBodies.inverseMass[contact.b] > 0) {
+					mWakes.push_back(mBodies.islands[contact.b]);
+				}
+			}
+			auto woke = false;
+			for (auto island : mWakes) {
+				woke = WakeIsland(island) || woke;
+			}
+			return woke;
+		}
+
+		auto PhysicsSystem::WakeIsland(std::uint32_t island) -> bool {
+			// an island wakes up when an awake body touches it or when one of its bodies is changed through its component, moving a transform does not wake it
+			auto sleeping = mSleepingIslands.find(island);
+			if (sleeping == mSleepingIslands.end()) {
+				return false;
+			}
+			for (auto component : sleeping->second) {
+				SwapBodies(component->mBody, mAwake);
+				mBodies.islands[mAwake] = NoIsland;
+				mBodies.sleepTime[mAwake] = 0;
+				mAwake += 1;
+			}
+			mSleepingIslands.erase(sleeping);
+			return true;
+		}
+
+		auto PhysicsSystem::SwapBodies(std::uint32_t a, std::uint32_t b) -> void {
+			if (a == b) {
+				return;
+			}
+			auto &bodies = mBodies;
+			// cells holding both bodies keep them apart while they are renamed
+			if (!SpatialHashGrid::IsEmpty(bodies.cells[a])) {
+				mGrid.Rename(a, Swapping, bodies.cells[a]);
+			}
+			if (!SpatialHashGrid::IsEmpty(bodies.cells[b])) {
+				mGrid.Rename(b, a, bodies.cells[b]);
+			}
+			if (!SpatialHashGrid::IsEmpty(bodies.cells[a])) {
+				mGrid.Rename(Swapping, b, bodies.cells[a]);
+			}
+			if (bodies.proxies[a] != AabbTree::NullNode) {
+				mTree.SetBody(bodies.proxies[a], b);
+			}
+			if (bodies.proxies[b] != AabbTree::NullNode) {
+				mTree.SetBody(bodies.proxies[b], a);
+			}
+			std::swap(bodies.components[a], bodies.components[b]);
+			bodies.components[a]->mBody = a;
+			bodies.components[b]->mBody = b;
+			std::swap(bodies.transforms[a], bodies.transforms[b]);
+			for (auto array : bodies.GetRealArrays()) {
+				std::swap((*array)[a], (*array)[b]);
+			}
+			for (auto array : bodies.GetFloatArrays()) {
+				std::swap((*array)[a], (*array)[b]);
+			}
+			std::swap(bodies.shape[a], bodies.shape[b]);
+			std::swap(bodies.cells[a], bodies.cells[b]);
+			std::swap(bodies.nextCells[a], bodies.nextCells[b]);
+			std::swap(bodies.proxies[a], bodies.proxies[b]);
+			std::swap(bodies.islands[a], bodies.islands[b]);
+			auto originA = mOrigins.count(a) != 0 ? mOrigins[a] : a;
+			auto originB = mOrigins.count(b) != 0 ? mOrigins[b] : b;
+			mOrigins[a] = originB;
+			mOrigins[b] = originA;
+		}
+
+		auto PhysicsSystem::ApplyRenames() -> void {
+			// the origins are the indexes the solver knew the moved bodies by, the impulses of the last step follow the bodies
+			if (mOrigins.empty()) {
+				return;
+			}
+			mRenames.clear();
+			for (auto [body, origin] : mOrigins) {
+				if (body != origin) {
+					mRenames[origin] = body;
+				}
+			}
+			mSolver.Rename(mRenames);
+			mOrigins.clear();
+		}
+
+		auto PhysicsSystem::UpdateBounds(std::size_t begin, std::size_t end) -> void {
+			auto &bodies = mBodies;
+			for (auto body = begin; body < end; body++) {
+				auto halfX = bodies.extentX[body];
+				auto halfY = bodies.extentY[body];
+				if (bodies.shape[body] == RigidBodyComponent::Shape::Box) {
+					// the bounding box of a rotated box, the axes are kept for the narrowphase
+					bodies.cos[body] = Symbiote::Core::Cos(bodies.rotation[body]);
+					bodies.sin[body] = Symbiote::Core::Sin(bodies.rotation[body]);
+					auto cos = Symbiote::Core::Abs(bodies.cos[body]);
+					auto sin = Symbiote::Core::Abs(bodies.sin[body]);
+					halfX = cos * bodies.extentX[body] + sin * bodies.extentY[body];
+					halfY = sin * bodies.extentX[body] + cos * bodies.extentY[body];
+				}
+				bodies.boundsMinX[body] = ToFloat(bodies.positionX[body] - halfX);
+				bodies.boundsMinY[body] = ToFloat(bodies.positionY[body] - halfY);
+				bodies.boundsMaxX[body] = ToFloat(bodies.positionX[body] + halfX);
+				bodies.boundsMaxY[body] = ToFloat(bodies.positionY[body] + halfY);
+				if (bodies.shape[body] == RigidBodyComponent::Shape::None) {
+					bodies.nextCells[body] = {};
+				} else {
+					bodies.nextCells[body] = mGrid.GetRange(bodies.boundsMinX[body], bodies.boundsMinY[body], bodies.boundsMaxX[body], bodies.boundsMaxY[body]);
+				}
+			}
+		}
+
+		auto PhysicsSystem::Bodies::GetRealArrays() -> std::array<std::vector<Real> *, 19> {
+			return {&positionX, &positionY, &rotation, &velocityX, &velocityY, &angularVelocity, &accelerationX, &accelerationY, &forceX, &forceY, &inverseMass, &inverseInertia, &linearDamping, &angularDamping, &extentX, &extentY, &cos, &sin, &sleepTime};
+		}
+
+		auto PhysicsSystem::Bodies::GetFloatArrays() -> std::array<std::vector<float> *, 4> {
+			return {&boundsMinX, &boundsMinY, &boundsMaxX, &boundsMaxY};
+		}
+
+		auto PhysicsSystem::Track(RigidBodyComponent *body) -> void {
+			auto index = static_cast<std::uint32_t>(mBodies.components.size());
+			body->mSystem = this;
+			body->mBody = index;
+			mBodies.components.push_back(body);
+			mBodies.transforms.push_back(nullptr);
+			for (auto array : mBodies.GetRealArrays()) {
+				array->push_back(0);
+			}
+			for (auto array : mBodies.GetFloatArrays()) {
+				array->push_back(0.0f);
+			}
+			mBodies.shape.push_back(RigidBodyComponent::Shape::None);
+			mBodies.cells.emplace_back();
+			mBodies.nextCells.emplace_back();
+			mBodies.proxies.push_back(AabbTree::NullNode);
+			mBodies.islands.push_back(NoIsland);
+			// a new body is awake, it takes the place of the first sleeping body
+			SwapBodies(index, mAwake);
+			index = mAwake++;
+			StoreBody(index, body->mState);
+			body->mPlaced = body->mSaved.has_value();
+			if (body->mSaved.has_value()) {
+				// a loaded body goes on from its exact numbers, its contacts are found again before the next step
+				RestoreBody(index, *body->mSaved);
+				body->mSaved.reset();
+				mRefresh = true;
+			}
+			if (!ResolveTransform(index)) {
+				body->mUnresolved = true;
+				mUnresolved.push_back(body);
+			}
+		}
+
+		auto PhysicsSystem::Untrack(RigidBodyComponent *body) -> void {
+			// the bodies resting on a removed body wake up, as does its own island
+			if (mBodies.proxies[body->mBody] != AabbTree::NullNode) {
+				auto index = body->mBody;
+				mWakes.clear();
+				mTree.Query({mBodies.boundsMinX[index], mBodies.boundsMinY[index]}, {mBodies.boundsMaxX[index], mBodies.boundsMaxY[index]}, [&](std::uint32_t other) {
+					if (other >= mAwake) {
+						mWakes.push_back(mBodies.islands[other]);
+					}
+					return true;
+				});
+				for (auto island : mWakes) {
+					WakeIsland(island);
+				}
+			}
+			if (body->mBody >= mAwake) {
+				WakeIsland(mBodies.islands[body->mBody]);
+			}
+			auto index = body->mBody;
+			body->mState = LoadBody(index);
+			body->mSaved = SaveBody(index);
+			body->mSystem = nullptr;
+			if (mBodies.transforms[index] != nullptr) {
+				mBodies.transforms[index]->mBody = nullptr;
+			}
+			if (body->mUnresolved) {
+				body->mUnresolved = false;
+				mUnresolved.erase(std::find(mUnresolved.begin(), mUnresolved.end(), body));
+			}
+			// the body leaves the bodies awake, then the last body takes its place
+			mAwake -= 1;
+			SwapBodies(index, mAwake);
+			auto last = static_cast<std::uint32_t>(mBodies.components.size() - 1);
+			SwapBodies(mAwake, last);
+			if (!SpatialHashGrid::IsEmpty(mBodies.cells[last])) {
+				mGrid.Remove(last, mBodies.cells[last]);
+			}
+			if (mBodies.proxies[last] != AabbTree::NullNode) {
+				mTree.DestroyProxy(mBodies.proxies[last]);
+			}
+			mBodies.components.pop_back();
+			mBodies.transforms.pop_back();
+			for (auto array : mBodies.GetRealArrays()) {
+				array->pop_back();
+			}
+			for (auto array : mBodies.GetFloatArrays()) {
+				array->pop_back();
+			}
+			mBodies.shape.pop_back();
+			mBodies.cells.pop_back();
+			mBodies.nextCells.pop_back();
+			mBodies.proxies.pop_back();
+			mBodies.islands.pop_back();
+			// the pairs hold indexes which are no longer valid
+			mPairs.clear();
+			mContacts.clear();
+			mSolver.Reset();
+			mOrigins.clear();
+		}
+
+		auto PhysicsSystem::ResolveTransform(std::uint32_t body) -> bool {
+			auto component = mBodies.components[body];
+			auto transform = component->mEntity.GetComponent<TransformComponent>();
+			if (mBodies.transforms[body] != nullptr) {
+				mBodies.transforms[body]->mBody = nullptr;
+			}
+			mBodies.transforms[body] = transform;
+			if (transform != nullptr) {
+				transform->mBody = component;
+			}
+			if (transform != nullptr && component->mPlaced) {
+				// a loaded body is where it was saved, it places its transform which would otherwise teleport it on the next step
+				auto position = glm::vec2(ToFloat(mBodies.positionX[body]), ToFloat(mBodies.positionY[body]));
+				if (transform->GetPosition() != position) {
+					transform->SetPosition(position);
+				}
+				auto rotation = ToFloat(mBodies.rotation[body]);
+				if (transform->GetRotation() != rotation) {
+					transform->SetRotation(rotation);
+				}
+			} else if (transform != nullptr) {
+				// the transform places the body when it is created
+				auto position = transform->GetPosition();
+				mBodies.positionX[body] = position.x;
+				mBodies.positionY[body] = position.y;
+				mBodies.rotation[body] = transform->GetRotation();
+			}
+			return transform != nullptr;
+		}
+
+		auto PhysicsSystem::DetachTransform(TransformComponent *transform) -> void {
+			// the body stops reading a removed transform, like a body created without one
+			auto body = transform->mBody;
+			transform->mBody = nullptr;
+			body->mSystem->mBodies.transforms[body->mBody] = nullptr;
+		}
+
+		auto PhysicsSystem::LoadBody(std::uint32_t body) const -> RigidBodyComponent::State {
+			RigidBodyComponent::State state;
+			state.position = {ToFloat(mBodies.positionX[body]), ToFloat(mBodies.positionY[body])};
+			state.velocity = {ToFloat(mBodies.velocityX[body]), ToFloat(mBodies.velocityY[body])};
+			state.acceleration = {ToFloat(mBodies.accelerationX[body]), ToFloat(mBodies.accelerationY[body])};
+			state.force = {ToFloat(mBodies.forceX[body]), ToFloat(mBodies.forceY[body])};
+			state.rotation = ToFloat(mBodies.rotation[body]);
+			state.angularVelocity = ToFloat(mBodies.angularVelocity[body]);
+			state.inverseMass = ToFloat(mBodies.inverseMass[body]);
+			state.linearDamping = ToFloat(mBodies.linearDamping[body]);
+			state.angularDamping = ToFloat(mBodies.angularDamping[body]);
+			state.shape = mBodies.shape[body];
+			state.extents = {ToFloat(mBodies.extentX[body]), ToFloat(mBodies.extentY[body])};
+			return state;
+		}
+
+		auto PhysicsSystem::StoreBody(std::uint32_t body, RigidBodyComponent::State const &state) -> void {
+			if (body >= mAwake) {
+				// a sleeping body changed through its component wakes its island up, the pairs lost their indexes
+				auto component = mBodies.components[body];
+				WakeIsland(mBodies.islands[body]);
+				body = component->mBody;
+				mPairs.clear();
+				mContacts.clear();
+				mRefresh = true;
+			}
+			// the state only changes the fields which differ from their float, the others keep the precision of their numbers
+			auto store = [](Real &value, float stored) {
+				if (ToFloat(value) != stored) {
+					value = stored;
+				}
+			};
+			mBodies.sleepTime[body] = 0;
+			store(mBodies.positionX[body], state.position.x);
+			store(mBodies.positionY[body], state.position.y);
+			store(mBodies.velocityX[body], state.velocity.x);
+			store(mBodies.velocityY[body], state.velocity.y);
+			store(mBodies.accelerationX[body], state.acceleration.x);
+			store(mBodies.accelerationY[body], state.acceleration.y);
+			store(mBodies.forceX[body], state.force.x);
+			store(mBodies.forceY[body], state.force.y);
+			store(mBodies.rotation[body], state.rotation);
+			store(mBodies.angularVelocity[body], state.angularVelocity);
+			store(mBodies.inverseMass[body], state.inverseMass);
+			store(mBodies.linearDamping[body], state.linearDamping);
+			store(mBodies.angularDamping[body], state.angularDamping);
+			mBodies.shape[body] = state.shape;
+			store(mBodies.extentX[body], state.extents.x);
+			store(mBodies.extentY[body], state.extents.y);
+			UpdateInertia(body);
+			if (state.force != glm::vec2(0.0f, 0.0f)) {
+				mForces = true;
+			}
+		}
+
+		auto PhysicsSystem::SaveBody(std::uint32_t body) const -> RigidBodyComponent::SavedState {
+			RigidBodyComponent::SavedState saved;
+			saved.positionX = mBodies.positionX[body];
+			saved.positionY = mBodies.positionY[body];
+			saved.rotation = mBodies.rotation[body];
+			saved.velocityX = mBodies.velocityX[body];
+			saved.velocityY = mBodies.velocityY[body];
+			saved.angularVelocity = mBodies.angularVelocity[body];
+			saved.accelerationX = mBodies.accelerationX[body];
+			saved.accelerationY = mBodies.accelerationY[body];
+			saved.forceX = mBodies.forceX[body];
+			saved.forceY = mBodies.forceY[body];
+			saved.inverseMass = mBodies.inverseMass[body];
+			saved.linearDamping = mBodies.linearDamping[body];
+			saved.angularDamping = mBodies.angularDamping[body];
+			saved.extentX = mBodies.extentX[body];
+			saved.extentY = mBodies.extentY[body];
+			saved.sleepTime = mBodies.sleepTime[body];
+			saved.shape = mBodies.shape[body];
+			return saved;
+		}
+
+		auto PhysicsSystem::RestoreBody(std::uint32_t body, RigidBodyComponent::SavedState const &saved) -> void {
+			mBodies.positionX[body] = saved.positionX;
+			mBodies.positionY[body] = saved.positionY;
+			mBodies.rotation[body] = saved.rotation;
+			mBodies.velocityX[body] = saved.velocityX;
+			mBodies.velocityY[body] = saved.velocityY;
+			mBodies.angularVelocity[body] = saved.angularVelocity;
+			mBodies.accelerationX[body] = saved.accelerationX;
+			mBodies.accelerationY[body] = saved.accelerationY;
+			mBodies.forceX[body] = saved.forceX;
+			mBodies.forceY[body] = saved.forceY;
+			mBodies.inverseMass[body] = saved.inverseMass;
+			mBodies.linearDamping[body] = saved.linearDamping;
+			mBodies.angularDamping[body] = saved.angularDamping;
+			mBodies.extentX[body] = saved.extentX;
+			mBodies.extentY[body] = saved.extentY;
+			mBodies.sleepTime[body] = saved.sleepTime;
+			mBodies.shape[body] = saved.shape;
+			UpdateInertia(body);
+			if (saved.forceX != 0 || saved.forceY != 0) {
+				mForces = true;
+			}
+		}
+
+		auto PhysicsSystem::UpdateInertia(std::uint32_t body) -> void {
+			// solid circles and boxes, a body without shape does not turn from contacts
+			auto extentX = mBodies.extentX[body], extentY = mBodies.extentY[body];
+			auto inertia = Real(0);
+			if (mBodies.shape[body] == RigidBodyComponent::Shape::Circle) {
+				inertia = extentX * extentX / Real(2);
+			} else if (mBodies.shape[body] == RigidBodyComponent::Shape::Box) {
+				inertia = (extentX * extentX + extentY * extentY) / Real(3);
+			}
+			mBodies.inverseInertia[body] = inertia > 0 ? mBodies.inverseMass[body] / inertia : Real(0);
 		}
 
 	} // namespace Game
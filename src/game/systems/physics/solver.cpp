@@ -0,0 +1,424 @@
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+
+#include "core/jobs/jobsystem.hpp"
+
+#include "game/systems/physics/solver.hpp"
+
+namespace Symbiote {
+	namespace Game {
+
+		namespace {
+			using Symbiote::Core::Real;
+			using Symbiote::Core::RealVec2;
+
+			constexpr std::uint32_t Unassigned = std::numeric_limits<std::uint32_t>::max();
+			// a body remembers the colors of its contacts in a mask, the contacts which find no free color share the last one and are solved serially
+			constexpr std::uint32_t MaxColors = 64;
+
+			auto Dot(RealVec2 const &a, RealVec2 const &b) -> Real {
+				return a.x * b.x + a.y * b.y;
+			}
+
+			auto Cross(RealVec2 const &a, RealVec2 const &b) -> Real {
+				return a.x * b.y - a.y * b.x;
+			}
+
+			// the velocity of a point of a body turning at the angular velocity
+			auto Cross(Real angularVelocity, RealVec2 const &anchor) -> RealVec2 {
+				return {-angularVelocity * anchor.y, angularVelocity * anchor.x};
+			}
+
+			auto Key(std::uint32_t a, std::uint32_t b) -> std::uint64_t {
+				return (static_cast<std::uint64_t>(a) << 32) | b;
+			}
+
+			auto Run(Symbiote::Core::JobSystem *jobs, std::size_t count, std::size_t grainSize, Symbiote::Core::JobSystem::RangeJob const &job) -> void {
+				if (jobs != nullptr && count > grainSize) {
+					jobs->ParallelFor(0, count, grainSize, job);
+				} else {
+					job(0, count);
+				}
+			}
+		} // namespace
+
+		auto ContactSolver::Solve(Bodies const &bodies, std::size_t bodyCount, std::vector<Narrowphase::Contact> const &contacts, Real deltaTime, Symbiote::Core::JobSystem *jobs) -> void {
+			auto inverseDeltaTime = deltaTime > 0 ? Real(1) / deltaTime : Real(0);
+			mConstraints.resize(contacts.size());
+			Run(jobs, contacts.size(), ContactsPerJob, [&](std::size_t begin, std::size_t end) {
+				for (auto contact = begin; contact < end; contact++) {
+					Prepare(bodies, contacts[contact], inverseDeltaTime, mConstraints[contact]);
+				}
+			});
+			BuildIslands(bodies, bodyCount);
+			// colored islands are at the end, every other island is solved by a single job
+			auto colored = static_cast<std::size_t>(std::partition_point(mIslands.begin(), mIslands.end(), [](auto &island) { return island.colorBegin == island.colorEnd; }) - mIslands.begin());
+			Run(jobs, colored, IslandsPerJob, [&](std::size_t begin, std::size_t end) {
+				for (auto island = begin; island < end; island++) {
+					SolveIsland(bodies, mIslands[island]);
+				}
+			});
+			for (auto island = colored; island < mIslands.size(); island++) {
+				SolveColors(bodies, mIslands[island], jobs);
+			}
+			// the impulses warm start the next step
+			std::swap(mPrevious, mConstraints);
+			mCache.clear();
+			for (std::uint32_t constraint = 0; constraint < mPrevious.size(); constraint++) {
+				mCache[Key(mPrevious[constraint].a, mPrevious[constraint].b)] = constraint;
+			}
+		}
+
+		auto ContactSolver::Reset() -> void {
+			mPrevious.clear();
+			mCache.clear();
+			mIslands.clear();
+			mColorCount = 0;
+		}
+
+		auto ContactSolver::Rename(std::unordered_map<std::uint32_t, std::uint32_t> const &renames) -> void {
+			auto rename = [&](std::uint32_t &body) {
+				auto renamed = renames.find(body);
+				if (renamed != renames.end()) {
+					body = renamed->second;
+				}
+			};
+			mCache.clear();
+			for (std::uint32_t constraint = 0; constraint < mPrevious.size(); constraint++) {
+				rename(mPrevious[constraint].a);
+				rename(mPrevious[constraint].b);
+				mCache[Key(mPrevious[constraint].a, mPrevious[constraint].b)] = constraint;
+			}
+		}
+
+		auto ContactSolver::GetIterations() const -> std::size_t {
+			return mIterations;
+		}
+
+		auto ContactSolver::SetIterations(std::size_t iterations) -> void {
+			if (iterations == 0) {
+				throw std::logic_error("ContactSolver::SetIterations: iterations must be positive");
+			}
+			mIterations = iterations;
+		}
+
+		auto ContactSolver::GetIslandCount() const -> std::size_t {
+			return mIslands.size();
+		}
+
+		auto ContactSolver::GetColorCount() const -> std::size_t {
+			return mColorCount;
+		}
+
+		auto ContactSolver::GetIslandBodies(std::size_t island, std::vector<std::uint32_t> &bodies) const -> void {
+			bodies.assign(mBodies.begin() + static_cast<std::ptrdiff_t>(mIslands[island].bodyBegin), mBodies.begin() + static_cast<std::ptrdiff_t>(mIslands[island].bodyEnd));
+		}
+
+		auto ContactSolver::Prepare(Bodies const &bodies, Narrowphase::Contact const &contact, Real inverseDeltaTime, Constraint &constraint) const -> void {
+			auto a = contact.a, b = contact.b;
+			auto massA = bodies.inverseMass[a], massB = bodies.inverseMass[b];
+			auto inertiaA = bodies.inverseInertia[a], inertiaB = bodies.inverseInertia[b];
+			auto centerA = RealVec2(bodies.x[a], bodies.y[a]);
+			auto centerB = RealVec2(bodies.x[b], bodies.y[b]);
+			auto tangent = RealVec2(contact.normal.y, -contact.normal.x);
+			auto cached = mCache.find(Key(a, b));
+			auto previous = cached != mCache.end() ? &mPrevious[cached->second] : nullptr;
+			constraint.a = a;
+			constraint.b = b;
+			constraint.normal = contact.normal;
+			constraint.pointCount = contact.pointCount;
+			for (std::uint32_t index = 0; index < contact.pointCount; index++) {
+				auto &source = contact.points[index];
+				auto &point = constraint.points[index];
+				point.anchorA = source.position - centerA;
+				point.anchorB = source.position - centerB;
+				auto normalA = Cross(point.anchorA, contact.normal), normalB = Cross(point.anchorB, contact.normal);
+				auto tangentA = Cross(point.anchorA, tangent), tangentB = Cross(point.anchorB, tangent);
+				auto normalMass = massA + massB + inertiaA * normalA * normalA + inertiaB * normalB * normalB;
+				auto tangentMass = massA + massB + inertiaA * tangentA * tangentA + inertiaB * tangentB * tangentB;
+				point.normalMass = normalMass > 0 ? Real(1) / normalMass : Real(0);
+				point.tangentMass = tangentMass > 0 ? Real(1) / tangentMass : Real(0);
+				point.bias = Baumgarte * inverseDeltaTime * std::min(std::max(-source.separation - LinearSlop, Real(0)), Real(MaxCorrection));
+				point.id = source.id;
+				point.normalImpulse = 0;
+				point.tangentImpulse = 0;
+				if (previous != nullptr) {
+					for (std::uint32_t match = 0; match < previous->pointCount; match++) {
+						if (previous->points[match].id == source.id) {
+							point.normalImpulse = previous->points[match].normalImpulse;
+							point.tangentImpulse = previous->points[match].tangentImpulse;
+							break;
+						}
+					}
+				}
+			}
+			if (constraint.pointCount == 2) {
+				auto &first = constraint.points[0];
+				auto &second = constraint.points[1];
+				auto firstA = Cross(first.anchorA, contact.normal), firstB = Cross(first.anchorB, contact.normal);
+				auto secondA = Cross(second.anchorA, contact.normal), secondB = Cross(second.anchorB, contact.normal);
+				constraint.k11 = massA + massB + inertiaA * firstA * firstA + inertiaB * firstB * firstB;
+				constraint.k22 = massA + massB + inertiaA * secondA * secondA + inertiaB * secondB * secondB;
+				constraint.k12 = massA + massB + inertiaA * firstA * secondA + inertiaB * firstB * secondB;
+				// points of a face nearly at the same place, the deepest one is kept, the condition is scaled down so that fixed point does not overflow
+				if (constraint.k11 * (constraint.k11 / MaxCondition) >= constraint.k11 * constraint.k22 - constraint.k12 * constraint.k12) {
+					if (second.id != first.id && contact.points[1].separation < contact.points[0].separation) {
+						first = second;
+					}
+					constraint.pointCount = 1;
+				}
+			}
+		}
+
+		auto ContactSolver::BuildIslands(Bodies const &bodies, std::size_t bodyCount) -> void {
+			// only the bodies of the contacts are set, the cost follows the contacts rather than the bodies
+			if (mParents.size() < bodyCount) {
+				mParents.resize(bodyCount);
+				mIslandIds.resize(bodyCount);
+				mMasks.resize(bodyCount);
+			}
+			for (auto &constraint : mConstraints) {
+				mParents[constraint.a] = constraint.a;
+				mParents[constraint.b] = constraint.b;
+				mIslandIds[constraint.a] = Unassigned;
+				mIslandIds[constraint.b] = Unassigned;
+			}
+			for (auto &constraint : mConstraints) {
+				if (bodies.inverseMass[constraint.a] > 0.0f && bodies.inverseMass[constraint.b] > 0.0f) {
+					auto a = Find(constraint.a), b = Find(constraint.b);
+					// the lowest body is the root, islands do not depend on the order of the contacts
+					mParents[std::max(a, b)] = std::min(a, b);
+				}
+			}
+			// islands are numbered in the order of their first contact, the constraints are sorted by island keeping their order
+			mLabels.resize(mConstraints.size());
+			mIslands.clear();
+			for (std::size_t index = 0; index < mConstraints.size(); index++) {
+				auto &constraint = mConstraints[index];
+				auto root = Find(bodies.inverseMass[constraint.a] > 0.0f ? constraint.a : constraint.b);
+				if (mIslandIds[root] == Unassigned) {
+					mIslandIds[root] = static_cast<std::uint32_t>(mIslands.size());
+					mIslands.emplace_back();
+				}
+				mLabels[index] = mIslandIds[root];
+				mIslands[mLabels[index]].end += 1;
+			}
+			std::size_t offset = 0;
+			for (auto &island : mIslands) {
+				island.begin = offset;
+				offset += island.end;
+				island.end = island.begin;
+			}
+			mOrder.resize(mConstraints.size());
+			for (std::uint32_t index = 0; index < mConstraints.size(); index++) {
+				mOrder[mIslands[mLabels[index]].end++] = index;
+			}
+			// the bodies with mass are listed by island, the parents are no longer needed and mark the bodies listed
+			mBodies.clear();
+			for (auto &island : mIslands) {
+				island.bodyBegin = mBodies.size();
+				for (auto index = island.begin; index < island.end; index++) {
+					auto &constraint = mConstraints[mOrder[index]];
+					for (auto body : {constraint.a, constraint.b}) {
+						if (bodies.inverseMass[body] > 0.0f && mParents[body] != Unassigned) {
+							mParents[body] = Unassigned;
+							mBodies.push_back(body);
+						}
+					}
+				}
+				island.bodyEnd = mBodies.size();
+			}
+			mColors.clear();
+			mColorCount = 0;
+			for (auto &island : mIslands) {
+				if (island.end - island.begin > ColoringThreshold) {
+					Color(bodies, island);
+				}
+			}
+			std::stable_partition(mIslands.begin(), mIslands.end(), [](auto &island) { return island.colorBegin == island.colorEnd; });
+		}
+
+		auto ContactSolver::Color(Bodies const &bodies, Island &island) -> void {
+			// greedy coloring, a contact takes the first color which none of its dynamic bodies has
+			std::size_t counts[MaxColors + 1] = {};
+			for (auto index = island.begin; index < island.end; index++) {
+				auto &constraint = mConstraints[mOrder[index]];
+				auto dynamicA = bodies.inverseMass[constraint.a] > 0.0f, dynamicB = bodies.inverseMass[constraint.b] > 0.0f;
+				auto used = (dynamicA ? mMasks[constraint.a] : 0) | (dynamicB ? mMasks[constraint.b] : 0);
+				std::uint32_t color = 0;
+				while (color < MaxColors && ((used >> color) & 1) != 0) {
+					color++;
+				}
+				if (color < MaxColors) {
+					auto bit = std::uint64_t(1) << color;
+					mMasks[constraint.a] |= dynamicA ? bit : 0;
+					mMasks[constraint.b] |= dynamicB ? bit : 0;
+				}
+				mLabels[index] = color;
+				counts[color] += 1;
+			}
+			for (auto index = island.begin; index < island.end; index++) {
+				auto &constraint = mConstraints[mOrder[index]];
+				mMasks[constraint.a] = 0;
+				mMasks[constraint.b] = 0;
+			}
+			// the constraints of the island are sorted by color, the empty colors are skipped
+			island.colorBegin = mColors.size();
+			auto offset = island.begin;
+			std::size_t offsets[MaxColors + 1] = {};
+			for (std::uint32_t color = 0; color <= MaxColors; color++) {
+				offsets[color] = offset;
+				if (counts[color] > 0) {
+					mColors.push_back(offset);
+					offset += counts[color];
+				}
+			}
+			mColors.push_back(offset);
+			island.colorEnd = mColors.size() - 1;
+			mColorCount = std::max(mColorCount, island.colorEnd - island.colorBegin);
+			mScratch.resize(island.end - island.begin);
+			for (auto index = island.begin; index < island.end; index++) {
+				mScratch[offsets[mLabels[index]]++ - island.begin] = mOrder[index];
+			}
+			std::copy(mScratch.begin(), mScratch.end(), mOrder.begin() + static_cast<std::ptrdiff_t>(island.begin));
+		}
+
+		auto ContactSolver::Find(std::uint32_t body) -> std::uint32_t {
+			while (mParents[body] != body) {
+				// path halving
+				mParents[body] = mParents[mParents[body]];
+				body = mParents[body];
+			}
+			return body;
+		}
+
+		auto ContactSolver::SolveIsland(Bodies const &bodies, Island const &island) -> void {
+			for (auto index = island.begin; index < island.end; index++) {
+				WarmStart(bodies, mConstraints[mOrder[index]]);
+			}
+			for (std::size_t iteration = 0; iteration < mIterations; iteration++) {
+				for (auto index = island.begin; index < island.end; index++) {
+					SolveConstraint(bodies, mConstraints[mOrder[index]]);
+				}
+			}
+		}
+
+		auto ContactSolver::SolveColors(Bodies const &bodies, Island const &island, Symbiote::Core::JobSystem *jobs) -> void {
+			auto colors = [&](auto const &solve) {
+				for (auto color = island.colorBegin; color < island.colorEnd; color++) {
+					auto begin = mColors[color], count = mColors[color + 1] - begin;
+					// only the overflow color comes after all the others, its contacts share bodies and are solved by a single job
+					auto grainSize = color + 1 == island.colorEnd && island.colorEnd - island.colorBegin > MaxColors ? count : ContactsPerJob;
+					Run(jobs, count, grainSize, [&](std::size_t first, std::size_t last) {
+						for (auto index = begin + first; index < begin + last; index++) {
+							solve(mConstraints[mOrder[index]]);
+						}
+					});
+				}
+			};
+			colors([&](Constraint &constraint) { WarmStart(bodies, constraint); });
+			for (std::size_t iteration = 0; iteration < mIterations; iteration++) {
+				colors([&](Constraint &constraint) { SolveConstraint(bodies, constraint); });
+			}
+		}
+
+		auto ContactSolver::WarmStart(Bodies const &bodies, Constraint const &constraint) -> void {
+			auto a = constraint.a, b = constraint.b;
+			auto tangent = RealVec2(constraint.normal.y, -constraint.normal.x);
+			auto impulse = RealVec2(0, 0);
+			auto torqueA = Real(0), torqueB = Real(0);
+			for (std::uint32_t index = 0; index < constraint.pointCount; index++) {
+				auto &point = constraint.points[index];
+				auto pointImpulse = constraint.normal * point.normalImpulse + tangent * point.tangentImpulse;
+				impulse += pointImpulse;
+				torqueA += Cross(point.anchorA, pointImpulse);
+				torqueB += Cross(point.anchorB, pointImpulse);
+			}
+			if (bodies.inverseMass[a] > 0.0f) {
+				bodies.velocityX[a] -= impulse.x * bodies.inverseMass[a];
+				bodies.velocityY[a] -= impulse.y * bodies.inverseMass[a];
+				bodies.angularVelocity[a] -= torqueA * bodies.inverseInertia[a];
+			}
+			if (bodies.inverseMass[b] > 0.0f) {
+				bodies.velocityX[b] += impulse.x * bodies.inverseMass[b];
+				bodies.velocityY[b] += impulse.y * bodies.inverseMass[b];
+				bodies.angularVelocity[b] += torqueB * bodies.inverseInertia[b];
+			}
+		}
+
+		auto ContactSolver::SolveConstraint(Bodies const &bodies, Constraint &constraint) -> void {
+			auto a = constraint.a, b = constraint.b;
+			auto massA = bodies.inverseMass[a], massB = bodies.inverseMass[b];
+			auto inertiaA = bodies.inverseInertia[a], inertiaB = bodies.inverseInertia[b];
+			auto velocityA = RealVec2(bodies.velocityX[a], bodies.velocityY[a]);
+			auto velocityB = RealVec2(bodies.velocityX[b], bodies.velocityY[b]);
+			auto angularA = bodies.angularVelocity[a], angularB = bodies.angularVelocity[b];
+			auto normal = constraint.normal;
+			auto tangent = RealVec2(normal.y, -normal.x);
+			auto apply = [&](RealVec2 const &anchorA, RealVec2 const &anchorB, RealVec2 const &impulse) {
+				velocityA -= impulse * massA;
+				angularA -= Cross(anchorA, impulse) * inertiaA;
+				velocityB += impulse * massB;
+				angularB += Cross(anchorB, impulse) * inertiaB;
+			};
+			// friction first, it is bounded by the normal impulse of the last iteration
+			for (std::uint32_t index = 0; index < constraint.pointCount; index++) {
+				auto &point = constraint.points[index];
+				auto relative = velocityB + Cross(angularB, point.anchorB) - velocityA - Cross(angularA, point.anchorA);
+				auto maxImpulse = Friction * point.normalImpulse;
+				auto impulse = std::max(-maxImpulse, std::min(point.tangentImpulse - Dot(relative, tangent) * point.tangentMass, maxImpulse));
+				apply(point.anchorA, point.anchorB, tangent * (impulse - point.tangentImpulse));
+				point.tangentImpulse = impulse;
+			}
+			// the accumulated normal impulse only pushes, the bias removes the penetration
+			if (constraint.pointCount == 1) {
+				auto &point = constraint.points[0];
+				auto relative = velocityB + Cross(angularB, point.anchorB) - velocityA - Cross(angularA, point.anchorA);
+				auto impulse = std::max(point.normalImpulse - (Dot(relative, normal) - point.bias) * point.normalMass, Real(0));
+				apply(point.anchorA, point.anchorB, normal * (impulse - point.normalImpulse));
+				point.normalImpulse = impulse;
+			} else if (constraint.pointCount == 2) {
+				// solving the points one after the other makes stacks rock, both impulses are found together as a linear complementarity problem
+				auto &first = constraint.points[0];
+				auto &second = constraint.points[1];
+				auto accumulated = RealVec2(first.normalImpulse, second.normalImpulse);
+				auto firstVelocity = Dot(velocityB + Cross(angularB, first.anchorB) - velocityA - Cross(angularA, first.anchorA), normal);
+				auto secondVelocity = Dot(velocityB + Cross(angularB, second.anchorB) - velocityA - Cross(angularA, second.anchorA), normal);
+				auto k11 = constraint.k11, k12 = constraint.k12, k22 = constraint.k22;
+				// b is the normal velocity left once the accumulated impulses are removed
+				auto b = RealVec2(firstVelocity - first.bias - (k11 * accumulated.x + k12 * accumulated.y), secondVelocity - second.bias - (k12 * accumulated.x + k22 * accumulated.y));
+				auto impulse = RealVec2(0, 0);
+				auto determinant = k11 * k22 - k12 * k12;
+				// both points push, then only one of them, then none: the first case whose impulses push and velocities separate
+				auto both = RealVec2(-(k22 * b.x - k12 * b.y), -(k11 * b.y - k12 * b.x)) / determinant;
+				if (both.x >= 0.0f && both.y >= 0.0f) {
+					impulse = both;
+				} else if (-b.x / k11 >= 0.0f && k12 * (-b.x / k11) + b.y >= 0.0f) {
+					impulse = {-b.x / k11, Real(0)};
+				} else if (-b.y / k22 >= 0.0f && k12 * (-b.y / k22) + b.x >= 0.0f) {
+					impulse = {Real(0), -b.y / k22};
+				} else if (!(b.x >= 0.0f && b.y >= 0.0f)) {
+					// no case holds, which only happens with degenerate masses: the impulses are kept
+					impulse = accumulated;
+				}
+				auto delta = impulse - accumulated;
+				apply(first.anchorA, first.anchorB, normal * delta.x);
+				apply(second.anchorA, second.anchorB, normal * delta.y);
+				first.normalImpulse = impulse.x;
+				second.normalImpulse = impulse.y;
+			}
+			if (massA > 0.0f) {
+				bodies.velocityX[a] = velocityA.x;
+				bodies.velocityY[a] = velocityA.y;
+				bodies.angularVelocity[a] = angularA;
+			}
+			if (massB > 0.0f) {
+				bodies.velocityX[b] = velocityB.x;
+				bodies.velocityY[b] = velocityB.y;
+				bodies.angularVelocity[b] = angularB;
+			}
+		}
+
+	} // namespace Game
+} // namespace Symbiote
\ No newline at end of file
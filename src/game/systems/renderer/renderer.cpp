@@ -2,7 +2,11 @@
 
 #include <SDL2/SDL.h>
 
+#include "core/ecs/entitymanager.hpp"
+#include "core/profiler/profiler.hpp"
+
 #include "game/systems/renderer/renderer.hpp"
+#include "game/components/transform/transform.hpp"
 
 DEFINE_SYSTEM(Symbiote::Game::RendererSystem);
 
@@ -26,8 +30,12 @@ namespace Symbiote {
 			SDL_Quit();
 		}
 
-		auto RendererSystem::Render() -> void {
-			mVulkanRenderer.Render();
+		auto RendererSystem::Render(float alpha) -> void {
+			SYMBIOTE_PROFILE_SCOPE(SystemName);
+			auto timer = TimeUpdate();
+			mSprites.clear();
+			static_cast<const Symbiote::Core::EntityManager &>(*mManager).With<TransformComponent>([this, alpha](auto, auto transform) { mSprites.push_back(transform->GetInterpolatedMatrix(alpha)); });
+			mVulkanRenderer.Render(mSprites);
 		}
 
 		auto RendererSystem::PollEvents() -> bool {
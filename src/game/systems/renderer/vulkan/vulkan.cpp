@@ -1,14 +1,63 @@
+#include <cmath>
 #include <vector>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <algorithm>
 #include <exception>
 
 #include <glm/vec4.hpp>
+#include <glm/mat3x3.hpp>
+#include <glm/geometric.hpp>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_vulkan.h>
 #include <vulkan/vulkan.hpp>
 
+#include "core/profiler/profiler.hpp"
+
 #include "game/systems/renderer/vulkan/vulkan.hpp"
 
+// sprites are squares of white texels, a world unit is sprite_pixels_per_unit pixels
+static constexpr std::uint32_t sprite_max_pixels = 64;
+static constexpr float sprite_pixels_per_unit = 16.0f;
+
+static auto find_host_memory_type(VkPhysicalDevice device, std::uint32_t type_bits) -> std::uint32_t {
+	VkPhysicalDeviceMemoryProperties memory_properties;
+	vkGetPhysicalDeviceMemoryProperties(device, &memory_properties);
+	VkMemoryPropertyFlags flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+	for (std::uint32_t type_index = 0; type_index < memory_properties.memoryTypeCount; ++type_index) {
+		if ((type_bits & (1u << type_index)) != 0 && (memory_properties.memoryTypes[type_index].propertyFlags & flags) == flags) {
+			return type_index;
+		}
+	}
+	throw std::runtime_error("VulkanRenderer::VulkanRenderer(): no host visible memory type");
+}
+
+static auto sprite_region(glm::mat3 const &sprite, VkExtent2D const &extent) -> VkBufferImageCopy {
+	// the origin is the center of the window and y goes up, the square is clipped to the window
+	auto size = std::clamp(glm::length(glm::vec2(sprite[0])) * sprite_pixels_per_unit, 1.0f, static_cast<float>(sprite_max_pixels));
+	auto center_x = static_cast<float>(extent.width) * 0.5f + sprite[2][0] * sprite_pixels_per_unit;
+	auto center_y = static_cast<float>(extent.height) * 0.5f - sprite[2][1] * sprite_pixels_per_unit;
+	VkBufferImageCopy region = {
+		bufferOffset : 0,
+		bufferRowLength : sprite_max_pixels,
+		bufferImageHeight : sprite_max_pixels,
+		imageSubresource : {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1},
+		imageOffset : {0, 0, 0},
+		imageExtent : {0, 0, 1},
+	};
+	if (!std::isfinite(size) || !std::isfinite(center_x) || !std::isfinite(center_y)) {
+		return region;
+	}
+	auto left = std::clamp(std::floor(center_x - size * 0.5f), 0.0f, static_cast<float>(extent.width));
+	auto right = std::clamp(std::floor(center_x + size * 0.5f), 0.0f, static_cast<float>(extent.width));
+	auto top = std::clamp(std::floor(center_y - size * 0.5f), 0.0f, static_cast<float>(extent.height));
+	auto bottom = std::clamp(std::floor(center_y + size * 0.5f), 0.0f, static_cast<float>(extent.height));
+	region.imageOffset = {static_cast<std::int32_t>(left), static_cast<std::int32_t>(top), 0};
+	region.imageExtent = {static_cast<std::uint32_t>(right - left), static_cast<std::uint32_t>(bottom - top), 1};
+	return region;
+}
+
 static auto vulkan_debug_report(VkDebugReportFlagsEXT flags, VkDebugReportObjectTypeEXT objectType, std::uint64_t object, std::size_t location, std::int32_t messageCode, const char *pLayerPrefix, const char *pMessage, void *pUserData) -> VkBool32 {
 	std::cout << pMessage << std::endl;
 	return VK_TRUE;
@@ -142,7 +191,7 @@ VulkanRenderer::VulkanRenderer(SDL_Window *window, glm::vec4 const &clear_color)
 			imageColorSpace : mPhysicalDevicesSurfaceFormatKHR[mPhysicalDeviceIndex][0].colorSpace, // TODO: replace 0
 			imageExtent : mPhysicalDeviceSurfaceCapabilitiesKHR[mPhysicalDeviceIndex].currentExtent,
 			imageArrayLayers : 1,
-			imageUsage : VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+			imageUsage : VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
 			imageSharingMode : VK_SHARING_MODE_EXCLUSIVE,
 			preTransform : VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR,
 			compositeAlpha : VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR,
@@ -153,6 +202,7 @@ VulkanRenderer::VulkanRenderer(SDL_Window *window, glm::vec4 const &clear_color)
 		if (vkCreateSwapchainKHR(mDevice, &swapchain_create_info, nullptr, &mSwapchainKHR) != VK_SUCCESS) {
 			throw std::runtime_error("VulkanRenderer::VulkanRenderer(): vkCreateSwapchainKHR failed");
 		}
+		mSwapchainExtent = swapchain_create_info.imageExtent;
 
 		unsigned int swapchain_image_count = 0;
 		if (vkGetSwapchainImagesKHR(mDevice, mSwapchainKHR, &swapchain_image_count, nullptr) != VK_SUCCESS) {
@@ -166,6 +216,7 @@ VulkanRenderer::VulkanRenderer(SDL_Window *window, glm::vec4 const &clear_color)
 
 		VkCommandPoolCreateInfo command_pool_create_info = {
 			sType : VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+			flags : VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
 			queueFamilyIndex : mPhysicalDeviceFamilyQueueIndex,
 		};
 
@@ -184,46 +235,105 @@ VulkanRenderer::VulkanRenderer(SDL_Window *window, glm::vec4 const &clear_color)
 			throw std::runtime_error("VulkanRenderer::VulkanRenderer(): vkAllocateCommandBuffers failed");
 		}
 
-		VkCommandBufferBeginInfo command_buffer_begin_info = {
-			sType : VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-			flags : VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT,
+		// the command buffers are recorded each frame, the sprites move
+		mClearColor = {clear_color.r, clear_color.g, clear_color.b, clear_color.a};
+
+		// Create sprite buffer
+		VkBufferCreateInfo sprite_buffer_create_info = {
+			sType : VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+			size : sprite_max_pixels * sprite_max_pixels * sizeof(std::uint32_t),
+			usage : VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			sharingMode : VK_SHARING_MODE_EXCLUSIVE,
 		};
-		VkClearColorValue clear_color_value = {clear_color.r, clear_color.g, clear_color.b, clear_color.a};
-		VkImageSubresourceRange image_range = {
-			aspectMask : VK_IMAGE_ASPECT_COLOR_BIT,
-			levelCount : 1,
-			layerCount : 1,
+		if (vkCreateBuffer(mDevice, &sprite_buffer_create_info, nullptr, &mSpriteBuffer) != VK_SUCCESS) {
+			throw std::runtime_error("VulkanRenderer::VulkanRenderer(): vkCreateBuffer failed");
+		}
+		VkMemoryRequirements sprite_memory_requirements;
+		vkGetBufferMemoryRequirements(mDevice, mSpriteBuffer, &sprite_memory_requirements);
+		VkMemoryAllocateInfo sprite_memory_allocate_info = {
+			sType : VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+			allocationSize : sprite_memory_requirements.size,
+			memoryTypeIndex : find_host_memory_type(mPhysicalDevices[mPhysicalDeviceIndex], sprite_memory_requirements.memoryTypeBits),
 		};
-
-		for (unsigned int command_buffer_index = 0; command_buffer_index < mCommandBuffers.size(); command_buffer_index++) {
-			if (vkBeginCommandBuffer(mCommandBuffers[command_buffer_index], &command_buffer_begin_info) != VK_SUCCESS) {
-				throw std::runtime_error("VulkanRenderer::VulkanRenderer(): vkBeginCommandBuffer failed");
-			}
-			vkCmdClearColorImage(mCommandBuffers[command_buffer_index], mSwapchainImages[command_buffer_index], VK_IMAGE_LAYOUT_GENERAL, &clear_color_value, 1, &image_range);
-			if (vkEndCommandBuffer(mCommandBuffers[command_buffer_index]) != VK_SUCCESS) {
-				throw std::runtime_error("VulkanRenderer::VulkanRenderer(): vkEndCommandBuffer failed");
-			}
+		if (vkAllocateMemory(mDevice, &sprite_memory_allocate_info, nullptr, &mSpriteMemory) != VK_SUCCESS) {
+			throw std::runtime_error("VulkanRenderer::VulkanRenderer(): vkAllocateMemory failed");
 		}
+		if (vkBindBufferMemory(mDevice, mSpriteBuffer, mSpriteMemory, 0) != VK_SUCCESS) {
+			throw std::runtime_error("VulkanRenderer::VulkanRenderer(): vkBindBufferMemory failed");
+		}
+		void *sprite_texels = nullptr;
+		if (vkMapMemory(mDevice, mSpriteMemory, 0, sprite_buffer_create_info.size, 0, &sprite_texels) != VK_SUCCESS) {
+			throw std::runtime_error("VulkanRenderer::VulkanRenderer(): vkMapMemory failed");
+		}
+		// white whatever the order of the channels of the surface format
+		std::memset(sprite_texels, 0xFF, sprite_buffer_create_info.size);
+		vkUnmapMemory(mDevice, mSpriteMemory);
 	}
 }
 
 VulkanRenderer::~VulkanRenderer() {
+	vkDestroyBuffer(mDevice, mSpriteBuffer, nullptr);
+	vkFreeMemory(mDevice, mSpriteMemory, nullptr);
 	vkDestroySurfaceKHR(mInstance, mSurface, nullptr);
 	vkDestroyInstance(mInstance, nullptr);
 }
 
-auto VulkanRenderer::Render() -> void {
+auto VulkanRenderer::Render(std::vector<glm::mat3> const &sprites) -> void {
+	SYMBIOTE_PROFILE_SCOPE("VulkanRenderer::Render");
 	unsigned int image_index = 0;
-	if (vkAcquireNextImageKHR(mDevice, mSwapchainKHR, UINT64_MAX, nullptr, nullptr, &image_index) != VK_SUCCESS) {
-		throw std::runtime_error("VulkanRenderer::VulkanRenderer(): vkAcquireNextImageKHR failed");
+	{
+		SYMBIOTE_PROFILE_SCOPE("vkAcquireNextImageKHR");
+		if (vkAcquireNextImageKHR(mDevice, mSwapchainKHR, UINT64_MAX, nullptr, nullptr, &image_index) != VK_SUCCESS) {
+			throw std::runtime_error("VulkanRenderer::VulkanRenderer(): vkAcquireNextImageKHR failed");
+		}
+	}
+	auto command_buffer = mCommandBuffers[image_index];
+	{
+		SYMBIOTE_PROFILE_SCOPE("vkBeginCommandBuffer");
+		// the command buffer of this image may still be used by the previous frame
+		if (vkQueueWaitIdle(mQueue) != VK_SUCCESS || vkResetCommandBuffer(command_buffer, 0) != VK_SUCCESS) {
+			throw std::runtime_error("VulkanRenderer::Render(): vkResetCommandBuffer failed");
+		}
+		VkCommandBufferBeginInfo command_buffer_begin_info = {
+			sType : VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+			flags : VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+		};
+		if (vkBeginCommandBuffer(command_buffer, &command_buffer_begin_info) != VK_SUCCESS) {
+			throw std::runtime_error("VulkanRenderer::Render(): vkBeginCommandBuffer failed");
+		}
+		VkImageSubresourceRange image_range = {
+			aspectMask : VK_IMAGE_ASPECT_COLOR_BIT,
+			levelCount : 1,
+			layerCount : 1,
+		};
+		vkCmdClearColorImage(command_buffer, mSwapchainImages[image_index], VK_IMAGE_LAYOUT_GENERAL, &mClearColor, 1, &image_range);
+		// the sprites are copied over the cleared image
+		VkMemoryBarrier clear_barrier = {
+			sType : VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+			srcAccessMask : VK_ACCESS_TRANSFER_WRITE_BIT,
+			dstAccessMask : VK_ACCESS_TRANSFER_WRITE_BIT,
+		};
+		vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &clear_barrier, 0, nullptr, 0, nullptr);
+		for (auto const &sprite : sprites) {
+			auto region = sprite_region(sprite, mSwapchainExtent);
+			if (region.imageExtent.width != 0 && region.imageExtent.height != 0) {
+				vkCmdCopyBufferToImage(command_buffer, mSpriteBuffer, mSwapchainImages[image_index], VK_IMAGE_LAYOUT_GENERAL, 1, &region);
+			}
+		}
+		if (vkEndCommandBuffer(command_buffer) != VK_SUCCESS) {
+			throw std::runtime_error("VulkanRenderer::Render(): vkEndCommandBuffer failed");
+		}
 	}
 	VkSubmitInfo submit_info = {
 		sType : VK_STRUCTURE_TYPE_SUBMIT_INFO,
 		commandBufferCount : 1,
-		pCommandBuffers : &mCommandBuffers[image_index],
+		pCommandBuffers : &command_buffer,
 	};
-	if (vkQueueSubmit(mQueue, 1, &submit_info, nullptr) != VK_SUCCESS) {
-		throw std::runtime_error("VulkanRenderer::VulkanRenderer(): vkQueueSubmit failed");
+	{
+		SYMBIOTE_PROFILE_SCOPE("vkQueueSubmit");
+		if (vkQueueSubmit(mQueue, 1, &submit_info, nullptr) != VK_SUCCESS) {
+			throw std::runtime_error("VulkanRenderer::VulkanRenderer(): vkQueueSubmit failed");
+		}
 	}
 	VkPresentInfoKHR presentInfo = {
 		sType : VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
@@ -231,7 +341,10 @@ auto VulkanRenderer::Render() -> void {
 		pSwapchains : &mSwapchainKHR,
 		pImageIndices : &image_index,
 	};
-	if (vkQueuePresentKHR(mQueue, &presentInfo) != VK_SUCCESS) {
-		throw std::runtime_error("VulkanRenderer::VulkanRenderer(): vkQueuePresentKHR failed");
+	{
+		SYMBIOTE_PROFILE_SCOPE("vkQueuePresentKHR");
+		if (vkQueuePresentKHR(mQueue, &presentInfo) != VK_SUCCESS) {
+			throw std::runtime_error("VulkanRenderer::VulkanRenderer(): vkQueuePresentKHR failed");
+		}
 	}
 }
\ No newline at end of file
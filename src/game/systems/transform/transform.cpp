@@ -0,0 +1,202 @@
+#include <algorithm>
+
+#include "core/ecs/entitymanager.hpp"
+
+#include "game/systems/transform/transform.hpp"
+#include "game/components/transform/transform.hpp"
+
+DEFINE_SYSTEM(Symbiote::Game::TransformSystem);
+
+namespace Symbiote {
+	namespace Game {
+
+		TransformSystem::~TransformSystem() {
+			for (auto &node : mNodes) {
+				if (node.transform != nullptr) {
+					node.transform->mSystem = nullptr;
+				}
+			}
+		}
+
+		auto TransformSystem::Update() -> void {
+			SYMBIOTE_PROFILE_SCOPE(SystemName);
+			auto timer = TimeUpdate();
+			if (!mAdopted) {
+				// transforms created before the system was added
+				mAdopted = true;
+				// transforms are read through the const manager, only the untracked ones are fetched for writing
+				static_cast<const Symbiote::Core::EntityManager &>(*mManager).With<TransformComponent>([this](auto entity, auto transform) {
+					if (transform->mSystem == nullptr) {
+						Track(entity.template GetComponent<TransformComponent>());
+					}
+				});
+			}
+			if (mOrderStale) {
+				RebuildOrder();
+			}
+			mUpdatedCount = 0;
+			if (!mPending) {
+				return;
+			}
+			// the subtree of a dirty transform is the range up to its end, every transform in it changed
+			std::sort(mDirty.begin(), mDirty.end());
+			std::uint32_t end = 0;
+			for (auto dirty : mDirty) {
+				if (dirty < end) {
+					continue;
+				}
+				end = mSubtreeEnds[dirty];
+				for (auto i = dirty; i < end; i++) {
+					auto &node = mNodes[i];
+					auto local = node.transform->GetLocalMatrix();
+					mWorlds[i] = node.parent != NoParent ? mWorlds[node.parent] * local : local;
+					node.transform->mWorld = mWorlds[i];
+					node.dirty = false;
+				}
+				mUpdatedCount += end - dirty;
+			}
+			mDirty.clear();
+			mPending = false;
+			mGeneration += 1;
+		}
+
+		auto TransformSystem::GetUpdatedCount() const -> std::size_t {
+			return mUpdatedCount;
+		}
+
+		auto TransformSystem::Track(TransformComponent *transform) -> void {
+			auto parent = NoParent;
+			if (transform->mParent.GetManager() != nullptr) {
+				// a child is not part of the range of its parent until the order is rebuilt
+				auto parentTransform = transform->mParent.IsValid() ? transform->mParent.GetComponent<TransformComponent>() : nullptr;
+				if (parentTransform != nullptr && parentTransform->mSystem == this) {
+					parent = parentTransform->mNode;
+				}
+				mOrderStale = true;
+			}
+			auto index = static_cast<std::uint32_t>(mNodes.size());
+			transform->mSystem = this;
+			transform->mNode = index;
+			mNodes.push_back({transform, parent, true});
+			mWorlds.emplace_back(1.0f);
+			mSubtreeEnds.push_back(index + 1);
+			mDirty.push_back(index);
+			mPending = true;
+			mGeneration += 1;
+		}
+
+		auto TransformSystem::Untrack(TransformComponent *transform) -> void {
+			// a transform removed from a living entity or moved to another world leaves its children in place
+			if (!transform->mEntity.IsValid()) {
+				mDestroyed.push_back(transform->mEntity);
+			}
+			mNodes[transform->mNode].transform = nullptr;
+			transform->mSystem = nullptr;
+			mOrderStale = true;
+			mPending = true;
+			mGeneration += 1;
+		}
+
+		auto TransformSystem::RebuildOrder() -> void {
+			auto count = static_cast<std::uint32_t>(mNodes.size());
+			// parents are resolved from the handles when their node is gone, a transform whose parent is destroyed is removed with its subtree
+			// and one whose parent lost its transform or left the world becomes a root
+			static constexpr std::uint32_t Orphan = NoParent - 1;
+			std::vector<std::uint32_t> parents(count, NoParent);
+			std::vector<std::uint32_t> offsets(count + 1, 0);
+			for (std::uint32_t i = 0; i < count; i++) {
+				auto &node = mNodes[i];
+				if (node.transform == nullptr) {
+					continue;
+				}
+				if (node.parent != NoParent && mNodes[node.parent].transform != nullptr) {
+					parents[i] = node.parent;
+				} else if (node.transform->mParent.GetManager() != nullptr) {
+					auto &handle = node.transform->mParent;
+					auto parent = handle.IsValid() ? handle.GetComponent<TransformComponent>() : nullptr;
+					if (parent != nullptr && parent->mSystem == this) {
+						parents[i] = parent->mNode;
+					} else if (!handle.IsValid() && std::find(mDestroyed.begin(), mDestroyed.end(), handle) != mDestroyed.end()) {
+						parents[i] = Orphan;
+					} else {
+						// the subtree of a new root moves, it is updated again
+						node.dirty = true;
+						if (parent == nullptr) {
+							handle = {};
+						}
+					}
+				}
+				if (parents[i] < Orphan) {
+					offsets[parents[i] + 1] += 1;
+				}
+			}
+			for (std::uint32_t i = 0; i < count; i++) {
+				offsets[i + 1] += offsets[i];
+			}
+			std::vector<std::uint32_t> children(offsets[count]);
+			std::vector<std::uint32_t> cursors(offsets.begin(), offsets.end() - 1);
+			for (std::uint32_t i = 0; i < count; i++) {
+				if (parents[i] < Orphan) {
+					children[cursors[parents[i]]++] = i;
+				}
+			}
+
+			std::vector<Node> nodes;
+			std::vector<glm::mat3> worlds;
+			std::vector<std::uint32_t> ends;
+			std::vector<std::uint32_t> remap(count, NoParent);
+			std::vector<Symbiote::Core::Entity> orphans;
+			std::vector<std::uint32_t> stack;
+			nodes.reserve(count);
+			worlds.reserve(count);
+			ends.reserve(count);
+			mDirty.clear();
+			for (std::uint32_t root = 0; root < count; root++) {
+				if (mNodes[root].transform == nullptr || parents[root] < Orphan) {
+					continue;
+				}
+				// the stack holds a node, then its end marker once its children are pushed
+				stack.push_back(root);
+				while (!stack.empty()) {
+					auto i = stack.back();
+					stack.pop_back();
+					if (i >= count) {
+						auto index = remap[i - count];
+						ends[index] = static_cast<std::uint32_t>(nodes.size());
+						continue;
+					}
+					auto transform = mNodes[i].transform;
+					if (parents[root] == Orphan) {
+						transform->mSystem = nullptr;
+						orphans.push_back(transform->mEntity);
+					} else {
+						auto index = static_cast<std::uint32_t>(nodes.size());
+						remap[i] = index;
+						transform->mNode = index;
+						nodes.push_back({transform, parents[i] != NoParent ? remap[parents[i]] : NoParent, mNodes[i].dirty});
+						worlds.push_back(mWorlds[i]);
+						ends.push_back(index + 1);
+						if (mNodes[i].dirty) {
+							mDirty.push_back(index);
+						}
+						stack.push_back(i + count);
+					}
+					// pushed in reverse so that the first child is visited first
+					for (auto child = offsets[i + 1]; child > offsets[i]; child--) {
+						stack.push_back(children[child - 1]);
+					}
+				}
+			}
+			mNodes = std::move(nodes);
+			mWorlds = std::move(worlds);
+			mSubtreeEnds = std::move(ends);
+			mDestroyed.clear();
+			mOrderStale = false;
+			// destroying a parent destroys its whole subtree, in one pass instead of one entity at a time
+			for (auto &orphan : orphans) {
+				orphan.Destroy();
+			}
+		}
+
+	} // namespace Game
+} // namespace Symbiote
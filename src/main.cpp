@@ -1,11 +1,15 @@
+#include <fstream>
 #include <iostream>
 
 #include <glm/vec4.hpp>
 
 #include "core/ecs/entitymanager.hpp"
+#include "core/loop/fixedtimestep.hpp"
+#include "core/profiler/profiler.hpp"
 
 #include "game/systems/physics/physics.hpp"
 #include "game/systems/renderer/renderer.hpp"
+#include "game/systems/transform/transform.hpp"
 #include "game/components/transform/transform.hpp"
 
 using namespace Symbiote::Core;
@@ -17,15 +21,27 @@ auto main() -> int {
 	manager.RegisterComponent<TransformComponent>();
 
 	auto physics = manager.AddSystem<PhysicsSystem>();
+	auto transforms = manager.AddSystem<TransformSystem>();
 	auto renderer = manager.AddSystem<RendererSystem>("Symbiote Engine - Vulkan", glm::vec4(0, 0, 1, 0));
 
 	auto entity = manager.CreateEntityWith<TransformComponent>();
 	auto transform = entity.GetComponent<TransformComponent>();
 
-	while (renderer->PollEvents()) {
-		physics->Update(0.16f);
-		renderer->Render();
-	}
+	auto poll = [&]() { return renderer->PollEvents(); };
+	auto simulate = [&](float step) {
+		manager.With<TransformComponent>([](auto, auto transform) { transform->StorePreviousState(); });
+		physics->Update(step);
+		transforms->Update();
+	};
+	auto render = [&](float alpha) { renderer->Render(alpha); };
+
+	FixedTimestep timestep;
+	timestep.Run(poll, simulate, render);
+
+#if defined(SYMBIOTE_PROFILER)
+	std::ofstream trace("symbiote.trace.json");
+	Profiler::Get().WriteChromeTrace(trace);
+#endif
 
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include <cmath>
+#include <random>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "glm/glm.hpp"
+
+#include "core/math/batch.hpp"
+
+using Symbiote::Core::SimdLevel;
+using Symbiote::Core::TransformArrays;
+
+// not a multiple of eight so that every path goes through its scalar tail
+static constexpr std::size_t Count = 1003;
+
+struct TransformColumns {
+	std::vector<float> x, y, rotation, scaleX, scaleY;
+
+	explicit TransformColumns(std::mt19937 &random) {
+		std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+		std::uniform_real_distribution<float> angle(-10.0f, 10.0f);
+		std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+		for (std::size_t i = 0; i < Count; i++) {
+			auto uniform = scale(random);
+			x.push_back(position(random));
+			y.push_back(position(random));
+			rotation.push_back(angle(random));
+			scaleX.push_back(uniform);
+			scaleY.push_back(uniform);
+		}
+	}
+
+	auto GetArrays() -> TransformArrays {
+		return {x.data(), y.data(), rotation.data(), scaleX.data(), scaleY.data()};
+	}
+
+	auto GetMatrix(std::size_t i) const -> glm::mat3 {
+		auto cos = std::cos(rotation[i]);
+		auto sin = std::sin(rotation[i]);
+		return {cos * scaleX[i], sin * scaleX[i], 0.0f, -sin * scaleY[i], cos * scaleY[i], 0.0f, x[i], y[i], 1.0f};
+	}
+};
+
+// runs the test with every instruction set the processor supports
+static auto ForEachSimdLevel(const std::function<void()> &test) -> void {
+	auto supported = Symbiote::Core::GetSupportedSimdLevel();
+	for (auto level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2}) {
+		if (static_cast<int>(level) <= static_cast<int>(supported)) {
+			SCOPED_TRACE(static_cast<int>(level));
+			Symbiote::Core::SetSimdLevel(level);
+			test();
+		}
+	}
+	Symbiote::Core::SetSimdLevel(supported);
+}
+
+TEST(Batch, ComposeTransforms) {
+	ForEachSimdLevel([]() {
+		std::mt19937 random(42);
+		TransformColumns parents(random), locals(random), worlds(random);
+		Symbiote::Core::ComposeTransforms(parents.GetArrays(), locals.GetArrays(), worlds.GetArrays(), Count);
+		for (std::size_t i = 0; i < Count; i++) {
+			auto expected = parents.GetMatrix(i) * locals.GetMatrix(i);
+			auto world = worlds.GetMatrix(i);
+			for (auto column = 0; column < 3; column++) {
+				for (auto row = 0; row < 2; row++) {
+					EXPECT_NEAR(expected[column][row], world[column][row], 1e-3f) << i;
+				}
+			}
+		}
+	});
+}
+
+TEST(Batch, TransformPoints) {
+	ForEachSimdLevel([]() {
+		std::mt19937 random(7);
+		TransformColumns points(random);
+		auto matrix = points.GetMatrix(0);
+		std::vector<float> x(Count), y(Count);
+		Symbiote::Core::TransformPoints(matrix, points.x.data(), points.y.data(), x.data(), y.data(), Count);
+		for (std::size_t i = 0; i < Count; i++) {
+			auto expected = matrix * glm::vec3(points.x[i], points.y[i], 1.0f);
+			EXPECT_NEAR(expected.x, x[i], 1e-3f);
+			EXPECT_NEAR(expected.y, y[i], 1e-3f);
+		}
+	});
+}
+
+TEST(Batch, IntegrateVelocities) {
+	ForEachSimdLevel([]() {
+		std::mt19937 random(3);
+		TransformColumns positions(random), velocities(random);
+		auto x = positions.x, y = positions.y;
+		Symbiote::Core::IntegrateVelocities(x.data(), y.data(), velocities.x.data(), velocities.y.data(), 0.5f, Count);
+		for (std::size_t i = 0; i < Count; i++) {
+			EXPECT_FLOAT_EQ(positions.x[i] + velocities.x[i] * 0.5f, x[i]);
+			EXPECT_FLOAT_EQ(positions.y[i] + velocities.y[i] * 0.5f, y[i]);
+		}
+	});
+}
+
+// fixed point integration gives the same bits at every simd level, negative velocities included
+template <typename Fixed>
+static auto TestIntegrateFixed() -> void {
+	std::mt19937 random(11);
+	TransformColumns positions(random), velocities(random);
+	std::vector<Fixed> x, y, velocityX, velocityY;
+	for (std::size_t i = 0; i < Count; i++) {
+		x.push_back(positions.x[i]);
+		y.push_back(positions.y[i]);
+		velocityX.push_back(velocities.x[i]);
+		velocityY.push_back(velocities.y[i]);
+	}
+	auto deltaTime = Fixed(1.0f / 60.0f);
+	ForEachSimdLevel([&]() {
+		auto resultX = x, resultY = y;
+		Symbiote::Core::IntegrateVelocities(resultX.data(), resultY.data(), velocityX.data(), velocityY.data(), deltaTime, Count);
+		for (std::size_t i = 0; i < Count; i++) {
+			ASSERT_EQ((x[i] + velocityX[i] * deltaTime).GetRaw(), resultX[i].GetRaw()) << i;
+			ASSERT_EQ((y[i] + velocityY[i] * deltaTime).GetRaw(), resultY[i].GetRaw()) << i;
+			EXPECT_NEAR(positions.x[i] + velocities.x[i] / 60.0f, static_cast<float>(resultX[i]), 1e-3f);
+		}
+	});
+}
+
+TEST(Batch, IntegrateFixedPoint) {
+	TestIntegrateFixed<Symbiote::Core::Q16>();
+	TestIntegrateFixed<Symbiote::Core::Q32>();
+}
+
+TEST(Batch, SimdLevel) {
+	EXPECT_EQ(Symbiote::Core::GetSupportedSimdLevel(), Symbiote::Core::GetSimdLevel());
+	if (Symbiote::Core::GetSupportedSimdLevel() != SimdLevel::AVX2) {
+		EXPECT_THROW(Symbiote::Core::SetSimdLevel(SimdLevel::AVX2), std::logic_error);
+	}
+}
@@ -5,11 +5,17 @@
 DEFINE_COMPONENT(DummyComponent);
 DEFINE_COMPONENT(PhysicsComponent);
 DEFINE_COMPONENT(TransformComponent);
+DEFINE_COMPONENT(ScaleComponent);
+DEFINE_COMPONENT(NameComponent);
 
 auto CreateEntityManager() -> std::unique_ptr<Symbiote::Core::EntityManager> {
 	auto manager = std::make_unique<Symbiote::Core::EntityManager>();
 	manager->RegisterComponent<DummyComponent>();
 	manager->RegisterComponent<PhysicsComponent>();
 	manager->RegisterComponent<TransformComponent>();
+	manager->RegisterComponent<ScaleComponent>();
+	manager->RegisterComponent<NameComponent>();
+	manager->RegisterComponent<PositionComponent>();
+	manager->RegisterComponent<VelocityComponent>();
 	return std::move(manager);
 }
\ No newline at end of file
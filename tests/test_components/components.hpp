@@ -1,10 +1,13 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <vector>
 #include <ostream>
 #include <istream>
 
 #include <core/ecs/component.hpp>
+#include <core/ecs/reflection.hpp>
 
 namespace Symbiote {
 	namespace Core {
@@ -32,14 +35,7 @@ public:
 	}
 
 public:
-	auto Serialize(std::ostream &out) const -> void override {
-		static_assert(std::is_pod<decltype(TransformComponent::mData)>::value, "TransformComponent is not POD");
-		out.write((char *)&mData, sizeof(mData));
-	}
-	auto Deserialize(std::istream &is) -> void override {
-		static_assert(std::is_pod<decltype(TransformComponent::mData)>::value, "TransformComponent is not POD");
-		is.read((char *)&mData, sizeof(mData));
-	}
+	DECLARE_FIELDS(TransformComponent, mData);
 
 public:
 	auto GetX() const -> float {
@@ -56,4 +52,57 @@ public:
 	} mData = {};
 };
 
+// the same data as TransformComponent, serialized by hand and saved as instances
+class ScaleComponent final : public Symbiote::Core::Component {
+public:
+	DECLARE_COMPONENT(ScaleComponent);
+
+public:
+	ScaleComponent() = default;
+	ScaleComponent(float x, float y) : mData{x, y} {
+	}
+
+public:
+	auto Serialize(std::ostream &out) const -> void override {
+		static_assert(std::is_pod<decltype(ScaleComponent::mData)>::value, "ScaleComponent is not POD");
+		out.write((char *)&mData, sizeof(mData));
+	}
+	auto Deserialize(std::istream &is) -> void override {
+		static_assert(std::is_pod<decltype(ScaleComponent::mData)>::value, "ScaleComponent is not POD");
+		is.read((char *)&mData, sizeof(mData));
+	}
+
+public:
+	struct {
+		float x;
+		float y;
+	} mData = {};
+};
+
+class NameComponent final : public Symbiote::Core::Component {
+public:
+	DECLARE_COMPONENT(NameComponent);
+	DECLARE_FIELDS(NameComponent, mName, mTags, mWeight);
+
+public:
+	std::string mName = {};
+	std::vector<int> mTags = {};
+	float mWeight = 0.0f;
+};
+
+struct PositionComponent {
+	DECLARE_POD_COMPONENT(PositionComponent);
+
+	float x;
+	float y;
+};
+
+struct VelocityComponent {
+	DECLARE_POD_COMPONENT(VelocityComponent);
+
+	float x;
+	float y;
+	float z;
+};
+
 auto CreateEntityManager() -> std::unique_ptr<Symbiote::Core::EntityManager>;
\ No newline at end of file
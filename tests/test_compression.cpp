@@ -0,0 +1,120 @@
+#include <random>
+#include <cstring>
+#include <sstream>
+#include <gtest/gtest.h>
+
+#include "core/ecs/entitymanager.hpp"
+#include "core/jobs/jobsystem.hpp"
+#include "core/serialization/compression.hpp"
+
+#include "test_components/components.hpp"
+
+static auto RoundTrip(const std::string &data) -> std::string {
+	std::string compressed;
+	Symbiote::Core::LzCompress(data.data(), data.size(), compressed);
+	std::string decompressed(data.size(), '\0');
+	Symbiote::Core::LzDecompress(compressed.data(), compressed.size(), &decompressed[0], decompressed.size());
+	return decompressed;
+}
+
+static auto Populate(Symbiote::Core::EntityManager &manager, int count) -> void {
+	for (auto i = 0; i < count; i++) {
+		auto entity = manager.CreateEntity();
+		entity.AddComponent<PositionComponent>(static_cast<float>(i % 64), 0.0f);
+		entity.AddComponent<VelocityComponent>(1.0f, 0.0f, 0.0f);
+		if (i % 2 == 0) {
+			entity.AddComponent<TransformComponent>(static_cast<float>(i), 1.0f);
+		}
+		if (i % 3 == 0) {
+			entity.AddComponent<NameComponent>()->mName = "enemy";
+		}
+	}
+}
+
+TEST(Compression, LzRoundTrip) {
+	std::mt19937 random(42);
+	std::string noise(100000, '\0');
+	for (auto &byte : noise) {
+		byte = static_cast<char>(random());
+	}
+	std::string pattern;
+	for (auto i = 0; i < 10000; i++) {
+		pattern += "symbiote" + std::to_string(i % 100);
+	}
+	for (const auto &data : {std::string{}, std::string{"abc"}, std::string(70000, 'z'), noise, pattern}) {
+		EXPECT_EQ(data, RoundTrip(data));
+	}
+
+	std::string compressed;
+	Symbiote::Core::LzCompress(pattern.data(), pattern.size(), compressed);
+	EXPECT_LT(compressed.size() * 20, pattern.size());
+	std::string decompressed(pattern.size() - 1, '\0');
+	EXPECT_THROW(Symbiote::Core::LzDecompress(compressed.data(), compressed.size(), &decompressed[0], decompressed.size()), std::runtime_error);
+}
+
+TEST(Compression, SnapshotRoundTrip) {
+	auto manager = CreateEntityManager();
+	Populate(*manager, 10000);
+	std::ostringstream os;
+	manager->Serialize(os);
+	auto snapshot = os.str();
+
+	Symbiote::Core::JobSystem jobs(2);
+	auto compressed = Symbiote::Core::CompressSnapshot(snapshot, &jobs);
+	EXPECT_TRUE(Symbiote::Core::IsCompressedSnapshot(compressed));
+	EXPECT_FALSE(Symbiote::Core::IsCompressedSnapshot(snapshot));
+	EXPECT_LT(compressed.size() * 4, snapshot.size());
+	EXPECT_EQ(compressed, Symbiote::Core::CompressSnapshot(snapshot));
+	EXPECT_EQ(snapshot, Symbiote::Core::DecompressSnapshot(compressed));
+	EXPECT_EQ(snapshot, Symbiote::Core::DecompressSnapshot(compressed, &jobs));
+
+	compressed.resize(compressed.size() - 1);
+	EXPECT_THROW(Symbiote::Core::DecompressSnapshot(compressed), std::runtime_error);
+}
+
+TEST(Compression, CorruptSnapshotWithJobs) {
+	auto manager = CreateEntityManager();
+	Populate(*manager, 10000);
+	std::ostringstream os;
+	manager->SerializeCompressed(os);
+	auto compressed = os.str();
+	// every chunk is corrupt past the chunk table, some of them fail on the worker threads
+	std::uint32_t chunkCount;
+	std::memcpy(&chunkCount, compressed.data() + 16, sizeof(chunkCount));
+	for (auto i = 20 + std::size_t{chunkCount} * 20; i < compressed.size(); i += 7) {
+		compressed[i] = static_cast<char>(~compressed[i]);
+	}
+
+	Symbiote::Core::JobSystem jobs(4);
+	EXPECT_THROW(Symbiote::Core::DecompressSnapshot(compressed, &jobs), std::runtime_error);
+	std::istringstream is(compressed);
+	auto loaded = CreateEntityManager();
+	EXPECT_THROW(loaded->Deserialize(is, &jobs), std::runtime_error);
+}
+
+TEST(Compression, EntityManagerRoundTrip) {
+	auto manager = CreateEntityManager();
+	Populate(*manager, 1000);
+	std::stringstream compressed;
+	manager->SerializeCompressed(compressed);
+
+	// Deserialize recognizes compressed snapshots
+	auto loaded = CreateEntityManager();
+	loaded->Deserialize(compressed);
+	std::ostringstream expected, actual;
+	manager->Serialize(expected);
+	loaded->Serialize(actual);
+	EXPECT_EQ(expected.str(), actual.str());
+	EXPECT_EQ(1000, loaded->Size());
+
+	const char *path = "compressed_save.bin";
+	auto result = manager->SaveAsync(path, {}, true).get();
+	EXPECT_TRUE(result.error.empty());
+	EXPECT_EQ(compressed.str().size(), result.size);
+	auto mapped = CreateEntityManager();
+	mapped->DeserializeMapped(path);
+	std::ostringstream mappedBytes;
+	mapped->Serialize(mappedBytes);
+	EXPECT_EQ(expected.str(), mappedBytes.str());
+	std::remove(path);
+}
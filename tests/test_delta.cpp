@@ -0,0 +1,142 @@
+#include <sstream>
+#include <gtest/gtest.h>
+
+#include "core/ecs/entitymanager.hpp"
+#include "core/serialization/delta.hpp"
+
+#include "test_components/components.hpp"
+
+static auto Save(const Symbiote::Core::EntityManager &manager) -> std::string {
+	std::ostringstream os;
+	manager.Serialize(os);
+	return os.str();
+}
+
+static auto Populate(Symbiote::Core::EntityManager &manager, int count) -> void {
+	for (auto i = 0; i < count; i++) {
+		auto entity = manager.CreateEntity();
+		entity.AddComponent<PositionComponent>(static_cast<float>(i), 0.0f);
+		if (i % 2 == 0) {
+			entity.AddComponent<TransformComponent>(static_cast<float>(i), 1.0f);
+		}
+		if (i % 5 == 0) {
+			entity.AddComponent<DummyComponent>();
+		}
+	}
+}
+
+TEST(SnapshotDelta, EncodeAndApply) {
+	auto manager = CreateEntityManager();
+	Populate(*manager, 2000);
+	auto baseline = Save(*manager);
+
+	auto entities = manager->With<PositionComponent>();
+	entities[3].GetComponent<PositionComponent>()->y = 10.0f;
+	entities[4].GetComponent<TransformComponent>()->mData.y = 20.0f;
+	entities[5].RemoveComponent<PositionComponent>();
+	entities[7].AddComponent<VelocityComponent>(1.0f, 2.0f, 3.0f);
+	entities[9].AddComponent<TransformComponent>(9.0f, 9.0f);
+	entities[8].Destroy();
+	manager->CreateEntity().AddComponent<DummyComponent>();
+	manager->CreateEntity().AddComponent<PositionComponent>(-1.0f, -1.0f);
+	auto target = Save(*manager);
+
+	for (auto runLengthEncode : {true, false}) {
+		auto delta = Symbiote::Core::EncodeSnapshotDelta(baseline, target, runLengthEncode);
+		EXPECT_EQ(target, Symbiote::Core::ApplySnapshotDelta(baseline, delta));
+		if (runLengthEncode) {
+			EXPECT_LT(delta.size() * 20, target.size());
+		}
+	}
+
+	// an unchanged world only costs the headers
+	auto empty = Symbiote::Core::EncodeSnapshotDelta(target, target);
+	EXPECT_LT(empty.size(), 512);
+	EXPECT_EQ(target, Symbiote::Core::ApplySnapshotDelta(target, empty));
+}
+
+TEST(SnapshotDelta, EntityManagerRoundTrip) {
+	auto manager = CreateEntityManager();
+	Populate(*manager, 100);
+	auto baseline = Save(*manager);
+	for (auto entity : manager->With<TransformComponent>()) {
+		entity.GetComponent<TransformComponent>()->mData.x += 0.5f;
+	}
+	std::stringstream delta;
+	manager->SerializeDelta(baseline, delta);
+
+	auto loaded = CreateEntityManager();
+	loaded->DeserializeDelta(baseline, delta);
+	EXPECT_EQ(Save(*manager), Save(*loaded));
+	EXPECT_EQ(100, loaded->Size());
+	EXPECT_EQ(2.5f, loaded->With<TransformComponent>()[1].GetComponent<TransformComponent>()->GetX());
+}
+
+TEST(SnapshotDelta, CaptureBaseline) {
+	auto manager = CreateEntityManager();
+	Populate(*manager, 5000);
+	auto baseline = manager->CaptureDeltaBaseline();
+	EXPECT_EQ(Save(*manager), baseline.snapshot);
+
+	auto entities = manager->With<PositionComponent>();
+	entities[3].GetComponent<PositionComponent>()->y = 10.0f;
+	entities[4].GetComponent<TransformComponent>()->mData.y = 20.0f;
+	entities[4000].GetComponent<PositionComponent>()->x = -4.0f;
+	entities[7].AddComponent<VelocityComponent>(1.0f, 2.0f, 3.0f);
+	auto target = Save(*manager);
+
+	// pages still shared with the capture are skipped, the delta is the one of the written snapshots
+	for (auto runLengthEncode : {true, false}) {
+		std::stringstream delta;
+		manager->SerializeDelta(baseline, delta, runLengthEncode);
+		EXPECT_EQ(Symbiote::Core::EncodeSnapshotDelta(baseline.snapshot, target, runLengthEncode), delta.str());
+		auto loaded = CreateEntityManager();
+		loaded->DeserializeDelta(baseline.snapshot, delta);
+		EXPECT_EQ(target, Save(*loaded));
+	}
+	EXPECT_THROW(Symbiote::Core::EncodeSnapshotDelta(Symbiote::Core::SnapshotDeltaBaseline{}, *manager->CaptureSnapshot()), std::logic_error);
+}
+
+TEST(SnapshotDelta, RejectsOtherBaseline) {
+	auto manager = CreateEntityManager();
+	Populate(*manager, 10);
+	auto baseline = Save(*manager);
+	manager->CreateEntity();
+	auto target = Save(*manager);
+	auto delta = Symbiote::Core::EncodeSnapshotDelta(baseline, target);
+
+	EXPECT_THROW(Symbiote::Core::ApplySnapshotDelta(target, delta), std::runtime_error);
+	EXPECT_THROW(Symbiote::Core::ApplySnapshotDelta(baseline, delta.substr(0, delta.size() - 4)), std::runtime_error);
+	EXPECT_THROW(Symbiote::Core::ApplySnapshotDelta(baseline, target), std::runtime_error);
+}
+
+TEST(SnapshotDelta, KeyframeChain) {
+	auto manager = CreateEntityManager();
+	Populate(*manager, 200);
+	std::vector<std::string> frames;
+	std::stringstream stream;
+	{
+		Symbiote::Core::SnapshotChainWriter writer(stream, 4);
+		for (auto frame = 0; frame < 10; frame++) {
+			for (auto entity : manager->With<PositionComponent>()) {
+				entity.GetComponent<PositionComponent>()->y += 1.0f;
+			}
+			if (frame % 3 == 0) {
+				manager->CreateEntity().AddComponent<PositionComponent>();
+			}
+			frames.push_back(Save(*manager));
+			writer.Write(frames.back());
+		}
+		EXPECT_EQ(10, writer.GetFrameCount());
+	}
+
+	Symbiote::Core::SnapshotChainReader reader(stream);
+	EXPECT_EQ(10, reader.GetFrameCount());
+	EXPECT_TRUE(reader.IsKeyframe(0));
+	EXPECT_FALSE(reader.IsKeyframe(3));
+	EXPECT_TRUE(reader.IsKeyframe(8));
+	for (auto frame : {0, 1, 2, 3, 7, 6, 9, 5}) {
+		EXPECT_EQ(frames[frame], reader.Read(frame));
+	}
+	EXPECT_THROW(reader.Read(10), std::logic_error);
+}
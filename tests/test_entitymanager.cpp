@@ -1,6 +1,9 @@
 #include <random>
 #include <cstdint>
+#include <cstring>
 #include <fstream>
+#include <sstream>
+#include <algorithm>
 #include <gtest/gtest.h>
 
 #include "core/ecs/entitymanager.hpp"
@@ -260,4 +263,137 @@ TEST(EntityManager, ExtremeSparseSaveAndLoad) {
 			ASSERT_EQ(entities[i * 2 + 1], entities2[i]);
 		}
 	}
+}
+
+TEST(EntityManager, SaveAndLoadWhitespaceBytes) {
+	auto manager = CreateEntityManager();
+	std::vector<Symbiote::Core::Entity> entities;
+	for (auto i = 0; i < 40; i++) {
+		entities.emplace_back(manager->CreateEntity());
+	}
+	// indexes 9 to 13 and 32 and these payload bytes used to be skipped as whitespace
+	std::uint32_t bits = 0x0A0B0C20;
+	float whitespace;
+	std::memcpy(&whitespace, &bits, sizeof(whitespace));
+	for (auto index : {9, 10, 11, 12, 13, 32}) {
+		auto transform = entities[index].AddComponent<TransformComponent>();
+		transform->mData.x = whitespace;
+		transform->mData.y = static_cast<float>(index);
+	}
+
+	std::stringstream stream;
+	manager->Serialize(stream);
+	manager->Deserialize(stream);
+
+	auto entitiesWithTransform = manager->With<TransformComponent>();
+	ASSERT_EQ(6, entitiesWithTransform.size());
+	for (auto index : {9, 10, 11, 12, 13, 32}) {
+		auto transform = entities[index].GetComponent<TransformComponent>();
+		ASSERT_NE(nullptr, transform);
+		EXPECT_EQ(0, std::memcmp(&whitespace, &transform->mData.x, sizeof(whitespace)));
+		EXPECT_EQ(static_cast<float>(index), transform->GetY());
+	}
+}
+
+TEST(EntityManager, SaveAndLoadFreeList) {
+	auto manager = CreateEntityManager();
+	std::vector<Symbiote::Core::Entity> entities;
+	for (auto i = 0; i < 8; i++) {
+		entities.emplace_back(manager->CreateEntity());
+	}
+	entities[5].Destroy();
+	entities[1].Destroy();
+	entities[3].Destroy();
+
+	std::stringstream stream;
+	manager->Serialize(stream);
+	auto expected1 = manager->CreateEntity();
+	auto expected2 = manager->CreateEntity();
+	manager->Deserialize(stream);
+
+	EXPECT_EQ(5, manager->Size());
+	EXPECT_EQ(expected1, manager->CreateEntity());
+	EXPECT_EQ(expected2, manager->CreateEntity());
+	EXPECT_FALSE(entities[1].IsValid());
+	EXPECT_TRUE(entities[7].IsValid());
+}
+
+TEST(EntityManager, SaveAndLoadInstanceComponents) {
+	auto manager = CreateEntityManager();
+	for (auto i = 0; i < 50; i++) {
+		auto entity = manager->CreateEntityWith<TransformComponent>();
+		if (i % 2 == 0) {
+			entity.AddComponent<ScaleComponent>(static_cast<float>(i), 2.0f);
+		}
+	}
+	auto capture = manager->CaptureSnapshot();
+	auto scales = std::find_if(capture->columns.begin(), capture->columns.end(), [](auto const &column) { return column.name == "ScaleComponent"; });
+	ASSERT_NE(scales, capture->columns.end());
+	EXPECT_EQ(Symbiote::Core::InstanceLayout, scales->layout);
+	EXPECT_EQ(26, scales->offsets.size());
+	EXPECT_EQ(25 * sizeof(ScaleComponent::mData), scales->payload.size());
+
+	std::stringstream stream;
+	manager->Serialize(stream);
+	auto loaded = CreateEntityManager();
+	loaded->Deserialize(stream);
+	auto entities = loaded->With<ScaleComponent>();
+	ASSERT_EQ(25, entities.size());
+	EXPECT_EQ(24.0f, entities[12].GetComponent<ScaleComponent>()->mData.x);
+	EXPECT_EQ(2.0f, entities[12].GetComponent<ScaleComponent>()->mData.y);
+	EXPECT_EQ(manager->Hash(), loaded->Hash());
+}
+
+TEST(EntityManager, LoadInvalidSnapshot) {
+	auto manager = CreateEntityManager();
+	manager->CreateEntityWith<TransformComponent>();
+	std::stringstream stream;
+	manager->Serialize(stream);
+	auto bytes = stream.str();
+
+	auto load = [&manager](std::string const &bytes) {
+		std::stringstream stream(bytes);
+		manager->Deserialize(stream);
+	};
+	EXPECT_NO_THROW(load(bytes));
+	EXPECT_ANY_THROW(load(bytes.substr(0, bytes.size() - 1)));
+	EXPECT_ANY_THROW(load(bytes.substr(0, 10)));
+	EXPECT_ANY_THROW(load(""));
+
+	auto badMagic = bytes;
+	badMagic[0] ^= 0xFF;
+	EXPECT_ANY_THROW(load(badMagic));
+
+	auto badVersion = bytes;
+	badVersion[4] += 1;
+	EXPECT_ANY_THROW(load(badVersion));
+
+	auto otherManager = std::make_unique<Symbiote::Core::EntityManager>();
+	std::stringstream unregistered(bytes);
+	EXPECT_ANY_THROW(otherManager->Deserialize(unregistered));
+}
+
+TEST(EntityManager, LoadCorruptHeader) {
+	auto manager = CreateEntityManager();
+	manager->CreateEntityWith<TransformComponent>();
+	manager->CreateEntityWith<PositionComponent>();
+	std::stringstream saved;
+	manager->Serialize(saved);
+	auto bytes = saved.str();
+
+	// counts larger than the stream fail before they are allocated, the world is left as it was
+	std::stringstream header;
+	for (std::uint32_t value : {Symbiote::Core::EntityManager::SnapshotMagic, Symbiote::Core::EntityManager::SnapshotVersion, 0xFFFFFFFFu, 0xFFFFFFFFu, 0u}) {
+		header.write(reinterpret_cast<const char *>(&value), sizeof(value));
+	}
+	EXPECT_THROW(manager->Deserialize(header), std::runtime_error);
+	EXPECT_EQ(2, manager->Size());
+	std::stringstream kept;
+	manager->Serialize(kept);
+	EXPECT_EQ(bytes, kept.str());
+
+	// a snapshot failing in its blocks leaves an empty world rather than a part of it
+	std::stringstream truncated(bytes.substr(0, bytes.size() - 1));
+	EXPECT_THROW(manager->Deserialize(truncated), std::runtime_error);
+	EXPECT_EQ(0, manager->Size());
 }
\ No newline at end of file
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include "core/loop/fixedtimestep.hpp"
+#include "game/components/transform/transform.hpp"
+
+using Symbiote::Core::FixedTimestep;
+
+TEST(FixedTimestep, AccumulatesSteps) {
+	FixedTimestep timestep(0.01f, 8, 0.25f);
+	auto steps = 0;
+	auto simulate = [&steps](float step) {
+		EXPECT_EQ(step, 0.01f);
+		steps += 1;
+	};
+
+	EXPECT_NEAR(0.5f, timestep.Advance(0.005f, simulate), 1e-4f);
+	EXPECT_EQ(0, steps);
+	EXPECT_EQ(0, timestep.GetSubsteps());
+
+	EXPECT_NEAR(0.5f, timestep.Advance(0.02f, simulate), 1e-4f);
+	EXPECT_EQ(2, steps);
+	EXPECT_EQ(2, timestep.GetSubsteps());
+
+	timestep.Advance(0.005f, simulate);
+	EXPECT_EQ(3, steps);
+	EXPECT_EQ(3, timestep.GetStepCount());
+	EXPECT_EQ(3, timestep.GetFrameCount());
+	EXPECT_NEAR(0.03, timestep.GetSimulatedTime(), 1e-6);
+	EXPECT_EQ(0.0, timestep.GetDroppedTime());
+}
+
+TEST(FixedTimestep, SpiralOfDeathProtection) {
+	FixedTimestep timestep(0.01f, 4, 0.1f);
+	auto steps = 0;
+	auto simulate = [&steps](float) { steps += 1; };
+
+	// clamped to 0.1 seconds, 10 steps due but only 4 allowed, the rest is dropped
+	timestep.Advance(10.0f, simulate);
+	EXPECT_EQ(4, steps);
+	EXPECT_EQ(10.0f, timestep.GetFrameTime());
+	EXPECT_NEAR(0.06, timestep.GetDroppedTime(), 1e-4);
+	EXPECT_LT(timestep.GetAlpha(), 1.0f);
+
+	timestep.Advance(0.01f, simulate);
+	EXPECT_EQ(5, steps);
+
+	EXPECT_ANY_THROW(FixedTimestep(0.0f));
+	EXPECT_ANY_THROW(FixedTimestep(0.1f, 0));
+	EXPECT_ANY_THROW(FixedTimestep(0.1f, 4, 0.05f));
+}
+
+TEST(FixedTimestep, Run) {
+	FixedTimestep timestep(0.001f);
+	auto frames = 0;
+	auto renders = 0;
+	timestep.Run([&frames]() { return frames++ < 3; }, [](float) {}, [&renders, &timestep](float alpha) {
+		EXPECT_EQ(alpha, timestep.GetAlpha());
+		EXPECT_GE(alpha, 0.0f);
+		EXPECT_LT(alpha, 1.0f);
+		renders += 1;
+	});
+	EXPECT_EQ(3, renders);
+	EXPECT_EQ(3, timestep.GetFrameCount());
+}
+
+TEST(FixedTimestep, TransformInterpolation) {
+	Symbiote::Game::TransformComponent transform({1, 1}, {0, 0}, 0.0f);
+	transform.StorePreviousState();
+	transform.SetPosition({10, 20});
+	transform.SetScale({3, 3});
+	transform.SetRotation(1.0f);
+
+	EXPECT_EQ(Symbiote::Game::TransformComponent::Position(0, 0), transform.GetInterpolatedPosition(0.0f));
+	EXPECT_EQ(Symbiote::Game::TransformComponent::Position(5, 10), transform.GetInterpolatedPosition(0.5f));
+	EXPECT_EQ(Symbiote::Game::TransformComponent::Position(10, 20), transform.GetInterpolatedPosition(1.0f));
+	EXPECT_EQ(Symbiote::Game::TransformComponent::Scale(2, 2), transform.GetInterpolatedScale(0.5f));
+	EXPECT_FLOAT_EQ(0.25f, transform.GetInterpolatedRotation(0.25f));
+
+	transform.StorePreviousState();
+	EXPECT_EQ(Symbiote::Game::TransformComponent::Position(10, 20), transform.GetInterpolatedPosition(0.0f));
+}
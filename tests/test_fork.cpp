@@ -0,0 +1,80 @@
+#include <sstream>
+#include <gtest/gtest.h>
+
+#include "core/ecs/entitymanager.hpp"
+#include "core/ecs/componentcolumn.hpp"
+
+#include "test_components/components.hpp"
+
+static auto Save(const Symbiote::Core::EntityManager &manager) -> std::string {
+	std::ostringstream os;
+	manager.Serialize(os);
+	return os.str();
+}
+
+static auto Populate(Symbiote::Core::EntityManager &manager, int count) -> void {
+	for (auto i = 0; i < count; i++) {
+		auto entity = manager.CreateEntity();
+		entity.AddComponent<PositionComponent>(static_cast<float>(i), 0.0f);
+		if (i % 2 == 0) {
+			entity.AddComponent<TransformComponent>(static_cast<float>(i), 1.0f);
+		}
+		if (i % 7 == 0) {
+			entity.AddComponent<NameComponent>()->mName = "entity " + std::to_string(i);
+		}
+	}
+}
+
+TEST(Fork, Diverge) {
+	auto manager = CreateEntityManager();
+	Populate(*manager, 5000);
+	auto saved = Save(*manager);
+
+	auto fork = manager->Fork();
+	EXPECT_EQ(saved, Save(*fork));
+	EXPECT_EQ(manager->Hash(), fork->Hash());
+
+	// the fork is simulated and edited on its own
+	fork->With<PositionComponent>([](auto, auto position) { position->y += 1.0f; });
+	fork->With<TransformComponent>([](auto, auto transform) { transform->mData.y = 2.0f; });
+	auto forked = fork->With<NameComponent>();
+	forked[0].GetComponent<NameComponent>()->mName = "forked";
+	forked[1].Destroy();
+	fork->CreateEntity().AddComponent<DummyComponent>();
+	EXPECT_EQ(saved, Save(*manager));
+	EXPECT_NE(saved, Save(*fork));
+	EXPECT_EQ(5000, fork->Size());
+
+	// and the parent keeps going without the fork seeing it
+	auto forkSaved = Save(*fork);
+	manager->With<PositionComponent>([](auto, auto position) { position->x = -1.0f; });
+	manager->With<NameComponent>()[0].GetComponent<NameComponent>()->mName = "parent";
+	EXPECT_EQ(forkSaved, Save(*fork));
+	EXPECT_EQ("forked", fork->With<NameComponent>()[0].GetComponent<NameComponent>()->mName);
+	EXPECT_EQ(1.0f, fork->With<PositionComponent>()[10].GetComponent<PositionComponent>()->y);
+}
+
+TEST(Fork, CopyOnWrite) {
+	auto manager = CreateEntityManager();
+	Populate(*manager, 5000);
+	auto fork = manager->Fork();
+
+	auto perPage = Symbiote::Core::ComponentColumn::PageSize / sizeof(PositionComponent);
+	const auto entities = manager->With<PositionComponent>();
+	const auto forked = fork->With<PositionComponent>();
+	EXPECT_EQ(entities[0].GetComponent<PositionComponent>(), forked[0].GetComponent<PositionComponent>());
+	EXPECT_EQ(entities[perPage].GetComponent<PositionComponent>(), forked[perPage].GetComponent<PositionComponent>());
+
+	// writing to a component copies its page only
+	fork->With<PositionComponent>()[0].GetComponent<PositionComponent>()->x = 42.0f;
+	EXPECT_NE(entities[0].GetComponent<PositionComponent>(), forked[0].GetComponent<PositionComponent>());
+	EXPECT_EQ(entities[perPage].GetComponent<PositionComponent>(), forked[perPage].GetComponent<PositionComponent>());
+	EXPECT_EQ(0.0f, entities[0].GetComponent<PositionComponent>()->x);
+	EXPECT_EQ(42.0f, forked[0].GetComponent<PositionComponent>()->x);
+
+	// once the fork is discarded, the parent writes in place again
+	fork.reset();
+	auto page = entities[perPage].GetComponent<PositionComponent>();
+	manager->With<PositionComponent>()[perPage].GetComponent<PositionComponent>()->x = 1.0f;
+	EXPECT_EQ(page, entities[perPage].GetComponent<PositionComponent>());
+}
@@ -0,0 +1,124 @@
+#include <sstream>
+#include <algorithm>
+#include <gtest/gtest.h>
+
+#include "core/ecs/entitymanager.hpp"
+#include "core/jobs/jobsystem.hpp"
+#include "core/serialization/hash.hpp"
+
+#include "test_components/components.hpp"
+
+static auto Populate(Symbiote::Core::EntityManager &manager, int count) -> void {
+	for (auto i = 0; i < count; i++) {
+		auto entity = manager.CreateEntity();
+		entity.AddComponent<PositionComponent>(static_cast<float>(i), 0.0f);
+		if (i % 2 == 0) {
+			entity.AddComponent<TransformComponent>(static_cast<float>(i), 1.0f);
+		}
+		if (i % 3 == 0) {
+			entity.AddComponent<NameComponent>()->mName = "name";
+		}
+		if (i % 5 == 0) {
+			entity.AddComponent<DummyComponent>();
+		}
+	}
+}
+
+TEST(Hash, HashWide) {
+	std::string bytes(1000, 'a');
+	EXPECT_EQ(Symbiote::Core::HashWide(bytes.data(), bytes.size()), Symbiote::Core::HashWide(bytes.data(), bytes.size()));
+	for (auto size : {0, 7, 31, 32, 33, 999}) {
+		EXPECT_NE(Symbiote::Core::HashWide(bytes.data(), size), Symbiote::Core::HashWide(bytes.data(), size + 1));
+	}
+	auto hash = Symbiote::Core::HashWide(bytes.data(), bytes.size());
+	bytes[500] = 'b';
+	EXPECT_NE(hash, Symbiote::Core::HashWide(bytes.data(), bytes.size()));
+}
+
+TEST(Hash, EqualWorlds) {
+	auto a = CreateEntityManager();
+	auto b = CreateEntityManager();
+	Populate(*a, 5000);
+	Populate(*b, 5000);
+	EXPECT_EQ(a->Hash(), b->Hash());
+
+	// a world loaded from a snapshot has the same hash
+	std::stringstream snapshot;
+	a->Serialize(snapshot);
+	auto loaded = CreateEntityManager();
+	loaded->Deserialize(snapshot);
+	EXPECT_EQ(a->Hash(), loaded->Hash());
+
+	Symbiote::Core::JobSystem jobs(2);
+	EXPECT_EQ(a->Hash(), a->Hash(&jobs));
+}
+
+TEST(Hash, DetectsChanges) {
+	auto manager = CreateEntityManager();
+	Populate(*manager, 5000);
+	auto hash = manager->Hash();
+	auto entities = manager->With<PositionComponent>();
+
+	// a changed page is hashed again, and the hash goes back once the value does
+	entities[4000].GetComponent<PositionComponent>()->y = 1.0f;
+	EXPECT_NE(hash, manager->Hash());
+	entities[4000].GetComponent<PositionComponent>()->y = 0.0f;
+	EXPECT_EQ(hash, manager->Hash());
+
+	entities[10].GetComponent<TransformComponent>()->mData.x = -1.0f;
+	EXPECT_NE(hash, manager->Hash());
+	entities[10].GetComponent<TransformComponent>()->mData.x = 10.0f;
+	EXPECT_EQ(hash, manager->Hash());
+
+	entities[9].GetComponent<NameComponent>()->mName = "other";
+	EXPECT_NE(hash, manager->Hash());
+	entities[9].GetComponent<NameComponent>()->mName = "name";
+	EXPECT_EQ(hash, manager->Hash());
+
+	entities[7].AddComponent<VelocityComponent>(0.0f, 0.0f, 0.0f);
+	EXPECT_NE(hash, manager->Hash());
+	entities[7].RemoveComponent<VelocityComponent>();
+	EXPECT_EQ(hash, manager->Hash());
+
+	// entity versions are part of the state
+	entities[1].Destroy();
+	auto destroyed = manager->Hash();
+	EXPECT_NE(hash, destroyed);
+	manager->CreateEntity().AddComponent<PositionComponent>(1.0f, 0.0f);
+	EXPECT_NE(hash, manager->Hash());
+	EXPECT_NE(destroyed, manager->Hash());
+}
+
+TEST(Hash, Rollback) {
+	auto manager = CreateEntityManager();
+	Populate(*manager, 1000);
+	manager->SaveFrame(0);
+	auto hash = manager->Hash();
+	manager->With<PositionComponent>([](auto, auto position) { position->x += 1.0f; });
+	EXPECT_NE(hash, manager->Hash());
+	manager->RestoreFrame(0);
+	EXPECT_EQ(hash, manager->Hash());
+}
+
+TEST(Hash, ConstViewsShareRollbackPages) {
+	auto manager = CreateEntityManager();
+	Populate(*manager, 1000);
+	manager->SaveFrame(0);
+	auto pages = [&manager]() {
+		auto capture = manager->CaptureSnapshot();
+		return std::find_if(capture->columns.begin(), capture->columns.end(), [](auto const &column) { return column.name == "PositionComponent"; })->pages;
+	};
+	auto saved = pages();
+
+	// reading through a const manager neither copies the pages shared with the frame nor dirties their hashes
+	const auto &reader = *manager;
+	float sum = 0.0f;
+	reader.With<PositionComponent>([&sum](auto, auto position) { sum += position->x; });
+	EXPECT_EQ(499500.0f, sum);
+	auto any = reader.Any<PositionComponent, DummyComponent>();
+	EXPECT_EQ(1000, any.size());
+	EXPECT_EQ(saved, pages());
+
+	manager->With<PositionComponent>([](auto, auto position) { position->x += 1.0f; });
+	EXPECT_NE(saved, pages());
+}
@@ -0,0 +1,131 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <stdexcept>
+#include <gtest/gtest.h>
+
+#include "core/jobs/jobsystem.hpp"
+
+using Symbiote::Core::JobSystem;
+
+TEST(JobSystem, ScheduleAndWait) {
+	JobSystem jobs(4);
+	JobSystem::Counter counter;
+	std::atomic<int> sum = {0};
+	for (auto i = 0; i < 1000; i++) {
+		jobs.Schedule([&sum, i]() { sum += i; }, &counter);
+	}
+	jobs.Wait(counter);
+	EXPECT_TRUE(counter.IsDone());
+	EXPECT_EQ(sum.load(), 999 * 1000 / 2);
+}
+
+TEST(JobSystem, SingleThreadIsDeterministic) {
+	JobSystem jobs(1);
+	EXPECT_EQ(1, jobs.GetThreadCount());
+	JobSystem::Counter counter;
+	std::vector<int> order;
+	for (auto i = 0; i < 8; i++) {
+		jobs.Schedule([&order, i]() { order.push_back(i); }, &counter);
+	}
+	EXPECT_EQ(8, counter.GetPending());
+	EXPECT_TRUE(order.empty());
+	jobs.Wait(counter);
+	EXPECT_EQ((std::vector<int>{7, 6, 5, 4, 3, 2, 1, 0}), order);
+}
+
+TEST(JobSystem, Dependencies) {
+	JobSystem jobs(4);
+	JobSystem::Counter first;
+	JobSystem::Counter second;
+	std::atomic<int> done = {0};
+	std::atomic<bool> ordered = {true};
+	for (auto i = 0; i < 64; i++) {
+		jobs.Schedule([&done]() { done += 1; }, &first);
+	}
+	for (auto i = 0; i < 64; i++) {
+		jobs.Schedule([&done, &ordered]() { ordered = ordered && done.load() >= 64; }, first, &second);
+	}
+	jobs.Wait(second);
+	EXPECT_TRUE(first.IsDone());
+	EXPECT_TRUE(ordered.load());
+
+	// dependency already satisfied
+	JobSystem::Counter third;
+	auto ran = false;
+	jobs.Schedule([&ran]() { ran = true; }, first, &third);
+	jobs.Wait(third);
+	EXPECT_TRUE(ran);
+}
+
+TEST(JobSystem, NestedJobs) {
+	JobSystem jobs(4);
+	JobSystem::Counter outer;
+	std::atomic<int> sum = {0};
+	for (auto i = 0; i < 16; i++) {
+		jobs.Schedule(
+			[&jobs, &sum]() {
+				JobSystem::Counter inner;
+				for (auto j = 0; j < 16; j++) {
+					jobs.Schedule([&sum]() { sum += 1; }, &inner);
+				}
+				jobs.Wait(inner);
+			},
+			&outer);
+	}
+	jobs.Wait(outer);
+	EXPECT_EQ(sum.load(), 256);
+}
+
+TEST(JobSystem, ParallelFor) {
+	for (auto threadCount : {1, 2, 4}) {
+		JobSystem jobs(threadCount);
+		std::vector<std::atomic<int>> visits(10007);
+		jobs.ParallelFor(0, visits.size(), 64, [&visits](std::size_t begin, std::size_t end) {
+			for (auto i = begin; i < end; i++) {
+				visits[i] += 1;
+			}
+		});
+		for (auto &visit : visits) {
+			ASSERT_EQ(visit.load(), 1);
+		}
+		auto calls = 0;
+		jobs.ParallelFor(5, 5, 0, [&calls](std::size_t, std::size_t) { calls += 1; });
+		EXPECT_EQ(calls, 0);
+	}
+	EXPECT_ANY_THROW(JobSystem(0));
+}
+
+TEST(JobSystem, Exceptions) {
+	JobSystem jobs(4);
+	JobSystem::Counter counter;
+	std::atomic<int> done = {0};
+	for (auto i = 0; i < 64; i++) {
+		jobs.Schedule(
+			[&done, i]() {
+				if (i % 16 == 0) {
+					throw std::runtime_error("job");
+				}
+				done += 1;
+			},
+			&counter);
+	}
+	// the other jobs still run, the waiting thread gets the exception once
+	EXPECT_THROW(jobs.Wait(counter), std::runtime_error);
+	EXPECT_TRUE(counter.IsDone());
+	EXPECT_EQ(done.load(), 60);
+	EXPECT_NO_THROW(jobs.Wait(counter));
+
+	// ranges failing on the worker threads are reported to the caller too
+	for (auto threadCount : {1, 4}) {
+		JobSystem parallel(threadCount);
+		auto range = [&parallel](std::size_t begin, std::size_t) {
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+			if (begin == 500 || parallel.GetWorkerIndex() != 0) {
+				throw std::runtime_error("range");
+			}
+		};
+		EXPECT_THROW(parallel.ParallelFor(0, 1000, 10, range), std::runtime_error);
+	}
+}
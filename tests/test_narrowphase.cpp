@@ -0,0 +1,228 @@
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+#include <functional>
+
+#include <gtest/gtest.h>
+
+#include "glm/geometric.hpp"
+#include "glm/gtc/constants.hpp"
+
+#include "core/math/batch.hpp"
+#include "core/jobs/jobsystem.hpp"
+
+#include "game/systems/physics/narrowphase.hpp"
+
+using Symbiote::Core::Real;
+using Symbiote::Core::SimdLevel;
+using Symbiote::Game::Narrowphase;
+using Symbiote::Game::SpatialHashGrid;
+using Symbiote::Game::RigidBodyComponent;
+
+// bodies as the physics system stores them
+struct ShapeColumns {
+	std::vector<RigidBodyComponent::Shape> shape;
+	std::vector<Real> x, y, cos, sin, extentX, extentY;
+
+	auto Add(RigidBodyComponent::Shape kind, glm::vec2 position, float rotation, glm::vec2 extents) -> std::uint32_t {
+		shape.push_back(kind);
+		x.push_back(position.x);
+		y.push_back(position.y);
+		cos.push_back(std::cos(rotation));
+		sin.push_back(std::sin(rotation));
+		extentX.push_back(extents.x);
+		extentY.push_back(extents.y);
+		return static_cast<std::uint32_t>(shape.size() - 1);
+	}
+
+	auto GetShapes() const -> Narrowphase::Shapes {
+		return {shape.data(), x.data(), y.data(), cos.data(), sin.data(), extentX.data(), extentY.data()};
+	}
+};
+
+// contacts are checked as floats whatever the numbers of the simulation
+static auto ToFloat(Real value) -> float {
+	return static_cast<float>(value);
+}
+
+static auto ToFloat(Symbiote::Core::RealVec2 const &value) -> glm::vec2 {
+	return {ToFloat(value.x), ToFloat(value.y)};
+}
+
+// fixed point is exact to a few of its steps rather than to the ulps of floats, and Q32.32 steps are finer than the float literals
+#if SYMBIOTE_FIXED_POINT
+#define EXPECT_REAL_EQ(expected, actual) EXPECT_NEAR(expected, ToFloat(actual), 4.0f * std::max(ToFloat(std::numeric_limits<Real>::epsilon()), std::numeric_limits<float>::epsilon()))
+#else
+#define EXPECT_REAL_EQ(expected, actual) EXPECT_FLOAT_EQ(expected, actual)
+#endif
+
+static auto ForEachSimdLevel(const std::function<void()> &test) -> void {
+	auto supported = Symbiote::Core::GetSupportedSimdLevel();
+	for (auto level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2}) {
+		if (static_cast<int>(level) <= static_cast<int>(supported)) {
+			SCOPED_TRACE(static_cast<int>(level));
+			Symbiote::Core::SetSimdLevel(level);
+			test();
+		}
+	}
+	Symbiote::Core::SetSimdLevel(supported);
+}
+
+static auto Collide(ShapeColumns const &columns, std::vector<SpatialHashGrid::Pair> const &pairs) -> std::vector<Narrowphase::Contact> {
+	Narrowphase narrowphase;
+	std::vector<Narrowphase::Contact> contacts;
+	narrowphase.Collide(columns.GetShapes(), pairs, contacts);
+	return contacts;
+}
+
+TEST(Narrowphase, Circles) {
+	ForEachSimdLevel([]() {
+		ShapeColumns columns;
+		auto a = columns.Add(RigidBodyComponent::Shape::Circle, {0.0f, 0.0f}, 0.0f, {1.0f, 1.0f});
+		auto b = columns.Add(RigidBodyComponent::Shape::Circle, {0.0f, 1.5f}, 0.0f, {1.0f, 1.0f});
+		auto c = columns.Add(RigidBodyComponent::Shape::Circle, {3.0f, 0.0f}, 0.0f, {0.5f, 0.5f});
+		auto d = columns.Add(RigidBodyComponent::Shape::Circle, {0.0f, 0.0f}, 0.0f, {0.5f, 0.5f});
+		auto contacts = Collide(columns, {{a, b}, {a, c}, {a, d}});
+		ASSERT_EQ(2, contacts.size());
+		EXPECT_EQ(a, contacts[0].a);
+		EXPECT_EQ(b, contacts[0].b);
+		ASSERT_EQ(1, contacts[0].pointCount);
+		EXPECT_REAL_EQ(0.0f, contacts[0].normal.x);
+		EXPECT_REAL_EQ(1.0f, contacts[0].normal.y);
+		EXPECT_REAL_EQ(-0.5f, contacts[0].points[0].separation);
+		EXPECT_REAL_EQ(0.75f, contacts[0].points[0].position.y);
+		// concentric circles still get a normal
+		EXPECT_EQ(d, contacts[1].b);
+		EXPECT_FLOAT_EQ(1.0f, glm::length(ToFloat(contacts[1].normal)));
+		EXPECT_REAL_EQ(-1.5f, contacts[1].points[0].separation);
+	});
+}
+
+TEST(Narrowphase, BoxCircle) {
+	ForEachSimdLevel([]() {
+		ShapeColumns columns;
+		auto box = columns.Add(RigidBodyComponent::Shape::Box, {0.0f, 0.0f}, 0.0f, {2.0f, 1.0f});
+		auto above = columns.Add(RigidBodyComponent::Shape::Circle, {1.0f, 1.5f}, 0.0f, {1.0f, 1.0f});
+		auto inside = columns.Add(RigidBodyComponent::Shape::Circle, {1.8f, 0.2f}, 0.0f, {0.5f, 0.5f});
+		auto corner = columns.Add(RigidBodyComponent::Shape::Circle, {2.5f, 1.5f}, 0.0f, {1.0f, 1.0f});
+		auto far = columns.Add(RigidBodyComponent::Shape::Circle, {4.0f, 0.0f}, 0.0f, {1.0f, 1.0f});
+		// the normal goes from the first body of the pair whatever its shape
+		auto contacts = Collide(columns, {{box, above}, {inside, box}, {box, corner}, {box, far}});
+		ASSERT_EQ(3, contacts.size());
+		EXPECT_REAL_EQ(0.0f, contacts[0].normal.x);
+		EXPECT_REAL_EQ(1.0f, contacts[0].normal.y);
+		EXPECT_REAL_EQ(-0.5f, contacts[0].points[0].separation);
+		EXPECT_REAL_EQ(1.0f, contacts[0].points[0].position.x);
+		EXPECT_REAL_EQ(0.75f, contacts[0].points[0].position.y);
+		EXPECT_EQ(inside, contacts[1].a);
+		EXPECT_REAL_EQ(-1.0f, contacts[1].normal.x);
+		EXPECT_REAL_EQ(0.0f, contacts[1].normal.y);
+		EXPECT_REAL_EQ(-0.7f, contacts[1].points[0].separation);
+		EXPECT_NEAR(std::sqrt(0.5f), ToFloat(contacts[2].normal.x), 1e-6f);
+		EXPECT_NEAR(std::sqrt(0.5f) - 1.0f, ToFloat(contacts[2].points[0].separation), 1e-6f);
+
+		// once turned, the box has the center of the circle on its side
+		columns.cos[box] = 0.0f;
+		columns.sin[box] = 1.0f;
+		contacts = Collide(columns, {{box, above}, {box, far}});
+		ASSERT_EQ(1, contacts.size());
+		EXPECT_REAL_EQ(1.0f, contacts[0].normal.x);
+		EXPECT_REAL_EQ(-1.0f, contacts[0].points[0].separation);
+	});
+}
+
+TEST(Narrowphase, Boxes) {
+	ForEachSimdLevel([]() {
+		ShapeColumns columns;
+		auto ground = columns.Add(RigidBodyComponent::Shape::Box, {0.0f, 0.0f}, 0.0f, {5.0f, 0.5f});
+		auto resting = columns.Add(RigidBodyComponent::Shape::Box, {1.0f, 0.9f}, 0.0f, {0.5f, 0.5f});
+		auto corner = columns.Add(RigidBodyComponent::Shape::Box, {-2.0f, 0.5f + std::sqrt(0.5f) - 0.1f}, glm::quarter_pi<float>(), {0.5f, 0.5f});
+		auto above = columns.Add(RigidBodyComponent::Shape::Box, {0.0f, 2.0f}, 0.3f, {0.5f, 0.5f});
+		auto contacts = Collide(columns, {{ground, resting}, {corner, ground}, {ground, above}});
+		ASSERT_EQ(2, contacts.size());
+
+		// a box resting on a face touches at the two ends of the incident face
+		ASSERT_EQ(2, contacts[0].pointCount);
+		EXPECT_NEAR(0.0f, ToFloat(contacts[0].normal.x), 1e-6f);
+		EXPECT_NEAR(1.0f, ToFloat(contacts[0].normal.y), 1e-6f);
+		for (auto &point : contacts[0].points) {
+			EXPECT_NEAR(-0.1f, ToFloat(point.separation), 1e-5f);
+			EXPECT_NEAR(0.45f, ToFloat(point.position.y), 1e-5f);
+		}
+		EXPECT_NEAR(2.0f, ToFloat(contacts[0].points[0].position.x) + ToFloat(contacts[0].points[1].position.x), 1e-5f);
+		EXPECT_NE(contacts[0].points[0].id, contacts[0].points[1].id);
+
+		// a box standing on a corner touches at one point, the normal goes from the first body
+		ASSERT_EQ(1, contacts[1].pointCount);
+		EXPECT_EQ(corner, contacts[1].a);
+		EXPECT_NEAR(0.0f, ToFloat(contacts[1].normal.x), 1e-5f);
+		EXPECT_NEAR(-1.0f, ToFloat(contacts[1].normal.y), 1e-5f);
+		EXPECT_NEAR(-0.1f, ToFloat(contacts[1].points[0].separation), 1e-5f);
+		EXPECT_NEAR(-2.0f, ToFloat(contacts[1].points[0].position.x), 1e-5f);
+	});
+}
+
+TEST(Narrowphase, Consistency) {
+	// every simd level finds the same contacts as the scalar path, in the same order and whatever the number of threads
+	ShapeColumns columns;
+	std::mt19937 random(42);
+	std::uniform_real_distribution<float> positions(0.0f, 30.0f);
+	std::uniform_real_distribution<float> angles(-3.14f, 3.14f);
+	std::uniform_real_distribution<float> sizes(0.2f, 2.0f);
+	for (auto i = 0; i < 2000; i++) {
+		auto shape = i % 2 == 0 ? RigidBodyComponent::Shape::Circle : RigidBodyComponent::Shape::Box;
+		auto radius = sizes(random);
+		columns.Add(shape, {positions(random), positions(random)}, angles(random), shape == RigidBodyComponent::Shape::Circle ? glm::vec2(radius, radius) : glm::vec2(radius, sizes(random)));
+	}
+	std::vector<SpatialHashGrid::Pair> pairs;
+	for (std::uint32_t a = 0; a < 2000; a++) {
+		for (std::uint32_t b = a + 1; b < 2000; b++) {
+			auto dx = ToFloat(columns.x[a] - columns.x[b]), dy = ToFloat(columns.y[a] - columns.y[b]);
+			if (dx * dx + dy * dy < 16.0f) {
+				pairs.push_back({a, b});
+			}
+		}
+	}
+	Symbiote::Core::SetSimdLevel(SimdLevel::Scalar);
+	auto expected = Collide(columns, pairs);
+	ASSERT_GT(expected.size(), 100);
+	Symbiote::Core::JobSystem jobs(4);
+	ForEachSimdLevel([&]() {
+		Narrowphase narrowphase;
+		std::vector<Narrowphase::Contact> contacts;
+		narrowphase.Collide(columns.GetShapes(), pairs, contacts, &jobs);
+		ASSERT_EQ(expected.size(), contacts.size());
+		for (std::size_t i = 0; i < contacts.size(); i++) {
+			ASSERT_EQ(expected[i].a, contacts[i].a);
+			ASSERT_EQ(expected[i].b, contacts[i].b);
+			ASSERT_EQ(expected[i].pointCount, contacts[i].pointCount);
+			EXPECT_NEAR(ToFloat(expected[i].normal.x), ToFloat(contacts[i].normal.x), 1e-4f);
+			EXPECT_NEAR(ToFloat(expected[i].normal.y), ToFloat(contacts[i].normal.y), 1e-4f);
+			for (std::uint32_t point = 0; point < contacts[i].pointCount; point++) {
+				EXPECT_EQ(expected[i].points[point].id, contacts[i].points[point].id);
+				EXPECT_NEAR(ToFloat(expected[i].points[point].separation), ToFloat(contacts[i].points[point].separation), 1e-4f);
+			}
+		}
+	});
+
+	// every contact point lies inside both shapes, within half of the penetration
+	for (auto &contact : expected) {
+		for (std::uint32_t point = 0; point < contact.pointCount; point++) {
+			EXPECT_LE(ToFloat(contact.points[point].separation), 0.0f);
+			for (auto body : {contact.a, contact.b}) {
+				auto offset = ToFloat(contact.points[point].position) - glm::vec2(ToFloat(columns.x[body]), ToFloat(columns.y[body]));
+				auto cos = ToFloat(columns.cos[body]), sin = ToFloat(columns.sin[body]);
+				auto local = glm::vec2(cos * offset.x + sin * offset.y, cos * offset.y - sin * offset.x);
+				auto tolerance = 1e-3f - ToFloat(contact.points[point].separation);
+				if (columns.shape[body] == RigidBodyComponent::Shape::Circle) {
+					EXPECT_LE(glm::length(offset), ToFloat(columns.extentX[body]) + tolerance);
+				} else {
+					EXPECT_LE(std::abs(local.x), ToFloat(columns.extentX[body]) + tolerance);
+					EXPECT_LE(std::abs(local.y), ToFloat(columns.extentY[body]) + tolerance);
+				}
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,677 @@
+#include <set>
+#include <random>
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include "glm/gtc/constants.hpp"
+
+#include "core/ecs/entitymanager.hpp"
+#include "core/jobs/jobsystem.hpp"
+#include "core/math/batch.hpp"
+
+#include "game/systems/physics/physics.hpp"
+#include "game/systems/physics/solver.hpp"
+#include "game/systems/physics/aabbtree.hpp"
+#include "game/components/rigidbody/rigidbody.hpp"
+#include "game/components/transform/transform.hpp"
+
+using Symbiote::Core::JobSystem;
+using Symbiote::Core::EntityManager;
+using Symbiote::Game::PhysicsSystem;
+using Symbiote::Game::TransformComponent;
+using Symbiote::Game::RigidBodyComponent;
+
+static auto CreatePhysicsEntityManager() -> std::unique_ptr<EntityManager> {
+	auto manager = std::make_unique<EntityManager>();
+	manager->RegisterComponent<TransformComponent>();
+	manager->RegisterComponent<RigidBodyComponent>();
+	return manager;
+}
+
+TEST(Physics, SemiImplicitEuler) {
+	auto manager = CreatePhysicsEntityManager();
+	auto physics = manager->AddSystem<PhysicsSystem>();
+	auto entity = manager->CreateEntityWith<RigidBodyComponent, TransformComponent>();
+	auto body = entity.GetComponent<RigidBodyComponent>();
+	auto transform = entity.GetComponent<TransformComponent>();
+	transform->SetPosition({1.0f, 2.0f});
+	body->SetAcceleration({0.0f, -10.0f});
+	body->SetVelocity({2.0f, 0.0f});
+	body->SetAngularVelocity(1.0f);
+
+	// the velocity is integrated first, the position moves with the new velocity
+	physics->Update(0.5f);
+	EXPECT_FLOAT_EQ(-5.0f, body->GetVelocity().y);
+	EXPECT_FLOAT_EQ(2.0f, transform->GetPosition().x);
+	EXPECT_FLOAT_EQ(-0.5f, transform->GetPosition().y);
+	EXPECT_FLOAT_EQ(0.5f, transform->GetRotation());
+
+	// forces last one step and scale with the inverse mass
+	body->SetAcceleration({0.0f, 0.0f});
+	body->SetVelocity({0.0f, 0.0f});
+	body->SetMass(2.0f);
+	body->AddForce({4.0f, 0.0f});
+	physics->Update(1.0f);
+	EXPECT_FLOAT_EQ(2.0f, body->GetVelocity().x);
+	physics->Update(1.0f);
+	EXPECT_FLOAT_EQ(2.0f, body->GetVelocity().x);
+	EXPECT_FLOAT_EQ(6.0f, transform->GetPosition().x);
+
+	// damping slows the body down, a static body ignores acceleration
+	body->SetLinearDamping(1.0f);
+	physics->Update(1.0f);
+	EXPECT_FLOAT_EQ(1.0f, body->GetVelocity().x);
+	body->SetMass(0.0f);
+	body->SetLinearDamping(0.0f);
+	body->SetAcceleration({0.0f, -10.0f});
+	physics->Update(1.0f);
+	EXPECT_FLOAT_EQ(0.0f, body->GetVelocity().y);
+
+	// moving the transform teleports the body
+	transform->SetPosition({100.0f, 0.0f});
+	physics->Update(1.0f);
+	EXPECT_FLOAT_EQ(101.0f, body->GetPosition().x);
+}
+
+TEST(Physics, Lifetime) {
+	auto manager = CreatePhysicsEntityManager();
+	std::vector<Symbiote::Core::Entity> entities;
+	for (auto i = 0; i < 10; i++) {
+		auto entity = manager->CreateEntityWith<RigidBodyComponent, TransformComponent>();
+		entity.GetComponent<RigidBodyComponent>()->SetVelocity({static_cast<float>(i), 0.0f});
+		entities.push_back(entity);
+	}
+	auto withoutTransform = manager->CreateEntityWith<RigidBodyComponent>();
+	withoutTransform.GetComponent<RigidBodyComponent>()->SetVelocity({1.0f, 0.0f});
+
+	// bodies created before the system are adopted on its first update
+	auto physics = manager->AddSystem<PhysicsSystem>();
+	physics->Update(1.0f);
+	EXPECT_EQ(11, physics->GetBodyCount());
+	EXPECT_FLOAT_EQ(1.0f, withoutTransform.GetComponent<RigidBodyComponent>()->GetPosition().x);
+
+	// removed bodies are replaced by the last ones
+	entities[3].Destroy();
+	entities[5].RemoveComponent<RigidBodyComponent>();
+	EXPECT_EQ(9, physics->GetBodyCount());
+	physics->Update(1.0f);
+	for (auto i = 0; i < 10; i++) {
+		if (i != 3 && i != 5) {
+			EXPECT_FLOAT_EQ(2.0f * i, entities[i].GetComponent<TransformComponent>()->GetPosition().x);
+		}
+	}
+
+	// a transform added later is found when dependencies are resolved
+	withoutTransform.AddComponent<TransformComponent>();
+	withoutTransform.ResolveComponentDependencies();
+	physics->Update(1.0f);
+	EXPECT_FLOAT_EQ(1.0f, withoutTransform.GetComponent<TransformComponent>()->GetPosition().x);
+
+	// bodies outlive the system with their state
+	manager->RemoveSystem<PhysicsSystem>();
+	EXPECT_FLOAT_EQ(9.0f, entities[9].GetComponent<RigidBodyComponent>()->GetVelocity().x);
+}
+
+TEST(Physics, RemoveTransform) {
+	auto manager = CreatePhysicsEntityManager();
+	auto physics = manager->AddSystem<PhysicsSystem>();
+	auto entity = manager->CreateEntityWith<RigidBodyComponent, TransformComponent>();
+	auto other = manager->CreateEntityWith<RigidBodyComponent, TransformComponent>();
+	entity.GetComponent<RigidBodyComponent>()->SetVelocity({1.0f, 0.0f});
+	physics->Update(1.0f);
+
+	// a body whose transform is removed keeps moving on its own
+	entity.RemoveComponent<TransformComponent>();
+	physics->Update(1.0f);
+	physics->Update(1.0f);
+	EXPECT_FLOAT_EQ(3.0f, entity.GetComponent<RigidBodyComponent>()->GetPosition().x);
+
+	// a transform added back places the body again
+	entity.AddComponent<TransformComponent>(TransformComponent::Scale{1, 1}, TransformComponent::Position{10, 0}, 0.0f);
+	entity.ResolveComponentDependencies();
+	physics->Update(1.0f);
+	EXPECT_FLOAT_EQ(11.0f, entity.GetComponent<TransformComponent>()->GetPosition().x);
+
+	// transforms outlive their body and the system
+	other.RemoveComponent<RigidBodyComponent>();
+	other.RemoveComponent<TransformComponent>();
+	manager->RemoveSystem<PhysicsSystem>();
+	entity.Destroy();
+}
+
+TEST(Physics, Parallel) {
+	JobSystem jobs(4);
+	auto serialManager = CreatePhysicsEntityManager();
+	auto parallelManager = CreatePhysicsEntityManager();
+	auto serial = serialManager->AddSystem<PhysicsSystem>();
+	auto parallel = parallelManager->AddSystem<PhysicsSystem>(&jobs);
+	for (auto manager : {serialManager.get(), parallelManager.get()}) {
+		for (std::size_t i = 0; i < 3 * PhysicsSystem::BatchSize * PhysicsSystem::BatchesPerJob + 7; i++) {
+			auto body = manager->CreateEntityWith<TransformComponent, RigidBodyComponent>().GetComponent<RigidBodyComponent>();
+			body->SetVelocity({static_cast<float>(i % 13), 1.0f});
+			body->SetAcceleration({0.0f, -9.8f});
+			body->SetLinearDamping(0.1f);
+		}
+	}
+	for (auto step = 0; step < 10; step++) {
+		serial->Update(1.0f / 60.0f);
+		parallel->Update(1.0f / 60.0f);
+	}
+	auto serialPositions = serialManager->With<TransformComponent>();
+	auto parallelPositions = parallelManager->With<TransformComponent>();
+	ASSERT_EQ(serialPositions.size(), parallelPositions.size());
+	for (std::size_t i = 0; i < serialPositions.size(); i++) {
+		EXPECT_EQ(serialPositions[i].GetComponent<TransformComponent>()->GetPosition(), parallelPositions[i].GetComponent<TransformComponent>()->GetPosition());
+	}
+}
+
+static auto FindPairsBruteForce(EntityManager &manager, PhysicsSystem &physics) -> std::set<std::pair<std::uint32_t, std::uint32_t>> {
+	std::set<std::pair<std::uint32_t, std::uint32_t>> pairs;
+	std::vector<std::pair<glm::vec2, glm::vec2>> bounds;
+	std::vector<RigidBodyComponent *> bodies;
+	for (std::uint32_t i = 0; i < physics.GetBodyCount(); i++) {
+		auto body = physics.GetEntity(i).GetComponent<RigidBodyComponent>();
+		bodies.push_back(body);
+		bounds.emplace_back(body->GetPosition() - body->GetExtents(), body->GetPosition() + body->GetExtents());
+	}
+	for (std::uint32_t a = 0; a < bodies.size(); a++) {
+		for (std::uint32_t b = a + 1; b < bodies.size(); b++) {
+			if (bodies[a]->GetShape() == RigidBodyComponent::Shape::None || bodies[b]->GetShape() == RigidBodyComponent::Shape::None) {
+				continue;
+			}
+			if (bodies[a]->GetMass() == 0.0f && bodies[b]->GetMass() == 0.0f) {
+				continue;
+			}
+			if (bounds[a].first.x <= bounds[b].second.x && bounds[b].first.x <= bounds[a].second.x && bounds[a].first.y <= bounds[b].second.y && bounds[b].first.y <= bounds[a].second.y) {
+				pairs.emplace(a, b);
+			}
+		}
+	}
+	return pairs;
+}
+
+static auto GetPairs(PhysicsSystem &physics) -> std::set<std::pair<std::uint32_t, std::uint32_t>> {
+	std::set<std::pair<std::uint32_t, std::uint32_t>> pairs;
+	for (auto pair : physics.GetPairs()) {
+		EXPECT_LT(pair.a, pair.b);
+		EXPECT_TRUE(pairs.emplace(pair.a, pair.b).second);
+	}
+	return pairs;
+}
+
+TEST(Physics, Broadphase) {
+	JobSystem jobs(4);
+	auto manager = CreatePhysicsEntityManager();
+	auto physics = manager->AddSystem<PhysicsSystem>(&jobs);
+	physics->SetCellSize(2.0f);
+	std::mt19937 random(42);
+	std::uniform_real_distribution<float> positions(-50.0f, 50.0f);
+	std::uniform_real_distribution<float> sizes(0.1f, 3.0f);
+	std::uniform_real_distribution<float> velocities(-20.0f, 20.0f);
+	std::vector<Symbiote::Core::Entity> entities;
+	for (auto i = 0; i < 2000; i++) {
+		auto entity = manager->CreateEntityWith<TransformComponent, RigidBodyComponent>();
+		auto body = entity.GetComponent<RigidBodyComponent>();
+		entity.GetComponent<TransformComponent>()->SetPosition({positions(random), positions(random)});
+		body->SetVelocity({velocities(random), velocities(random)});
+		// boxes stay axis aligned so that their bounds are their extents
+		if (i % 3 == 0) {
+			body->SetCircle(sizes(random));
+		} else if (i % 3 == 1) {
+			body->SetBox({sizes(random), sizes(random)});
+		}
+		if (i % 7 == 0) {
+			body->SetMass(0.0f);
+		}
+		entities.push_back(entity);
+	}
+
+	// the grid is updated incrementally as bodies move, are removed and change shape
+	for (auto step = 0; step < 10; step++) {
+		physics->Update(1.0f / 30.0f);
+		auto pairs = GetPairs(*physics);
+		EXPECT_FALSE(pairs.empty());
+		EXPECT_EQ(FindPairsBruteForce(*manager, *physics), pairs);
+		entities[step * 100].Destroy();
+		entities[step * 100 + 1].GetComponent<RigidBodyComponent>()->ClearShape();
+		entities[step * 100 + 2].GetComponent<RigidBodyComponent>()->SetCircle(10.0f);
+	}
+
+	// a new cell size inserts every body again
+	physics->SetCellSize(7.0f);
+	physics->Update(1.0f / 30.0f);
+	EXPECT_EQ(FindPairsBruteForce(*manager, *physics), GetPairs(*physics));
+}
+
+TEST(Physics, AabbTree) {
+	Symbiote::Game::AabbTree tree(0.5f);
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> positions(-100.0f, 100.0f);
+	std::uniform_real_distribution<float> moves(-2.0f, 2.0f);
+	std::vector<std::int32_t> proxies;
+	std::vector<glm::vec2> centers;
+	for (std::uint32_t i = 0; i < 1000; i++) {
+		centers.emplace_back(positions(random), positions(random));
+		proxies.push_back(tree.CreateProxy(centers[i] - 1.0f, centers[i] + 1.0f, i));
+	}
+	EXPECT_TRUE(tree.Validate());
+	EXPECT_EQ(1000, tree.GetProxyCount());
+	EXPECT_LE(tree.GetHeight(), 15);
+
+	// bodies which stay in their fat box do not move in the tree
+	EXPECT_FALSE(tree.MoveProxy(proxies[0], centers[0] - 1.2f, centers[0] + 0.8f, {0, 0}));
+	EXPECT_TRUE(tree.MoveProxy(proxies[0], centers[0] - 2.0f, centers[0] + 0.0f, {-1, 0}));
+	EXPECT_FLOAT_EQ(centers[0].x - 3.5f, tree.GetFatMin(proxies[0]).x);
+	EXPECT_FLOAT_EQ(centers[0].x + 0.5f, tree.GetFatMax(proxies[0]).x);
+
+	for (auto step = 0; step < 20; step++) {
+		for (std::uint32_t i = step; i < centers.size(); i++) {
+			centers[i] += glm::vec2(moves(random), moves(random));
+			tree.MoveProxy(proxies[i], centers[i] - 1.0f, centers[i] + 1.0f, {0, 0});
+		}
+		tree.DestroyProxy(proxies[step]);
+		ASSERT_TRUE(tree.Validate());
+	}
+	EXPECT_EQ(980, tree.GetProxyCount());
+
+	// queries see every fat box overlapping the region
+	std::set<std::uint32_t> found;
+	tree.Query({-20.0f, -20.0f}, {20.0f, 20.0f}, [&](std::uint32_t body) { return found.insert(body).second; });
+	std::set<std::uint32_t> expected;
+	for (std::uint32_t i = 20; i < centers.size(); i++) {
+		auto min = tree.GetFatMin(proxies[i]), max = tree.GetFatMax(proxies[i]);
+		if (min.x <= 20.0f && min.y <= 20.0f && max.x >= -20.0f && max.y >= -20.0f) {
+			expected.insert(i);
+		}
+	}
+	EXPECT_FALSE(expected.empty());
+	EXPECT_EQ(expected, found);
+}
+
+TEST(Physics, Queries) {
+	auto manager = CreatePhysicsEntityManager();
+	auto physics = manager->AddSystem<PhysicsSystem>();
+	auto circle = manager->CreateEntityWith<TransformComponent, RigidBodyComponent>();
+	circle.GetComponent<RigidBodyComponent>()->SetCircle(1.0f);
+	circle.GetComponent<RigidBodyComponent>()->SetMass(0.0f);
+	auto box = manager->CreateEntityWith<TransformComponent, RigidBodyComponent>();
+	box.GetComponent<TransformComponent>()->SetPosition({5.0f, 0.0f});
+	box.GetComponent<TransformComponent>()->SetRotation(glm::quarter_pi<float>());
+	box.GetComponent<RigidBodyComponent>()->SetBox({1.0f, 1.0f});
+	box.GetComponent<RigidBodyComponent>()->SetMass(0.0f);
+	physics->Update(1.0f / 60.0f);
+
+	// the closest shape is hit, shapes containing the origin or out of reach are not
+	auto hit = physics->Raycast({{-5.0f, 0.0f}, {2.0f, 0.0f}, 100.0f});
+	ASSERT_TRUE(hit.has_value());
+	EXPECT_EQ(circle, hit->entity);
+	EXPECT_FLOAT_EQ(4.0f, hit->distance);
+	EXPECT_FLOAT_EQ(-1.0f, hit->normal.x);
+	hit = physics->Raycast({{5.0f, -5.0f}, {0.0f, 1.0f}, 100.0f});
+	ASSERT_TRUE(hit.has_value());
+	EXPECT_EQ(box, hit->entity);
+	EXPECT_NEAR(-std::sqrt(2.0f), hit->point.y, 1e-5f);
+	EXPECT_NEAR(-std::sqrt(0.5f), hit->normal.y, 1e-5f);
+	EXPECT_FALSE(physics->Raycast({{0.0f, 0.0f}, {-1.0f, 0.0f}, 100.0f}).has_value());
+	EXPECT_FALSE(physics->Raycast({{-5.0f, 0.0f}, {1.0f, 0.0f}, 3.0f}).has_value());
+	EXPECT_FALSE(physics->Raycast({{-5.0f, 2.0f}, {1.0f, 0.0f}, 100.0f}).has_value());
+
+	// regions and circles test the shapes, not only their bounding boxes
+	std::vector<Symbiote::Core::Entity> entities;
+	physics->QueryAABB({{0.8f, 0.8f}, {2.0f, 2.0f}}, entities);
+	EXPECT_TRUE(entities.empty());
+	physics->QueryAABB({{3.0f, 0.8f}, {4.0f, 2.0f}}, entities);
+	EXPECT_TRUE(entities.empty());
+	physics->QueryAABB({{-0.5f, -0.5f}, {4.0f, 0.5f}}, entities);
+	EXPECT_EQ(2, entities.size());
+	physics->QueryCircle({{3.0f, 1.0f}, 0.5f}, entities);
+	EXPECT_TRUE(entities.empty());
+	physics->QueryCircle({{3.0f, 0.0f}, 0.7f}, entities);
+	ASSERT_EQ(1, entities.size());
+	EXPECT_EQ(box, entities[0]);
+
+	// moved and removed bodies are found where they are after the update
+	circle.GetComponent<TransformComponent>()->SetPosition({0.0f, 50.0f});
+	physics->Update(1.0f / 60.0f);
+	physics->QueryCircle({{0.0f, 50.0f}, 0.1f}, entities);
+	ASSERT_EQ(1, entities.size());
+	EXPECT_EQ(circle, entities[0]);
+	circle.Destroy();
+	physics->QueryAABB({{-100.0f, -100.0f}, {100.0f, 100.0f}}, entities);
+	ASSERT_EQ(1, entities.size());
+	EXPECT_EQ(box, entities[0]);
+}
+
+TEST(Physics, BatchedQueries) {
+	JobSystem jobs(4);
+	auto manager = CreatePhysicsEntityManager();
+	auto physics = manager->AddSystem<PhysicsSystem>(&jobs);
+	std::mt19937 random(3);
+	std::uniform_real_distribution<float> positions(-50.0f, 50.0f);
+	std::uniform_real_distribution<float> angles(0.0f, 6.28f);
+	for (auto i = 0; i < 1000; i++) {
+		auto entity = manager->CreateEntityWith<TransformComponent, RigidBodyComponent>();
+		entity.GetComponent<TransformComponent>()->SetPosition({positions(random), positions(random)});
+		entity.GetComponent<TransformComponent>()->SetRotation(angles(random));
+		auto body = entity.GetComponent<RigidBodyComponent>();
+		i % 2 == 0 ? body->SetCircle(0.5f) : body->SetBox({0.5f, 1.0f});
+	}
+	physics->Update(1.0f / 60.0f);
+
+	std::vector<PhysicsSystem::Ray> rays;
+	std::vector<PhysicsSystem::Circle> circles;
+	for (auto i = 0; i < 500; i++) {
+		auto angle = angles(random);
+		rays.push_back({{positions(random), positions(random)}, {std::cos(angle), std::sin(angle)}, 30.0f});
+		circles.push_back({{positions(random), positions(random)}, 3.0f});
+	}
+	std::vector<std::optional<PhysicsSystem::RaycastHit>> hits;
+	std::vector<std::vector<Symbiote::Core::Entity>> found;
+	physics->Raycast(rays, hits);
+	physics->QueryCircle(circles, found);
+	ASSERT_EQ(rays.size(), hits.size());
+	ASSERT_EQ(circles.size(), found.size());
+	auto hitCount = 0;
+	std::vector<Symbiote::Core::Entity> entities;
+	for (std::size_t i = 0; i < rays.size(); i++) {
+		auto hit = physics->Raycast(rays[i]);
+		ASSERT_EQ(hit.has_value(), hits[i].has_value());
+		if (hit.has_value()) {
+			hitCount += 1;
+			EXPECT_EQ(hit->entity, hits[i]->entity);
+			EXPECT_EQ(hit->distance, hits[i]->distance);
+		}
+		physics->QueryCircle(circles[i], entities);
+		EXPECT_EQ(entities, found[i]);
+	}
+	EXPECT_GT(hitCount, 0);
+}
+
+static auto CreateBox(EntityManager &manager, glm::vec2 position, glm::vec2 halfExtents, float mass) -> RigidBodyComponent * {
+	auto entity = manager.CreateEntityWith<TransformComponent, RigidBodyComponent>();
+	auto body = entity.GetComponent<RigidBodyComponent>();
+	entity.GetComponent<TransformComponent>()->SetPosition(position);
+	body->SetBox(halfExtents);
+	body->SetMass(mass);
+	body->SetAcceleration({0.0f, -10.0f});
+	return body;
+}
+
+TEST(Physics, Stacking) {
+	JobSystem jobs(4);
+	auto manager = CreatePhysicsEntityManager();
+	auto physics = manager->AddSystem<PhysicsSystem>(&jobs);
+	// the stacks are solved on every step rather than falling asleep
+	physics->SetSleepingEnabled(false);
+	CreateBox(*manager, {0.0f, 0.0f}, {20.0f, 0.5f}, 0.0f);
+	std::vector<RigidBodyComponent *> left, right;
+	for (auto i = 0; i < 10; i++) {
+		left.push_back(CreateBox(*manager, {-5.0f, 1.0f + i}, {0.5f, 0.5f}, 1.0f));
+		right.push_back(CreateBox(*manager, {5.0f, 1.0f + i}, {0.5f, 0.5f}, 1.0f));
+	}
+	for (auto step = 0; step < 300; step++) {
+		physics->Update(1.0f / 60.0f);
+	}
+	// the stacks rest on the ground, they only touch through it and are islands of their own
+	EXPECT_EQ(2, physics->GetIslandCount());
+	EXPECT_THROW(physics->SetSolverIterations(0), std::logic_error);
+	for (auto stack : {&left, &right}) {
+		for (std::size_t i = 0; i < stack->size(); i++) {
+			auto body = (*stack)[i];
+			EXPECT_NEAR(stack == &left ? -5.0f : 5.0f, body->GetPosition().x, 0.01f);
+			EXPECT_NEAR(1.0f + i, body->GetPosition().y, 0.05f);
+			EXPECT_NEAR(0.0f, body->GetRotation(), 0.01f);
+			EXPECT_LT(glm::length(body->GetVelocity()), 0.05f);
+		}
+	}
+}
+
+TEST(Physics, Sleeping) {
+	JobSystem jobs(4);
+	auto manager = CreatePhysicsEntityManager();
+	auto physics = manager->AddSystem<PhysicsSystem>(&jobs);
+	auto groundEntity = manager->CreateEntityWith<TransformComponent, RigidBodyComponent>();
+	auto ground = groundEntity.GetComponent<RigidBodyComponent>();
+	ground->SetBox({20.0f, 0.5f});
+	ground->SetMass(0.0f);
+	std::vector<RigidBodyComponent *> stack;
+	for (auto i = 0; i < 5; i++) {
+		stack.push_back(CreateBox(*manager, {-5.0f, 1.0f + i}, {0.5f, 0.5f}, 1.0f));
+	}
+	auto alone = CreateBox(*manager, {5.0f, 1.0f}, {0.5f, 0.5f}, 1.0f);
+	for (auto step = 0; step < 120; step++) {
+		physics->Update(1.0f / 60.0f);
+	}
+	// bodies at rest fall asleep, sleeping bodies are neither simulated nor paired together
+	EXPECT_EQ(0, physics->GetAwakeCount());
+	EXPECT_EQ(7, physics->GetBodyCount());
+	EXPECT_TRUE(physics->GetContacts().empty());
+	auto position = stack.back()->GetPosition();
+	physics->Update(1.0f / 60.0f);
+	EXPECT_TRUE(stack.back()->IsSleeping());
+	EXPECT_EQ(position, stack.back()->GetPosition());
+	EXPECT_EQ(glm::vec2(0.0f, 0.0f), stack.back()->GetVelocity());
+
+	// a body falling on the stack wakes its island, the ground and the other island sleep on
+	auto falling = CreateBox(*manager, {-5.0f, 7.0f}, {0.5f, 0.5f}, 1.0f);
+	EXPECT_EQ(1, physics->GetAwakeCount());
+	for (auto step = 0; step < 30 && stack[0]->IsSleeping(); step++) {
+		physics->Update(1.0f / 60.0f);
+	}
+	for (auto body : stack) {
+		EXPECT_FALSE(body->IsSleeping());
+	}
+	EXPECT_FALSE(falling->IsSleeping());
+	EXPECT_TRUE(ground->IsSleeping());
+	EXPECT_TRUE(alone->IsSleeping());
+	EXPECT_EQ(6, physics->GetAwakeCount());
+	for (auto step = 0; step < 180; step++) {
+		physics->Update(1.0f / 60.0f);
+	}
+	EXPECT_EQ(0, physics->GetAwakeCount());
+	EXPECT_NEAR(6.0f, falling->GetPosition().y, 0.05f);
+
+	// changing a body wakes it, the bodies resting on a removed body wake up
+	alone->SetVelocity({1.0f, 0.0f});
+	EXPECT_FALSE(alone->IsSleeping());
+	EXPECT_EQ(1, physics->GetAwakeCount());
+	stack[0]->WakeUp();
+	EXPECT_EQ(7, physics->GetAwakeCount());
+	physics->Update(1.0f / 60.0f);
+	EXPECT_GT(alone->GetPosition().x, 5.0f);
+	EXPECT_NEAR(6.0f, falling->GetPosition().y, 0.05f);
+	for (auto step = 0; step < 60; step++) {
+		physics->Update(1.0f / 60.0f);
+	}
+	EXPECT_TRUE(stack[0]->IsSleeping());
+	groundEntity.Destroy();
+	EXPECT_FALSE(stack[0]->IsSleeping());
+	physics->Update(1.0f / 60.0f);
+	EXPECT_LT(stack[0]->GetVelocity().y, 0.0f);
+
+	// disabling sleeping wakes every body
+	alone->SetVelocity({0.0f, 0.0f});
+	alone->SetAcceleration({0.0f, 0.0f});
+	for (auto step = 0; step < 60; step++) {
+		physics->Update(1.0f / 60.0f);
+	}
+	EXPECT_TRUE(alone->IsSleeping());
+	physics->SetSleepingEnabled(false);
+	EXPECT_FALSE(alone->IsSleeping());
+	EXPECT_EQ(physics->GetBodyCount(), physics->GetAwakeCount());
+}
+
+TEST(Physics, SolverParallel) {
+	// bricks of a pyramid rest on the two bricks below them, the pyramid is one island with enough contacts to be colored
+	// it is solved the same whatever the number of threads
+	JobSystem jobs(4);
+	auto serialManager = CreatePhysicsEntityManager();
+	auto parallelManager = CreatePhysicsEntityManager();
+	auto serial = serialManager->AddSystem<PhysicsSystem>();
+	auto parallel = parallelManager->AddSystem<PhysicsSystem>(&jobs);
+	for (auto manager : {serialManager.get(), parallelManager.get()}) {
+		CreateBox(*manager, {0.0f, 0.0f}, {40.0f, 0.5f}, 0.0f);
+		for (auto row = 0; row < 15; row++) {
+			for (auto column = 0; column < 50 - row; column++) {
+				CreateBox(*manager, {column + row * 0.5f - 25.0f, 0.75f + row * 0.5f}, {0.5f, 0.25f}, 1.0f);
+			}
+		}
+	}
+	for (auto step = 0; step < 180; step++) {
+		serial->Update(1.0f / 60.0f);
+		parallel->Update(1.0f / 60.0f);
+	}
+	EXPECT_EQ(1, parallel->GetIslandCount());
+	EXPECT_GT(parallel->GetContacts().size(), Symbiote::Game::ContactSolver::ColoringThreshold);
+	auto serialBodies = serialManager->With<RigidBodyComponent>();
+	auto parallelBodies = parallelManager->With<RigidBodyComponent>();
+	ASSERT_EQ(serialBodies.size(), parallelBodies.size());
+	for (std::size_t i = 0; i < serialBodies.size(); i++) {
+		auto expected = serialBodies[i].GetComponent<RigidBodyComponent>();
+		auto body = parallelBodies[i].GetComponent<RigidBodyComponent>();
+		EXPECT_EQ(expected->GetPosition(), body->GetPosition());
+		EXPECT_EQ(expected->GetRotation(), body->GetRotation());
+		// the wall stands
+		EXPECT_NEAR(0.0f, body->GetRotation(), 0.01f);
+		EXPECT_LT(glm::length(body->GetVelocity()), 0.1f);
+	}
+}
+
+TEST(Physics, ContactSolver) {
+	// a chain of touching bodies moving into each other, its contacts alternate between two colors
+	using Symbiote::Game::Narrowphase;
+	using Symbiote::Game::ContactSolver;
+	constexpr std::uint32_t count = 4000;
+	std::vector<Symbiote::Core::Real> velocityX(count), velocityY(count, 0.0f), angularVelocity(count, 0.0f), x(count), y(count, 0.0f), inverseMass(count, 1.0f), inverseInertia(count, 1.0f);
+	std::vector<Narrowphase::Contact> contacts;
+	for (std::uint32_t body = 0; body < count; body++) {
+		x[body] = static_cast<float>(body);
+		velocityX[body] = body % 2 == 0 ? -1.0f : 1.0f;
+		if (body + 1 < count) {
+			Narrowphase::Contact contact;
+			contact.a = body;
+			contact.b = body + 1;
+			contact.normal = {1.0f, 0.0f};
+			contact.pointCount = 1;
+			contact.points[0].position = {body + 0.5f, 0.0f};
+			contacts.push_back(contact);
+		}
+	}
+	// the last body is static, it is only read
+	inverseMass[count - 1] = 0.0f;
+	inverseInertia[count - 1] = 0.0f;
+	auto solve = [&](Symbiote::Core::JobSystem *jobs) {
+		auto vx = velocityX, vy = velocityY, w = angularVelocity;
+		ContactSolver solver;
+		ContactSolver::Bodies bodies;
+		bodies.velocityX = vx.data();
+		bodies.velocityY = vy.data();
+		bodies.angularVelocity = w.data();
+		bodies.x = x.data();
+		bodies.y = y.data();
+		bodies.inverseMass = inverseMass.data();
+		bodies.inverseInertia = inverseInertia.data();
+		solver.Solve(bodies, count, contacts, 1.0f / 60.0f, jobs);
+		EXPECT_EQ(1, solver.GetIslandCount());
+		EXPECT_EQ(2, solver.GetColorCount());
+		EXPECT_EQ(1.0f, vx[count - 1]);
+		return vx;
+	};
+	JobSystem jobs(4);
+	auto expected = solve(nullptr);
+	EXPECT_EQ(expected, solve(&jobs));
+	// no two bodies keep moving into each other
+	for (std::uint32_t body = 0; body + 2 < count; body++) {
+		EXPECT_GE(expected[body + 1] - expected[body], -1e-4f);
+	}
+}
+
+TEST(Physics, SaveAndRestore) {
+	// bodies in free flight, a restored, forked or streamed in world goes on from the same numbers as if nothing happened
+	auto manager = CreatePhysicsEntityManager();
+	auto physics = manager->AddSystem<PhysicsSystem>();
+	for (auto i = 0; i < 20; i++) {
+		auto body = CreateBox(*manager, {i * 4.0f, 0.0f}, {0.5f, 0.25f}, 1.0f + i * 0.25f);
+		if (i % 2 == 0) {
+			body->SetCircle(0.5f);
+		}
+		body->SetVelocity({(i % 3) * 0.5f, 1.0f});
+		body->SetAngularVelocity(i * 0.25f);
+		body->SetLinearDamping(0.125f);
+	}
+	auto step = [](PhysicsSystem &physics) {
+		for (auto i = 0; i < 30; i++) {
+			physics.Update(1.0f / 60.0f);
+		}
+		return physics.Hash();
+	};
+	auto created = manager->Hash();
+	auto hash = step(*physics);
+	auto worldHash = manager->Hash();
+	EXPECT_NE(created, worldHash);
+	manager->SaveFrame(0);
+	auto fork = manager->Fork();
+	std::stringstream saved;
+	manager->Serialize(saved);
+	auto after = step(*physics);
+	EXPECT_NE(worldHash, manager->Hash());
+
+	manager->RestoreFrame(0);
+	EXPECT_EQ(hash, physics->Hash());
+	EXPECT_EQ(worldHash, manager->Hash());
+	EXPECT_EQ(after, step(*physics));
+
+	// the fork keeps the state of its bodies until a physics system adopts them
+	EXPECT_EQ(worldHash, fork->Hash());
+	auto forkBody = fork->With<RigidBodyComponent>()[4].GetComponent<RigidBodyComponent>();
+	EXPECT_NE(0.0f, forkBody->GetVelocity().x);
+	EXPECT_NE(0.0f, forkBody->GetPosition().y);
+	EXPECT_EQ(after, step(*fork->AddSystem<PhysicsSystem>()));
+
+	auto loaded = CreatePhysicsEntityManager();
+	auto loadedPhysics = loaded->AddSystem<PhysicsSystem>();
+	loaded->Deserialize(saved);
+	EXPECT_EQ(hash, loadedPhysics->Hash());
+	EXPECT_EQ(worldHash, loaded->Hash());
+	EXPECT_EQ(after, step(*loadedPhysics));
+}
+
+TEST(Physics, Determinism) {
+	// boxes and circles thrown in a pile, the world after the same steps has the same hash whatever the threads
+	auto simulate = [](JobSystem *jobs) {
+		auto manager = CreatePhysicsEntityManager();
+		auto physics = manager->AddSystem<PhysicsSystem>(jobs);
+		CreateBox(*manager, {0.0f, 0.0f}, {20.0f, 0.5f}, 0.0f);
+		// the inputs are exact in binary, a compiler fusing their products and sums would otherwise start from other positions
+		for (auto i = 0; i < 60; i++) {
+			auto body = CreateBox(*manager, {(i % 10) * 1.125f - 5.0f + (i / 10) * 0.125f, 2.0f + (i / 10) * 1.25f}, {0.375f, 0.25f}, 1.0f + (i % 4) * 0.5f);
+			if (i % 3 == 0) {
+				body->SetCircle(0.4375f);
+			}
+			body->SetVelocity({(i % 7) * 0.5f - 1.5f, 0.0f});
+			body->SetAngularVelocity((i % 5) * 0.375f - 0.75f);
+		}
+		for (auto step = 0; step < 240; step++) {
+			physics->Update(1.0f / 60.0f);
+		}
+		// the world hash covers every saved number of the bodies, the physics hash only their positions and velocities
+		return manager->Hash();
+	};
+	JobSystem jobs(4);
+	auto hash = simulate(nullptr);
+	EXPECT_EQ(hash, simulate(nullptr));
+	EXPECT_EQ(hash, simulate(&jobs));
+#if SYMBIOTE_FIXED_POINT
+	// fixed point also steps the same whatever the instruction set, the compiler or its flags: every build gives these hashes
+	auto supported = Symbiote::Core::GetSupportedSimdLevel();
+	Symbiote::Core::SetSimdLevel(Symbiote::Core::SimdLevel::Scalar);
+	EXPECT_EQ(hash, simulate(&jobs));
+	Symbiote::Core::SetSimdLevel(supported);
+#if SYMBIOTE_FIXED_POINT == 16
+	EXPECT_EQ(8909318314608405655ull, hash);
+#else
+	EXPECT_EQ(870309429374844668ull, hash);
+#endif
+#endif
+}
\ No newline at end of file
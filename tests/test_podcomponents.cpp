@@ -0,0 +1,169 @@
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <gtest/gtest.h>
+
+#include "core/ecs/entitymanager.hpp"
+
+#include "test_components/components.hpp"
+
+using Symbiote::Core::ComponentColumn;
+
+TEST(PodComponents, AddGetRemove) {
+	auto manager = CreateEntityManager();
+	auto entity1 = manager->CreateEntity();
+	auto entity2 = manager->CreateEntity();
+	auto entity3 = manager->CreateEntity();
+
+	auto position1 = entity1.AddComponent<PositionComponent>(1.0f, 2.0f);
+	entity2.AddComponent<PositionComponent>(3.0f, 4.0f);
+	entity3.AddComponent<PositionComponent>();
+	entity3.AddComponent<VelocityComponent>(1.0f, 1.0f, 1.0f);
+	entity3.AddComponent<TransformComponent>(5.0f, 6.0f);
+
+	EXPECT_EQ(position1, entity1.GetComponent<PositionComponent>());
+	EXPECT_EQ(2.0f, position1->y);
+	EXPECT_EQ(0.0f, entity3.GetComponent<PositionComponent>()->x);
+	EXPECT_TRUE((entity3.HasComponent<PositionComponent, VelocityComponent, TransformComponent>()));
+	EXPECT_FALSE(entity1.HasComponent<VelocityComponent>());
+	EXPECT_ANY_THROW(entity1.AddComponent<PositionComponent>());
+	EXPECT_ANY_THROW(entity1.RemoveComponent<VelocityComponent>());
+
+	// the last component is moved into the hole
+	entity1.RemoveComponent<PositionComponent>();
+	EXPECT_FALSE(entity1.HasComponent<PositionComponent>());
+	EXPECT_EQ(3.0f, entity2.GetComponent<PositionComponent>()->x);
+	EXPECT_EQ(0.0f, entity3.GetComponent<PositionComponent>()->x);
+
+	auto count = 0;
+	manager->With<PositionComponent, VelocityComponent>([&count, &entity3](auto entity, auto position, auto velocity) {
+		EXPECT_EQ(entity3, entity);
+		EXPECT_EQ(0.0f, position->y);
+		EXPECT_EQ(1.0f, velocity->z);
+		count += 1;
+	});
+	EXPECT_EQ(1, count);
+
+	entity3.Destroy();
+	auto entity4 = manager->CreateEntity();
+	EXPECT_FALSE((entity4.HasAnyComponent<PositionComponent, VelocityComponent>()));
+
+	Symbiote::Core::EntityManager unregistered;
+	auto entity5 = unregistered.CreateEntity();
+	EXPECT_EQ(nullptr, entity5.GetComponent<PositionComponent>());
+	EXPECT_ANY_THROW(entity5.AddComponent<PositionComponent>());
+}
+
+TEST(PodComponents, ColumnPages) {
+	ComponentColumn column("Column", sizeof(float), alignof(float));
+	auto perPage = column.GetElementsPerPage();
+	EXPECT_EQ(ComponentColumn::PageSize / sizeof(float), perPage);
+	for (Symbiote::Core::Entity::PointerSize i = 0; i < perPage + 1; i++) {
+		*static_cast<float *>(column.Insert(i)) = static_cast<float>(i);
+	}
+	EXPECT_EQ(2, column.GetPageCount());
+	column.Erase(0);
+	EXPECT_EQ(1, column.GetPageCount());
+	EXPECT_EQ(static_cast<float>(perPage), *static_cast<const float *>(column.Get(perPage)));
+	EXPECT_EQ(nullptr, column.Get(0));
+
+	EXPECT_ANY_THROW(ComponentColumn("Huge", ComponentColumn::PageSize + 1, 1));
+}
+
+TEST(PodComponents, SaveAndLoad) {
+	std::stringstream snapshot;
+	{
+		auto manager = CreateEntityManager();
+		for (auto i = 0; i < 5000; i++) {
+			auto entity = manager->CreateEntity();
+			entity.AddComponent<PositionComponent>(static_cast<float>(i), static_cast<float>(-i));
+			if (i % 3 == 0) {
+				entity.AddComponent<VelocityComponent>(0.0f, 0.0f, static_cast<float>(i));
+			}
+			if (i % 7 == 0) {
+				entity.AddComponent<TransformComponent>(static_cast<float>(i), 0.0f);
+			}
+		}
+		manager->Serialize(snapshot);
+	}
+
+	auto manager = CreateEntityManager();
+	manager->Deserialize(snapshot);
+	EXPECT_EQ(5000, manager->Size());
+	auto i = 0;
+	for (auto entity : *manager) {
+		EXPECT_EQ(static_cast<float>(i), entity.GetComponent<PositionComponent>()->x);
+		EXPECT_EQ(static_cast<float>(-i), entity.GetComponent<PositionComponent>()->y);
+		EXPECT_EQ(i % 3 == 0, entity.HasComponent<VelocityComponent>());
+		EXPECT_EQ(i % 7 == 0, entity.HasComponent<TransformComponent>());
+		i += 1;
+	}
+
+	// equal worlds produce equal snapshots
+	std::stringstream again;
+	manager->Serialize(again);
+	EXPECT_EQ(snapshot.str(), again.str());
+}
+
+TEST(PodComponents, MappedLoad) {
+	const char *path = "pod_mapped_save.bin";
+	{
+		auto manager = CreateEntityManager();
+		for (auto i = 0; i < 10000; i++) {
+			auto entity = manager->CreateEntity();
+			entity.AddComponent<PositionComponent>(static_cast<float>(i), 1.0f);
+			if (i % 2 == 0) {
+				entity.AddComponent<TransformComponent>(static_cast<float>(i), 2.0f);
+			}
+		}
+		std::ofstream file(path, std::ios::binary);
+		manager->Serialize(file);
+	}
+
+	std::string before;
+	{
+		auto manager = CreateEntityManager();
+		manager->DeserializeMapped(path);
+		EXPECT_EQ(10000, manager->Size());
+		auto i = 0;
+		for (auto entity : *manager) {
+			ASSERT_EQ(static_cast<float>(i), entity.GetComponent<PositionComponent>()->x);
+			EXPECT_EQ(i % 2 == 0, entity.HasComponent<TransformComponent>());
+			// writes are private to the loaded world
+			entity.GetComponent<PositionComponent>()->y = 42.0f;
+			i += 1;
+		}
+		auto entity = manager->CreateEntity();
+		entity.AddComponent<PositionComponent>(-1.0f, -1.0f);
+		entity.AddComponent<VelocityComponent>();
+		entity = *manager->begin();
+		entity.Destroy();
+		EXPECT_EQ(10000, manager->Size());
+		EXPECT_EQ(-1.0f, manager->With<VelocityComponent>().front().GetComponent<PositionComponent>()->x);
+	}
+
+	auto manager = CreateEntityManager();
+	manager->DeserializeMapped(path);
+	for (auto entity : *manager) {
+		ASSERT_EQ(1.0f, entity.GetComponent<PositionComponent>()->y);
+	}
+	std::remove(path);
+
+	EXPECT_ANY_THROW(manager->DeserializeMapped("pod_missing_save.bin"));
+}
+
+TEST(PodComponents, LoadMismatchedSnapshot) {
+	std::stringstream snapshot;
+	{
+		auto manager = CreateEntityManager();
+		manager->CreateEntity().AddComponent<PositionComponent>();
+		manager->Serialize(snapshot);
+	}
+	Symbiote::Core::EntityManager manager;
+	EXPECT_THROW(manager.Deserialize(snapshot), std::logic_error);
+
+	auto bytes = snapshot.str();
+	std::stringstream truncated(bytes.substr(0, bytes.size() - 100));
+	auto registered = CreateEntityManager();
+	EXPECT_THROW(registered->Deserialize(truncated), std::runtime_error);
+}
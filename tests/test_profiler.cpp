@@ -0,0 +1,84 @@
+#include <thread>
+#include <sstream>
+#include <algorithm>
+#include <gtest/gtest.h>
+
+#include "core/ecs/entitymanager.hpp"
+#include "core/profiler/profiler.hpp"
+
+#include "test_components/components.hpp"
+
+using Symbiote::Core::Profiler;
+
+static auto CountEvents(const std::vector<Profiler::Event> &events, const std::string &name) -> std::size_t {
+	return std::count_if(events.begin(), events.end(), [&name](const auto &event) { return name == event.name; });
+}
+
+TEST(Profiler, RecordAndCollect) {
+	Profiler profiler;
+	profiler.Record("first", 10, 20);
+	profiler.Record("second", 5, 30);
+	auto events = profiler.Collect();
+	ASSERT_EQ(2, events.size());
+	EXPECT_STREQ("second", events[0].name);
+	EXPECT_STREQ("first", events[1].name);
+	EXPECT_EQ(10, events[1].begin);
+	EXPECT_EQ(20, events[1].end);
+	EXPECT_EQ(events[0].threadId, events[1].threadId);
+
+	profiler.Clear();
+	EXPECT_TRUE(profiler.Collect().empty());
+}
+
+TEST(Profiler, RingBufferKeepsMostRecentEvents) {
+	Profiler profiler;
+	for (std::uint64_t i = 0; i < Profiler::BufferSize + 10; i++) {
+		profiler.Record("event", i, i + 1);
+	}
+	auto events = profiler.Collect();
+	ASSERT_EQ(Profiler::BufferSize - 1, events.size());
+	EXPECT_EQ(11, events.front().begin);
+	EXPECT_EQ(Profiler::BufferSize + 9, events.back().begin);
+}
+
+TEST(Profiler, PerThreadBuffers) {
+	Profiler profiler;
+	profiler.Record("main", 1, 2);
+	std::thread([&profiler]() { profiler.Record("worker", 3, 4); }).join();
+	auto events = profiler.Collect();
+	ASSERT_EQ(2, events.size());
+	EXPECT_NE(events[0].threadId, events[1].threadId);
+}
+
+TEST(Profiler, ChromeTrace) {
+	Profiler profiler;
+	profiler.Record("quoted \"zone\"", 1500, 4000);
+	std::stringstream trace;
+	profiler.WriteChromeTrace(trace);
+	EXPECT_EQ("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[{\"name\":\"quoted \\\"zone\\\"\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":1.500,\"dur\":2.500}]}", trace.str());
+}
+
+#if defined(SYMBIOTE_PROFILER)
+TEST(Profiler, Scopes) {
+	auto &profiler = Profiler::Get();
+	profiler.Clear();
+	{
+		SYMBIOTE_PROFILE_SCOPE("outer");
+		SYMBIOTE_PROFILE_SCOPE("inner");
+		auto manager = CreateEntityManager();
+		manager->CreateEntityWith<TransformComponent>();
+		manager->With<TransformComponent>([](auto, auto) {});
+	}
+	auto events = profiler.Collect();
+	EXPECT_EQ(1, CountEvents(events, "outer"));
+	EXPECT_EQ(1, CountEvents(events, "inner"));
+	EXPECT_EQ(1, CountEvents(events, "EntityManager::CreateEntity"));
+	EXPECT_EQ(1, CountEvents(events, "EntityManager::With"));
+	auto outer = std::find_if(events.begin(), events.end(), [](const auto &event) { return std::string{"outer"} == event.name; });
+	for (const auto &event : events) {
+		EXPECT_GE(event.begin, outer->begin);
+		EXPECT_LE(event.end, outer->end);
+		EXPECT_LE(event.begin, event.end);
+	}
+}
+#endif
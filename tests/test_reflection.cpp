@@ -0,0 +1,151 @@
+#include <sstream>
+#include <gtest/gtest.h>
+
+#include "core/ecs/entitymanager.hpp"
+#include "core/ecs/reflection.hpp"
+#include "core/serialization/delta.hpp"
+#include "core/serialization/binary.hpp"
+
+#include "test_components/components.hpp"
+
+static auto Save(const Symbiote::Core::EntityManager &manager) -> std::string {
+	std::ostringstream os;
+	manager.Serialize(os);
+	return os.str();
+}
+
+// transforms and scales as snapshot versions 1 to 3 wrote them, before TransformComponent was reflected every component was an instance
+static auto WriteInstanceSnapshot(std::uint32_t version, std::uint32_t count) -> std::string {
+	using Symbiote::Core::WriteBinary;
+	std::ostringstream os;
+	std::vector<Symbiote::Core::Entity::PointerSize> versions(count, 1), entities;
+	for (std::uint32_t i = 0; i < count; i++) {
+		entities.push_back(i);
+	}
+	WriteBinary(os, Symbiote::Core::EntityManager::SnapshotMagic);
+	WriteBinary(os, version);
+	WriteBinary(os, count);
+	WriteBinary(os, std::uint32_t{0});
+	WriteBinary(os, std::uint32_t{2});
+	WriteBinary(os, versions);
+	for (std::string name : {"ScaleComponent", "TransformComponent"}) {
+		WriteBinary(os, static_cast<std::uint32_t>(name.size()));
+		os.write(name.data(), static_cast<std::streamsize>(name.size()));
+		if (version >= 2) {
+			WriteBinary(os, static_cast<std::uint32_t>(Symbiote::Core::InstanceLayout));
+			WriteBinary(os, std::uint32_t{0});
+		}
+	}
+	for (std::uint32_t typeIndex = 0; typeIndex < 2; typeIndex++) {
+		std::vector<std::uint32_t> offsets(1, 0);
+		std::vector<float> payload;
+		for (std::uint32_t i = 0; i < count; i++) {
+			payload.push_back(typeIndex == 0 ? 2.0f : static_cast<float>(i));
+			payload.push_back(typeIndex == 0 ? static_cast<float>(i) : 0.5f);
+			offsets.push_back(offsets.back() + 2 * sizeof(float));
+		}
+		WriteBinary(os, typeIndex);
+		WriteBinary(os, static_cast<std::uint64_t>(sizeof(count) + count * sizeof(std::uint32_t) + offsets.size() * sizeof(std::uint32_t) + payload.size() * sizeof(float)));
+		WriteBinary(os, count);
+		WriteBinary(os, entities);
+		WriteBinary(os, offsets);
+		WriteBinary(os, payload);
+	}
+	return os.str();
+}
+
+TEST(Reflection, Fields) {
+	EXPECT_TRUE(Symbiote::Core::IsReflectedComponent<NameComponent>);
+	EXPECT_TRUE(Symbiote::Core::IsReflectedComponent<TransformComponent>);
+	EXPECT_FALSE(Symbiote::Core::IsReflectedComponent<DummyComponent>);
+	EXPECT_FALSE(Symbiote::Core::IsReflectedComponent<PositionComponent>);
+
+	auto fields = NameComponent::ReflectedFields();
+	EXPECT_STREQ("mName", std::get<0>(fields).name);
+	EXPECT_STREQ("mTags", std::get<1>(fields).name);
+	EXPECT_STREQ("mWeight", std::get<2>(fields).name);
+	EXPECT_NE(Symbiote::Core::FieldsSignature<NameComponent>(), Symbiote::Core::FieldsSignature<TransformComponent>());
+}
+
+TEST(Reflection, HashAndEqual) {
+	NameComponent a, b;
+	a.mName = b.mName = "symbiote";
+	a.mTags = b.mTags = {1, 2, 3};
+	EXPECT_TRUE(Symbiote::Core::FieldsEqual(a, b));
+	EXPECT_EQ(Symbiote::Core::HashFields(a), Symbiote::Core::HashFields(b));
+
+	b.mTags.push_back(4);
+	EXPECT_FALSE(Symbiote::Core::FieldsEqual(a, b));
+	EXPECT_NE(Symbiote::Core::HashFields(a), Symbiote::Core::HashFields(b));
+
+	auto &reflected = Symbiote::Core::GetReflectedComponent<NameComponent>();
+	b.mTags.pop_back();
+	b.mWeight = 1.0f;
+	EXPECT_FALSE(reflected.equal(&a, &b));
+	EXPECT_NE(reflected.hash(&a, Symbiote::Core::HashSeed), reflected.hash(&b, Symbiote::Core::HashSeed));
+}
+
+TEST(Reflection, SaveAndLoad) {
+	auto manager = CreateEntityManager();
+	for (auto i = 0; i < 100; i++) {
+		auto entity = manager->CreateEntityWith<TransformComponent>();
+		entity.GetComponent<TransformComponent>()->mData = {static_cast<float>(i), 2.0f};
+		if (i % 3 == 0) {
+			auto name = entity.AddComponent<NameComponent>();
+			name->mName = "entity " + std::to_string(i);
+			name->mTags.assign(i % 7, i);
+			name->mWeight = i * 0.5f;
+		}
+	}
+	auto saved = Save(*manager);
+
+	auto loaded = CreateEntityManager();
+	std::istringstream is(saved);
+	loaded->Deserialize(is);
+	EXPECT_EQ(saved, Save(*loaded));
+	auto names = loaded->With<NameComponent>();
+	ASSERT_EQ(34, names.size());
+	auto name = names[11].GetComponent<NameComponent>();
+	EXPECT_EQ("entity 33", name->mName);
+	EXPECT_EQ(std::vector<int>(5, 33), name->mTags);
+	EXPECT_EQ(16.5f, name->mWeight);
+	EXPECT_EQ(33.0f, names[11].GetComponent<TransformComponent>()->GetX());
+}
+
+TEST(Reflection, Delta) {
+	auto manager = CreateEntityManager();
+	for (auto i = 0; i < 1000; i++) {
+		manager->CreateEntity().AddComponent<NameComponent>()->mName = "entity";
+	}
+	auto baseline = Save(*manager);
+	manager->With<NameComponent>()[10].GetComponent<NameComponent>()->mWeight = 2.0f;
+	auto target = Save(*manager);
+
+	auto delta = Symbiote::Core::EncodeSnapshotDelta(baseline, target);
+	EXPECT_LT(delta.size() * 20, target.size());
+	EXPECT_EQ(target, Symbiote::Core::ApplySnapshotDelta(baseline, delta));
+}
+
+
+TEST(Reflection, LoadInstanceSnapshot) {
+	auto expected = CreateEntityManager();
+	for (auto i = 0; i < 20; i++) {
+		auto entity = expected->CreateEntity();
+		entity.AddComponent<ScaleComponent>(2.0f, static_cast<float>(i));
+		entity.AddComponent<TransformComponent>(static_cast<float>(i), 0.5f);
+	}
+
+	// the reflected component reads each instance as its fields, the hand-serialized one through Deserialize
+	for (std::uint32_t version = 1; version <= Symbiote::Core::EntityManager::SnapshotVersion; version++) {
+		std::istringstream is(WriteInstanceSnapshot(version, 20));
+		auto loaded = CreateEntityManager();
+		loaded->Deserialize(is);
+		auto entities = loaded->With<TransformComponent>();
+		ASSERT_EQ(20, entities.size());
+		EXPECT_EQ(7.0f, entities[7].GetComponent<TransformComponent>()->GetX());
+		EXPECT_EQ(0.5f, entities[7].GetComponent<TransformComponent>()->GetY());
+		EXPECT_EQ(7.0f, entities[7].GetComponent<ScaleComponent>()->mData.y);
+		EXPECT_EQ(Save(*expected), Save(*loaded));
+		EXPECT_EQ(expected->Hash(), loaded->Hash());
+	}
+}
@@ -0,0 +1,122 @@
+#include <sstream>
+#include <gtest/gtest.h>
+
+#include "core/ecs/entitymanager.hpp"
+
+#include "test_components/components.hpp"
+
+static auto Save(const Symbiote::Core::EntityManager &manager) -> std::string {
+	std::ostringstream os;
+	manager.Serialize(os);
+	return os.str();
+}
+
+static auto Populate(Symbiote::Core::EntityManager &manager, int count) -> void {
+	for (auto i = 0; i < count; i++) {
+		auto entity = manager.CreateEntity();
+		entity.AddComponent<PositionComponent>(static_cast<float>(i), 0.0f);
+		entity.AddComponent<VelocityComponent>(1.0f, 0.5f, 0.0f);
+		if (i % 2 == 0) {
+			entity.AddComponent<TransformComponent>(static_cast<float>(i), 1.0f);
+		}
+		if (i % 5 == 0) {
+			entity.AddComponent<DummyComponent>();
+		}
+	}
+}
+
+static auto Simulate(Symbiote::Core::EntityManager &manager) -> void {
+	manager.With<PositionComponent, VelocityComponent>([](auto, auto position, auto velocity) {
+		position->x += velocity->x;
+		position->y += velocity->y;
+	});
+	manager.With<TransformComponent>([](auto, auto transform) { transform->mData.y *= 1.5f; });
+}
+
+TEST(Rollback, SaveAndRestore) {
+	auto manager = CreateEntityManager();
+	Populate(*manager, 3000);
+	manager->SaveFrame(0);
+	auto frame0 = Save(*manager);
+
+	auto entities = manager->With<PositionComponent>();
+	Simulate(*manager);
+	entities[3].RemoveComponent<PositionComponent>();
+	entities[4].AddComponent<NameComponent>()->mName = "four";
+	entities[5].Destroy();
+	manager->CreateEntity().AddComponent<DummyComponent>();
+	manager->SaveFrame(1);
+	auto frame1 = Save(*manager);
+
+	Simulate(*manager);
+	entities[6].Destroy();
+	manager->RestoreFrame(0);
+	EXPECT_EQ(frame0, Save(*manager));
+	EXPECT_EQ(3000, manager->Size());
+
+	// writing to a restored world does not alter the kept frame
+	Simulate(*manager);
+	manager->RestoreFrame(1);
+	EXPECT_EQ(frame1, Save(*manager));
+	EXPECT_EQ("four", manager->With<NameComponent>()[0].GetComponent<NameComponent>()->mName);
+	Simulate(*manager);
+	manager->RestoreFrame(0);
+	EXPECT_EQ(frame0, Save(*manager));
+}
+
+TEST(Rollback, RingBuffer) {
+	auto manager = CreateEntityManager();
+	EXPECT_EQ(Symbiote::Core::EntityManager::DefaultRollbackFrameCount, manager->GetRollbackFrameCount());
+	manager->SetRollbackFrameCount(4);
+	for (std::uint64_t tick = 0; tick < 10; tick++) {
+		manager->CreateEntity();
+		manager->SaveFrame(tick);
+	}
+	EXPECT_FALSE(manager->HasFrame(5));
+	for (std::uint64_t tick = 6; tick < 10; tick++) {
+		EXPECT_TRUE(manager->HasFrame(tick));
+	}
+	EXPECT_THROW(manager->RestoreFrame(3), std::logic_error);
+
+	// saving an earlier tick again drops the frames after it
+	manager->RestoreFrame(7);
+	EXPECT_EQ(8, manager->Size());
+	manager->SaveFrame(7);
+	EXPECT_TRUE(manager->HasFrame(7));
+	EXPECT_FALSE(manager->HasFrame(8));
+	EXPECT_FALSE(manager->HasFrame(9));
+}
+
+TEST(Rollback, Resimulate) {
+	auto manager = CreateEntityManager();
+	Populate(*manager, 500);
+	std::vector<std::string> frames;
+	for (std::uint64_t tick = 0; tick <= 20; tick++) {
+		manager->SaveFrame(tick);
+		frames.push_back(Save(*manager));
+		Simulate(*manager);
+	}
+	manager->RestoreFrame(12);
+	for (std::uint64_t tick = 12; tick <= 20; tick++) {
+		EXPECT_EQ(frames[tick], Save(*manager));
+		manager->SaveFrame(tick);
+		Simulate(*manager);
+	}
+}
+
+TEST(Rollback, PodPointersAfterCapture) {
+	auto manager = CreateEntityManager();
+	auto entity = manager->CreateEntity();
+	auto position = entity.AddComponent<PositionComponent>(1.0f, 0.0f);
+	manager->SaveFrame(0);
+	auto fork = manager->Fork();
+
+	// the frame and the fork share the page, a pointer taken before them is fetched again to write
+	auto fetched = entity.GetComponent<PositionComponent>();
+	EXPECT_NE(position, fetched);
+	fetched->x = 5.0f;
+	EXPECT_EQ(5.0f, entity.GetComponent<PositionComponent>()->x);
+	EXPECT_EQ(1.0f, fork->With<PositionComponent>()[0].GetComponent<PositionComponent>()->x);
+	manager->RestoreFrame(0);
+	EXPECT_EQ(1.0f, manager->With<PositionComponent>()[0].GetComponent<PositionComponent>()->x);
+}
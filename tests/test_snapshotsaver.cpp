@@ -0,0 +1,96 @@
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <gtest/gtest.h>
+
+#include "core/ecs/entitymanager.hpp"
+
+#include "test_components/components.hpp"
+
+static auto Save(const Symbiote::Core::EntityManager &manager) -> std::string {
+	std::ostringstream os;
+	manager.Serialize(os);
+	return os.str();
+}
+
+static auto ReadFile(const char *path) -> std::string {
+	std::ifstream file(path, std::ios::binary);
+	std::ostringstream os;
+	os << file.rdbuf();
+	return os.str();
+}
+
+TEST(SnapshotSaver, CaptureIsCopyOnWrite) {
+	auto manager = CreateEntityManager();
+	for (auto i = 0; i < 5000; i++) {
+		auto entity = manager->CreateEntity();
+		entity.AddComponent<PositionComponent>(static_cast<float>(i), 0.0f);
+		entity.AddComponent<TransformComponent>(static_cast<float>(i), 0.0f);
+	}
+	auto before = Save(*manager);
+	auto capture = manager->CaptureSnapshot();
+
+	for (auto entity : manager->With<PositionComponent, TransformComponent>()) {
+		entity.GetComponent<PositionComponent>()->y = 1.0f;
+		entity.GetComponent<TransformComponent>()->mData.y = 1.0f;
+	}
+	manager->CreateEntity().AddComponent<PositionComponent>();
+
+	std::ostringstream os;
+	Symbiote::Core::WriteSnapshot(*capture, os);
+	EXPECT_EQ(before, os.str());
+	EXPECT_NE(before, Save(*manager));
+
+	// pages are only copied once
+	auto position = manager->With<PositionComponent>().front().GetComponent<PositionComponent>();
+	EXPECT_EQ(position, manager->With<PositionComponent>().front().GetComponent<PositionComponent>());
+}
+
+TEST(SnapshotSaver, SaveAsync) {
+	const char *path = "async_save.bin";
+	auto manager = CreateEntityManager();
+	for (auto i = 0; i < 1000; i++) {
+		manager->CreateEntity().AddComponent<PositionComponent>(static_cast<float>(i), 0.0f);
+	}
+	auto expected = Save(*manager);
+
+	std::atomic<int> callbacks = {0};
+	auto future = manager->SaveAsync(path, [&callbacks](const auto &result) {
+		EXPECT_TRUE(result.error.empty());
+		callbacks += 1;
+	});
+	// the simulation keeps going while the file is written
+	for (auto entity : manager->With<PositionComponent>()) {
+		entity.GetComponent<PositionComponent>()->x = -1.0f;
+	}
+	auto result = future.get();
+	EXPECT_EQ(1, callbacks.load());
+	EXPECT_TRUE(result.error.empty());
+	EXPECT_EQ(expected.size(), result.size);
+	EXPECT_GT(result.stall.count(), 0);
+	EXPECT_EQ(expected, ReadFile(path));
+
+	auto loaded = CreateEntityManager();
+	loaded->DeserializeMapped(path);
+	EXPECT_EQ(999.0f, loaded->With<PositionComponent>().back().GetComponent<PositionComponent>()->x);
+	std::remove(path);
+}
+
+TEST(SnapshotSaver, SavesInOrderAndReportsErrors) {
+	auto manager = CreateEntityManager();
+	std::vector<std::future<Symbiote::Core::SnapshotSaver::Result>> futures;
+	for (auto i = 0; i < 4; i++) {
+		manager->CreateEntity().AddComponent<TransformComponent>(static_cast<float>(i), 0.0f);
+		futures.emplace_back(manager->SaveAsync("async_save_order.bin"));
+	}
+	auto expected = Save(*manager);
+	for (auto &future : futures) {
+		EXPECT_TRUE(future.get().error.empty());
+	}
+	EXPECT_EQ(expected, ReadFile("async_save_order.bin"));
+	std::remove("async_save_order.bin");
+
+	auto failed = manager->SaveAsync("missing_directory/async_save.bin").get();
+	EXPECT_FALSE(failed.error.empty());
+}
@@ -1,6 +1,14 @@
 #include "systems.hpp"
 
+DEFINE_SYSTEM(BusySystem);
 DEFINE_SYSTEM(WorldStateSystem);
 
 WorldStateSystem::WorldStateSystem(char *inputState, char *networkState) : mInputState(inputState), mNetworkState(networkState) {
+}
+
+auto BusySystem::Update(std::chrono::nanoseconds duration) -> void {
+	auto timer = TimeUpdate();
+	auto start = std::chrono::steady_clock::now();
+	while (std::chrono::steady_clock::now() - start < duration) {
+	}
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <chrono>
+
 #include <core/ecs/system.hpp>
 
 class WorldStateSystem final : public Symbiote::Core::System {
@@ -12,4 +14,12 @@ public:
 public:
 	char *mInputState = nullptr;
 	char *mNetworkState = nullptr;
+};
+
+class BusySystem final : public Symbiote::Core::System {
+public:
+	DECLARE_SYSTEM(BusySystem);
+
+public:
+	auto Update(std::chrono::nanoseconds duration) -> void;
 };
\ No newline at end of file
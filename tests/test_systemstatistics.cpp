@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include <core/ecs/entitymanager.hpp>
+
+#include "test_systems/systems.hpp"
+
+using namespace std::chrono_literals;
+
+TEST(SystemStatistics, Summary) {
+	Symbiote::Core::SystemStatistics statistics;
+	EXPECT_EQ(0, statistics.GetSummary().samples);
+	for (auto i = 1; i <= 100; i++) {
+		statistics.Record(std::chrono::nanoseconds(i));
+	}
+	auto summary = statistics.GetSummary();
+	EXPECT_EQ(100, summary.samples);
+	EXPECT_EQ(1ns, summary.min);
+	EXPECT_EQ(100ns, summary.max);
+	EXPECT_EQ(50ns, summary.average);
+	EXPECT_EQ(95ns, summary.p95);
+	EXPECT_EQ(99ns, summary.p99);
+	EXPECT_EQ(100ns, summary.last);
+	EXPECT_EQ(0, summary.overruns);
+
+	// rolling window drops the oldest samples
+	for (std::size_t i = 0; i < Symbiote::Core::SystemStatistics::WindowSize; i++) {
+		statistics.Record(1000ns);
+	}
+	summary = statistics.GetSummary();
+	EXPECT_EQ(Symbiote::Core::SystemStatistics::WindowSize, summary.samples);
+	EXPECT_EQ(1000ns, summary.min);
+	EXPECT_EQ(1000ns, summary.average);
+}
+
+TEST(SystemStatistics, Budget) {
+	Symbiote::Core::SystemStatistics statistics;
+	statistics.SetBudget(10ns);
+	EXPECT_TRUE(statistics.Record(5ns));
+	EXPECT_TRUE(statistics.Record(10ns));
+	EXPECT_FALSE(statistics.Record(11ns));
+	EXPECT_EQ(1, statistics.GetSummary().overruns);
+	statistics.Reset();
+	EXPECT_EQ(0, statistics.GetSummary().overruns);
+	EXPECT_EQ(0, statistics.GetSummary().samples);
+	EXPECT_EQ(10ns, statistics.GetSummary().budget);
+}
+
+TEST(SystemStatistics, EntityManagerQueries) {
+	Symbiote::Core::EntityManager manager;
+	EXPECT_ANY_THROW(manager.GetSystemStatistics<BusySystem>());
+	EXPECT_ANY_THROW(manager.SetSystemBudget<BusySystem>(1ms));
+
+	auto busy = manager.AddSystem<BusySystem>();
+	manager.AddSystem<WorldStateSystem>(nullptr, nullptr);
+	busy->Update(100us);
+	busy->Update(100us);
+
+	auto summary = manager.GetSystemStatistics<BusySystem>();
+	EXPECT_EQ(2, summary.samples);
+	EXPECT_GE(summary.min, 100us);
+	EXPECT_GE(summary.max, summary.min);
+	EXPECT_EQ(0, manager.GetSystemStatistics<WorldStateSystem>().samples);
+
+	auto all = manager.GetSystemsStatistics();
+	ASSERT_EQ(2, all.size());
+	EXPECT_EQ(BusySystem::SystemName, all[0].first);
+	EXPECT_EQ(2, all[0].second.samples);
+	EXPECT_EQ(WorldStateSystem::SystemName, all[1].first);
+}
+
+TEST(SystemStatistics, BudgetWarnings) {
+	Symbiote::Core::EntityManager manager;
+	auto busy = manager.AddSystem<BusySystem>();
+	std::vector<std::string> warnings;
+	manager.SetBudgetWarningHandler([&warnings](const Symbiote::Core::System &system, auto elapsed, auto budget) {
+		EXPECT_GT(elapsed, budget);
+		warnings.emplace_back(system.GetSystemName());
+	});
+	manager.SetSystemBudget<BusySystem>(50us);
+
+	busy->Update(0us);
+	EXPECT_TRUE(warnings.empty());
+	busy->Update(200us);
+	ASSERT_EQ(1, warnings.size());
+	EXPECT_EQ(BusySystem::SystemName, warnings[0]);
+	EXPECT_EQ(1, manager.GetSystemStatistics<BusySystem>().overruns);
+}
@@ -0,0 +1,181 @@
+#include <cmath>
+#include <gtest/gtest.h>
+
+#include "core/ecs/entitymanager.hpp"
+
+#include "game/systems/transform/transform.hpp"
+#include "game/components/transform/transform.hpp"
+
+using Symbiote::Core::Entity;
+using Symbiote::Core::EntityManager;
+using Symbiote::Game::TransformSystem;
+using Symbiote::Game::TransformComponent;
+using Symbiote::Game::TransformCoordinates;
+
+static constexpr float HalfPi = 1.57079632679f;
+
+static auto CreateTransform(EntityManager &manager, TransformComponent::Position position, Entity parent = {}) -> Entity {
+	auto entity = manager.CreateEntity();
+	entity.AddComponent<TransformComponent>(TransformComponent::Scale{1.0f, 1.0f}, position, 0.0f, parent);
+	return entity;
+}
+
+TEST(Transform, WorldCoordinates) {
+	EntityManager manager;
+	manager.RegisterComponent<TransformComponent>();
+	auto rootEntity = CreateTransform(manager, {10.0f, 0.0f});
+	auto childEntity = CreateTransform(manager, {1.0f, 0.0f}, rootEntity);
+	auto grandchildEntity = CreateTransform(manager, {1.0f, 0.0f}, childEntity);
+	auto root = rootEntity.GetComponent<TransformComponent>();
+	auto grandchild = grandchildEntity.GetComponent<TransformComponent>();
+	root->SetRotation(HalfPi);
+	root->SetScale({2.0f, 2.0f});
+
+	// world transforms go up the whole hierarchy
+	EXPECT_NEAR(10.0f, grandchild->GetPosition(TransformCoordinates::World).x, 1e-4f);
+	EXPECT_NEAR(4.0f, grandchild->GetPosition(TransformCoordinates::World).y, 1e-4f);
+	EXPECT_NEAR(HalfPi, grandchild->GetRotation(TransformCoordinates::World), 1e-4f);
+	EXPECT_NEAR(2.0f, grandchild->GetScale(TransformCoordinates::World).x, 1e-4f);
+	EXPECT_EQ(2, grandchild->GetDepth());
+
+	// world setters are converted to local coordinates
+	grandchild->SetPosition({0.0f, 0.0f}, TransformCoordinates::World);
+	grandchild->SetRotation(0.0f, TransformCoordinates::World);
+	grandchild->SetScale({1.0f, 1.0f}, TransformCoordinates::World);
+	EXPECT_NEAR(-1.0f, grandchild->GetPosition().x, 1e-4f);
+	EXPECT_NEAR(5.0f, grandchild->GetPosition().y, 1e-4f);
+	EXPECT_NEAR(-HalfPi, grandchild->GetRotation(), 1e-4f);
+	EXPECT_NEAR(0.5f, grandchild->GetScale().x, 1e-4f);
+	EXPECT_NEAR(0.0f, glm::length(grandchild->GetPosition(TransformCoordinates::World)), 1e-4f);
+	EXPECT_NEAR(0.0f, grandchild->GetRotation(TransformCoordinates::World), 1e-4f);
+
+	EXPECT_THROW(root->SetParent(grandchildEntity), std::logic_error);
+	EXPECT_THROW(root->SetParent(manager.CreateEntity()), std::logic_error);
+	EXPECT_TRUE(grandchild->GetParent() == childEntity);
+	grandchild->SetParent({});
+	EXPECT_EQ(0, grandchild->GetDepth());
+	EXPECT_FALSE(grandchild->GetParent().IsValid());
+}
+
+TEST(Transform, DirtySubtrees) {
+	EntityManager manager;
+	manager.RegisterComponent<TransformComponent>();
+	auto transforms = manager.AddSystem<TransformSystem>();
+	std::vector<Entity> chain = {CreateTransform(manager, {0.0f, 0.0f})};
+	for (auto i = 1; i < 1000; i++) {
+		chain.push_back(CreateTransform(manager, {1.0f, 0.0f}, chain.back()));
+	}
+	auto other = CreateTransform(manager, {0.0f, 0.0f});
+	auto last = chain.back().GetComponent<TransformComponent>();
+	transforms->Update();
+	EXPECT_EQ(1001, transforms->GetUpdatedCount());
+	EXPECT_EQ(999.0f, last->GetWorldMatrix()[2].x);
+
+	transforms->Update();
+	EXPECT_EQ(0, transforms->GetUpdatedCount());
+
+	chain[500].GetComponent<TransformComponent>()->SetPosition({2.0f, 0.0f});
+	other.GetComponent<TransformComponent>()->SetPosition({1.0f, 0.0f});
+	// reads between updates see the change
+	EXPECT_EQ(1000.0f, last->GetPosition(TransformCoordinates::World).x);
+	transforms->Update();
+	EXPECT_EQ(501, transforms->GetUpdatedCount());
+	EXPECT_EQ(1000.0f, last->GetWorldMatrix()[2].x);
+
+	// reparenting is applied on the next update, all at once
+	chain[10].GetComponent<TransformComponent>()->SetParent(other);
+	chain[20].GetComponent<TransformComponent>()->SetParent(other);
+	EXPECT_EQ(1, chain[20].GetComponent<TransformComponent>()->GetDepth());
+	transforms->Update();
+	EXPECT_EQ(990, transforms->GetUpdatedCount());
+	EXPECT_EQ(982.0f, last->GetWorldMatrix()[2].x);
+	EXPECT_EQ(11.0f, chain[19].GetComponent<TransformComponent>()->GetWorldMatrix()[2].x);
+}
+
+TEST(Transform, Lifetime) {
+	EntityManager manager;
+	manager.RegisterComponent<TransformComponent>();
+	auto parent = CreateTransform(manager, {5.0f, 0.0f});
+	auto child = CreateTransform(manager, {1.0f, 0.0f}, parent);
+	auto grandchild = CreateTransform(manager, {1.0f, 0.0f}, child);
+	auto other = CreateTransform(manager, {1.0f, 0.0f});
+
+	// transforms created before the system are adopted on its first update
+	auto transforms = manager.AddSystem<TransformSystem>();
+	transforms->Update();
+	EXPECT_EQ(4, transforms->GetUpdatedCount());
+	EXPECT_EQ(7.0f, grandchild.GetComponent<TransformComponent>()->GetPosition(TransformCoordinates::World).x);
+
+	// destroying the parent destroys its subtree on the next update
+	parent.Destroy();
+	EXPECT_TRUE(child.IsValid());
+	transforms->Update();
+	EXPECT_FALSE(child.IsValid());
+	EXPECT_FALSE(grandchild.IsValid());
+	EXPECT_TRUE(other.IsValid());
+
+	// components outlive the system
+	manager.RemoveSystem<TransformSystem>();
+	other.GetComponent<TransformComponent>()->SetPosition({3.0f, 0.0f});
+	EXPECT_EQ(3.0f, other.GetComponent<TransformComponent>()->GetWorldMatrix()[2].x);
+}
+
+TEST(Transform, RemoveParentTransform) {
+	EntityManager manager;
+	manager.RegisterComponent<TransformComponent>();
+	auto transforms = manager.AddSystem<TransformSystem>();
+	auto parent = CreateTransform(manager, {5.0f, 0.0f});
+	auto child = CreateTransform(manager, {1.0f, 0.0f}, parent);
+	auto grandchild = CreateTransform(manager, {1.0f, 0.0f}, child);
+	transforms->Update();
+
+	// a parent which loses its transform keeps living, its children become roots
+	parent.RemoveComponent<TransformComponent>();
+	transforms->Update();
+	EXPECT_TRUE(parent.IsValid());
+	ASSERT_TRUE(child.IsValid());
+	EXPECT_EQ(Entity{}, child.GetComponent<TransformComponent>()->GetParent());
+	EXPECT_EQ(1.0f, child.GetComponent<TransformComponent>()->GetPosition(TransformCoordinates::World).x);
+	EXPECT_EQ(2.0f, grandchild.GetComponent<TransformComponent>()->GetPosition(TransformCoordinates::World).x);
+}
+
+TEST(Transform, MoveParent) {
+	EntityManager manager;
+	EntityManager other;
+	manager.RegisterComponent<TransformComponent>();
+	other.RegisterComponent<TransformComponent>();
+	auto transforms = manager.AddSystem<TransformSystem>();
+	auto parent = CreateTransform(manager, {5.0f, 0.0f});
+	auto child = CreateTransform(manager, {1.0f, 0.0f}, parent);
+	transforms->Update();
+
+	// a parent moved to another world, as when the cell of the parent is unloaded, leaves its children as roots
+	auto moved = other.MoveEntities(manager, {parent});
+	transforms->Update();
+	EXPECT_FALSE(parent.IsValid());
+	ASSERT_TRUE(child.IsValid());
+	EXPECT_EQ(Entity{}, child.GetComponent<TransformComponent>()->GetParent());
+	EXPECT_EQ(1.0f, child.GetComponent<TransformComponent>()->GetPosition(TransformCoordinates::World).x);
+	EXPECT_EQ(5.0f, moved[0].GetComponent<TransformComponent>()->GetPosition().x);
+}
+
+TEST(Transform, InterpolatedWorldMatrix) {
+	EntityManager manager;
+	manager.RegisterComponent<TransformComponent>();
+	auto rootEntity = CreateTransform(manager, {0.0f, 0.0f});
+	auto childEntity = CreateTransform(manager, {1.0f, 0.0f}, rootEntity);
+	auto root = rootEntity.GetComponent<TransformComponent>();
+	auto child = childEntity.GetComponent<TransformComponent>();
+	root->StorePreviousState();
+	child->StorePreviousState();
+	root->SetPosition({10.0f, 0.0f});
+	root->SetRotation(HalfPi);
+
+	// the child is drawn where the interpolated parent carries it
+	auto halfway = child->GetInterpolatedMatrix(0.5f);
+	EXPECT_NEAR(5.0f + std::cos(HalfPi * 0.5f), halfway[2][0], 1e-4f);
+	EXPECT_NEAR(std::sin(HalfPi * 0.5f), halfway[2][1], 1e-4f);
+	auto current = child->GetInterpolatedMatrix(1.0f);
+	EXPECT_NEAR(child->GetPosition(TransformCoordinates::World).x, current[2][0], 1e-4f);
+	EXPECT_NEAR(child->GetPosition(TransformCoordinates::World).y, current[2][1], 1e-4f);
+}
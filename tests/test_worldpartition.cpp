@@ -0,0 +1,145 @@
+#include <cstdio>
+#include <fstream>
+#include <utility>
+#include <algorithm>
+#include <gtest/gtest.h>
+
+#include "core/ecs/entitymanager.hpp"
+#include "core/ecs/worldpartition.hpp"
+#include "core/jobs/jobsystem.hpp"
+
+#include "test_components/components.hpp"
+
+static constexpr float CellSize = 10.0f;
+
+static auto Locate(const Symbiote::Core::Entity &entity, float &x, float &y) -> bool {
+	auto transform = entity.GetComponent<TransformComponent>();
+	if (transform == nullptr) {
+		return false;
+	}
+	x = transform->GetX();
+	y = transform->GetY();
+	return true;
+}
+
+// one entity per unit along x, 10 entities per cell over 10 cells
+static auto Populate(Symbiote::Core::EntityManager &manager) -> std::vector<Symbiote::Core::Entity> {
+	std::vector<Symbiote::Core::Entity> entities;
+	for (auto i = 0; i < 100; i++) {
+		auto entity = manager.CreateEntity();
+		entity.AddComponent<TransformComponent>(static_cast<float>(i), 0.0f);
+		entity.AddComponent<PositionComponent>(static_cast<float>(i), static_cast<float>(i * 2));
+		if (i % 3 == 0) {
+			entity.AddComponent<NameComponent>()->mName = "entity " + std::to_string(i);
+		}
+		entities.push_back(entity);
+	}
+	return entities;
+}
+
+static auto Contents(Symbiote::Core::EntityManager &manager) -> std::vector<std::pair<float, std::string>> {
+	std::vector<std::pair<float, std::string>> contents;
+	manager.With<TransformComponent, PositionComponent>([&](auto entity, auto transform, auto position) {
+		auto name = entity.template GetComponent<NameComponent>();
+		EXPECT_EQ(transform->GetX() * 2, position->y);
+		contents.emplace_back(transform->GetX(), name != nullptr ? name->mName : std::string{});
+	});
+	std::sort(contents.begin(), contents.end());
+	return contents;
+}
+
+TEST(WorldPartition, StreamCells) {
+	Symbiote::Core::JobSystem jobs(2);
+	auto manager = CreateEntityManager();
+	auto entities = Populate(*manager);
+	auto global = manager->CreateEntityWith<DummyComponent>();
+	auto expected = Contents(*manager);
+
+	Symbiote::Core::WorldPartition::Settings settings;
+	settings.cellSize = CellSize;
+	Symbiote::Core::WorldPartition partition(*manager, jobs, &Locate, settings);
+	partition.Update(5.0f, 5.0f);
+	partition.Flush();
+	// cells 0 and 1 are around the focus, entities without a transform are never streamed out
+	EXPECT_EQ(21, manager->Size());
+	EXPECT_EQ(8, partition.GetSavedCellCount());
+	EXPECT_TRUE(global.IsValid());
+	EXPECT_TRUE(entities[15].IsValid());
+	EXPECT_FALSE(entities[50].IsValid());
+	EXPECT_THROW(entities[50].GetComponent<TransformComponent>(), std::logic_error);
+	EXPECT_TRUE(partition.IsCellLoaded(partition.GetCell(15.0f, 0.0f)));
+	EXPECT_EQ(Symbiote::Core::WorldPartition::CellState::Saved, partition.GetCellState(partition.GetCell(50.0f, 0.0f)));
+
+	partition.Update(55.0f, 5.0f);
+	partition.Flush();
+	EXPECT_EQ(31, manager->Size());
+	EXPECT_EQ(7, partition.GetSavedCellCount());
+	EXPECT_FALSE(entities[15].IsValid());
+	EXPECT_TRUE(partition.IsCellLoaded(partition.GetCell(50.0f, 0.0f)));
+
+	for (auto x = 0.0f; x < 100.0f; x += CellSize) {
+		partition.Update(x, 5.0f);
+	}
+	partition.Update(5.0f, 5.0f);
+	partition.Flush();
+	EXPECT_EQ(21, manager->Size());
+	auto focus = Contents(*manager);
+	EXPECT_TRUE(std::equal(focus.begin(), focus.end(), expected.begin()));
+}
+
+TEST(WorldPartition, Callbacks) {
+	Symbiote::Core::JobSystem jobs(1);
+	auto manager = CreateEntityManager();
+	auto entities = Populate(*manager);
+
+	Symbiote::Core::WorldPartition::Settings settings;
+	settings.cellSize = CellSize;
+	settings.loadRadius = 0;
+	settings.directory = ".";
+	settings.compress = false;
+	Symbiote::Core::WorldPartition partition(*manager, jobs, &Locate, settings);
+	std::vector<Symbiote::Core::Entity> unloaded, loaded;
+	partition.SetCellUnloadCallback([&](auto cell, const auto &cellEntities) {
+		if (cell == partition.GetCell(30.0f, 0.0f)) {
+			unloaded = cellEntities;
+		}
+	});
+	partition.SetCellLoadCallback([&](auto cell, const auto &cellEntities) {
+		EXPECT_EQ(partition.GetCell(30.0f, 0.0f), cell);
+		loaded = cellEntities;
+	});
+	partition.Update(0.0f, 0.0f);
+	partition.Flush();
+	ASSERT_EQ(10, unloaded.size());
+	EXPECT_TRUE(std::equal(unloaded.begin(), unloaded.end(), entities.begin() + 30));
+	EXPECT_TRUE(std::ifstream("./cell_3_0.bin").good());
+
+	partition.Update(30.0f, 0.0f);
+	partition.Flush();
+	// loaded entities are new handles, given in the order the cell was saved in
+	ASSERT_EQ(10, loaded.size());
+	for (auto i = 0; i < 10; i++) {
+		EXPECT_FALSE(unloaded[i].IsValid());
+		EXPECT_EQ(30.0f + i, loaded[i].GetComponent<TransformComponent>()->GetX());
+	}
+	for (auto x = 0; x < 100; x += 10) {
+		std::remove(("./cell_" + std::to_string(x / 10) + "_0.bin").c_str());
+	}
+}
+
+TEST(WorldPartition, FailedSave) {
+	Symbiote::Core::JobSystem jobs(1);
+	auto manager = CreateEntityManager();
+	Populate(*manager);
+
+	Symbiote::Core::WorldPartition::Settings settings;
+	settings.cellSize = CellSize;
+	settings.directory = "./missing/directory";
+	Symbiote::Core::WorldPartition partition(*manager, jobs, &Locate, settings);
+	partition.Update(0.0f, 0.0f);
+	EXPECT_THROW(partition.Flush(), std::runtime_error);
+	partition.Flush();
+	// the entities of the cells which failed to save are back in the world
+	EXPECT_EQ(100, manager->Size());
+	EXPECT_EQ(0, partition.GetSavedCellCount());
+}